@@ -0,0 +1,123 @@
+#include <string.h>
+
+#include "common_bench_utils.h"
+#include "../stack/stack.h"
+#include "../queue/queue.h"
+#include "../common/defs.h"
+
+#define N_ELEMS 1000000
+#define N_ROUNDS 3
+
+/**
+ * Linked with '-Wl,--wrap=malloc' so that every malloc call of the containers is counted
+ */
+void *__real_malloc(size_t size);
+void *__wrap_malloc(size_t size);
+
+static size_t n_mallocs = 0;
+
+void *__wrap_malloc(size_t size)
+{
+    n_mallocs++;
+    return __real_malloc(size);
+}
+
+typedef struct {
+    uint32_t id;
+    uint32_t weight;
+    uint64_t stamp;
+} record_t;
+
+static elem_t record_copy(elem_t r)
+{
+    record_t *copy = malloc(sizeof(record_t));
+    memcpy(copy, r, sizeof(record_t));
+    return copy;
+}
+
+static void record_delete(elem_t r)
+{
+    free(r);
+}
+
+static size_t record_size(const void *r)
+{
+    return sizeof(record_t);
+}
+
+////////////////////////////////////////////////////////////////////
+///     BENCHMARKS
+////////////////////////////////////////////////////////////////////
+
+static void bench_stack(const char *mode, Stack s)
+{
+    char name[64];
+    uint64_t ns, fill_ns = 0, clear_ns = 0;
+    record_t record = {0, 0, 0};
+
+    size_t mallocs = n_mallocs;
+    for (size_t round = 0; round < N_ROUNDS; round++) {
+        BENCH_TIME(ns,
+            for (uint32_t i = 0; i < N_ELEMS; i++) {
+                record.id = i;
+                stack__push(s, &record);
+            }
+        );
+        fill_ns += ns;
+
+        BENCH_TIME(ns,
+            stack__clear(s);
+        );
+        clear_ns += ns;
+    }
+    mallocs = n_mallocs - mallocs;
+
+    snprintf(name, sizeof(name), "%s push", mode);
+    print_bench_result(name, (size_t)N_ELEMS * N_ROUNDS, fill_ns);
+    snprintf(name, sizeof(name), "%s clear", mode);
+    print_bench_result(name, (size_t)N_ELEMS * N_ROUNDS, clear_ns);
+    printf("%-50s %12zu mallocs %9.3f ms per clear\n", mode, mallocs, (double)clear_ns / N_ROUNDS / 1e6);
+
+    stack__free(s);
+}
+
+static void bench_queue(const char *mode, Queue q)
+{
+    char name[64];
+    uint64_t ns;
+    record_t record = {0, 0, 0};
+
+    size_t mallocs = n_mallocs;
+    for (uint32_t i = 0; i < N_ELEMS; i++) {
+        record.id = i;
+        queue__enqueue(q, &record);
+    }
+    BENCH_TIME(ns,
+        for (uint32_t i = 0; i < N_ELEMS; i++) {
+            queue__dequeue(q, NULL);
+            queue__enqueue(q, &record);
+        }
+    );
+    snprintf(name, sizeof(name), "%s dequeue + enqueue", mode);
+    print_bench_result(name, N_ELEMS, ns);
+
+    BENCH_TIME(ns,
+        queue__free(q);
+    );
+    snprintf(name, sizeof(name), "%s free", mode);
+    print_bench_result(name, N_ELEMS, ns);
+    printf("%-50s %12zu mallocs\n", mode, n_mallocs - mallocs);
+}
+
+
+int main(void)
+{
+    printf("----------- BENCH ARENA -----------\n");
+
+    bench_stack("Stack copy enabled,", stack__empty_copy_enabled(record_copy, record_delete));
+    bench_stack("Stack arena,", stack__empty_arena(record_size));
+    bench_queue("Queue copy enabled,", queue__empty_copy_enabled(record_copy, record_delete));
+    bench_queue("Queue arena,", queue__empty_arena(record_size));
+
+    return EXIT_SUCCESS;
+}
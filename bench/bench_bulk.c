@@ -0,0 +1,250 @@
+#include "common_bench_utils.h"
+#include "../stack/stack.h"
+#include "../queue/queue.h"
+#include "../common/defs.h"
+
+#define BATCH 256
+#define N_ROUNDS 40000
+#define HANDOVER_ELEMS 1000000
+#define N_HANDOVERS 20
+
+static elem_t int_copy(elem_t e)
+{
+    int *copy = malloc(sizeof(int));
+    *copy = *(int *)e;
+    return copy;
+}
+
+static void int_delete(elem_t e)
+{
+    free(e);
+}
+
+/**
+ * The copies of a run share a single block starting at the first one, so the run must be deleted as a whole
+ */
+static void int_copy_n(elem_t *dst, const elem_t *src, size_t n)
+{
+    int *block = malloc(sizeof(int) * n);
+    for (size_t i = 0; i < n; i++) {
+        block[i] = *(const int *)src[i];
+        dst[i] = &block[i];
+    }
+}
+
+static void int_delete_n(elem_t *elems, size_t n)
+{
+    free(elems[0]);
+}
+
+////////////////////////////////////////////////////////////////////
+///     BENCHMARKS
+////////////////////////////////////////////////////////////////////
+
+/**
+ * Each round pushes a batch in a fresh stack then pops it, so that the growth steps are part of the cost
+ */
+static void bench_stack(const char *mode, bool copy_enabled, elem_t *batch, elem_t *out)
+{
+    char name[64];
+    uint64_t ns;
+
+    BENCH_TIME(ns,
+        for (size_t r = 0; r < N_ROUNDS; r++) {
+            Stack s = copy_enabled ? stack__empty_copy_enabled(int_copy, int_delete) : stack__empty_copy_disabled();
+            for (size_t i = 0; i < BATCH; i++) {
+                stack__push(s, batch[i]);
+            }
+            for (size_t i = BATCH; i > 0; i--) {
+                stack__pop(s, &out[i - 1]);
+            }
+            stack__free(s);
+            if (copy_enabled) {
+                for (size_t i = 0; i < BATCH; i++) free(out[i]);
+            }
+        }
+    );
+    snprintf(name, sizeof(name), "Stack push/pop loop, %s", mode);
+    print_bench_result(name, 2 * BATCH * N_ROUNDS, ns);
+
+    BENCH_TIME(ns,
+        for (size_t r = 0; r < N_ROUNDS; r++) {
+            Stack s = copy_enabled ? stack__empty_copy_enabled(int_copy, int_delete) : stack__empty_copy_disabled();
+            stack__push_n(s, batch, BATCH);
+            stack__pop_n(s, out, BATCH);
+            stack__free(s);
+            if (copy_enabled) {
+                for (size_t i = 0; i < BATCH; i++) free(out[i]);
+            }
+        }
+    );
+    snprintf(name, sizeof(name), "Stack push_n/pop_n, %s", mode);
+    print_bench_result(name, 2 * BATCH * N_ROUNDS, ns);
+}
+
+static void bench_queue(const char *mode, bool copy_enabled, elem_t *batch, elem_t *out)
+{
+    char name[64];
+    uint64_t ns;
+
+    BENCH_TIME(ns,
+        for (size_t r = 0; r < N_ROUNDS; r++) {
+            Queue q = copy_enabled ? queue__empty_copy_enabled(int_copy, int_delete) : queue__empty_copy_disabled();
+            for (size_t i = 0; i < BATCH; i++) {
+                queue__enqueue(q, batch[i]);
+            }
+            for (size_t i = 0; i < BATCH; i++) {
+                queue__dequeue(q, &out[i]);
+            }
+            queue__free(q);
+            if (copy_enabled) {
+                for (size_t i = 0; i < BATCH; i++) free(out[i]);
+            }
+        }
+    );
+    snprintf(name, sizeof(name), "Queue enqueue/dequeue loop, %s", mode);
+    print_bench_result(name, 2 * BATCH * N_ROUNDS, ns);
+
+    BENCH_TIME(ns,
+        for (size_t r = 0; r < N_ROUNDS; r++) {
+            Queue q = copy_enabled ? queue__empty_copy_enabled(int_copy, int_delete) : queue__empty_copy_disabled();
+            queue__enqueue_n(q, batch, BATCH);
+            queue__dequeue_n(q, out, BATCH);
+            queue__free(q);
+            if (copy_enabled) {
+                for (size_t i = 0; i < BATCH; i++) free(out[i]);
+            }
+        }
+    );
+    snprintf(name, sizeof(name), "Queue enqueue_n/dequeue_n, %s", mode);
+    print_bench_result(name, 2 * BATCH * N_ROUNDS, ns);
+}
+
+
+/**
+ * Hands a filled stack over to the caller, by a copy with dump or by giving the array away with steal
+ */
+static void bench_handover(elem_t *elems)
+{
+    char name[64];
+    uint64_t ns, dump_ns = 0, steal_ns = 0;
+    Stack s = stack__empty_copy_disabled();
+
+    for (size_t r = 0; r < N_HANDOVERS; r++) {
+        stack__push_n(s, elems, HANDOVER_ELEMS);
+        BENCH_TIME(ns, free(stack__dump(s)););
+        dump_ns += ns;
+
+        stack__push_n(s, elems, HANDOVER_ELEMS);
+        BENCH_TIME(ns, free(stack__steal(s, NULL, NULL)););
+        steal_ns += ns;
+    }
+    stack__free(s);
+
+    snprintf(name, sizeof(name), "Stack dump, %d elems", HANDOVER_ELEMS);
+    print_bench_result(name, N_HANDOVERS, dump_ns);
+    snprintf(name, sizeof(name), "Stack steal, %d elems", HANDOVER_ELEMS);
+    print_bench_result(name, N_HANDOVERS, steal_ns);
+}
+
+
+/**
+ * Each round allocates a batch of fresh elements and hands them to a copy enabled queue, which copies them
+ * with 'enqueue' so that the caller frees its originals, or takes them over with 'enqueue_owned'
+ */
+static void bench_owned(void)
+{
+    char name[64];
+    uint64_t ns;
+    elem_t fresh[BATCH];
+    Queue q = queue__empty_copy_enabled(int_copy, int_delete);
+
+    BENCH_TIME(ns,
+        for (size_t r = 0; r < N_ROUNDS; r++) {
+            for (int i = 0; i < BATCH; i++) {
+                fresh[i] = malloc(sizeof(int));
+                *(int *)fresh[i] = i;
+                queue__enqueue(q, fresh[i]);
+                free(fresh[i]);
+            }
+            queue__dequeue_n(q, NULL, BATCH);
+        }
+    );
+    snprintf(name, sizeof(name), "Queue enqueue + free, copy enabled");
+    print_bench_result(name, BATCH * N_ROUNDS, ns);
+
+    BENCH_TIME(ns,
+        for (size_t r = 0; r < N_ROUNDS; r++) {
+            for (int i = 0; i < BATCH; i++) {
+                fresh[i] = malloc(sizeof(int));
+                *(int *)fresh[i] = i;
+            }
+            queue__enqueue_owned_n(q, fresh, BATCH);
+            queue__dequeue_n(q, NULL, BATCH);
+        }
+    );
+    snprintf(name, sizeof(name), "Queue enqueue_owned_n, copy enabled");
+    print_bench_result(name, BATCH * N_ROUNDS, ns);
+
+    queue__free(q);
+}
+
+
+/**
+ * Each round pushes a batch then clears the stack, the batch operators allocate and free one block per batch
+ */
+static void bench_batch_operators(elem_t *batch)
+{
+    char name[64];
+    uint64_t ns;
+    Stack s = stack__empty_copy_enabled(int_copy, int_delete);
+
+    BENCH_TIME(ns,
+        for (size_t r = 0; r < N_ROUNDS; r++) {
+            stack__push_n(s, batch, BATCH);
+            stack__clear(s);
+        }
+    );
+    snprintf(name, sizeof(name), "Stack push_n/clear, copy operators");
+    print_bench_result(name, BATCH * N_ROUNDS, ns);
+    stack__free(s);
+
+    s = stack__empty_copy_enabled_n(int_copy, int_delete, int_copy_n, int_delete_n);
+    BENCH_TIME(ns,
+        for (size_t r = 0; r < N_ROUNDS; r++) {
+            stack__push_n(s, batch, BATCH);
+            stack__clear(s);
+        }
+    );
+    snprintf(name, sizeof(name), "Stack push_n/clear, batch operators");
+    print_bench_result(name, BATCH * N_ROUNDS, ns);
+    stack__free(s);
+}
+
+int main(void)
+{
+    printf("----------- BENCH BULK -----------\n");
+
+    int values[BATCH];
+    elem_t batch[BATCH], out[BATCH];
+    for (int i = 0; i < BATCH; i++) {
+        values[i] = i;
+        batch[i] = &values[i];
+    }
+
+    bench_stack("copy disabled", false, batch, out);
+    bench_stack("copy enabled", true, batch, out);
+    bench_queue("copy disabled", false, batch, out);
+    bench_queue("copy enabled", true, batch, out);
+    bench_owned();
+    bench_batch_operators(batch);
+
+    elem_t *elems = malloc(sizeof(elem_t) * HANDOVER_ELEMS);
+    for (int i = 0; i < HANDOVER_ELEMS; i++) {
+        elems[i] = &values[i % BATCH];
+    }
+    bench_handover(elems);
+    free(elems);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,107 @@
+#include "common_bench_utils.h"
+#include "../stack/stack.h"
+#include "../queue/queue.h"
+#include "../common/defs.h"
+
+#define BOUNDARY 1024
+#define N_CYCLES 1000000
+
+static size_t n_reallocs = 0;
+
+static void *counting_alloc(void *ctx, size_t size)
+{
+    return malloc(size);
+}
+
+static void *counting_realloc(void *ctx, void *ptr, size_t size)
+{
+    n_reallocs++;
+    return realloc(ptr, size);
+}
+
+static void counting_free(void *ctx, void *ptr)
+{
+    free(ptr);
+}
+
+static const allocator_t allocator = {counting_alloc, counting_realloc, counting_free, NULL};
+
+////////////////////////////////////////////////////////////////////
+///     BENCHMARKS
+////////////////////////////////////////////////////////////////////
+
+/**
+ * Oscillates one element below and above a power of two: pop, pop, push, push
+ */
+static void bench_stack(const char *mode, const capacity_policy_t *policy)
+{
+    char name[64];
+    uint64_t ns;
+    Stack s = stack__empty_with_allocator(&allocator, NULL, NULL);
+    stack__set_policy(s, policy);
+
+    for (size_t i = 0; i <= BOUNDARY; i++) {
+        stack__push(s, (elem_t)i);
+    }
+
+    n_reallocs = 0;
+    BENCH_TIME(ns,
+        for (size_t i = 0; i < N_CYCLES; i++) {
+            stack__pop(s, NULL);
+            stack__pop(s, NULL);
+            stack__push(s, (elem_t)i);
+            stack__push(s, (elem_t)i);
+        }
+    );
+    snprintf(name, sizeof(name), "Stack %s", mode);
+    print_bench_result(name, 4 * N_CYCLES, ns);
+    printf("%-50s %12zu reallocs\n", name, n_reallocs);
+
+    stack__free(s);
+}
+
+static void bench_queue(const char *mode, const capacity_policy_t *policy)
+{
+    char name[64];
+    uint64_t ns;
+    Queue q = queue__empty_with_allocator(&allocator, NULL, NULL);
+    queue__set_policy(q, policy);
+
+    for (size_t i = 0; i <= BOUNDARY; i++) {
+        queue__enqueue(q, (elem_t)i);
+    }
+
+    n_reallocs = 0;
+    BENCH_TIME(ns,
+        for (size_t i = 0; i < N_CYCLES; i++) {
+            queue__dequeue(q, NULL);
+            queue__dequeue(q, NULL);
+            queue__enqueue(q, (elem_t)i);
+            queue__enqueue(q, (elem_t)i);
+        }
+    );
+    snprintf(name, sizeof(name), "Queue %s", mode);
+    print_bench_result(name, 4 * N_CYCLES, ns);
+    printf("%-50s %12zu reallocs\n", name, n_reallocs);
+
+    queue__free(q);
+}
+
+
+int main(void)
+{
+    printf("----------- BENCH CAPACITY POLICY -----------\n");
+
+    const capacity_policy_t half = {2, 2, 2};
+    const capacity_policy_t quarter = {2, 4, 2};
+    const capacity_policy_t never = {2, 0, 2};
+
+    bench_stack("shrink at 1/2,", &half);
+    bench_stack("shrink at 1/4,", &quarter);
+    bench_stack("never shrink,", &never);
+    bench_queue("shrink at 1/2,", &half);
+    bench_queue("shrink at 1/4,", &quarter);
+    bench_queue("never shrink,", &never);
+
+    return EXIT_SUCCESS;
+}
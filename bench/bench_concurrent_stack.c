@@ -0,0 +1,117 @@
+#include <pthread.h>
+#include <unistd.h>
+
+#include "common_bench_utils.h"
+#include "../stack/stack.h"
+#include "../stack/concurrent_stack.h"
+#include "../common/defs.h"
+
+#define N_OPERATIONS 2000000
+#define STACK_CAPACITY 1024
+
+/**
+ * A 'Stack' shared by all threads behind a global mutex, as used before 'ConcurrentStack' existed
+ */
+typedef struct {
+    Stack s;
+    pthread_mutex_t lock;
+} locked_stack_t;
+
+typedef struct {
+    void *s;
+    size_t n_ops;
+} worker_t;
+
+////////////////////////////////////////////////////////////////////
+///     WORKERS
+////////////////////////////////////////////////////////////////////
+
+static void *locked_worker(void *arg)
+{
+    worker_t *worker = arg;
+    locked_stack_t *ls = worker->s;
+    elem_t top;
+    for (size_t i = 0; i < worker->n_ops; i++) {
+        pthread_mutex_lock(&ls->lock);
+        stack__push(ls->s, (elem_t)(i + 1));
+        pthread_mutex_unlock(&ls->lock);
+        pthread_mutex_lock(&ls->lock);
+        stack__pop(ls->s, &top);
+        pthread_mutex_unlock(&ls->lock);
+    }
+    return NULL;
+}
+
+static void *concurrent_worker(void *arg)
+{
+    worker_t *worker = arg;
+    elem_t top;
+    for (size_t i = 0; i < worker->n_ops; i++) {
+        concurrent_stack__push(worker->s, (elem_t)(i + 1));
+        concurrent_stack__pop(worker->s, &top);
+    }
+    return NULL;
+}
+
+////////////////////////////////////////////////////////////////////
+///     BENCHMARKS
+////////////////////////////////////////////////////////////////////
+
+/**
+ * Runs 'n_threads' workers doing push/pop pairs, 'N_OPERATIONS' operations in total
+ */
+static uint64_t run_workers(void *s, size_t n_threads, void *(*work)(void *))
+{
+    pthread_t *threads = malloc(sizeof(pthread_t) * n_threads);
+    worker_t *workers = malloc(sizeof(worker_t) * n_threads);
+    uint64_t ns;
+
+    BENCH_TIME(ns,
+        for (size_t i = 0; i < n_threads; i++) {
+            workers[i].s = s;
+            workers[i].n_ops = N_OPERATIONS / 2 / n_threads;
+            pthread_create(&threads[i], NULL, work, &workers[i]);
+        }
+        for (size_t i = 0; i < n_threads; i++) {
+            pthread_join(threads[i], NULL);
+        }
+    );
+
+    free(threads);
+    free(workers);
+    return ns;
+}
+
+static void bench_contention(size_t n_threads)
+{
+    char name[64];
+    size_t n_ops = (N_OPERATIONS / 2 / n_threads) * n_threads * 2;
+
+    locked_stack_t ls;
+    ls.s = stack__empty_copy_disabled();
+    pthread_mutex_init(&ls.lock, NULL);
+    snprintf(name, sizeof(name), "mutex + Stack, %zu threads", n_threads);
+    print_bench_result(name, n_ops, run_workers(&ls, n_threads, locked_worker));
+    pthread_mutex_destroy(&ls.lock);
+    stack__free(ls.s);
+
+    ConcurrentStack s = concurrent_stack__empty_copy_disabled(STACK_CAPACITY);
+    snprintf(name, sizeof(name), "ConcurrentStack, %zu threads", n_threads);
+    print_bench_result(name, n_ops, run_workers(s, n_threads, concurrent_worker));
+    concurrent_stack__free(s);
+}
+
+
+int main(int argc, char **argv)
+{
+    long n_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t max_threads = argc > 1 ? (size_t)atol(argv[1]) : (size_t)(n_cpus > 1 ? n_cpus : 2);
+
+    printf("----------- BENCH CONCURRENT STACK -----------\n");
+
+    for (size_t n_threads = 1; n_threads <= max_threads; n_threads <<= 1) {
+        bench_contention(n_threads);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,65 @@
+#include "common_bench_utils.h"
+#include "../queue/queue.h"
+#include "../common/defs.h"
+
+#define MAX_ELEMS 100000
+
+static size_t sink = 0;
+
+static void visit(const void *v, void *user_data)
+{
+    *(size_t *)user_data += (size_t)(uintptr_t)v & 0xff;
+}
+
+////////////////////////////////////////////////////////////////////
+///     BENCHMARKS
+////////////////////////////////////////////////////////////////////
+
+/**
+ * Traverses a copy disabled queue, a quarter of its pointers are repeated
+ */
+static void bench_size(Queue q, elem_t *ptrs, size_t n_elems)
+{
+    char name[64];
+    uint64_t ns;
+
+    queue__dequeue_n(q, NULL, SIZE_MAX);
+    queue__enqueue_n(q, ptrs, n_elems);
+
+    BENCH_TIME(ns,
+        queue__foreach(q, visit, &sink);
+    );
+    snprintf(name, sizeof(name), "queue__foreach, %zu elems", n_elems);
+    print_bench_result(name, n_elems, ns);
+
+    BENCH_TIME(ns,
+        queue__foreach_all(q, visit, &sink);
+    );
+    snprintf(name, sizeof(name), "queue__foreach_all, %zu elems", n_elems);
+    print_bench_result(name, n_elems, ns);
+}
+
+
+int main(void)
+{
+    printf("----------- BENCH FOREACH -----------\n");
+
+    static const size_t sizes[] = {1000, 10000, MAX_ELEMS};
+    static int values[MAX_ELEMS];
+    elem_t *ptrs = malloc(sizeof(elem_t) * MAX_ELEMS);
+    Queue q = queue__empty_copy_disabled();
+
+    for (size_t i = 0; i < MAX_ELEMS; i++) {
+        ptrs[i] = &values[i % 4 ? i : i / 4];
+    }
+
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(*sizes); i++) {
+        bench_size(q, ptrs, sizes[i]);
+    }
+    printf("(%zu)\n", sink);
+
+    queue__free(q);
+    free(ptrs);
+
+    return EXIT_SUCCESS;
+}
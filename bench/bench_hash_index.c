@@ -0,0 +1,93 @@
+#include "common_bench_utils.h"
+#include "../queue/queue.h"
+#include "../common/defs.h"
+
+#define MAX_ELEMS 65536
+#define N_INSERTED (1 << 20)
+
+static size_t sink = 0;
+
+static uint64_t hash_u32(const void *v)
+{
+    return *(const uint32_t *)v;
+}
+
+static int match_u32(const void *v1, const void *v2)
+{
+    return *(const uint32_t *)v1 == *(const uint32_t *)v2;
+}
+
+/* same function with another address, so that the searches ignore the index */
+static int match_u32_linear(const void *v1, const void *v2)
+{
+    return *(const uint32_t *)v1 == *(const uint32_t *)v2;
+}
+
+////////////////////////////////////////////////////////////////////
+///     BENCHMARKS
+////////////////////////////////////////////////////////////////////
+
+/**
+ * Enqueues the 'n_elems' first values unless the queue already contains them,
+ * half of them are duplicates
+ */
+static void dedup(Queue q, uint32_t *values, size_t n_elems, compare_func_t match)
+{
+    queue__dequeue_n(q, NULL, SIZE_MAX);
+    for (size_t i = 0; i < n_elems; i++) {
+        if (!queue__contains(q, &values[i], match)) {
+            queue__enqueue(q, &values[i]);
+        }
+    }
+    sink += queue__length(q);
+}
+
+
+static void bench_size(Queue q, uint32_t *values, size_t n_elems)
+{
+    char name[64];
+    uint64_t ns;
+    size_t n_rounds = N_INSERTED / n_elems;
+    if (n_elems > 256) {
+        n_rounds = 1;
+    }
+
+    BENCH_TIME(ns,
+        for (size_t r = 0; r < n_rounds; r++) {
+            dedup(q, values, n_elems, match_u32_linear);
+        }
+    );
+    snprintf(name, sizeof(name), "linear contains, %zu elems", n_elems);
+    print_bench_result(name, n_rounds * n_elems, ns);
+
+    BENCH_TIME(ns,
+        for (size_t r = 0; r < n_rounds; r++) {
+            dedup(q, values, n_elems, match_u32);
+        }
+    );
+    snprintf(name, sizeof(name), "hash index contains, %zu elems", n_elems);
+    print_bench_result(name, n_rounds * n_elems, ns);
+}
+
+
+int main(void)
+{
+    printf("----------- BENCH HASH INDEX -----------\n");
+
+    static const size_t sizes[] = {8, 16, 32, 64, 256, 4096, MAX_ELEMS};
+    static uint32_t values[MAX_ELEMS];
+    Queue q = queue__empty_indexed(hash_u32, match_u32);
+
+    for (uint32_t i = 0; i < MAX_ELEMS; i++) {
+        values[i] = (i * 2654435761u) % (MAX_ELEMS / 2);
+    }
+
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(*sizes); i++) {
+        bench_size(q, values, sizes[i]);
+    }
+    printf("(%zu)\n", sink);
+
+    queue__free(q);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,94 @@
+#include <string.h>
+
+#include "common_bench_utils.h"
+#include "../stack/stack.h"
+#include "../common/defs.h"
+
+#define N_ELEMS 1000000
+#define N_SEARCHES 20
+
+/**
+ * Small fixed size record as stored by the users of inline stacks
+ */
+typedef struct {
+    uint32_t id;
+    uint32_t weight;
+    uint64_t stamp;
+} record_t;
+
+static elem_t record_copy(elem_t r)
+{
+    record_t *copy = malloc(sizeof(record_t));
+    memcpy(copy, r, sizeof(record_t));
+    return copy;
+}
+
+static void record_delete(elem_t r)
+{
+    free(r);
+}
+
+static void record_sum(const void *r, void *user_data)
+{
+    *(uint64_t *)user_data += ((const record_t *)r)->weight;
+}
+
+static int record_match(const void *r, const void *key)
+{
+    return ((const record_t *)r)->id == *(const uint32_t *)key;
+}
+
+////////////////////////////////////////////////////////////////////
+///     BENCHMARKS
+////////////////////////////////////////////////////////////////////
+
+static void bench_stack(const char *mode, Stack s)
+{
+    char name[64];
+    uint64_t ns, sum = 0;
+    uint32_t missing = N_ELEMS;
+    record_t record = {0, 0, 0};
+
+    BENCH_TIME(ns,
+        for (uint32_t i = 0; i < N_ELEMS; i++) {
+            record.id = i;
+            record.weight = i & 0xff;
+            stack__push(s, &record);
+        }
+    );
+    snprintf(name, sizeof(name), "%s push", mode);
+    print_bench_result(name, N_ELEMS, ns);
+
+    BENCH_TIME(ns,
+        stack__foreach(s, record_sum, &sum);
+    );
+    snprintf(name, sizeof(name), "%s foreach", mode);
+    print_bench_result(name, N_ELEMS, ns);
+
+    BENCH_TIME(ns,
+        for (size_t i = 0; i < N_SEARCHES; i++) {
+            sum += stack__search(s, &missing, record_match);
+        }
+    );
+    snprintf(name, sizeof(name), "%s search (miss)", mode);
+    print_bench_result(name, (size_t)N_ELEMS * N_SEARCHES, ns);
+
+    BENCH_TIME(ns,
+        stack__free(s);
+    );
+    snprintf(name, sizeof(name), "%s free", mode);
+    print_bench_result(name, N_ELEMS, ns);
+
+    if (!sum) printf("unexpected checksum\n");
+}
+
+
+int main(void)
+{
+    printf("----------- BENCH INLINE STORAGE -----------\n");
+
+    bench_stack("Stack copy enabled,", stack__empty_copy_enabled(record_copy, record_delete));
+    bench_stack("Stack inline,", stack__empty_inline(sizeof(record_t)));
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,142 @@
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+#include "common_bench_utils.h"
+#include "../queue/queue.h"
+#include "../queue/mpmc_queue.h"
+#include "../common/defs.h"
+
+#define N_TRANSFERS 2000000
+#define MPMC_CAPACITY 1024
+
+/**
+ * A 'Queue' shared by all threads behind a global mutex, as used before 'MpmcQueue' existed
+ */
+typedef struct {
+    Queue q;
+    pthread_mutex_t lock;
+} locked_queue_t;
+
+typedef struct {
+    void *q;
+    size_t n_ops;
+} worker_t;
+
+////////////////////////////////////////////////////////////////////
+///     WORKERS
+////////////////////////////////////////////////////////////////////
+
+static void *locked_producer(void *arg)
+{
+    worker_t *worker = arg;
+    locked_queue_t *lq = worker->q;
+    for (size_t i = 0; i < worker->n_ops; i++) {
+        pthread_mutex_lock(&lq->lock);
+        queue__enqueue(lq->q, (elem_t)(i + 1));
+        pthread_mutex_unlock(&lq->lock);
+    }
+    return NULL;
+}
+
+static void *locked_consumer(void *arg)
+{
+    worker_t *worker = arg;
+    locked_queue_t *lq = worker->q;
+    elem_t front;
+    size_t received = 0;
+    while (received < worker->n_ops) {
+        pthread_mutex_lock(&lq->lock);
+        if (!queue__dequeue(lq->q, &front)) {
+            received++;
+            pthread_mutex_unlock(&lq->lock);
+        } else {
+            pthread_mutex_unlock(&lq->lock);
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void *mpmc_producer(void *arg)
+{
+    worker_t *worker = arg;
+    for (size_t i = 0; i < worker->n_ops; i++) {
+        mpmc_queue__enqueue(worker->q, (elem_t)(i + 1));
+    }
+    return NULL;
+}
+
+static void *mpmc_consumer(void *arg)
+{
+    worker_t *worker = arg;
+    elem_t front;
+    for (size_t i = 0; i < worker->n_ops; i++) {
+        mpmc_queue__dequeue(worker->q, &front);
+    }
+    return NULL;
+}
+
+////////////////////////////////////////////////////////////////////
+///     BENCHMARKS
+////////////////////////////////////////////////////////////////////
+
+/**
+ * Runs 'n_threads' producers and 'n_threads' consumers sharing 'N_TRANSFERS' elements
+ */
+static uint64_t run_workers(void *q, size_t n_threads, void *(*prod)(void *), void *(*cons)(void *))
+{
+    pthread_t *threads = malloc(sizeof(pthread_t) * n_threads * 2);
+    worker_t *workers = malloc(sizeof(worker_t) * n_threads);
+    uint64_t ns;
+
+    BENCH_TIME(ns,
+        for (size_t i = 0; i < n_threads; i++) {
+            workers[i].q = q;
+            workers[i].n_ops = N_TRANSFERS / n_threads;
+            pthread_create(&threads[2 * i], NULL, prod, &workers[i]);
+            pthread_create(&threads[2 * i + 1], NULL, cons, &workers[i]);
+        }
+        for (size_t i = 0; i < n_threads * 2; i++) {
+            pthread_join(threads[i], NULL);
+        }
+    );
+
+    free(threads);
+    free(workers);
+    return ns;
+}
+
+static void bench_scaling(size_t n_threads)
+{
+    char name[64];
+    size_t n_ops = (N_TRANSFERS / n_threads) * n_threads;
+
+    locked_queue_t lq;
+    lq.q = queue__empty_copy_disabled();
+    pthread_mutex_init(&lq.lock, NULL);
+    snprintf(name, sizeof(name), "mutex + Queue, %zu producers/%zu consumers", n_threads, n_threads);
+    print_bench_result(name, n_ops, run_workers(&lq, n_threads, locked_producer, locked_consumer));
+    pthread_mutex_destroy(&lq.lock);
+    queue__free(lq.q);
+
+    MpmcQueue q = mpmc_queue__empty_copy_disabled(MPMC_CAPACITY);
+    snprintf(name, sizeof(name), "MpmcQueue, %zu producers/%zu consumers", n_threads, n_threads);
+    print_bench_result(name, n_ops, run_workers(q, n_threads, mpmc_producer, mpmc_consumer));
+    mpmc_queue__free(q);
+}
+
+
+int main(int argc, char **argv)
+{
+    long n_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t max_threads = argc > 1 ? (size_t)atol(argv[1]) : (size_t)(n_cpus > 1 ? n_cpus : 2);
+
+    printf("----------- BENCH MPMC QUEUE -----------\n");
+
+    for (size_t n_threads = 1; n_threads <= max_threads; n_threads <<= 1) {
+        bench_scaling(n_threads);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,73 @@
+#include "common_bench_utils.h"
+#include "../queue/queue.h"
+#include "../common/defs.h"
+
+#define MAX_ELEMS 4000000
+
+static int int_ptr_compare(const void *a, const void *b)
+{
+    int x = **(int *const *)a;
+    int y = **(int *const *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * Refills the queue with the same shuffled pointers before each sort
+ */
+static void refill(Queue q, elem_t *shuffled, size_t n_elems)
+{
+    queue__dequeue_n(q, NULL, SIZE_MAX);
+    queue__enqueue_n(q, shuffled, n_elems);
+}
+
+////////////////////////////////////////////////////////////////////
+///     BENCHMARKS
+////////////////////////////////////////////////////////////////////
+
+static void bench_size(Queue q, elem_t *shuffled, size_t n_elems)
+{
+    static const size_t n_threads[] = {1, 2, 4, 8};
+    char name[64];
+    uint64_t ns;
+
+    refill(q, shuffled, n_elems);
+    BENCH_TIME(ns, queue__sort(q, int_ptr_compare););
+    snprintf(name, sizeof(name), "qsort, %zu elems", n_elems);
+    print_bench_result(name, n_elems, ns);
+
+    for (size_t stable = 0; stable < 2; stable++) {
+        for (size_t t = 0; t < sizeof(n_threads) / sizeof(*n_threads); t++) {
+            refill(q, shuffled, n_elems);
+            BENCH_TIME(ns, queue__sort_parallel(q, int_ptr_compare, n_threads[t], (char)stable););
+            snprintf(name, sizeof(name), "parallel %s, %zu threads, %zu elems", stable ? "stable" : "unstable", n_threads[t], n_elems);
+            print_bench_result(name, n_elems, ns);
+        }
+    }
+}
+
+
+int main(void)
+{
+    printf("----------- BENCH PARALLEL SORT -----------\n");
+
+    static const size_t sizes[] = {100000, 1000000, MAX_ELEMS};
+    int *values = malloc(sizeof(int) * MAX_ELEMS);
+    elem_t *shuffled = malloc(sizeof(elem_t) * MAX_ELEMS);
+    Queue q = queue__empty_copy_disabled();
+
+    srand(42);
+    for (size_t i = 0; i < MAX_ELEMS; i++) {
+        values[i] = rand();
+        shuffled[i] = &values[i];
+    }
+
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(*sizes); i++) {
+        bench_size(q, shuffled, sizes[i]);
+    }
+
+    queue__free(q);
+    free(shuffled);
+    free(values);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,96 @@
+#include <unistd.h>
+
+#include "common_bench_utils.h"
+#include "../queue/queue.h"
+#include "../common/defs.h"
+#include "../common/thread_pool.h"
+
+#define N_ELEMS 200000
+#define N_ROUNDS 64
+
+/**
+ * Stands for an expensive predicate such as parsing or validating the element
+ */
+static uint64_t digest(const void *v)
+{
+    uint64_t h = *(const uint32_t *)v;
+    for (size_t r = 0; r < N_ROUNDS; r++) {
+        h ^= h >> 29;
+        h *= 0xbf58476d1ce4e5b9ULL;
+    }
+    return h;
+}
+
+static void apply_digest(const void *v, void *user_data)
+{
+    if (digest(v) == 0) {
+        __atomic_fetch_add((size_t *)user_data, 1, __ATOMIC_RELAXED);
+    }
+}
+
+static char never(const void *v, void *user_data)
+{
+    return digest(v) == 0;
+}
+
+static char half(const void *v, void *user_data)
+{
+    return digest(v) & 1;
+}
+
+////////////////////////////////////////////////////////////////////
+///     BENCHMARKS
+////////////////////////////////////////////////////////////////////
+
+static void bench_threads(Queue q, uint32_t *values, size_t n_threads, size_t *sink)
+{
+    char name[64];
+    uint64_t ns;
+    ThreadPool pool = thread_pool__create(n_threads);
+
+    BENCH_TIME(ns, queue__foreach_parallel(q, apply_digest, sink, pool););
+    snprintf(name, sizeof(name), "foreach_parallel, %zu threads", n_threads);
+    print_bench_result(name, N_ELEMS, ns);
+
+    BENCH_TIME(ns, *sink += (size_t)queue__any_parallel(q, never, NULL, pool););
+    snprintf(name, sizeof(name), "any_parallel (no match), %zu threads", n_threads);
+    print_bench_result(name, N_ELEMS, ns);
+
+    BENCH_TIME(ns, queue__filter_parallel(q, half, NULL, pool););
+    snprintf(name, sizeof(name), "filter_parallel, %zu threads", n_threads);
+    print_bench_result(name, N_ELEMS, ns);
+
+    queue__dequeue_n(q, NULL, SIZE_MAX);
+    queue__enqueue_n(q, values, N_ELEMS);
+    thread_pool__free(pool);
+}
+
+
+int main(void)
+{
+    printf("----------- BENCH PARALLEL TRAVERSAL -----------\n");
+
+    size_t n_cpus = (size_t)sysconf(_SC_NPROCESSORS_ONLN);
+    uint32_t *values = malloc(sizeof(uint32_t) * N_ELEMS);
+    Queue q = queue__empty_inline(sizeof(uint32_t));
+    size_t sink = 0;
+    uint64_t ns;
+
+    for (uint32_t i = 0; i < N_ELEMS; i++) {
+        values[i] = i + 1;
+    }
+    queue__enqueue_n(q, values, N_ELEMS);
+
+    BENCH_TIME(ns, queue__foreach(q, apply_digest, &sink););
+    print_bench_result("foreach, sequential", N_ELEMS, ns);
+
+    for (size_t n_threads = 1; n_threads <= 2 * n_cpus && n_threads <= 16; n_threads *= 2) {
+        bench_threads(q, values, n_threads, &sink);
+    }
+    printf("(%zu cpus, %zu)\n", n_cpus, sink);
+
+    queue__free(q);
+    free(values);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,67 @@
+#include "common_bench_utils.h"
+#include "../stack/stack.h"
+#include "../common/defs.h"
+#include "../common/ptr_search.h"
+
+#define MAX_ELEMS 65536
+#define N_SEARCHED (1 << 24)
+
+static size_t sink = 0;
+
+////////////////////////////////////////////////////////////////////
+///     BENCHMARKS
+////////////////////////////////////////////////////////////////////
+
+/**
+ * Searches a missing pointer, the whole stack is read by each search
+ */
+static void bench_size(Stack s, elem_t *ptrs, size_t n_elems, elem_t missing)
+{
+    char name[64];
+    uint64_t ns;
+    size_t n_searches = N_SEARCHED / n_elems;
+
+    stack__pop_n(s, NULL, SIZE_MAX);
+    stack__push_n(s, ptrs, n_elems);
+
+    BENCH_TIME(ns,
+        for (size_t i = 0; i < n_searches; i++) {
+            sink += ptr_search_scalar(ptrs, n_elems, missing);
+        }
+    );
+    snprintf(name, sizeof(name), "scalar, %zu elems", n_elems);
+    print_bench_result(name, n_searches * n_elems, ns);
+
+    BENCH_TIME(ns,
+        for (size_t i = 0; i < n_searches; i++) {
+            sink += stack__ptr_search(s, missing);
+        }
+    );
+    snprintf(name, sizeof(name), "stack__ptr_search (%s), %zu elems", ptr_search_kernel(), n_elems);
+    print_bench_result(name, n_searches * n_elems, ns);
+}
+
+
+int main(void)
+{
+    printf("----------- BENCH PTR SEARCH -----------\n");
+
+    static const size_t sizes[] = {16, 256, 4096, MAX_ELEMS};
+    static int values[MAX_ELEMS + 1];
+    elem_t *ptrs = malloc(sizeof(elem_t) * MAX_ELEMS);
+    Stack s = stack__empty_copy_disabled();
+
+    for (size_t i = 0; i < MAX_ELEMS; i++) {
+        ptrs[i] = &values[i];
+    }
+
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(*sizes); i++) {
+        bench_size(s, ptrs, sizes[i], &values[MAX_ELEMS]);
+    }
+    printf("(%zu)\n", sink);
+
+    stack__free(s);
+    free(ptrs);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,79 @@
+#include "common_bench_utils.h"
+#include "../queue/queue.h"
+#include "../common/defs.h"
+
+#define MAX_ELEMS 4000000
+
+/**
+ * Record sorted by its id, as most comparators of our users do
+ */
+typedef struct {
+    uint32_t id;
+    uint32_t payload;
+} record_t;
+
+static size_t n_compares = 0;
+
+static int record_compare(const void *a, const void *b)
+{
+    n_compares++;
+    uint32_t x = (*(record_t *const *)a)->id;
+    uint32_t y = (*(record_t *const *)b)->id;
+    return (x > y) - (x < y);
+}
+
+static uint64_t record_key(const void *r)
+{
+    return ((const record_t *)r)->id;
+}
+
+////////////////////////////////////////////////////////////////////
+///     BENCHMARKS
+////////////////////////////////////////////////////////////////////
+
+static void bench_size(Queue q, elem_t *shuffled, size_t n_elems)
+{
+    char name[64];
+    uint64_t ns;
+
+    queue__dequeue_n(q, NULL, SIZE_MAX);
+    queue__enqueue_n(q, shuffled, n_elems);
+    n_compares = 0;
+    BENCH_TIME(ns, queue__sort(q, record_compare););
+    snprintf(name, sizeof(name), "qsort, %zu elems", n_elems);
+    print_bench_result(name, n_elems, ns);
+    printf("%-50s %12zu compares\n", name, n_compares);
+
+    queue__dequeue_n(q, NULL, SIZE_MAX);
+    queue__enqueue_n(q, shuffled, n_elems);
+    BENCH_TIME(ns, queue__sort_by_key(q, record_key););
+    snprintf(name, sizeof(name), "sort_by_key, %zu elems", n_elems);
+    print_bench_result(name, n_elems, ns);
+}
+
+
+int main(void)
+{
+    printf("----------- BENCH RADIX SORT -----------\n");
+
+    static const size_t sizes[] = {10000, 100000, 1000000, MAX_ELEMS};
+    record_t *records = malloc(sizeof(record_t) * MAX_ELEMS);
+    elem_t *shuffled = malloc(sizeof(elem_t) * MAX_ELEMS);
+    Queue q = queue__empty_copy_disabled();
+
+    srand(42);
+    for (size_t i = 0; i < MAX_ELEMS; i++) {
+        records[i] = (record_t){(uint32_t)rand(), (uint32_t)i};
+        shuffled[i] = &records[i];
+    }
+
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(*sizes); i++) {
+        bench_size(q, shuffled, sizes[i]);
+    }
+
+    queue__free(q);
+    free(shuffled);
+    free(records);
+
+    return EXIT_SUCCESS;
+}
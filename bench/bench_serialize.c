@@ -0,0 +1,174 @@
+#include <string.h>
+#include <unistd.h>
+
+#include "common_bench_utils.h"
+#include "../queue/queue.h"
+#include "../common/defs.h"
+
+#define DEFAULT_INLINE_MB 2048
+#define FILL_BATCH (1 << 20)
+#define N_POINTERS (1 << 21)
+
+static uint64_t sink = 0;
+
+static elem_t u64_copy(elem_t e)
+{
+    uint64_t *copy = malloc(sizeof(uint64_t));
+    *copy = *(uint64_t *)e;
+    return copy;
+}
+
+static void u64_delete(elem_t e)
+{
+    free(e);
+}
+
+static size_t u64_writer(const void *elem, void *buffer, size_t capacity)
+{
+    if (capacity >= sizeof(uint64_t)) {
+        memcpy(buffer, elem, sizeof(uint64_t));
+    }
+    return sizeof(uint64_t);
+}
+
+static elem_t u64_reader(const void *payload, size_t size)
+{
+    uint64_t *value = malloc(sizeof(uint64_t));
+    memcpy(value, payload, sizeof(uint64_t));
+    return value;
+}
+
+/**
+ * Temporary file removed as soon as it is opened
+ */
+static int temp_fd(void)
+{
+    char path[] = "/tmp/bench_serializeXXXXXX";
+    int fd = mkstemp(path);
+    unlink(path);
+    return fd;
+}
+
+static void print_bytes_result(const char *name, size_t n_bytes, uint64_t ns)
+{
+    double seconds = (double)ns / 1e9;
+    printf("%-48s %12zu MB  %10.3f ms %10.2f GB/s\n", name, n_bytes >> 20, (double)ns / 1e6,
+           (double)n_bytes / seconds / 1e9);
+}
+
+////////////////////////////////////////////////////////////////////
+///     BENCHMARKS
+////////////////////////////////////////////////////////////////////
+
+/**
+ * Writes then reads back an inline queue of 'n_mb' MB of 64 bits values through the page cache,
+ * the source queue is freed before the load so that a single copy is in memory at once
+ */
+static void bench_inline(size_t n_mb)
+{
+    uint64_t ns;
+    size_t n_elems = (n_mb << 20) / sizeof(uint64_t);
+    uint64_t *batch = malloc(sizeof(uint64_t) * FILL_BATCH);
+    Queue q = queue__empty_inline(sizeof(uint64_t));
+    int fd = temp_fd();
+
+    if (!batch || !q || fd < 0 || queue__reserve(q, n_elems) < 0) {
+        printf("Inline queue of %zu MB: not enough resources\n", n_mb);
+        free(batch);
+        queue__free(q);
+        if (fd >= 0) close(fd);
+        return;
+    }
+    for (size_t i = 0; i < n_elems; i += FILL_BATCH) {
+        size_t n = n_elems - i < FILL_BATCH ? n_elems - i : FILL_BATCH;
+        for (size_t k = 0; k < n; k++) {
+            batch[k] = i + k;
+        }
+        queue__enqueue_n(q, batch, n);
+    }
+    free(batch);
+
+    BENCH_TIME(ns,
+        queue__serialize(q, fd, NULL);
+    );
+    print_bytes_result("Queue serialize, inline", n_elems * sizeof(uint64_t), ns);
+    queue__free(q);
+
+    lseek(fd, 0, SEEK_SET);
+    BENCH_TIME(ns,
+        q = queue__deserialize(NULL, fd, NULL, NULL);
+    );
+    print_bytes_result("Queue deserialize, inline", n_elems * sizeof(uint64_t), ns);
+
+    uint64_t last;
+    if (!q || queue__length(q) != n_elems || queue__peek_back(q, (elem_t *)&last) < 0 || last != n_elems - 1) {
+        printf("Inline round trip FAILED\n");
+    }
+    queue__free(q);
+    close(fd);
+}
+
+/**
+ * Writes then reads back a queue of pointers, through the chunked format then through
+ * 'queue__to_array' and one write per element as done by hand before
+ */
+static void bench_pointers(void)
+{
+    uint64_t ns;
+    int fd = temp_fd();
+    Queue q = queue__empty_copy_enabled(u64_copy, u64_delete);
+    for (uint64_t i = 0; i < N_POINTERS; i++) {
+        queue__enqueue(q, &i);
+    }
+
+    BENCH_TIME(ns,
+        queue__serialize(q, fd, u64_writer);
+    );
+    print_bench_result("Queue serialize, pointers", N_POINTERS, ns);
+
+    lseek(fd, 0, SEEK_SET);
+    Queue loaded = NULL;
+    BENCH_TIME(ns,
+        loaded = queue__deserialize(queue__empty_copy_enabled(u64_copy, u64_delete), fd, u64_reader, NULL);
+    );
+    print_bench_result("Queue deserialize, pointers", N_POINTERS, ns);
+    sink += queue__length(loaded);
+    queue__free(loaded);
+
+    lseek(fd, 0, SEEK_SET);
+    BENCH_TIME(ns,
+        elem_t *array = queue__to_array(q);
+        for (size_t i = 0; i < N_POINTERS; i++) {
+            sink += (uint64_t)write(fd, array[i], sizeof(uint64_t));
+            free(array[i]);
+        }
+        free(array);
+    );
+    print_bench_result("Queue to_array + write per element", N_POINTERS, ns);
+
+    lseek(fd, 0, SEEK_SET);
+    loaded = queue__empty_copy_enabled(u64_copy, u64_delete);
+    BENCH_TIME(ns,
+        uint64_t value;
+        for (size_t i = 0; i < N_POINTERS && read(fd, &value, sizeof(uint64_t)) == sizeof(uint64_t); i++) {
+            queue__enqueue(loaded, &value);
+        }
+    );
+    print_bench_result("Queue read + enqueue per element", N_POINTERS, ns);
+    sink += queue__length(loaded);
+    queue__free(loaded);
+
+    queue__free(q);
+    close(fd);
+}
+
+int main(void)
+{
+    printf("----------- BENCH SERIALIZE -----------\n");
+
+    const char *mb = getenv("BENCH_SERIALIZE_MB");
+    bench_inline(mb ? strtoul(mb, NULL, 10) : DEFAULT_INLINE_MB);
+    bench_pointers();
+
+    return sink ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,151 @@
+#include <string.h>
+
+#include "common_bench_utils.h"
+#include "../queue/queue.h"
+#include "../common/defs.h"
+
+#define DEFAULT_SPILL_MB 1024
+#define WATERMARK (1 << 22)
+#define FILL_BATCH (1 << 16)
+#define N_POINTERS (1 << 21)
+#define POINTER_WATERMARK (1 << 16)
+
+static uint64_t sink = 0;
+
+static elem_t u64_copy(elem_t e)
+{
+    uint64_t *copy = malloc(sizeof(uint64_t));
+    *copy = *(uint64_t *)e;
+    return copy;
+}
+
+static void u64_delete(elem_t e)
+{
+    free(e);
+}
+
+static size_t u64_writer(const void *elem, void *buffer, size_t capacity)
+{
+    if (capacity >= sizeof(uint64_t)) {
+        memcpy(buffer, elem, sizeof(uint64_t));
+    }
+    return sizeof(uint64_t);
+}
+
+static elem_t u64_reader(const void *payload, size_t size)
+{
+    uint64_t *value = malloc(sizeof(uint64_t));
+    memcpy(value, payload, sizeof(uint64_t));
+    return value;
+}
+
+static void print_spill_stats(const Queue q, const size_t max_capacity)
+{
+    queue_spill_stats_t stats;
+    if (queue__spill_stats(q, &stats) < 0) return;
+
+    printf("%-48s %12lu MB spilled, %zu reloads, %.3f ms avg, %.3f ms max, ring of %zu MB at most\n", "",
+           stats.total_spilled_bytes >> 20, stats.n_reloads,
+           stats.n_reloads ? (double)stats.reload_ns_total / (double)stats.n_reloads / 1e6 : 0.0,
+           (double)stats.reload_ns_max / 1e6, (max_capacity * sizeof(uint64_t)) >> 20);
+}
+
+////////////////////////////////////////////////////////////////////
+///     BENCHMARKS
+////////////////////////////////////////////////////////////////////
+
+/**
+ * Enqueues then dequeues 'n_mb' MB of 64 bits values by batches, in memory then spilling to 'dir'
+ * with WATERMARK values kept in memory
+ */
+static void bench_inline(const char *dir, const size_t n_mb)
+{
+    uint64_t ns;
+    size_t n_elems = (n_mb << 20) / sizeof(uint64_t);
+    uint64_t batch[FILL_BATCH];
+
+    for (int spill = 0; spill < 2; spill++) {
+        Queue q = queue__empty_inline(sizeof(uint64_t));
+        if (spill && queue__set_spill(q, dir, WATERMARK, NULL, NULL) < 0) {
+            printf("Cannot spill to %s\n", dir);
+            queue__free(q);
+            return;
+        }
+
+        size_t max_capacity = 0;
+        BENCH_TIME(ns,
+            for (size_t i = 0; i < n_elems; i += FILL_BATCH) {
+                for (size_t k = 0; k < FILL_BATCH; k++) {
+                    batch[k] = i + k;
+                }
+                if (queue__enqueue_n(q, batch, FILL_BATCH) < 0) break;
+                max_capacity = queue__capacity(q) > max_capacity ? queue__capacity(q) : max_capacity;
+            }
+        );
+        print_bench_result(spill ? "Queue enqueue_n, spilling" : "Queue enqueue_n, in memory", n_elems, ns);
+
+        size_t n_checked = 0;
+        BENCH_TIME(ns,
+            size_t n;
+            while ((n = queue__dequeue_n(q, batch, FILL_BATCH)) && n != SIZE_MAX) {
+                for (size_t k = 0; k < n; k++) {
+                    n_checked += batch[k] == n_checked;
+                }
+            }
+        );
+        print_bench_result(spill ? "Queue dequeue_n, spilling" : "Queue dequeue_n, in memory", n_elems, ns);
+        if (n_checked != n_elems) {
+            printf("FIFO order FAILED after %zu values\n", n_checked);
+        }
+        print_spill_stats(q, max_capacity);
+        sink += n_checked;
+        queue__free(q);
+    }
+}
+
+/**
+ * Same with pointers saved by an element writer, one value enqueued or dequeued at a time
+ */
+static void bench_pointers(const char *dir)
+{
+    uint64_t ns;
+
+    for (int spill = 0; spill < 2; spill++) {
+        Queue q = queue__empty_copy_enabled(u64_copy, u64_delete);
+        if (spill) {
+            queue__set_spill(q, dir, POINTER_WATERMARK, u64_writer, u64_reader);
+        }
+
+        size_t max_capacity = 0;
+        BENCH_TIME(ns,
+            for (uint64_t i = 0; i < N_POINTERS; i++) {
+                queue__enqueue(q, &i);
+            }
+            max_capacity = queue__capacity(q);
+        );
+        print_bench_result(spill ? "Queue enqueue pointers, spilling" : "Queue enqueue pointers, in memory", N_POINTERS, ns);
+
+        elem_t elem;
+        BENCH_TIME(ns,
+            while (!queue__dequeue(q, &elem)) {
+                sink += *(uint64_t *)elem;
+                free(elem);
+            }
+        );
+        print_bench_result(spill ? "Queue dequeue pointers, spilling" : "Queue dequeue pointers, in memory", N_POINTERS, ns);
+        print_spill_stats(q, max_capacity);
+        queue__free(q);
+    }
+}
+
+int main(void)
+{
+    printf("----------- BENCH SPILL -----------\n");
+
+    const char *mb = getenv("BENCH_SPILL_MB");
+    const char *dir = getenv("BENCH_SPILL_DIR");
+    bench_inline(dir ? dir : "/tmp", mb ? strtoul(mb, NULL, 10) : DEFAULT_SPILL_MB);
+    bench_pointers(dir ? dir : "/tmp");
+
+    return sink ? EXIT_SUCCESS : EXIT_FAILURE;
+}
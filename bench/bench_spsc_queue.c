@@ -0,0 +1,159 @@
+#include <pthread.h>
+#include <sched.h>
+
+#include "common_bench_utils.h"
+#include "../queue/queue.h"
+#include "../queue/spsc_queue.h"
+#include "../common/defs.h"
+
+#define N_TRANSFERS 2000000
+#define SPSC_CAPACITY 1024
+#define BATCH_SIZE 64
+
+/**
+ * A 'Queue' shared by two threads behind a mutex, as used before 'SpscQueue' existed
+ */
+typedef struct {
+    Queue q;
+    pthread_mutex_t lock;
+} locked_queue_t;
+
+////////////////////////////////////////////////////////////////////
+///     PRODUCERS
+////////////////////////////////////////////////////////////////////
+
+static void *locked_producer(void *arg)
+{
+    locked_queue_t *lq = arg;
+    for (size_t i = 1; i <= N_TRANSFERS; i++) {
+        pthread_mutex_lock(&lq->lock);
+        queue__enqueue(lq->q, (elem_t)i);
+        pthread_mutex_unlock(&lq->lock);
+    }
+    return NULL;
+}
+
+static void *spsc_producer(void *arg)
+{
+    SpscQueue q = arg;
+    for (size_t i = 1; i <= N_TRANSFERS; i++) {
+        while (spsc_queue__enqueue(q, (elem_t)i) < 0) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void *spsc_batch_producer(void *arg)
+{
+    SpscQueue q = arg;
+    elem_t batch[BATCH_SIZE];
+    size_t next = 1;
+    while (next <= N_TRANSFERS) {
+        size_t n = 0;
+        for (; n < BATCH_SIZE && next + n <= N_TRANSFERS; n++) {
+            batch[n] = (elem_t)(next + n);
+        }
+        size_t sent = 0;
+        while ((sent += spsc_queue__enqueue_n(q, batch + sent, n - sent)) < n) {
+            sched_yield();
+        }
+        next += n;
+    }
+    return NULL;
+}
+
+////////////////////////////////////////////////////////////////////
+///     BENCHMARKS
+////////////////////////////////////////////////////////////////////
+
+static void bench_locked_queue(void)
+{
+    locked_queue_t lq;
+    pthread_t thread;
+    uint64_t ns;
+    size_t received = 0;
+    elem_t front;
+
+    lq.q = queue__empty_copy_disabled();
+    pthread_mutex_init(&lq.lock, NULL);
+
+    BENCH_TIME(ns,
+        pthread_create(&thread, NULL, locked_producer, &lq);
+        while (received < N_TRANSFERS) {
+            pthread_mutex_lock(&lq.lock);
+            if (!queue__dequeue(lq.q, &front)) {
+                received++;
+                pthread_mutex_unlock(&lq.lock);
+            } else {
+                pthread_mutex_unlock(&lq.lock);
+                sched_yield();
+            }
+        }
+        pthread_join(thread, NULL);
+    );
+    print_bench_result("mutex + Queue enqueue/dequeue", N_TRANSFERS, ns);
+
+    pthread_mutex_destroy(&lq.lock);
+    queue__free(lq.q);
+}
+
+static void bench_spsc_queue(void)
+{
+    pthread_t thread;
+    uint64_t ns;
+    size_t received = 0;
+    elem_t front;
+    SpscQueue q = spsc_queue__empty_copy_disabled(SPSC_CAPACITY);
+
+    BENCH_TIME(ns,
+        pthread_create(&thread, NULL, spsc_producer, q);
+        while (received < N_TRANSFERS) {
+            if (!spsc_queue__dequeue(q, &front)) {
+                received++;
+            } else {
+                sched_yield();
+            }
+        }
+        pthread_join(thread, NULL);
+    );
+    print_bench_result("SpscQueue enqueue/dequeue", N_TRANSFERS, ns);
+
+    spsc_queue__free(q);
+}
+
+static void bench_spsc_queue_batch(void)
+{
+    pthread_t thread;
+    uint64_t ns;
+    size_t received = 0;
+    elem_t batch[BATCH_SIZE];
+    SpscQueue q = spsc_queue__empty_copy_disabled(SPSC_CAPACITY);
+
+    BENCH_TIME(ns,
+        pthread_create(&thread, NULL, spsc_batch_producer, q);
+        while (received < N_TRANSFERS) {
+            size_t n = spsc_queue__dequeue_n(q, batch, BATCH_SIZE);
+            if (!n) {
+                sched_yield();
+            }
+            received += n;
+        }
+        pthread_join(thread, NULL);
+    );
+    print_bench_result("SpscQueue enqueue_n/dequeue_n (64)", N_TRANSFERS, ns);
+
+    spsc_queue__free(q);
+}
+
+
+int main(void)
+{
+    printf("----------- BENCH SPSC QUEUE -----------\n");
+
+    bench_locked_queue();
+    bench_spsc_queue();
+    bench_spsc_queue_batch();
+
+    return EXIT_SUCCESS;
+}
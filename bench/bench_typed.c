@@ -0,0 +1,156 @@
+#include "common_bench_utils.h"
+#include "../stack/stack.h"
+#include "../stack/stack_typed.h"
+#include "../queue/queue.h"
+#include "../queue/queue_typed.h"
+#include "../common/defs.h"
+
+#define N_ELEMS 1000000
+#define N_SEARCHES 20
+
+static int int_match(const void *a, const void *b)
+{
+    return *(const int *)a == *(const int *)b;
+}
+
+static int int_cmp(const void *a, const void *b)
+{
+    int x = *(const int *)a, y = *(const int *)b;
+    return (x > y) - (x < y);
+}
+
+static int double_cmp(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+////////////////////////////////////////////////////////////////////
+///     BENCHMARKS
+////////////////////////////////////////////////////////////////////
+
+static void bench_stack_int(void)
+{
+    uint64_t ns;
+    size_t sum = 0;
+    int value, missing = -1;
+    Stack s = stack__empty_inline(sizeof(int));
+    Stack_int t = stack_int__empty();
+
+    srand(42);
+    BENCH_TIME(ns,
+        for (int i = 0; i < N_ELEMS; i++) {
+            value = rand();
+            stack__push(s, &value);
+        }
+    );
+    print_bench_result("Stack inline int, push", N_ELEMS, ns);
+
+    srand(42);
+    BENCH_TIME(ns,
+        for (int i = 0; i < N_ELEMS; i++) {
+            stack_int__push(t, rand());
+        }
+    );
+    print_bench_result("Stack_int, push", N_ELEMS, ns);
+
+    BENCH_TIME(ns,
+        for (size_t i = 0; i < N_SEARCHES; i++) {
+            sum += stack__search(s, &missing, int_match);
+        }
+    );
+    print_bench_result("Stack inline int, search (miss)", (size_t)N_ELEMS * N_SEARCHES, ns);
+
+    BENCH_TIME(ns,
+        for (size_t i = 0; i < N_SEARCHES; i++) {
+            sum += stack_int__search(t, missing);
+        }
+    );
+    print_bench_result("Stack_int, search (miss)", (size_t)N_ELEMS * N_SEARCHES, ns);
+
+    BENCH_TIME(ns,
+        stack__sort(s, int_cmp);
+    );
+    print_bench_result("Stack inline int, sort", N_ELEMS, ns);
+
+    BENCH_TIME(ns,
+        stack_int__sort(t);
+    );
+    print_bench_result("Stack_int, sort", N_ELEMS, ns);
+
+    BENCH_TIME(ns,
+        for (int i = 0; i < N_ELEMS; i++) {
+            stack__pop(s, (elem_t *)&value);
+            sum += (size_t)value;
+        }
+    );
+    print_bench_result("Stack inline int, pop", N_ELEMS, ns);
+
+    BENCH_TIME(ns,
+        for (int i = 0; i < N_ELEMS; i++) {
+            stack_int__pop(t, &value);
+            sum -= (size_t)value;
+        }
+    );
+    print_bench_result("Stack_int, pop", N_ELEMS, ns);
+
+    if (sum != 2 * N_SEARCHES * (size_t)SIZE_MAX) printf("unexpected checksum\n");
+
+    stack__free(s);
+    stack_int__free(t);
+}
+
+static void bench_queue_double(void)
+{
+    uint64_t ns;
+    double value;
+    Queue q = queue__empty_inline(sizeof(double));
+    Queue_double r = queue_double__empty();
+
+    srand(42);
+    for (int i = 0; i < N_ELEMS; i++) {
+        value = rand() / (double)RAND_MAX;
+        queue__enqueue(q, &value);
+        queue_double__enqueue(r, value);
+    }
+
+    BENCH_TIME(ns,
+        queue__sort(q, double_cmp);
+    );
+    print_bench_result("Queue inline double, sort", N_ELEMS, ns);
+
+    BENCH_TIME(ns,
+        queue_double__sort(r);
+    );
+    print_bench_result("Queue_double, sort", N_ELEMS, ns);
+
+    BENCH_TIME(ns,
+        for (int i = 0; i < N_ELEMS; i++) {
+            queue__dequeue(q, (elem_t *)&value);
+            queue__enqueue(q, &value);
+        }
+    );
+    print_bench_result("Queue inline double, dequeue + enqueue", N_ELEMS, ns);
+
+    BENCH_TIME(ns,
+        for (int i = 0; i < N_ELEMS; i++) {
+            queue_double__dequeue(r, &value);
+            queue_double__enqueue(r, value);
+        }
+    );
+    print_bench_result("Queue_double, dequeue + enqueue", N_ELEMS, ns);
+
+    queue__free(q);
+    queue_double__free(r);
+}
+
+
+int main(void)
+{
+    printf("----------- BENCH TYPED CONTAINERS -----------\n");
+
+    bench_stack_int();
+    bench_queue_double();
+
+    return EXIT_SUCCESS;
+}
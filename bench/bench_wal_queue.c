@@ -0,0 +1,169 @@
+#include <limits.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "common_bench_utils.h"
+#include "../queue/wal_queue.h"
+#include "../queue/queue.h"
+#include "../common/defs.h"
+
+#define DEFAULT_N_OPS 200000
+#define DEFAULT_N_SYNCED_OPS 2000
+#define N_VALUES 64
+
+static uint64_t sink = 0;
+
+static void remove_log(const char *dir)
+{
+    char path[PATH_MAX + 16];
+    snprintf(path, sizeof(path), "%s/queue.wal", dir);
+    unlink(path);
+}
+
+////////////////////////////////////////////////////////////////////
+///     BENCHMARKS
+////////////////////////////////////////////////////////////////////
+
+/**
+ * Enqueues then dequeues 'n_ops' 64 bits values one at a time in a queue logged in 'dir' with 'policy',
+ * the log is removed afterward
+ */
+static void bench_policy(const char *name, const char *dir, const wal_policy_t policy, const size_t n_ops)
+{
+    uint64_t ns;
+    char label[64];
+    wal_queue_stats_t stats;
+
+    WalQueue q = wal_queue__open_inline(dir, sizeof(uint64_t), &policy);
+    if (!q) {
+        printf("Cannot open a log in %s\n", dir);
+        return;
+    }
+
+    BENCH_TIME(ns,
+        for (uint64_t i = 0; i < n_ops; i++) {
+            wal_queue__enqueue(q, &i);
+        }
+        wal_queue__sync(q);
+    );
+    snprintf(label, sizeof(label), "WalQueue enqueue, %s", name);
+    print_bench_result(label, n_ops, ns);
+
+    BENCH_TIME(ns,
+        uint64_t value;
+        while (!wal_queue__dequeue(q, (elem_t *)&value)) {
+            sink += value;
+        }
+        wal_queue__sync(q);
+    );
+    snprintf(label, sizeof(label), "WalQueue dequeue, %s", name);
+    print_bench_result(label, n_ops, ns);
+
+    wal_queue__stats(q, &stats);
+    printf("%-48s %12zu commits, %zu fdatasyncs, %zu compactions\n", "", stats.n_commits, stats.n_syncs,
+           stats.n_compactions);
+    wal_queue__free(q);
+
+    remove_log(dir);
+}
+
+/**
+ * Same with batches of N_VALUES values, each batch committed as a group of N_VALUES records
+ */
+static void bench_batches(const char *dir, const size_t n_ops)
+{
+    uint64_t ns;
+    uint64_t batch[N_VALUES];
+    wal_policy_t policy = WAL_DEFAULT_POLICY;
+    size_t n_elems = n_ops - n_ops % N_VALUES;
+
+    policy.group_size = N_VALUES;
+    WalQueue q = wal_queue__open_inline(dir, sizeof(uint64_t), &policy);
+    if (!q) return;
+
+    BENCH_TIME(ns,
+        for (size_t i = 0; i < n_elems; i += N_VALUES) {
+            for (size_t k = 0; k < N_VALUES; k++) {
+                batch[k] = i + k;
+            }
+            wal_queue__enqueue_n(q, batch, N_VALUES);
+        }
+    );
+    print_bench_result("WalQueue enqueue_n, group of 64, fsync", n_elems, ns);
+
+    BENCH_TIME(ns,
+        size_t n;
+        while ((n = wal_queue__dequeue_n(q, batch, N_VALUES)) && n != SIZE_MAX) {
+            sink += batch[n - 1];
+        }
+        wal_queue__sync(q);
+    );
+    print_bench_result("WalQueue dequeue_n, one record per batch, fsync", n_elems, ns);
+    wal_queue__free(q);
+
+    remove_log(dir);
+}
+
+/**
+ * The in memory queue the logged ones are built on
+ */
+static void bench_memory(const size_t n_ops)
+{
+    uint64_t ns;
+    Queue q = queue__empty_inline(sizeof(uint64_t));
+
+    BENCH_TIME(ns,
+        for (uint64_t i = 0; i < n_ops; i++) {
+            queue__enqueue(q, &i);
+        }
+    );
+    print_bench_result("Queue enqueue, in memory", n_ops, ns);
+
+    BENCH_TIME(ns,
+        uint64_t value;
+        while (!queue__dequeue(q, (elem_t *)&value)) {
+            sink += value;
+        }
+    );
+    print_bench_result("Queue dequeue, in memory", n_ops, ns);
+    queue__free(q);
+}
+
+int main(void)
+{
+    printf("----------- BENCH WAL QUEUE -----------\n");
+
+    const char *ops = getenv("BENCH_WAL_OPS");
+    const char *synced_ops = getenv("BENCH_WAL_SYNCED_OPS");
+    const char *parent = getenv("BENCH_WAL_DIR");
+    size_t n_ops = ops ? strtoul(ops, NULL, 10) : DEFAULT_N_OPS;
+    size_t n_synced_ops = synced_ops ? strtoul(synced_ops, NULL, 10) : DEFAULT_N_SYNCED_OPS;
+
+    char dir[PATH_MAX];
+    snprintf(dir, sizeof(dir), "%s/bench_wal_queueXXXXXX", parent ? parent : "/tmp");
+    if (!mkdtemp(dir)) {
+        printf("Cannot create a directory in %s\n", parent ? parent : "/tmp");
+        return EXIT_FAILURE;
+    }
+
+    wal_policy_t policy = WAL_DEFAULT_POLICY;
+    policy.group_ns = 0;
+
+    policy.group_size = 1;
+    bench_policy("fsync per op", dir, policy, n_synced_ops);
+    policy.group_size = 16;
+    bench_policy("group of 16, fsync", dir, policy, n_ops);
+    policy.group_size = 128;
+    bench_policy("group of 128, fsync", dir, policy, n_ops);
+    policy.group_size = 1024;
+    bench_policy("group of 1024, fsync", dir, policy, n_ops);
+    policy.group_size = 128;
+    policy.fsync = false;
+    bench_policy("group of 128, no fsync", dir, policy, n_ops);
+    bench_batches(dir, n_ops);
+    bench_memory(n_ops);
+
+    rmdir(dir);
+
+    return sink ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,162 @@
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <unistd.h>
+
+#include "common_bench_utils.h"
+#include "../stack/stack.h"
+#include "../stack/ws_deque.h"
+#include "../common/defs.h"
+
+#define N_TASKS 2000000
+
+/**
+ * A 'Stack' of tasks shared by the owner and the thieves behind a mutex, as used before 'WsDeque' existed
+ */
+typedef struct {
+    Stack s;
+    pthread_mutex_t lock;
+} locked_stack_t;
+
+typedef struct {
+    void *tasks;
+    atomic_bool *done;
+    size_t n_steals;
+} thief_t;
+
+////////////////////////////////////////////////////////////////////
+///     OWNERS AND THIEVES
+////////////////////////////////////////////////////////////////////
+
+/**
+ * The owner pushes every task and runs one of its own tasks every other push
+ */
+static void locked_owner(void *tasks)
+{
+    locked_stack_t *ls = tasks;
+    elem_t task;
+    for (size_t i = 0; i < N_TASKS; i++) {
+        pthread_mutex_lock(&ls->lock);
+        stack__push(ls->s, (elem_t)i);
+        if (i & 1) stack__pop(ls->s, &task);
+        pthread_mutex_unlock(&ls->lock);
+    }
+}
+
+static void *locked_thief(void *arg)
+{
+    thief_t *thief = arg;
+    locked_stack_t *ls = thief->tasks;
+    elem_t task;
+    while (true) {
+        pthread_mutex_lock(&ls->lock);
+        char stolen = stack__pop(ls->s, &task);
+        pthread_mutex_unlock(&ls->lock);
+        if (!stolen) {
+            thief->n_steals++;
+        } else if (atomic_load_explicit(thief->done, memory_order_acquire)) {
+            break;
+        } else {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void ws_owner(void *tasks)
+{
+    WsDeque d = tasks;
+    elem_t task;
+    for (size_t i = 0; i < N_TASKS; i++) {
+        ws_deque__push(d, (elem_t)i);
+        if (i & 1) ws_deque__pop(d, &task);
+    }
+}
+
+static void *ws_thief(void *arg)
+{
+    thief_t *thief = arg;
+    elem_t task;
+    while (true) {
+        if (!ws_deque__steal(thief->tasks, &task)) {
+            thief->n_steals++;
+        } else if (atomic_load_explicit(thief->done, memory_order_acquire) && ws_deque__is_empty(thief->tasks)) {
+            break;
+        } else {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+////////////////////////////////////////////////////////////////////
+///     BENCHMARKS
+////////////////////////////////////////////////////////////////////
+
+/**
+ * Runs the owner on the calling thread against 'n_thieves' thieves until every task is taken,
+ * returns the number of steals
+ */
+static size_t run_thieves(void *tasks, size_t n_thieves, void (*owner)(void *), void *(*steal)(void *), uint64_t *ns)
+{
+    pthread_t *threads = malloc(sizeof(pthread_t) * n_thieves);
+    thief_t *thieves = malloc(sizeof(thief_t) * n_thieves);
+    atomic_bool done = false;
+    size_t n_steals = 0;
+
+    BENCH_TIME(*ns,
+        for (size_t i = 0; i < n_thieves; i++) {
+            thieves[i].tasks = tasks;
+            thieves[i].done = &done;
+            thieves[i].n_steals = 0;
+            pthread_create(&threads[i], NULL, steal, &thieves[i]);
+        }
+        owner(tasks);
+        atomic_store_explicit(&done, true, memory_order_release);
+        for (size_t i = 0; i < n_thieves; i++) {
+            pthread_join(threads[i], NULL);
+            n_steals += thieves[i].n_steals;
+        }
+    );
+
+    free(threads);
+    free(thieves);
+    return n_steals;
+}
+
+static void bench_steal(size_t n_thieves)
+{
+    char name[64];
+    uint64_t ns;
+    size_t n_steals;
+
+    locked_stack_t ls;
+    ls.s = stack__empty_copy_disabled();
+    pthread_mutex_init(&ls.lock, NULL);
+    n_steals = run_thieves(&ls, n_thieves, locked_owner, locked_thief, &ns);
+    snprintf(name, sizeof(name), "mutex + Stack, %zu thieves (steals)", n_thieves);
+    print_bench_result(name, n_steals, ns);
+    pthread_mutex_destroy(&ls.lock);
+    stack__free(ls.s);
+
+    WsDeque d = ws_deque__empty_copy_disabled();
+    n_steals = run_thieves(d, n_thieves, ws_owner, ws_thief, &ns);
+    snprintf(name, sizeof(name), "WsDeque, %zu thieves (steals)", n_thieves);
+    print_bench_result(name, n_steals, ns);
+    ws_deque__free(d);
+}
+
+
+int main(int argc, char **argv)
+{
+    long n_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t max_thieves = argc > 1 ? (size_t)atol(argv[1]) : (size_t)(n_cpus > 1 ? n_cpus - 1 : 1);
+
+    printf("----------- BENCH WORK-STEALING DEQUE -----------\n");
+
+    for (size_t n_thieves = 1; n_thieves <= max_thieves; n_thieves <<= 1) {
+        bench_steal(n_thieves);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,16 @@
+#include "common_bench_utils.h"
+
+///////////////////////////////////////////////////////////////////////////////
+///     TIME AND PRINT FUNCTIONS FOR BENCHMARKS
+///////////////////////////////////////////////////////////////////////////////
+
+uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+void print_bench_result(const char *name, size_t n_ops, uint64_t ns) {
+    double seconds = (double)ns / 1e9;
+    printf("%-48s %12zu ops %10.3f ms %10.2f Mops/s\n", name, n_ops, (double)ns / 1e6, (double)n_ops / seconds / 1e6);
+}
@@ -0,0 +1,37 @@
+#ifndef __COMMON_BENCH_UTILS_H__
+#define __COMMON_BENCH_UTILS_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/**
+ * Times '__expr' and stores the elapsed nanoseconds in '__ns'
+ */
+#define BENCH_TIME(__ns, __expr) do { \
+    uint64_t __start = now_ns(); \
+    __expr \
+    (__ns) = now_ns() - __start; \
+} while (false)
+
+///////////////////////////////////////////////////////////////////////////////
+///     COMMON BENCHMARKS FUNCTIONS
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief monotonic clock
+ * @return the current time in nanoseconds
+ */
+uint64_t now_ns(void);
+
+/**
+ * @brief Print a benchmark result line as a throughput in millions of operations per second
+ * @param name the benchmark name
+ * @param n_ops the number of operations done
+ * @param ns the elapsed time in nanoseconds
+ */
+void print_bench_result(const char *name, size_t n_ops, uint64_t ns);
+
+#endif
@@ -0,0 +1,242 @@
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "arena.h"
+
+#define ARENA_MIN_CHUNK 32
+#define ARENA_N_CLASSES 8
+
+///////////////////////////////////////////////////////////////////////////////
+///     ARENA STRUCTURE
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Header preceding every chunk, padded so that the chunk keeps the alignment of malloc
+ */
+typedef union
+{
+    struct {
+        Arena arena;
+        uint32_t size_class;
+        uint32_t size;
+    } info;
+    max_align_t align;
+} chunk_header_t;
+
+/**
+ * Slabs are chained through their first word
+ */
+typedef struct slab_t
+{
+    struct slab_t *next;
+    _Alignas(max_align_t) unsigned char data[];
+} slab_t;
+
+/**
+ * Blocks of oversized chunks are doubly linked so that a released one is freed at once
+ */
+typedef struct large_t
+{
+    struct large_t *prev;
+    struct large_t *next;
+    _Alignas(max_align_t) unsigned char data[];
+} large_t;
+
+struct ArenaSt
+{
+    slab_t *slabs;
+    slab_t *current;
+    size_t offset;
+    large_t *large;
+    size_t n_slabs;
+    chunk_header_t *free_lists[ARENA_N_CLASSES];
+};
+
+///////////////////////////////////////////////////////////////////////////////
+///     ARENA MACRO UTILITARIES
+///////////////////////////////////////////////////////////////////////////////
+
+#define CLASS_SIZE(__class) \
+    ((size_t)ARENA_MIN_CHUNK << (__class))
+
+/**
+ * Smallest class whose chunks hold 'chunk_size' bytes, 'chunk_size' must be greater than ARENA_MIN_CHUNK
+ */
+#define SIZE_CLASS(__chunk_size) \
+    ((uint32_t)(64 - __builtin_clzll((unsigned long long)(__chunk_size) - 1) - __builtin_ctz(ARENA_MIN_CHUNK)))
+
+#define HEADER_OF(__chunk) \
+    ((chunk_header_t *)(__chunk) - 1)
+
+#define LARGE_OF(__header) \
+    ((large_t *)((unsigned char *)(__header) - offsetof(large_t, data)))
+
+/**
+ * A released chunk stores the next chunk of its free list in place of its content,
+ * which is why a chunk always has room for a pointer after its header
+ */
+#define FREE_NEXT(__header) \
+    (*(chunk_header_t **)((__header) + 1))
+
+/**
+ * Carves a chunk of 'chunk_size' bytes in the current slab, moves on to the next slab when it is full
+ */
+static chunk_header_t *bump(const Arena a, const size_t chunk_size) {
+    if (!a->current || a->offset + chunk_size > ARENA_SLAB_SIZE) {
+        slab_t *next = a->current ? a->current->next : a->slabs;
+        if (!next) {
+            if (!(next = malloc(sizeof(slab_t) + ARENA_SLAB_SIZE))) return NULL;
+            next->next = NULL;
+            if (a->current) {
+                a->current->next = next;
+            } else {
+                a->slabs = next;
+            }
+            a->n_slabs++;
+        }
+        a->current = next;
+        a->offset = 0;
+    }
+
+    chunk_header_t *header = (chunk_header_t *)(a->current->data + a->offset);
+    a->offset += chunk_size;
+
+    return header;
+}
+
+static chunk_header_t *alloc_large(const Arena a, const size_t chunk_size) {
+    large_t *block = malloc(sizeof(large_t) + chunk_size);
+    if (!block) return NULL;
+
+    block->prev = NULL;
+    block->next = a->large;
+    if (a->large) {
+        a->large->prev = block;
+    }
+    a->large = block;
+
+    return (chunk_header_t *)block->data;
+}
+
+static void free_large(const Arena a, chunk_header_t *header) {
+    large_t *block = LARGE_OF(header);
+
+    if (block->prev) {
+        block->prev->next = block->next;
+    } else {
+        a->large = block->next;
+    }
+    if (block->next) {
+        block->next->prev = block->prev;
+    }
+
+    free(block);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///     ARENA FUNCTIONS TO EXPORT
+///////////////////////////////////////////////////////////////////////////////
+
+Arena arena__empty(void) {
+    return calloc(1, sizeof(struct ArenaSt));
+}
+
+elem_t arena__alloc(const Arena a, const size_t size) {
+    if (!a || size > UINT32_MAX) return NULL;
+
+    size_t chunk_size = sizeof(chunk_header_t) + (size < sizeof(chunk_header_t *) ? sizeof(chunk_header_t *) : size);
+    uint32_t size_class = chunk_size <= ARENA_MIN_CHUNK ? 0 : SIZE_CLASS(chunk_size);
+    if (size_class > ARENA_N_CLASSES) {
+        size_class = ARENA_N_CLASSES;
+    }
+
+    chunk_header_t *header;
+    if (size_class == ARENA_N_CLASSES) {
+        header = alloc_large(a, chunk_size);
+    } else if ((header = a->free_lists[size_class])) {
+        a->free_lists[size_class] = FREE_NEXT(header);
+    } else {
+        header = bump(a, CLASS_SIZE(size_class));
+    }
+    if (!header) return NULL;
+
+    header->info.arena = a;
+    header->info.size_class = size_class;
+    header->info.size = (uint32_t)size;
+
+    return header + 1;
+}
+
+elem_t arena__copy(const Arena a, const elem_t elem, const size_t size) {
+    if (!elem) return NULL;
+
+    elem_t chunk = arena__alloc(a, size);
+    if (chunk) {
+        memcpy(chunk, elem, size);
+    }
+
+    return chunk;
+}
+
+inline size_t arena__size(const elem_t chunk) {
+    return !chunk ? 0 : HEADER_OF(chunk)->info.size;
+}
+
+elem_t arena__clone(const elem_t chunk) {
+    if (!chunk) return NULL;
+
+    size_t size = HEADER_OF(chunk)->info.size;
+    elem_t copy = malloc(size ? size : 1);
+    if (copy) {
+        memcpy(copy, chunk, size);
+    }
+
+    return copy;
+}
+
+void arena__release(const elem_t chunk) {
+    if (!chunk) return;
+
+    chunk_header_t *header = HEADER_OF(chunk);
+    Arena a = header->info.arena;
+    uint32_t size_class = header->info.size_class;
+    if (size_class == ARENA_N_CLASSES) {
+        free_large(a, header);
+        return;
+    }
+
+    FREE_NEXT(header) = a->free_lists[size_class];
+    a->free_lists[size_class] = header;
+}
+
+inline size_t arena__n_slabs(const Arena a) {
+    return !a ? SIZE_MAX : a->n_slabs;
+}
+
+void arena__reset(const Arena a) {
+    if (!a) return;
+
+    while (a->large) {
+        large_t *next = a->large->next;
+        free(a->large);
+        a->large = next;
+    }
+
+    a->current = NULL;
+    a->offset = 0;
+    memset(a->free_lists, 0, sizeof(a->free_lists));
+}
+
+void arena__free(const Arena a) {
+    if (!a) return;
+
+    arena__reset(a);
+    while (a->slabs) {
+        slab_t *next = a->slabs->next;
+        free(a->slabs);
+        a->slabs = next;
+    }
+
+    free(a);
+}
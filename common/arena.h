@@ -0,0 +1,111 @@
+#ifndef __ARENA_H__
+#define __ARENA_H__
+
+#include <stddef.h>
+
+#include "defs.h"
+
+
+/**
+ * Implementation of a slab allocator owning the element copies of a container
+ *
+ * Notes :
+ * 1) Chunks are carved from slabs of ARENA_SLAB_SIZE bytes and rounded up to a power of two size class,
+ * a released chunk goes to the free list of its class and is reused by the next allocation of that class.
+ * Chunks bigger than the largest class get their own block which is freed as soon as the chunk is released.
+ *
+ * 2) Every chunk starts with a header recording its arena and its size, so that 'arena__size',
+ * 'arena__clone' and 'arena__release' only need the chunk and can be used as element operators.
+ *
+ * 3) 'arena__reset' drops every chunk at once but keeps the slabs for the next allocations,
+ * 'arena__free' gives all the memory back to the system.
+ */
+typedef struct ArenaSt * Arena;
+
+#define ARENA_SLAB_SIZE 65536
+
+
+/**
+ * @brief create an empty arena, no slab is allocated until the first chunk
+ * @note complexity: O(1)
+ * @return a pointer to arena on success, NULL on failure
+ */
+Arena arena__empty(void);
+
+
+/**
+ * @brief allocates a chunk of 'size' bytes in the arena
+ * @details the chunk is aligned as a chunk returned by malloc
+ * @note complexity: O(1)
+ * @param a the arena
+ * @param size byte size of the chunk
+ * @return a pointer to the chunk on success, NULL on failure
+ */
+elem_t arena__alloc(const Arena a, const size_t size);
+
+
+/**
+ * @brief allocates a chunk holding a copy of the 'size' first bytes pointed by 'elem'
+ * @note complexity: O(size)
+ * @param a the arena
+ * @param elem pointer to the bytes to copy
+ * @param size number of bytes to copy
+ * @return a pointer to the chunk on success, NULL on failure
+ */
+elem_t arena__copy(const Arena a, const elem_t elem, const size_t size);
+
+
+/**
+ * @brief byte size requested for a chunk
+ * @note complexity: O(1)
+ * @param chunk the chunk
+ * @return the byte size of the chunk, 0 if chunk is NULL
+ */
+size_t arena__size(const elem_t chunk);
+
+
+/**
+ * @brief retrieves a copy of a chunk allocated with malloc
+ * @details the copy does not belong to the arena and must be manually freed by user afterward
+ * @note complexity: O(size)
+ * @param chunk the chunk
+ * @return a pointer to the copy on success, NULL on failure
+ */
+elem_t arena__clone(const elem_t chunk);
+
+
+/**
+ * @brief gives back a chunk to its arena
+ * @note complexity: O(1)
+ * @param chunk the chunk
+ */
+void arena__release(const elem_t chunk);
+
+
+/**
+ * @brief number of slabs allocated by the arena since its creation
+ * @note complexity: O(1)
+ * @param a the arena
+ * @return the number of slabs allocated on success, SIZE_MAX on failure
+ */
+size_t arena__n_slabs(const Arena a);
+
+
+/**
+ * @brief releases all chunks of the arena at once
+ * @details the slabs are kept and reused, the blocks of oversized chunks are freed
+ * @note complexity: O(1), O(k) with k oversized chunks
+ * @param a the arena
+ */
+void arena__reset(const Arena a);
+
+
+/**
+ * @brief frees all allocated memory used by the arena
+ * @note complexity: O(s) with s the number of slabs
+ * @param a the arena
+ */
+void arena__free(const Arena a);
+
+
+#endif
@@ -1,6 +1,7 @@
 #ifndef __DEFS_H__
 #define __DEFS_H__
 
+#include <stddef.h>
 #include <stdint.h>
 
 #ifndef SUCCESS
@@ -15,6 +16,9 @@
 #ifndef false
 #define false 0
 #endif
+#ifndef CACHE_LINE_SIZE
+#define CACHE_LINE_SIZE 64
+#endif
 
 /**
  * Generical element type
@@ -31,6 +35,56 @@ typedef elem_t (*copy_operator_t)(elem_t);
  */
 typedef void (*delete_operator_t)(elem_t);
 
+/**
+ * Optional function pointer to copy the 'n' entities of 'src' in 'dst' at once, both arrays may be the same
+ */
+typedef void (*copy_n_operator_t)(elem_t *dst, const elem_t *src, size_t n);
+
+/**
+ * Optional function pointer to delete the 'n' entities of 'elems' at once
+ */
+typedef void (*delete_n_operator_t)(elem_t *elems, size_t n);
+
+/**
+ * Function pointer required to know the byte size of an entity copied in an arena
+ */
+typedef size_t (*size_operator_t)(const void *);
+
+/**
+ * Allocator used for the structure of a container and its array of elements,
+ * 'ctx' is given back as first argument of each function
+ */
+typedef struct
+{
+    void *(*alloc)(void *ctx, size_t size);
+    void *(*realloc)(void *ctx, void *ptr, size_t size);
+    void (*free)(void *ctx, void *ptr);
+    void *ctx;
+} allocator_t;
+
+/**
+ * Capacity policy of a container: the capacity is multiplied by 'growth_factor' when the container is full
+ * and divided by it once less than 1/'shrink_threshold' of it is used, but never below 'min_capacity'.
+ * A null 'shrink_threshold' means the container never shrinks
+ */
+typedef struct
+{
+    size_t growth_factor;
+    size_t shrink_threshold;
+    size_t min_capacity;
+} capacity_policy_t;
+
+/**
+ * Contiguous run of 'length' slots of 'slot_size' bytes lent by a container: each slot holds a pointer to
+ * an element, or the value itself for an inline container
+ */
+typedef struct
+{
+    const void *slots;
+    size_t length;
+    size_t slot_size;
+} span_t;
+
 /**
  * Function pointer for lambda applying
  */
@@ -51,6 +105,27 @@ typedef char (*filter_func_t)(const void *, void *);
  */
 typedef int (*compare_func_t)(const void *, const void *);
 
+/**
+ * Function pointer extracting the integer key an element is sorted by, keys are compared as unsigned integers
+ */
+typedef uint64_t (*key_func_t)(const void *);
+
+/**
+ * Function pointer hashing an element, elements matching each other must have the same hash
+ */
+typedef uint64_t (*hash_func_t)(const void *);
+
+/**
+ * Function pointer encoding an element in 'buffer' when its payload fits in 'capacity' bytes,
+ * returns the byte size of the payload whether it fits or not, SIZE_MAX on failure
+ */
+typedef size_t (*elem_writer_t)(const void *elem, void *buffer, size_t capacity);
+
+/**
+ * Function pointer building a new element from the 'size' bytes of its payload, returns NULL on failure
+ */
+typedef elem_t (*elem_reader_t)(const void *payload, size_t size);
+
 /**
  * Function pointer for element print
  */
@@ -0,0 +1,189 @@
+#include <stdint.h>
+
+#include "hash_index.h"
+
+#define HASH_INDEX_INITIAL_CAPACITY 16
+#define EMPTY_ENTRY SIZE_MAX
+
+///////////////////////////////////////////////////////////////////////////////
+///     HASH INDEX STRUCTURE
+///////////////////////////////////////////////////////////////////////////////
+
+typedef struct
+{
+    uint64_t hash;
+    size_t pos;
+} index_entry_t;
+
+struct HashIndexSt
+{
+    index_entry_t *entries;
+    size_t capacity;
+    size_t length;
+    hash_func_t hash;
+    compare_func_t match;
+    index_getter_t get;
+    const void *container;
+    allocator_t allocator;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+///     HASH INDEX UTILITARIES
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Finalizer of MurmurHash3
+ */
+static inline uint64_t mix(uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return x;
+}
+
+static index_entry_t *alloc_entries(const HashIndex h, const size_t capacity) {
+    index_entry_t *entries = h->allocator.alloc(h->allocator.ctx, sizeof(index_entry_t) * capacity);
+    if (entries) {
+        for (size_t i = 0; i < capacity; i++) {
+            entries[i].pos = EMPTY_ENTRY;
+        }
+    }
+    return entries;
+}
+
+static void place(index_entry_t *entries, const size_t mask, const uint64_t hash, const size_t pos) {
+    size_t i = (size_t)hash & mask;
+    while (entries[i].pos != EMPTY_ENTRY) {
+        i = (i + 1) & mask;
+    }
+    entries[i] = (index_entry_t){hash, pos};
+}
+
+static char grow(const HashIndex h) {
+    size_t capacity = h->capacity * 2;
+    index_entry_t *entries = capacity ? alloc_entries(h, capacity) : NULL;
+    if (!entries) return FAILURE;
+
+    for (size_t i = 0; i < h->capacity; i++) {
+        if (h->entries[i].pos != EMPTY_ENTRY) {
+            place(entries, capacity - 1, h->entries[i].hash, h->entries[i].pos);
+        }
+    }
+    h->allocator.free(h->allocator.ctx, h->entries);
+    h->entries = entries;
+    h->capacity = capacity;
+
+    return SUCCESS;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///     HASH INDEX FUNCTIONS TO EXPORT
+///////////////////////////////////////////////////////////////////////////////
+
+HashIndex hash_index__empty(const hash_func_t hash, const compare_func_t match, const index_getter_t get,
+                            const void *container, const allocator_t *allocator) {
+    if (!hash || !match || !get || !allocator) return NULL;
+
+    HashIndex h = allocator->alloc(allocator->ctx, sizeof(struct HashIndexSt));
+    if (!h) return NULL;
+
+    h->allocator = *allocator;
+    h->entries = alloc_entries(h, HASH_INDEX_INITIAL_CAPACITY);
+    if (!h->entries) {
+        allocator->free(allocator->ctx, h);
+        return NULL;
+    }
+    h->capacity = HASH_INDEX_INITIAL_CAPACITY;
+    h->length = 0;
+    h->hash = hash;
+    h->match = match;
+    h->get = get;
+    h->container = container;
+
+    return h;
+}
+
+char hash_index__insert(const HashIndex h, const elem_t elem, const size_t pos) {
+    if (!h || pos == EMPTY_ENTRY) return FAILURE;
+
+    if ((h->length + 1) * 2 > h->capacity && grow(h) < 0) return FAILURE;
+
+    place(h->entries, h->capacity - 1, mix(h->hash(elem)), pos);
+    h->length++;
+
+    return SUCCESS;
+}
+
+char hash_index__remove(const HashIndex h, const elem_t elem, const size_t pos) {
+    if (!h) return FAILURE;
+
+    size_t mask = h->capacity - 1;
+    uint64_t hash = mix(h->hash(elem));
+    size_t i = (size_t)hash & mask;
+
+    while (h->entries[i].pos != pos) {
+        if (h->entries[i].pos == EMPTY_ENTRY) return FAILURE;
+        i = (i + 1) & mask;
+    }
+
+    /* shifts back the following entries of the cluster which may not stay after the hole */
+    for (size_t j = (i + 1) & mask; h->entries[j].pos != EMPTY_ENTRY; j = (j + 1) & mask) {
+        size_t home = (size_t)h->entries[j].hash & mask;
+        if (((j - home) & mask) >= ((j - i) & mask)) {
+            h->entries[i] = h->entries[j];
+            i = j;
+        }
+    }
+    h->entries[i].pos = EMPTY_ENTRY;
+    h->length--;
+
+    return SUCCESS;
+}
+
+size_t hash_index__find(const HashIndex h, const elem_t elem) {
+    if (!h) return SIZE_MAX;
+
+    size_t mask = h->capacity - 1;
+    uint64_t hash = mix(h->hash(elem));
+    size_t found = SIZE_MAX;
+
+    for (size_t i = (size_t)hash & mask; h->entries[i].pos != EMPTY_ENTRY; i = (i + 1) & mask) {
+        size_t pos = h->entries[i].pos;
+        if (h->entries[i].hash == hash && pos < found && h->match(h->get(h->container, pos), elem)) {
+            found = pos;
+        }
+    }
+
+    return found;
+}
+
+size_t hash_index__length(const HashIndex h) {
+    return !h ? SIZE_MAX : h->length;
+}
+
+hash_func_t hash_index__hash(const HashIndex h) {
+    return !h ? NULL : h->hash;
+}
+
+compare_func_t hash_index__match(const HashIndex h) {
+    return !h ? NULL : h->match;
+}
+
+void hash_index__clear(const HashIndex h) {
+    if (!h) return;
+
+    for (size_t i = 0; i < h->capacity; i++) {
+        h->entries[i].pos = EMPTY_ENTRY;
+    }
+    h->length = 0;
+}
+
+void hash_index__free(const HashIndex h) {
+    if (!h) return;
+
+    allocator_t allocator = h->allocator;
+    allocator.free(allocator.ctx, h->entries);
+    allocator.free(allocator.ctx, h);
+}
@@ -0,0 +1,119 @@
+#ifndef __HASH_INDEX_H__
+#define __HASH_INDEX_H__
+
+#include <stddef.h>
+
+#include "defs.h"
+
+
+/**
+ * Implementation of a hash index of the positions of the elements of a container
+ *
+ * Notes :
+ * 1) The index is an open addressing table with linear probing, holding the hash and the position of each
+ * indexed element but not the element itself: elements are read back from the container through the getter
+ * given at creation, 'elem_t (*get)(const void *container, size_t pos)', so that the index survives the
+ * reallocations of the container. Removed entries are filled by shifting the following ones back, no tombstone
+ * is left behind. The table doubles when it gets half full.
+ *
+ * 2) Positions are chosen by the container and must be unique, an element may be indexed at several positions.
+ * 'hash_index__find' returns the smallest position of the elements matching the searched one.
+ *
+ * 3) Hashes given by the hash function are mixed before use, a poor hash function such as the identity
+ * of an integer field still spreads over the table.
+ */
+typedef struct HashIndexSt * HashIndex;
+
+typedef elem_t (*index_getter_t)(const void *, size_t);
+
+
+/**
+ * @brief create an empty index
+ * @note complexity: O(1)
+ * @param hash the hash function of the elements
+ * @param match the function telling if an element of the container matches a searched one
+ * @param get the getter of the element at a position of the container
+ * @param container the container given back to 'get'
+ * @param allocator the allocator of the index
+ * @return a pointer to index on success, NULL on failure
+ */
+HashIndex hash_index__empty(const hash_func_t hash, const compare_func_t match, const index_getter_t get,
+                            const void *container, const allocator_t *allocator);
+
+
+/**
+ * @brief indexes 'elem' at position 'pos'
+ * @note complexity: O(1) on average
+ * @param h the index
+ * @param elem the element, or an element matching it
+ * @param pos its position, not already indexed
+ * @return 0 on success, -1 on failure
+ */
+char hash_index__insert(const HashIndex h, const elem_t elem, const size_t pos);
+
+
+/**
+ * @brief removes the entry of 'elem' at position 'pos'
+ * @note complexity: O(1) on average
+ * @param h the index
+ * @param elem the element, or an element matching it
+ * @param pos its position
+ * @return 0 on success, -1 on failure (no such entry)
+ */
+char hash_index__remove(const HashIndex h, const elem_t elem, const size_t pos);
+
+
+/**
+ * @brief smallest position of an element matching 'elem'
+ * @note complexity: O(1) on average
+ * @param h the index
+ * @param elem the searched element
+ * @return the position if found, SIZE_MAX if not, SIZE_MAX on failure
+ */
+size_t hash_index__find(const HashIndex h, const elem_t elem);
+
+
+/**
+ * @brief number of indexed positions
+ * @note complexity: O(1)
+ * @param h the index
+ * @return the number of entries, SIZE_MAX on failure
+ */
+size_t hash_index__length(const HashIndex h);
+
+
+/**
+ * @brief hash function of the index
+ * @note complexity: O(1)
+ * @param h the index
+ * @return the hash function, NULL on failure
+ */
+hash_func_t hash_index__hash(const HashIndex h);
+
+
+/**
+ * @brief match function of the index
+ * @note complexity: O(1)
+ * @param h the index
+ * @return the match function, NULL on failure
+ */
+compare_func_t hash_index__match(const HashIndex h);
+
+
+/**
+ * @brief removes every entry, the table keeps its capacity
+ * @note complexity: O(capacity)
+ * @param h the index
+ */
+void hash_index__clear(const HashIndex h);
+
+
+/**
+ * @brief deallocate the index
+ * @note complexity: O(1)
+ * @param h the index
+ */
+void hash_index__free(const HashIndex h);
+
+
+#endif
@@ -0,0 +1,246 @@
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "parallel_sort.h"
+
+#define INSERTION_THRESHOLD 16
+
+///////////////////////////////////////////////////////////////////////////////
+///     PARALLEL SORT STRUCTURES
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Work of one thread: sorting a run in place with 'tmp' as scratch, or writing the slots
+ * ['k_start', 'k_end') of the merge of the runs 'a' and 'b' in 'dst'
+ */
+typedef struct
+{
+    size_t size;
+    compare_func_t cmp;
+    char stable;
+    char is_merge;
+    char *run;
+    char *tmp;
+    size_t n_elems;
+    const char *a;
+    size_t len_a;
+    const char *b;
+    size_t len_b;
+    char *dst;
+    size_t k_start;
+    size_t k_end;
+} sort_task_t;
+
+///////////////////////////////////////////////////////////////////////////////
+///     SEQUENTIAL SORT AND MERGE
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Pointer slots are copied by a single move instead of a call to memcpy with a runtime size
+ */
+static inline void slot_copy(char *dst, const char *src, const size_t size) {
+    if (size == sizeof(elem_t)) {
+        memcpy(dst, src, sizeof(elem_t));
+    } else {
+        memcpy(dst, src, size);
+    }
+}
+
+static void insertion_sort(char *a, const size_t n, const size_t size, const compare_func_t cmp, char *key) {
+    for (size_t i = 1; i < n; i++) {
+        size_t j = i;
+        slot_copy(key, a + i * size, size);
+        while (j > 0 && cmp(a + (j - 1) * size, key) > 0) {
+            slot_copy(a + j * size, a + (j - 1) * size, size);
+            j--;
+        }
+        slot_copy(a + j * size, key, size);
+    }
+}
+
+/**
+ * Merges the slots 'i' to 'i_end' of 'a' and 'j' to 'j_end' of 'b' in 'dst',
+ * equal elements of 'a' go first
+ */
+static void merge(const char *a, size_t i, const size_t i_end, const char *b, size_t j, const size_t j_end,
+                  char *dst, const size_t size, const compare_func_t cmp) {
+    while (i < i_end && j < j_end) {
+        if (cmp(a + i * size, b + j * size) <= 0) {
+            slot_copy(dst, a + i * size, size);
+            i++;
+        } else {
+            slot_copy(dst, b + j * size, size);
+            j++;
+        }
+        dst += size;
+    }
+    memcpy(dst, a + i * size, (i_end - i) * size);
+    dst += (i_end - i) * size;
+    memcpy(dst, b + j * size, (j_end - j) * size);
+}
+
+/**
+ * Stable merge sort of 'a', 'tmp' must hold as many slots as 'a'
+ */
+static void merge_sort(char *a, char *tmp, const size_t n, const size_t size, const compare_func_t cmp) {
+    if (n <= INSERTION_THRESHOLD) {
+        insertion_sort(a, n, size, cmp, tmp);
+        return;
+    }
+
+    size_t mid = n / 2;
+    merge_sort(a, tmp, mid, size, cmp);
+    merge_sort(a + mid * size, tmp + mid * size, n - mid, size, cmp);
+
+    if (cmp(a + (mid - 1) * size, a + mid * size) <= 0) return;
+
+    merge(a, 0, mid, a + mid * size, 0, n - mid, tmp, size, cmp);
+    memcpy(a, tmp, n * size);
+}
+
+/**
+ * Number of slots of 'a' among the 'k' first slots of the merge of 'a' and 'b'
+ */
+static size_t co_rank(const size_t k, const char *a, const size_t len_a, const char *b, const size_t len_b,
+                      const size_t size, const compare_func_t cmp) {
+    size_t lo = k > len_b ? k - len_b : 0;
+    size_t hi = k < len_a ? k : len_a;
+
+    while (lo < hi) {
+        size_t i = lo + (hi - lo) / 2;
+        size_t j = k - i;
+        if (j > 0 && cmp(a + i * size, b + (j - 1) * size) <= 0) {
+            lo = i + 1;
+        } else {
+            hi = i;
+        }
+    }
+
+    return lo;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///     THREADS
+///////////////////////////////////////////////////////////////////////////////
+
+static void *run_task(void *arg) {
+    sort_task_t *t = arg;
+
+    if (t->is_merge) {
+        size_t i_start = co_rank(t->k_start, t->a, t->len_a, t->b, t->len_b, t->size, t->cmp);
+        size_t i_end = co_rank(t->k_end, t->a, t->len_a, t->b, t->len_b, t->size, t->cmp);
+        merge(t->a, i_start, i_end, t->b, t->k_start - i_start, t->k_end - i_end,
+              t->dst + t->k_start * t->size, t->size, t->cmp);
+    } else if (t->stable) {
+        merge_sort(t->run, t->tmp, t->n_elems, t->size, t->cmp);
+    } else {
+        qsort(t->run, t->n_elems, t->size, t->cmp);
+    }
+
+    return NULL;
+}
+
+/**
+ * Runs the first task in the calling thread and each other one in its own thread,
+ * in the calling thread too if the thread cannot be created
+ */
+static void run_tasks(sort_task_t *tasks, const size_t n_tasks) {
+    pthread_t threads[PARALLEL_SORT_MAX_THREADS];
+    char created[PARALLEL_SORT_MAX_THREADS];
+
+    for (size_t i = 1; i < n_tasks; i++) {
+        created[i] = !pthread_create(&threads[i], NULL, run_task, &tasks[i]);
+    }
+    run_task(&tasks[0]);
+    for (size_t i = 1; i < n_tasks; i++) {
+        if (created[i]) {
+            pthread_join(threads[i], NULL);
+        } else {
+            run_task(&tasks[i]);
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///     PARALLEL SORT FUNCTIONS TO EXPORT
+///////////////////////////////////////////////////////////////////////////////
+
+char parallel_sort(void *base, const size_t n_elems, const size_t size, const compare_func_t cmp,
+                   const size_t n_threads, const char stable, const allocator_t *allocator) {
+    if ((!base && n_elems) || !size || !cmp || !allocator) return FAILURE;
+    if (n_elems < 2) return SUCCESS;
+
+    size_t n_runs = n_threads < PARALLEL_SORT_MAX_THREADS ? n_threads : PARALLEL_SORT_MAX_THREADS;
+    if (n_runs > n_elems / PARALLEL_SORT_CUTOFF) {
+        n_runs = n_elems / PARALLEL_SORT_CUTOFF;
+    }
+    if (n_runs <= 1 && !stable) {
+        qsort(base, n_elems, size, cmp);
+        return SUCCESS;
+    }
+    if (n_elems > SIZE_MAX / size) return FAILURE;
+
+    char *scratch = allocator->alloc(allocator->ctx, n_elems * size);
+    if (!scratch) return FAILURE;
+
+    if (n_runs <= 1) {
+        merge_sort(base, scratch, n_elems, size, cmp);
+        allocator->free(allocator->ctx, scratch);
+        return SUCCESS;
+    }
+
+    size_t n_workers = n_runs;
+    sort_task_t tasks[PARALLEL_SORT_MAX_THREADS];
+    size_t bounds[PARALLEL_SORT_MAX_THREADS + 1];
+    char *src = base;
+    char *dst = scratch;
+
+    for (size_t r = 0; r <= n_runs; r++) {
+        bounds[r] = n_elems * r / n_runs;
+    }
+    for (size_t r = 0; r < n_runs; r++) {
+        tasks[r] = (sort_task_t){.size = size, .cmp = cmp, .stable = stable, .is_merge = false,
+                                 .run = src + bounds[r] * size, .tmp = dst + bounds[r] * size,
+                                 .n_elems = bounds[r + 1] - bounds[r]};
+    }
+    run_tasks(tasks, n_runs);
+
+    while (n_runs > 1) {
+        size_t n_merges = (n_runs + 1) / 2;
+        size_t n_tasks = 0;
+
+        for (size_t m = 0; m < n_merges; m++) {
+            size_t lo = bounds[2 * m];
+            size_t mid = bounds[2 * m + 1];
+            size_t hi = 2 * m + 2 <= n_runs ? bounds[2 * m + 2] : mid;
+            size_t n_parts = n_workers / n_merges + (m < n_workers % n_merges);
+            for (size_t p = 0; p < n_parts; p++) {
+                tasks[n_tasks++] = (sort_task_t){.size = size, .cmp = cmp, .stable = stable, .is_merge = true,
+                                                 .a = src + lo * size, .len_a = mid - lo,
+                                                 .b = src + mid * size, .len_b = hi - mid,
+                                                 .dst = dst + lo * size,
+                                                 .k_start = (hi - lo) * p / n_parts,
+                                                 .k_end = (hi - lo) * (p + 1) / n_parts};
+            }
+        }
+        run_tasks(tasks, n_tasks);
+
+        for (size_t m = 0; m < n_merges; m++) {
+            bounds[m] = bounds[2 * m];
+        }
+        bounds[n_merges] = n_elems;
+        n_runs = n_merges;
+
+        char *swap = src;
+        src = dst;
+        dst = swap;
+    }
+
+    if (src != base) {
+        memcpy(base, src, n_elems * size);
+    }
+    allocator->free(allocator->ctx, scratch);
+
+    return SUCCESS;
+}
@@ -0,0 +1,47 @@
+#ifndef __PARALLEL_SORT_H__
+#define __PARALLEL_SORT_H__
+
+#include <stddef.h>
+
+#include "defs.h"
+
+
+/**
+ * Implementation of a multi-threaded merge sort of an array of fixed size slots
+ *
+ * Notes :
+ * 1) The array is split in one run per thread, each thread sorts its run, then the runs are merged pairwise
+ * until one remains. Every merge is split between the threads available for it by a binary search of the
+ * position where each thread starts in both runs, so the last merges still use all the threads.
+ *
+ * 2) Runs are sorted with qsort, or with a sequential merge sort when the sort has to be stable. The merges
+ * always keep the order of equal elements.
+ *
+ * 3) Arrays smaller than PARALLEL_SORT_CUTOFF elements per thread are given to less threads, down to a
+ * sequential sort done by the calling thread. A thread which cannot be created has its work done by the
+ * calling thread as well, the result does not depend on the number of threads actually running.
+ */
+
+#define PARALLEL_SORT_CUTOFF 8192
+#define PARALLEL_SORT_MAX_THREADS 64
+
+
+/**
+ * @brief sorts the 'n_elems' slots of 'size' bytes of 'base' with up to 'n_threads' threads
+ * @details a scratch buffer of the size of the array is taken from 'allocator' unless the sort is sequential and
+ * unstable, 'n_threads' is capped at PARALLEL_SORT_MAX_THREADS
+ * @note complexity: O(n*log(n)/n_threads + n*log(n_threads))
+ * @param base the array
+ * @param n_elems the number of slots
+ * @param size the byte size of a slot
+ * @param cmp the compare function, called with pointers to the slots
+ * @param n_threads the maximum number of threads, including the calling one
+ * @param stable keeps the order of equal elements if set
+ * @param allocator the allocator of the scratch buffer
+ * @return 0 on success, -1 on failure (the array is left unchanged)
+ */
+char parallel_sort(void *base, const size_t n_elems, const size_t size, const compare_func_t cmp,
+                   const size_t n_threads, const char stable, const allocator_t *allocator);
+
+
+#endif
@@ -0,0 +1,120 @@
+#include <stdint.h>
+
+#include "ptr_search.h"
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define PTR_SEARCH_SIMD 1
+#endif
+
+typedef size_t (*ptr_search_func_t)(const elem_t *, const size_t, const elem_t);
+
+///////////////////////////////////////////////////////////////////////////////
+///     KERNELS
+///////////////////////////////////////////////////////////////////////////////
+
+size_t ptr_search_scalar(const elem_t *elems, const size_t n_elems, const elem_t elem) {
+    for (size_t i = 0; i < n_elems; i++) {
+        if (elems[i] == elem) return i;
+    }
+
+    return SIZE_MAX;
+}
+
+#ifdef PTR_SEARCH_SIMD
+
+/**
+ * SSE2 has no 64 bits comparison, a pointer matches when both of its 32 bits halves do
+ */
+static inline int sse2_match_mask(const __m128i v, const __m128i needle) {
+    __m128i eq = _mm_cmpeq_epi32(v, needle);
+    eq = _mm_and_si128(eq, _mm_shuffle_epi32(eq, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_movemask_pd(_mm_castsi128_pd(eq));
+}
+
+static size_t ptr_search_sse2(const elem_t *elems, const size_t n_elems, const elem_t elem) {
+    __m128i needle = _mm_set1_epi64x((long long)(intptr_t)elem);
+    size_t i = 0;
+
+    for (; i + 4 <= n_elems; i += 4) {
+        int mask = sse2_match_mask(_mm_loadu_si128((const __m128i *)(elems + i)), needle)
+                 | sse2_match_mask(_mm_loadu_si128((const __m128i *)(elems + i + 2)), needle) << 2;
+        if (mask) return i + (size_t)__builtin_ctz((unsigned int)mask);
+    }
+
+    size_t found = ptr_search_scalar(elems + i, n_elems - i, elem);
+    return found == SIZE_MAX ? SIZE_MAX : i + found;
+}
+
+__attribute__((target("avx2")))
+static size_t ptr_search_avx2(const elem_t *elems, const size_t n_elems, const elem_t elem) {
+    __m256i needle = _mm256_set1_epi64x((long long)(intptr_t)elem);
+    size_t i = 0;
+
+    for (; i + 8 <= n_elems; i += 8) {
+        __m256i eq_lo = _mm256_cmpeq_epi64(_mm256_loadu_si256((const __m256i *)(elems + i)), needle);
+        __m256i eq_hi = _mm256_cmpeq_epi64(_mm256_loadu_si256((const __m256i *)(elems + i + 4)), needle);
+        if (_mm256_testz_si256(_mm256_or_si256(eq_lo, eq_hi), _mm256_or_si256(eq_lo, eq_hi))) continue;
+
+        int mask = _mm256_movemask_pd(_mm256_castsi256_pd(eq_lo))
+                 | _mm256_movemask_pd(_mm256_castsi256_pd(eq_hi)) << 4;
+        return i + (size_t)__builtin_ctz((unsigned int)mask);
+    }
+
+    size_t found = ptr_search_sse2(elems + i, n_elems - i, elem);
+    return found == SIZE_MAX ? SIZE_MAX : i + found;
+}
+
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+///     KERNEL SELECTION
+///////////////////////////////////////////////////////////////////////////////
+
+static ptr_search_func_t select_kernel(const char **name) {
+#ifdef PTR_SEARCH_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        *name = "avx2";
+        return ptr_search_avx2;
+    }
+    *name = "sse2";
+    return ptr_search_sse2;
+#else
+    *name = "scalar";
+    return ptr_search_scalar;
+#endif
+}
+
+static size_t ptr_search_resolve(const elem_t *elems, const size_t n_elems, const elem_t elem);
+
+/**
+ * Every thread resolving the kernel stores the same one, the race on the first searches is harmless
+ */
+static ptr_search_func_t kernel = ptr_search_resolve;
+
+static size_t ptr_search_resolve(const elem_t *elems, const size_t n_elems, const elem_t elem) {
+    const char *name;
+    ptr_search_func_t selected = select_kernel(&name);
+
+    __atomic_store_n(&kernel, selected, __ATOMIC_RELAXED);
+
+    return selected(elems, n_elems, elem);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///     PTR SEARCH FUNCTIONS TO EXPORT
+///////////////////////////////////////////////////////////////////////////////
+
+size_t ptr_search(const elem_t *elems, const size_t n_elems, const elem_t elem) {
+    if (!elems) return SIZE_MAX;
+
+    return __atomic_load_n(&kernel, __ATOMIC_RELAXED)(elems, n_elems, elem);
+}
+
+const char *ptr_search_kernel(void) {
+    const char *name;
+    select_kernel(&name);
+
+    return name;
+}
@@ -0,0 +1,51 @@
+#ifndef __PTR_SEARCH_H__
+#define __PTR_SEARCH_H__
+
+#include <stddef.h>
+
+#include "defs.h"
+
+
+/**
+ * Implementation of the search of a pointer in an array of pointers
+ *
+ * Notes :
+ * 1) On x86 the array is compared several pointers per instruction: 8 per iteration with AVX2, 4 with SSE2
+ * which every x86-64 processor has. The kernel is selected once with cpuid, on the first search,
+ * other architectures use the scalar loop.
+ *
+ * 2) All kernels return the first matching position, they only differ by speed.
+ */
+
+
+/**
+ * @brief searches 'elem' in the 'n_elems' pointers of 'elems' with the fastest kernel of the processor
+ * @note complexity: O(n)
+ * @param elems the array of pointers
+ * @param n_elems the number of pointers
+ * @param elem the pointer to search
+ * @return the first position of 'elem' in 'elems', SIZE_MAX if it is not found
+ */
+size_t ptr_search(const elem_t *elems, const size_t n_elems, const elem_t elem);
+
+
+/**
+ * @brief same as 'ptr_search' comparing one pointer at a time
+ * @note complexity: O(n)
+ * @param elems the array of pointers
+ * @param n_elems the number of pointers
+ * @param elem the pointer to search
+ * @return the first position of 'elem' in 'elems', SIZE_MAX if it is not found
+ */
+size_t ptr_search_scalar(const elem_t *elems, const size_t n_elems, const elem_t elem);
+
+
+/**
+ * @brief name of the kernel used by 'ptr_search': "avx2", "sse2" or "scalar"
+ * @note complexity: O(1)
+ * @return the kernel name
+ */
+const char *ptr_search_kernel(void);
+
+
+#endif
@@ -0,0 +1,117 @@
+#include <stdint.h>
+#include <string.h>
+
+#include "ptr_set.h"
+
+#define PTR_SET_MIN_CAPACITY 16
+
+///////////////////////////////////////////////////////////////////////////////
+///     PTR SET STRUCTURE
+///////////////////////////////////////////////////////////////////////////////
+
+struct PtrSetSt
+{
+    elem_t *slots;
+    size_t capacity;
+    size_t length;
+    size_t max_length;
+    char has_null;
+    allocator_t allocator;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+///     PTR SET UTILITARIES
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Fibonacci hashing, the low bits of a pointer are mostly zeros because of the alignment
+ */
+static inline size_t slot_of(const elem_t elem, const size_t capacity) {
+    uint64_t h = (uint64_t)(uintptr_t)elem * 0x9e3779b97f4a7c15ULL;
+    return (size_t)(h >> 32) & (capacity - 1);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///     PTR SET FUNCTIONS TO EXPORT
+///////////////////////////////////////////////////////////////////////////////
+
+PtrSet ptr_set__empty(const allocator_t *allocator) {
+    if (!allocator) return NULL;
+
+    PtrSet set = allocator->alloc(allocator->ctx, sizeof(struct PtrSetSt));
+    if (!set) return NULL;
+
+    set->allocator = *allocator;
+    set->slots = NULL;
+    set->capacity = 0;
+    set->length = 0;
+    set->max_length = 0;
+    set->has_null = false;
+
+    return set;
+}
+
+char ptr_set__reset(const PtrSet set, const size_t n_elems) {
+    if (!set || n_elems > SIZE_MAX / (4 * sizeof(elem_t))) return FAILURE;
+
+    size_t capacity = PTR_SET_MIN_CAPACITY;
+    while (capacity < 2 * n_elems) {
+        capacity *= 2;
+    }
+
+    if (capacity > set->capacity) {
+        elem_t *slots = set->allocator.alloc(set->allocator.ctx, sizeof(elem_t) * capacity);
+        if (!slots) return FAILURE;
+
+        if (set->slots) set->allocator.free(set->allocator.ctx, set->slots);
+        set->slots = slots;
+        set->capacity = capacity;
+    }
+
+    /* only the part of the table the 'n_elems' insertions hash into is cleared */
+    memset(set->slots, 0, sizeof(elem_t) * capacity);
+    set->length = 0;
+    set->max_length = capacity / 2;
+    set->has_null = false;
+
+    return SUCCESS;
+}
+
+char ptr_set__insert(const PtrSet set, const elem_t elem) {
+    if (!set || !set->max_length) return FAILURE;
+
+    if (!elem) {
+        char inserted = !set->has_null;
+        set->has_null = true;
+        return inserted;
+    }
+    if (set->length == set->max_length) return FAILURE;
+
+    size_t mask = set->max_length * 2 - 1;
+    size_t i = slot_of(elem, set->max_length * 2);
+    while (set->slots[i]) {
+        if (set->slots[i] == elem) return false;
+        i = (i + 1) & mask;
+    }
+    set->slots[i] = elem;
+    set->length++;
+
+    return true;
+}
+
+void ptr_set__release(const PtrSet set) {
+    if (!set) return;
+
+    if (set->slots) set->allocator.free(set->allocator.ctx, set->slots);
+    set->slots = NULL;
+    set->capacity = 0;
+    set->length = 0;
+    set->max_length = 0;
+}
+
+void ptr_set__free(const PtrSet set) {
+    if (!set) return;
+
+    ptr_set__release(set);
+    set->allocator.free(set->allocator.ctx, set);
+}
@@ -0,0 +1,69 @@
+#ifndef __PTR_SET_H__
+#define __PTR_SET_H__
+
+#include <stddef.h>
+
+#include "defs.h"
+
+
+/**
+ * Implementation of a set of pointers, used as the scratch table remembering the pointers already visited
+ *
+ * Notes :
+ * 1) The set is an open addressing table with linear probing, it is sized once for a given number of insertions
+ * by 'ptr_set__reset' and never grows afterwards, so that an insertion cannot fail. The table is kept between
+ * two resets and only reallocated when it is too small, a container reuses the same scratch table for all its
+ * traversals.
+ *
+ * 2) The table holds at most half as many pointers as it has slots. NULL marks the empty slots, the NULL pointer
+ * itself is remembered by a separate flag.
+ */
+typedef struct PtrSetSt * PtrSet;
+
+
+/**
+ * @brief create an empty set with no table
+ * @note complexity: O(1)
+ * @param allocator the allocator of the set and of its table
+ * @return a pointer to set on success, NULL on failure
+ */
+PtrSet ptr_set__empty(const allocator_t *allocator);
+
+
+/**
+ * @brief empties the set and makes room for 'n_elems' insertions
+ * @note complexity: O(n)
+ * @param set the set
+ * @param n_elems the number of insertions to come
+ * @return 0 on success, -1 on failure
+ */
+char ptr_set__reset(const PtrSet set, const size_t n_elems);
+
+
+/**
+ * @brief adds 'elem' to the set, at most the number of pointers given to the last reset can be added
+ * @note complexity: O(1) on average
+ * @param set the set
+ * @param elem the pointer
+ * @return 1 if 'elem' was not in the set, 0 if it already was, -1 on failure
+ */
+char ptr_set__insert(const PtrSet set, const elem_t elem);
+
+
+/**
+ * @brief releases the table of the set, the next reset allocates a new one
+ * @note complexity: O(1)
+ * @param set the set
+ */
+void ptr_set__release(const PtrSet set);
+
+
+/**
+ * @brief free all memory used by the set
+ * @note complexity: O(1)
+ * @param set the set
+ */
+void ptr_set__free(const PtrSet set);
+
+
+#endif
@@ -0,0 +1,91 @@
+#include <stdint.h>
+#include <string.h>
+
+#include "radix_sort.h"
+
+#define RADIX_BITS 8
+#define RADIX_SIZE (1 << RADIX_BITS)
+#define N_PASSES (sizeof(uint64_t) * 8 / RADIX_BITS)
+
+#define DIGIT(__key, __pass) \
+    ((size_t)((__key) >> ((__pass) * RADIX_BITS)) & (RADIX_SIZE - 1))
+
+///////////////////////////////////////////////////////////////////////////////
+///     RADIX SORT STRUCTURES
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Key of a slot and its position in the array before the sort
+ */
+typedef struct
+{
+    uint64_t key;
+    size_t pos;
+} keyed_slot_t;
+
+///////////////////////////////////////////////////////////////////////////////
+///     RADIX SORT FUNCTIONS TO EXPORT
+///////////////////////////////////////////////////////////////////////////////
+
+char radix_sort(void *base, const size_t n_elems, const size_t size, const key_func_t key,
+                const char by_pointer, const allocator_t *allocator) {
+    if ((!base && n_elems) || !size || !key || !allocator) return FAILURE;
+    if (n_elems < 2) return SUCCESS;
+    if (n_elems > SIZE_MAX / (2 * sizeof(keyed_slot_t)) || n_elems > SIZE_MAX / size) return FAILURE;
+
+    keyed_slot_t *pairs = allocator->alloc(allocator->ctx, 2 * n_elems * sizeof(keyed_slot_t));
+    char *slots = pairs ? allocator->alloc(allocator->ctx, n_elems * size) : NULL;
+    if (!slots) {
+        if (pairs) allocator->free(allocator->ctx, pairs);
+        return FAILURE;
+    }
+
+    size_t counts[N_PASSES][RADIX_SIZE] = {{0}};
+    keyed_slot_t *src = pairs;
+    keyed_slot_t *dst = pairs + n_elems;
+    char *elems = base;
+
+    for (size_t i = 0; i < n_elems; i++) {
+        char *slot = elems + i * size;
+        uint64_t k = key(by_pointer ? *(elem_t *)slot : slot);
+        src[i] = (keyed_slot_t){k, i};
+        for (size_t p = 0; p < N_PASSES; p++) {
+            counts[p][DIGIT(k, p)]++;
+        }
+    }
+
+    for (size_t p = 0; p < N_PASSES; p++) {
+        size_t *count = counts[p];
+        if (count[DIGIT(src[0].key, p)] == n_elems) continue;
+
+        size_t offset = 0;
+        for (size_t d = 0; d < RADIX_SIZE; d++) {
+            size_t n = count[d];
+            count[d] = offset;
+            offset += n;
+        }
+        for (size_t i = 0; i < n_elems; i++) {
+            dst[count[DIGIT(src[i].key, p)]++] = src[i];
+        }
+
+        keyed_slot_t *swap = src;
+        src = dst;
+        dst = swap;
+    }
+
+    if (size == sizeof(elem_t)) {
+        for (size_t i = 0; i < n_elems; i++) {
+            ((elem_t *)slots)[i] = ((elem_t *)elems)[src[i].pos];
+        }
+    } else {
+        for (size_t i = 0; i < n_elems; i++) {
+            memcpy(slots + i * size, elems + src[i].pos * size, size);
+        }
+    }
+    memcpy(elems, slots, n_elems * size);
+
+    allocator->free(allocator->ctx, slots);
+    allocator->free(allocator->ctx, pairs);
+
+    return SUCCESS;
+}
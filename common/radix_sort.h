@@ -0,0 +1,42 @@
+#ifndef __RADIX_SORT_H__
+#define __RADIX_SORT_H__
+
+#include <stddef.h>
+
+#include "defs.h"
+
+
+/**
+ * Implementation of a LSD radix sort of an array of fixed size slots by an integer key
+ *
+ * Notes :
+ * 1) The key of each slot is extracted once into a side array of (key, position) pairs, the pairs are sorted
+ * one byte of the key at a time, lowest byte first, then the slots are moved once to their final position.
+ * No compare function is called, the sort is stable.
+ *
+ * 2) The byte histograms of all the passes are counted in a single read of the keys, the passes
+ * on a byte which is the same for every key are skipped: small keys only cost the passes they need.
+ *
+ * 3) Keys are ordered as unsigned integers, a signed key must have its sign bit flipped
+ * ('(uint64_t)x ^ (1ull << 63)') to sort negative values first.
+ */
+
+
+/**
+ * @brief sorts the 'n_elems' slots of 'size' bytes of 'base' by the key extracted by 'key'
+ * @details 'key' receives the pointer stored in each slot if 'by_pointer' is set, the address of the slot otherwise.
+ * Scratch buffers of 32 bytes plus one slot per element are taken from 'allocator'
+ * @note complexity: O(n) with at most 8 passes over the keys
+ * @param base the array
+ * @param n_elems the number of slots
+ * @param size the byte size of a slot
+ * @param key the key extractor
+ * @param by_pointer gives the pointer stored in the slots to 'key' if set
+ * @param allocator the allocator of the scratch buffers
+ * @return 0 on success, -1 on failure (the array is left unchanged)
+ */
+char radix_sort(void *base, const size_t n_elems, const size_t size, const key_func_t key,
+                const char by_pointer, const allocator_t *allocator);
+
+
+#endif
@@ -0,0 +1,262 @@
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "stream.h"
+
+#define STREAM_MAGIC "GADT"
+#define CHUNK_HEADER_SIZE 16
+#define RECORD_HEADER_SIZE 8
+#define MAX_IO_SIZE ((size_t)1 << 30)
+
+///////////////////////////////////////////////////////////////////////////////
+///     STREAM STRUCTURE
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * When writing, 'buffer' holds the 'used' bytes not written yet, the chunk being filled starting at 'chunk_start'.
+ * When reading, it holds the current chunk, 'pos' is the offset of the next record and 'n_records' the number
+ * of records left in the chunk
+ */
+struct StreamSt
+{
+    int fd;
+    allocator_t allocator;
+    unsigned char *buffer;
+    size_t capacity;
+    size_t used;
+    size_t pos;
+    size_t chunk_start;
+    char chunk_open;
+    uint64_t n_records;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+///     STREAM UTILITARIES
+///////////////////////////////////////////////////////////////////////////////
+
+static inline void put_u64(unsigned char *p, uint64_t v) {
+    for (size_t i = 0; i < 8; i++) {
+        p[i] = (unsigned char)(v >> (8 * i));
+    }
+}
+
+static inline uint64_t get_u64(const unsigned char *p) {
+    uint64_t v = 0;
+    for (size_t i = 0; i < 8; i++) {
+        v |= (uint64_t)p[i] << (8 * i);
+    }
+    return v;
+}
+
+/**
+ * Partial writes and interrupted calls are resumed, large writes are split in calls of MAX_IO_SIZE bytes
+ */
+static char write_all(const int fd, const void *data, size_t n_bytes) {
+    const char *p = data;
+
+    while (n_bytes) {
+        ssize_t n = write(fd, p, n_bytes < MAX_IO_SIZE ? n_bytes : MAX_IO_SIZE);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return FAILURE;
+        p += n;
+        n_bytes -= (size_t)n;
+    }
+
+    return SUCCESS;
+}
+
+/**
+ * Partial reads and interrupted calls are resumed, the end of the file before 'n_bytes' bytes is a failure
+ */
+static char read_all(const int fd, void *data, size_t n_bytes) {
+    char *p = data;
+
+    while (n_bytes) {
+        ssize_t n = read(fd, p, n_bytes < MAX_IO_SIZE ? n_bytes : MAX_IO_SIZE);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return FAILURE;
+        p += n;
+        n_bytes -= (size_t)n;
+    }
+
+    return SUCCESS;
+}
+
+static char reserve(const Stream st, const size_t capacity) {
+    if (capacity <= st->capacity) return SUCCESS;
+
+    unsigned char *buffer = st->allocator.realloc(st->allocator.ctx, st->buffer, capacity);
+    if (!buffer) return FAILURE;
+
+    st->buffer = buffer;
+    st->capacity = capacity;
+
+    return SUCCESS;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///     STREAM FUNCTIONS TO EXPORT
+///////////////////////////////////////////////////////////////////////////////
+
+Stream stream__open(const int fd, const allocator_t *allocator) {
+    if (fd < 0 || !allocator) return NULL;
+
+    Stream st = allocator->alloc(allocator->ctx, sizeof(struct StreamSt));
+    if (!st) return NULL;
+
+    st->buffer = allocator->alloc(allocator->ctx, STREAM_CHUNK_SIZE);
+    if (!st->buffer) {
+        allocator->free(allocator->ctx, st);
+        return NULL;
+    }
+    st->fd = fd;
+    st->allocator = *allocator;
+    st->capacity = STREAM_CHUNK_SIZE;
+    st->used = 0;
+    st->pos = 0;
+    st->chunk_start = 0;
+    st->chunk_open = false;
+    st->n_records = 0;
+
+    return st;
+}
+
+char stream__write_header(const Stream st, const stream_header_t *header) {
+    if (!st || !header || st->chunk_open) return FAILURE;
+    if (reserve(st, st->used + STREAM_HEADER_SIZE) < 0) return FAILURE;
+
+    unsigned char *p = st->buffer + st->used;
+    memset(p, 0, STREAM_HEADER_SIZE);
+    memcpy(p, STREAM_MAGIC, 4);
+    p[4] = (unsigned char)STREAM_VERSION;
+    p[5] = (unsigned char)(STREAM_VERSION >> 8);
+    p[8] = header->kind;
+    p[9] = header->flags;
+    put_u64(p + 16, header->elem_size);
+    put_u64(p + 24, header->count);
+    st->used += STREAM_HEADER_SIZE;
+
+    return SUCCESS;
+}
+
+char stream__write_elem(const Stream st, const void *elem, const elem_writer_t writer) {
+    if (!st || !writer) return FAILURE;
+
+    if (st->chunk_open && st->capacity - st->used < RECORD_HEADER_SIZE && stream__flush(st) < 0) return FAILURE;
+    if (!st->chunk_open) {
+        if (reserve(st, st->used + CHUNK_HEADER_SIZE + RECORD_HEADER_SIZE) < 0) return FAILURE;
+        st->chunk_start = st->used;
+        st->chunk_open = true;
+        st->n_records = 0;
+        st->used += CHUNK_HEADER_SIZE;
+    }
+
+    size_t offset = st->used + RECORD_HEADER_SIZE;
+    size_t size = writer(elem, st->buffer + offset, st->capacity - offset);
+    if (size == SIZE_MAX) return FAILURE;
+
+    if (size > st->capacity - offset) {
+        /* the record goes to the next chunk, or to a larger buffer if it is alone in its chunk */
+        if (st->n_records || st->chunk_start) {
+            if (stream__flush(st) < 0) return FAILURE;
+            return stream__write_elem(st, elem, writer);
+        }
+        if (size > SIZE_MAX - offset || reserve(st, offset + size) < 0) return FAILURE;
+        size = writer(elem, st->buffer + offset, st->capacity - offset);
+        if (size > st->capacity - offset) return FAILURE;
+    }
+
+    put_u64(st->buffer + st->used, size);
+    st->used = offset + size;
+    st->n_records++;
+
+    return SUCCESS;
+}
+
+char stream__write_raw(const Stream st, const void *data, const size_t n_bytes) {
+    if (!st || (!data && n_bytes)) return FAILURE;
+    if (stream__flush(st) < 0) return FAILURE;
+
+    return write_all(st->fd, data, n_bytes);
+}
+
+char stream__flush(const Stream st) {
+    if (!st) return FAILURE;
+
+    if (st->chunk_open && !st->n_records) {
+        st->used = st->chunk_start;
+        st->chunk_open = false;
+    } else if (st->chunk_open) {
+        put_u64(st->buffer + st->chunk_start, st->used - st->chunk_start - CHUNK_HEADER_SIZE);
+        put_u64(st->buffer + st->chunk_start + 8, st->n_records);
+        st->chunk_open = false;
+        st->n_records = 0;
+    }
+    if (st->used && write_all(st->fd, st->buffer, st->used) < 0) return FAILURE;
+    st->used = 0;
+    st->chunk_start = 0;
+
+    return SUCCESS;
+}
+
+char stream__read_header(const Stream st, stream_header_t *header) {
+    if (!st || !header) return FAILURE;
+
+    unsigned char p[STREAM_HEADER_SIZE];
+    if (read_all(st->fd, p, STREAM_HEADER_SIZE) < 0) return FAILURE;
+    if (memcmp(p, STREAM_MAGIC, 4) || (p[4] | p[5] << 8) != STREAM_VERSION) return FAILURE;
+
+    header->kind = p[8];
+    header->flags = p[9];
+    header->elem_size = get_u64(p + 16);
+    header->count = get_u64(p + 24);
+    st->n_records = 0;
+
+    return SUCCESS;
+}
+
+char stream__read_elem(const Stream st, const elem_reader_t reader, elem_t *elem) {
+    if (!st || !reader || !elem) return FAILURE;
+
+    if (!st->n_records) {
+        unsigned char p[CHUNK_HEADER_SIZE];
+        if (read_all(st->fd, p, CHUNK_HEADER_SIZE) < 0) return FAILURE;
+
+        uint64_t n_bytes = get_u64(p);
+        uint64_t n_records = get_u64(p + 8);
+        if (!n_records || n_bytes > SIZE_MAX || n_bytes / RECORD_HEADER_SIZE < n_records) return FAILURE;
+        if (reserve(st, (size_t)n_bytes) < 0 || read_all(st->fd, st->buffer, (size_t)n_bytes) < 0) return FAILURE;
+
+        st->used = (size_t)n_bytes;
+        st->pos = 0;
+        st->n_records = n_records;
+    }
+
+    if (st->used - st->pos < RECORD_HEADER_SIZE) return FAILURE;
+    uint64_t size = get_u64(st->buffer + st->pos);
+    if (size > st->used - st->pos - RECORD_HEADER_SIZE) return FAILURE;
+
+    size_t offset = st->pos + RECORD_HEADER_SIZE;
+    st->pos = offset + (size_t)size;
+    st->n_records--;
+    if (!st->n_records && st->pos != st->used) return FAILURE;
+
+    *elem = reader(st->buffer + offset, (size_t)size);
+
+    return !*elem ? FAILURE : SUCCESS;
+}
+
+char stream__read_raw(const Stream st, void *data, const size_t n_bytes) {
+    if (!st || (!data && n_bytes)) return FAILURE;
+
+    return read_all(st->fd, data, n_bytes);
+}
+
+void stream__free(const Stream st) {
+    if (!st) return;
+
+    allocator_t allocator = st->allocator;
+    allocator.free(allocator.ctx, st->buffer);
+    allocator.free(allocator.ctx, st);
+}
@@ -0,0 +1,146 @@
+#ifndef __STREAM_H__
+#define __STREAM_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "defs.h"
+
+
+/**
+ * Implementation of the binary format of the containers saved to a file descriptor
+ *
+ * Notes :
+ * 1) A saved container starts with a header of STREAM_HEADER_SIZE bytes: the magic "GADT", the version of the
+ * format, the kind of container, flags, the size of a value stored inline (0 for pointers) and the number of
+ * elements. Integers are written in little endian whatever the host.
+ *
+ * 2) Values stored inline (STREAM_FIXED_SIZE flag) follow the header as they are in memory, one after the other,
+ * and are read back in a single read straight into the slots of the container.
+ *
+ * 3) Pointers are encoded by the element writer of the user, each record is the byte size of the payload
+ * followed by the payload. Records are gathered in chunks of about STREAM_CHUNK_SIZE bytes written at once,
+ * each chunk starts with its byte size and its number of records. A record larger than a chunk gets a chunk
+ * of its own.
+ *
+ * 4) The reader never reads past the last byte of the container, several containers can be saved one after
+ * the other on the same file descriptor, including pipes and sockets.
+ *
+ * 5) A stream buffers the chunk being written or read, it must be flushed before it is freed when writing.
+ */
+typedef struct StreamSt * Stream;
+
+#define STREAM_VERSION 1
+#define STREAM_HEADER_SIZE 32
+#define STREAM_CHUNK_SIZE 65536
+
+#define STREAM_FIXED_SIZE 0x1
+
+typedef enum
+{
+    STREAM_STACK = 1,
+    STREAM_QUEUE = 2,
+} stream_kind_t;
+
+typedef struct
+{
+    uint8_t kind;
+    uint8_t flags;
+    uint64_t elem_size;
+    uint64_t count;
+} stream_header_t;
+
+
+/**
+ * @brief create a stream writing to or reading from 'fd'
+ * @note complexity: O(1)
+ * @param fd the file descriptor, left open by the stream
+ * @param allocator the allocator of the buffer
+ * @return a pointer to stream on success, NULL on failure
+ */
+Stream stream__open(const int fd, const allocator_t *allocator);
+
+
+/**
+ * @brief writes the header in the buffer of the stream
+ * @note complexity: O(1)
+ * @param st the stream
+ * @param header the header
+ * @return 0 on success, -1 on failure
+ */
+char stream__write_header(const Stream st, const stream_header_t *header);
+
+
+/**
+ * @brief appends the record of 'elem' to the chunk being written, the chunk is written first when full
+ * @details 'writer' may be called twice for the same element when its payload does not fit the chunk
+ * @note complexity: O(size of the payload)
+ * @param st the stream
+ * @param elem the element given to 'writer'
+ * @param writer the element writer
+ * @return 0 on success, -1 on failure
+ */
+char stream__write_elem(const Stream st, const void *elem, const elem_writer_t writer);
+
+
+/**
+ * @brief writes the buffered bytes then the 'n_bytes' bytes of 'data' without copying them
+ * @note complexity: O(n_bytes)
+ * @param st the stream
+ * @param data the bytes
+ * @param n_bytes the number of bytes
+ * @return 0 on success, -1 on failure
+ */
+char stream__write_raw(const Stream st, const void *data, const size_t n_bytes);
+
+
+/**
+ * @brief writes the buffered bytes
+ * @note complexity: O(STREAM_CHUNK_SIZE)
+ * @param st the stream
+ * @return 0 on success, -1 on failure
+ */
+char stream__flush(const Stream st);
+
+
+/**
+ * @brief reads a header and checks its magic and version
+ * @note complexity: O(1)
+ * @param st the stream
+ * @param header storage of the header
+ * @return 0 on success, -1 on failure
+ */
+char stream__read_header(const Stream st, stream_header_t *header);
+
+
+/**
+ * @brief reads the next record, and the next chunk first when the current one is exhausted
+ * @note complexity: O(size of the payload)
+ * @param st the stream
+ * @param reader the element reader, given the payload
+ * @param elem storage of the element built by 'reader'
+ * @return 0 on success, -1 on failure
+ */
+char stream__read_elem(const Stream st, const elem_reader_t reader, elem_t *elem);
+
+
+/**
+ * @brief reads exactly 'n_bytes' bytes in 'data'
+ * @note complexity: O(n_bytes)
+ * @param st the stream
+ * @param data storage of 'n_bytes' bytes
+ * @param n_bytes the number of bytes
+ * @return 0 on success, -1 on failure
+ */
+char stream__read_raw(const Stream st, void *data, const size_t n_bytes);
+
+
+/**
+ * @brief frees the stream, the file descriptor stays open
+ * @note complexity: O(1)
+ * @param st the stream
+ */
+void stream__free(const Stream st);
+
+
+#endif
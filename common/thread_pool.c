@@ -0,0 +1,292 @@
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "thread_pool.h"
+
+///////////////////////////////////////////////////////////////////////////////
+///     THREAD POOL STRUCTURES
+///////////////////////////////////////////////////////////////////////////////
+
+struct ThreadPoolSt
+{
+    pthread_t threads[THREAD_POOL_MAX_THREADS];
+    size_t n_workers;
+    pthread_mutex_t run_lock;
+    pthread_mutex_t lock;
+    pthread_cond_t job_posted;
+    pthread_cond_t job_done;
+    void (*job)(void *);
+    void *arg;
+    size_t generation;
+    size_t n_running;
+    char stopping;
+};
+
+typedef enum
+{
+    LOOP_FOREACH,
+    LOOP_ALL,
+    LOOP_ANY,
+    LOOP_FILTER,
+    LOOP_COMPACT,
+} loop_kind_t;
+
+/**
+ * Traversal shared by the workers: each one takes the next chunk until none is left or 'stop' is set
+ */
+typedef struct
+{
+    loop_kind_t kind;
+    char *base;
+    size_t n_elems;
+    size_t size;
+    char by_pointer;
+    applying_func_t func;
+    filter_func_t pred;
+    void *user_data;
+    size_t n_chunks;
+    size_t next_chunk;
+    char stop;
+    char *dst;
+    char *kept;
+    size_t *offsets;
+} loop_t;
+
+///////////////////////////////////////////////////////////////////////////////
+///     WORKERS
+///////////////////////////////////////////////////////////////////////////////
+
+static void *worker(void *arg) {
+    ThreadPool pool = arg;
+    size_t seen = 0;
+
+    pthread_mutex_lock(&pool->lock);
+    for (;;) {
+        while (!pool->stopping && pool->generation == seen) {
+            pthread_cond_wait(&pool->job_posted, &pool->lock);
+        }
+        if (pool->stopping) break;
+
+        seen = pool->generation;
+        void (*job)(void *) = pool->job;
+        void *job_arg = pool->arg;
+        pthread_mutex_unlock(&pool->lock);
+
+        job(job_arg);
+
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->n_running == 0) {
+            pthread_cond_signal(&pool->job_done);
+        }
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    return NULL;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///     TRAVERSALS
+///////////////////////////////////////////////////////////////////////////////
+
+static inline void *slot_elem(const loop_t *l, char *slot) {
+    return l->by_pointer ? *(elem_t *)slot : slot;
+}
+
+static void run_chunk(loop_t *l, const size_t c) {
+    size_t start = c * THREAD_POOL_CHUNK;
+    size_t end = start + THREAD_POOL_CHUNK < l->n_elems ? start + THREAD_POOL_CHUNK : l->n_elems;
+    char *slot = l->base + start * l->size;
+    size_t n_kept = 0;
+
+    switch (l->kind) {
+    case LOOP_FOREACH:
+        for (size_t i = start; i < end; i++, slot += l->size) {
+            l->func(slot_elem(l, slot), l->user_data);
+        }
+        break;
+    case LOOP_ALL:
+    case LOOP_ANY:
+        for (size_t i = start; i < end && !__atomic_load_n(&l->stop, __ATOMIC_RELAXED); i++, slot += l->size) {
+            if (!l->pred(slot_elem(l, slot), l->user_data) == (l->kind == LOOP_ALL)) {
+                __atomic_store_n(&l->stop, true, __ATOMIC_RELAXED);
+            }
+        }
+        break;
+    case LOOP_FILTER:
+        for (size_t i = start; i < end; i++, slot += l->size) {
+            l->kept[i] = l->pred(slot_elem(l, slot), l->user_data) ? true : false;
+            n_kept += (size_t)l->kept[i];
+        }
+        l->offsets[c] = n_kept;
+        break;
+    case LOOP_COMPACT:
+        for (size_t i = start, k = l->offsets[c]; i < end; i++, slot += l->size) {
+            if (l->kept[i]) {
+                memcpy(l->dst + k++ * l->size, slot, l->size);
+            }
+        }
+        break;
+    }
+}
+
+static void run_loop(void *arg) {
+    loop_t *l = arg;
+    size_t c;
+
+    while (!__atomic_load_n(&l->stop, __ATOMIC_RELAXED)
+           && (c = __atomic_fetch_add(&l->next_chunk, 1, __ATOMIC_RELAXED)) < l->n_chunks) {
+        run_chunk(l, c);
+    }
+}
+
+static char start_loop(const ThreadPool pool, loop_t *l, const loop_kind_t kind) {
+    l->kind = kind;
+    l->next_chunk = 0;
+    l->stop = false;
+
+    return thread_pool__run(pool, run_loop, l);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///     THREAD POOL FUNCTIONS TO EXPORT
+///////////////////////////////////////////////////////////////////////////////
+
+ThreadPool thread_pool__create(const size_t n_threads) {
+    if (!n_threads) return NULL;
+
+    ThreadPool pool = malloc(sizeof(struct ThreadPoolSt));
+    if (!pool) return NULL;
+
+    pool->n_workers = 0;
+    pool->job = NULL;
+    pool->arg = NULL;
+    pool->generation = 0;
+    pool->n_running = 0;
+    pool->stopping = false;
+    pthread_mutex_init(&pool->run_lock, NULL);
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->job_posted, NULL);
+    pthread_cond_init(&pool->job_done, NULL);
+
+    size_t n_workers = (n_threads < THREAD_POOL_MAX_THREADS ? n_threads : THREAD_POOL_MAX_THREADS) - 1;
+    while (pool->n_workers < n_workers && !pthread_create(&pool->threads[pool->n_workers], NULL, worker, pool)) {
+        pool->n_workers++;
+    }
+
+    return pool;
+}
+
+size_t thread_pool__size(const ThreadPool pool) {
+    return !pool ? SIZE_MAX : pool->n_workers + 1;
+}
+
+char thread_pool__run(const ThreadPool pool, void (*job)(void *), void *arg) {
+    if (!pool || !job) return FAILURE;
+
+    pthread_mutex_lock(&pool->run_lock);
+
+    pthread_mutex_lock(&pool->lock);
+    pool->job = job;
+    pool->arg = arg;
+    pool->n_running = pool->n_workers;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->job_posted);
+    pthread_mutex_unlock(&pool->lock);
+
+    job(arg);
+
+    pthread_mutex_lock(&pool->lock);
+    while (pool->n_running) {
+        pthread_cond_wait(&pool->job_done, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    pthread_mutex_unlock(&pool->run_lock);
+
+    return SUCCESS;
+}
+
+char thread_pool__foreach(const ThreadPool pool, void *base, const size_t n_elems, const size_t size,
+                          const char by_pointer, const applying_func_t func, void *user_data) {
+    if (!pool || (!base && n_elems) || !size || !func) return FAILURE;
+    if (!n_elems) return SUCCESS;
+
+    loop_t l = {.base = base, .n_elems = n_elems, .size = size, .by_pointer = by_pointer, .func = func,
+                .user_data = user_data, .n_chunks = (n_elems + THREAD_POOL_CHUNK - 1) / THREAD_POOL_CHUNK};
+
+    return start_loop(pool, &l, LOOP_FOREACH);
+}
+
+char thread_pool__all(const ThreadPool pool, void *base, const size_t n_elems, const size_t size,
+                      const char by_pointer, const filter_func_t pred, void *user_data) {
+    if (!pool || (!base && n_elems) || !size || !pred) return FAILURE;
+    if (!n_elems) return true;
+
+    loop_t l = {.base = base, .n_elems = n_elems, .size = size, .by_pointer = by_pointer, .pred = pred,
+                .user_data = user_data, .n_chunks = (n_elems + THREAD_POOL_CHUNK - 1) / THREAD_POOL_CHUNK};
+
+    return start_loop(pool, &l, LOOP_ALL) < 0 ? FAILURE : !l.stop;
+}
+
+char thread_pool__any(const ThreadPool pool, void *base, const size_t n_elems, const size_t size,
+                      const char by_pointer, const filter_func_t pred, void *user_data) {
+    if (!pool || (!base && n_elems) || !size || !pred) return FAILURE;
+    if (!n_elems) return false;
+
+    loop_t l = {.base = base, .n_elems = n_elems, .size = size, .by_pointer = by_pointer, .pred = pred,
+                .user_data = user_data, .n_chunks = (n_elems + THREAD_POOL_CHUNK - 1) / THREAD_POOL_CHUNK};
+
+    return start_loop(pool, &l, LOOP_ANY) < 0 ? FAILURE : l.stop;
+}
+
+size_t thread_pool__filter(const ThreadPool pool, void *base, const size_t n_elems, const size_t size,
+                           const char by_pointer, const filter_func_t pred, void *user_data,
+                           void *dst, char *kept) {
+    if (!pool || (!base && n_elems) || !size || !pred || (!dst && n_elems) || (!kept && n_elems)) return SIZE_MAX;
+    if (!n_elems) return 0;
+
+    loop_t l = {.base = base, .n_elems = n_elems, .size = size, .by_pointer = by_pointer, .pred = pred,
+                .user_data = user_data, .n_chunks = (n_elems + THREAD_POOL_CHUNK - 1) / THREAD_POOL_CHUNK,
+                .dst = dst, .kept = kept};
+
+    l.offsets = malloc(sizeof(size_t) * l.n_chunks);
+    if (!l.offsets) return SIZE_MAX;
+
+    size_t n_kept = 0;
+    if (start_loop(pool, &l, LOOP_FILTER) == SUCCESS) {
+        /* the count of each chunk becomes the position of its first kept slot */
+        for (size_t c = 0; c < l.n_chunks; c++) {
+            size_t count = l.offsets[c];
+            l.offsets[c] = n_kept;
+            n_kept += count;
+        }
+        if (start_loop(pool, &l, LOOP_COMPACT) < 0) {
+            n_kept = SIZE_MAX;
+        }
+    } else {
+        n_kept = SIZE_MAX;
+    }
+    free(l.offsets);
+
+    return n_kept;
+}
+
+void thread_pool__free(const ThreadPool pool) {
+    if (!pool) return;
+
+    pthread_mutex_lock(&pool->lock);
+    pool->stopping = true;
+    pthread_cond_broadcast(&pool->job_posted);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (size_t i = 0; i < pool->n_workers; i++) {
+        pthread_join(pool->threads[i], NULL);
+    }
+
+    pthread_mutex_destroy(&pool->run_lock);
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->job_posted);
+    pthread_cond_destroy(&pool->job_done);
+    free(pool);
+}
@@ -0,0 +1,140 @@
+#ifndef __THREAD_POOL_H__
+#define __THREAD_POOL_H__
+
+#include <stddef.h>
+
+#include "defs.h"
+
+
+/**
+ * Implementation of a pool of worker threads and of the parallel traversals of an array of fixed size slots
+ *
+ * Notes :
+ * 1) A pool created for 'n_threads' threads starts 'n_threads' - 1 workers which wait for jobs until the pool
+ * is freed, the calling thread takes part in every job as the last worker. A pool runs one job at a time,
+ * jobs submitted concurrently by several threads are run one after the other. Workers which cannot be started
+ * are not replaced, a pool always has at least the calling thread.
+ *
+ * 2) The traversals split the array in chunks of THREAD_POOL_CHUNK slots which the workers take in turn, so that
+ * expensive elements do not leave the other workers idle. The functions given to them are called concurrently
+ * and must be thread safe, in no particular order.
+ *
+ * 3) Slots hold either a pointer given as is to the user functions ('by_pointer' set) or a value whose address
+ * is given to them, like the elements of the containers.
+ *
+ * 4) 'thread_pool__any' and 'thread_pool__all' stop all the workers as soon as one of them finds the answer.
+ * 'thread_pool__filter' evaluates the predicate in parallel, then copies the kept slots in parallel at
+ * positions given by the number of slots kept by the previous chunks, which keeps their order.
+ */
+typedef struct ThreadPoolSt * ThreadPool;
+
+#define THREAD_POOL_CHUNK 256
+#define THREAD_POOL_MAX_THREADS 256
+
+
+/**
+ * @brief create a pool of 'n_threads' threads, including the calling one
+ * @details 'n_threads' is capped at THREAD_POOL_MAX_THREADS
+ * @note complexity: O(n_threads)
+ * @param n_threads the number of threads
+ * @return a pointer to pool on success, NULL on failure
+ */
+ThreadPool thread_pool__create(const size_t n_threads);
+
+
+/**
+ * @brief returns the number of threads running the jobs of the pool, including the calling one
+ * @note complexity: O(1)
+ * @param pool the pool
+ * @return the number of threads, SIZE_MAX if the pool is NULL
+ */
+size_t thread_pool__size(const ThreadPool pool);
+
+
+/**
+ * @brief calls 'job(arg)' once in every thread of the pool and waits for all of them to return
+ * @note complexity: O(1) besides the job
+ * @param pool the pool
+ * @param job the job
+ * @param arg the argument of the job
+ * @return 0 on success, -1 on failure
+ */
+char thread_pool__run(const ThreadPool pool, void (*job)(void *), void *arg);
+
+
+/**
+ * @brief maps 'func' to the 'n_elems' slots of 'size' bytes of 'base' with the threads of the pool
+ * @note complexity: O(n/n_threads)
+ * @param pool the pool
+ * @param base the array
+ * @param n_elems the number of slots
+ * @param size the byte size of a slot
+ * @param by_pointer gives the pointer held by the slots to 'func' if set, the address of the slots if not
+ * @param func the applying function
+ * @param user_data optional data to be used as an additional argument of the application function
+ * @return 0 on success, -1 on failure
+ */
+char thread_pool__foreach(const ThreadPool pool, void *base, const size_t n_elems, const size_t size,
+                          const char by_pointer, const applying_func_t func, void *user_data);
+
+
+/**
+ * @brief checks if all the slots satisfy the predicate, with the threads of the pool
+ * @note complexity: O(n/n_threads)
+ * @param pool the pool
+ * @param base the array
+ * @param n_elems the number of slots
+ * @param size the byte size of a slot
+ * @param by_pointer gives the pointer held by the slots to 'pred' if set, the address of the slots if not
+ * @param pred the predicate
+ * @param user_data optional data to be used as an additional argument of the predicate
+ * @return 1 if all slots satisfy the predicate, 0 if not, -1 on failure
+ */
+char thread_pool__all(const ThreadPool pool, void *base, const size_t n_elems, const size_t size,
+                      const char by_pointer, const filter_func_t pred, void *user_data);
+
+
+/**
+ * @brief checks if any slot satisfies the predicate, with the threads of the pool
+ * @note complexity: O(n/n_threads)
+ * @param pool the pool
+ * @param base the array
+ * @param n_elems the number of slots
+ * @param size the byte size of a slot
+ * @param by_pointer gives the pointer held by the slots to 'pred' if set, the address of the slots if not
+ * @param pred the predicate
+ * @param user_data optional data to be used as an additional argument of the predicate
+ * @return 1 if any slot satisfies the predicate, 0 if not, -1 on failure
+ */
+char thread_pool__any(const ThreadPool pool, void *base, const size_t n_elems, const size_t size,
+                      const char by_pointer, const filter_func_t pred, void *user_data);
+
+
+/**
+ * @brief copies the slots satisfying the predicate to 'dst' in their order, with the threads of the pool
+ * @note complexity: O(n/n_threads + n_chunks)
+ * @param pool the pool
+ * @param base the array
+ * @param n_elems the number of slots
+ * @param size the byte size of a slot
+ * @param by_pointer gives the pointer held by the slots to 'pred' if set, the address of the slots if not
+ * @param pred the predicate
+ * @param user_data optional data to be used as an additional argument of the predicate
+ * @param dst the array receiving the kept slots, large enough for 'n_elems' slots and not overlapping 'base'
+ * @param kept the array of 'n_elems' flags set to 1 for the kept slots and 0 for the others
+ * @return the number of kept slots, SIZE_MAX on failure
+ */
+size_t thread_pool__filter(const ThreadPool pool, void *base, const size_t n_elems, const size_t size,
+                           const char by_pointer, const filter_func_t pred, void *user_data,
+                           void *dst, char *kept);
+
+
+/**
+ * @brief stops the threads of the pool and free all memory used by the pool
+ * @note complexity: O(n_threads)
+ * @param pool the pool
+ */
+void thread_pool__free(const ThreadPool pool);
+
+
+#endif
@@ -1,19 +1,228 @@
 #ifndef __VEC_H__
 #define __VEC_H__
 
+#include "arena.h"
+#include "ptr_search.h"
+#include "ptr_set.h"
+
+///////////////////////////////////////////////////////////////////////////////
+///     ALLOCATOR UTILITARIES
+///////////////////////////////////////////////////////////////////////////////
+
+static inline void *default_alloc(void *ctx, size_t size) {
+    return malloc(size);
+}
+
+static inline void *default_realloc(void *ctx, void *ptr, size_t size) {
+    return realloc(ptr, size);
+}
+
+static inline void default_free(void *ctx, void *ptr) {
+    free(ptr);
+}
+
+/**
+ * Allocator of the containers built without an explicit one
+ */
+#define DEFAULT_ALLOCATOR \
+    ((allocator_t){default_alloc, default_realloc, default_free, NULL})
+
+#define ALLOC(__allocator, __size) \
+    ((__allocator).alloc((__allocator).ctx, (__size)))
+
+#define REALLOC(__allocator, __mem, __size) \
+    ((__allocator).realloc((__allocator).ctx, (__mem), (__size)))
+
+#define DEALLOC(__allocator, __mem) \
+    ((__allocator).free((__allocator).ctx, (__mem)))
+
+///////////////////////////////////////////////////////////////////////////////
+///     CAPACITY POLICY UTILITARIES
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Capacity doubles when full and halves once less than a quarter of it is used, the gap between
+ * both thresholds keeps a container oscillating around a power of two from reallocating every time
+ */
+#define DEFAULT_POLICY(__min_capacity) \
+    ((capacity_policy_t){2, 4, (__min_capacity)})
+
+/**
+ * A shrink must leave room for all elements, ring buffers also need a power of two growth factor
+ */
+#define POLICY_IS_VALID(__policy, __is_ring) \
+    ((__policy).growth_factor >= 2 && (__policy).min_capacity \
+     && (!(__policy).shrink_threshold || (__policy).shrink_threshold >= (__policy).growth_factor) \
+     && (!(__is_ring) || !((__policy).growth_factor & ((__policy).growth_factor - 1))))
+
+#define SHOULD_SHRINK(__ptr, __policy) \
+    ((__policy).shrink_threshold && (__ptr)->length < (__ptr)->capacity / (__policy).shrink_threshold \
+     && (__ptr)->capacity / (__policy).growth_factor >= (__policy).min_capacity)
+
+/**
+ * Capacity reached by growth steps of the policy to hold 'n_elems', 'n_elems' itself if the steps overflow
+ */
+#define GROWN_CAPACITY(__capacity, __n_elems, __policy) \
+({ \
+    size_t __grown = (__capacity); \
+    while (__grown < (__n_elems) && __grown <= SIZE_MAX / (__policy).growth_factor) { \
+        __grown *= (__policy).growth_factor; \
+    } \
+    __grown < (__n_elems) ? (__n_elems) : __grown; \
+})
+
+/**
+ * Capacity reached by the shrink steps of the policy a container of 'length' elements would take one by one
+ */
+#define SHRUNK_CAPACITY(__ptr, __policy) \
+({ \
+    size_t __shrunk = (__ptr)->capacity; \
+    while ((__policy).shrink_threshold && (__ptr)->length < __shrunk / (__policy).shrink_threshold \
+           && __shrunk / (__policy).growth_factor >= (__policy).min_capacity) { \
+        __shrunk /= (__policy).growth_factor; \
+    } \
+    __shrunk; \
+})
+
+///////////////////////////////////////////////////////////////////////////////
+///     VECTOR UTILITARIES
+///////////////////////////////////////////////////////////////////////////////
+
 #define PTR_INCREMENT(__ptr, __size) \
     (__ptr) = (void *)((size_t)(__ptr) + (__size))
 
-#define SWAP(__ptr, __i, __j) \
-    elem_t *__elems = (__ptr)->elems; \
-    elem_t __temp = __elems[__i]; \
-    __elems[__i] = __elems[__j]; \
-    __elems[__j] = __temp
+/**
+ * Byte size of a slot of 'elems', containers storing their values inline have a non zero 'elem_size'
+ */
+#define SLOT_SIZE(__ptr) \
+    ((__ptr)->elem_size ? (__ptr)->elem_size : sizeof(elem_t))
+
+#define SLOT(__ptr, __i) \
+    ((void *)((char *)(__ptr)->elems + (__i) * SLOT_SIZE(__ptr)))
+
+/**
+ * Element given to user functions: the stored pointer, or the address of the value when stored inline
+ */
+#define ELEM(__ptr, __i) \
+    ((__ptr)->elem_size ? SLOT(__ptr, __i) : (__ptr)->elems[__i])
+
+/**
+ * Stores 'elem' at position 'i', the pointed value is copied when stored inline
+ * and the copy is allocated in the arena of the container when it has one
+ */
+#define ELEM_STORE(__ptr, __i, __elem) do { \
+    if ((__ptr)->elem_size) { \
+        memcpy(SLOT(__ptr, __i), (__elem), (__ptr)->elem_size); \
+    } else if ((__ptr)->arena) { \
+        (__ptr)->elems[__i] = arena__copy((__ptr)->arena, (__elem), (__ptr)->operator_size(__elem)); \
+    } else { \
+        (__ptr)->elems[__i] = (__ptr)->operator_copy(__elem); \
+    } \
+} while (false)
+
+/**
+ * Retrieves the element at position 'i' in 'dst' through '__op', the value is copied
+ * in the storage pointed by 'dst' when stored inline
+ */
+#define ELEM_LOAD(__ptr, __i, __dst, __op) do { \
+    if ((__ptr)->elem_size) { \
+        memcpy((__dst), SLOT(__ptr, __i), (__ptr)->elem_size); \
+    } else { \
+        *(__dst) = (__op)((__ptr)->elems[__i]); \
+    } \
+} while (false)
+
+/**
+ * Copies the 'n_elems' pointers of 'src' in 'dst' with a single call to the batch copy operator,
+ * or with one call to the copy operator per element when none was registered, empty runs are skipped
+ */
+#define COPY_N(__ptr, __dst, __src, __n_elems) do { \
+    if ((__ptr)->operator_copy_n && (__n_elems)) { \
+        (__ptr)->operator_copy_n((__dst), (__src), (__n_elems)); \
+    } else { \
+        for (size_t __k_cpy = 0; __k_cpy < (__n_elems); __k_cpy++) { \
+            (__dst)[__k_cpy] = (__ptr)->operator_copy((__src)[__k_cpy]); \
+        } \
+    } \
+} while (false)
+
+/**
+ * Deletes the 'n_elems' pointers of 'elems' with a single call to the batch delete operator,
+ * or with one call to the delete operator per element when none was registered, empty runs are skipped
+ */
+#define DELETE_N(__ptr, __elems, __n_elems) do { \
+    if ((__ptr)->operator_delete_n && (__n_elems)) { \
+        (__ptr)->operator_delete_n((__elems), (__n_elems)); \
+    } else { \
+        for (size_t __k_del = 0; __k_del < (__n_elems); __k_del++) { \
+            (__ptr)->operator_delete((__elems)[__k_del]); \
+        } \
+    } \
+} while (false)
+
+/**
+ * Stores the 'n_elems' slots of 'array' from position 'i', pointers and inline values are copied
+ * in one block unless each element needs its own copy
+ */
+#define ELEMS_STORE(__ptr, __i, __array, __n_elems) do { \
+    if ((__ptr)->elem_size || !(__ptr)->copy_enabled) { \
+        memcpy(SLOT(__ptr, __i), (__array), SLOT_SIZE(__ptr) * (__n_elems)); \
+    } else if ((__ptr)->arena) { \
+        const elem_t *__src = (const elem_t *)(__array); \
+        for (size_t k = 0; k < (__n_elems); k++) { \
+            ELEM_STORE(__ptr, (__i) + k, __src[k]); \
+        } \
+    } else { \
+        COPY_N(__ptr, &(__ptr)->elems[__i], (const elem_t *)(__array), __n_elems); \
+    } \
+} while (false)
+
+/**
+ * Stores the 'n_elems' pointers of 'array' from position 'i' as they are, the container takes them over
+ */
+#define ELEMS_MOVE(__ptr, __i, __array, __n_elems) \
+    memcpy(&(__ptr)->elems[__i], (__array), sizeof(elem_t) * (__n_elems))
+
+/**
+ * Moves the 'n_elems' elements from position 'i' to the slots of 'dst', the elements of an arena are
+ * cloned out of it then released, the other ones are deleted instead if 'dst' is NULL
+ */
+#define ELEMS_TAKE(__ptr, __i, __dst, __n_elems) do { \
+    elem_t *__taken = (elem_t *)(__dst); \
+    if (__taken && !(__ptr)->arena) { \
+        memcpy(__taken, SLOT(__ptr, __i), SLOT_SIZE(__ptr) * (__n_elems)); \
+    } else if ((__ptr)->copy_enabled) { \
+        if (__taken) { \
+            COPY_N(__ptr, __taken, &(__ptr)->elems[__i], __n_elems); \
+        } \
+        DELETE_N(__ptr, &(__ptr)->elems[__i], __n_elems); \
+    } \
+} while (false)
+
+/**
+ * Values are swapped byte by byte unless their slots have the size of the 'elems' type
+ */
+#define SWAP(__ptr, __i, __j) do { \
+    if ((__ptr)->elem_size && (__ptr)->elem_size != sizeof(*(__ptr)->elems)) { \
+        char *__a = SLOT(__ptr, __i); \
+        char *__b = SLOT(__ptr, __j); \
+        for (size_t __byte = 0; __byte < (__ptr)->elem_size; __byte++) { \
+            char __c = __a[__byte]; \
+            __a[__byte] = __b[__byte]; \
+            __b[__byte] = __c; \
+        } \
+    } else { \
+        __typeof__((__ptr)->elems) __elems = (__ptr)->elems; \
+        __typeof__(*__elems) __temp = __elems[__i]; \
+        __elems[__i] = __elems[__j]; \
+        __elems[__j] = __temp; \
+    } \
+} while (false)
 
 #define RESIZE(__ptr, __new_capacity) \
 ({ \
     int __result_res = FAILURE; \
-    elem_t *__realloc_res = realloc((__ptr)->elems, sizeof(elem_t) * (__new_capacity)); \
+    __typeof__((__ptr)->elems) __realloc_res = REALLOC((__ptr)->allocator, (__ptr)->elems, SLOT_SIZE(__ptr) * (__new_capacity)); \
     if (__realloc_res) { \
         (__ptr)->elems = __realloc_res; \
         (__ptr)->capacity = (__new_capacity); \
@@ -22,12 +231,16 @@
     (char)__result_res; \
 })
 
-#define ENSURE_CAPACITY(__ptr) \
+/**
+ * Grows the capacity by the growth factor of the policy, smaller steps are tried if the allocation fails
+ */
+#define ENSURE_CAPACITY(__ptr, __policy) \
 ({ \
     int __result_ens = FAILURE; \
     size_t __capacity = (__ptr)->capacity; \
+    size_t __factor = (__policy).growth_factor - 1; \
     if ((__ptr)->back == __capacity) { \
-        size_t __offset = (__capacity < SIZE_MAX>>1) ? __capacity : SIZE_MAX - __capacity; \
+        size_t __offset = (__capacity <= (SIZE_MAX - __capacity) / __factor) ? __capacity * __factor : SIZE_MAX - __capacity; \
         while (__offset && (__result_ens = RESIZE((__ptr), __capacity + __offset))) { \
             __offset = __offset>>1; \
         } \
@@ -37,63 +250,141 @@
     (char)__result_ens; \
 })
 
+#define SHRINK(__ptr, __policy) do { \
+    if (SHOULD_SHRINK(__ptr, __policy)) { \
+        RESIZE(__ptr, (__ptr)->capacity / (__policy).growth_factor); \
+    } \
+} while (false)
+
+/**
+ * Makes room for 'n_elems' more elements with a single reallocation
+ */
+#define RESERVE_N(__ptr, __n_elems, __policy) \
+({ \
+    int __result_rsv = SUCCESS; \
+    size_t __needed = (__ptr)->back + (__n_elems); \
+    if (__needed < (__ptr)->back) { \
+        __result_rsv = FAILURE; \
+    } else if (__needed > (__ptr)->capacity) { \
+        __result_rsv = RESIZE(__ptr, GROWN_CAPACITY((__ptr)->capacity, __needed, __policy)); \
+    } \
+    (char)__result_rsv; \
+})
+
+/**
+ * Applies all the shrink steps due after removing several elements with a single reallocation
+ */
+#define SHRINK_N(__ptr, __policy) do { \
+    size_t __new_capacity = SHRUNK_CAPACITY(__ptr, __policy); \
+    if (__new_capacity < (__ptr)->capacity) { \
+        RESIZE(__ptr, __new_capacity); \
+    } \
+} while (false)
+
+/**
+ * With a batch copy operator the addresses of the slots of 'array' are stored first, then copied in place
+ */
 #define FROM_ARRAY(__ptr, __array, __n_elems, __size) \
-    for (size_t i = 0; i < __n_elems; i++) { \
-        (__ptr)->elems[(__ptr)->back + i] = (__ptr)->operator_copy(A); \
-        PTR_INCREMENT(__array, __size); \
+    if ((__ptr)->operator_copy_n) { \
+        for (size_t i = 0; i < __n_elems; i++) { \
+            (__ptr)->elems[(__ptr)->back + i] = (elem_t)(__array); \
+            PTR_INCREMENT(__array, __size); \
+        } \
+        COPY_N(__ptr, &(__ptr)->elems[(__ptr)->back], &(__ptr)->elems[(__ptr)->back], __n_elems); \
+    } else { \
+        for (size_t i = 0; i < __n_elems; i++) { \
+            ELEM_STORE(__ptr, (__ptr)->back + i, __array); \
+            PTR_INCREMENT(__array, __size); \
+        } \
     } \
-    (__ptr)->back += n_elems; \
-    (__ptr)->length += n_elems
+    (__ptr)->back += (__n_elems); \
+    (__ptr)->length += (__n_elems)
 
 #define COPY(__dst, __src, __start, __n_elems) \
+    COPY_AT(__dst, 0, __src, __start, __n_elems)
+
+/**
+ * Same as 'COPY' with the copies stored from the slot '__dst_start' of '__dst'
+ */
+#define COPY_AT(__dst, __dst_start, __src, __start, __n_elems) \
 ({ \
-    if ((__src)->copy_enabled) { \
+    if ((__src)->elem_size) { \
+        (__dst)->copy_enabled = false; \
+        memcpy(SLOT(__dst, __dst_start), SLOT(__src, __start), (__src)->elem_size * (__n_elems)); \
+    } else if ((__dst)->arena) { \
         (__dst)->copy_enabled = true; \
         for (size_t i = 0; i < (__n_elems); i++) { \
-            (__dst)->elems[i] = (__src)->operator_copy((__src)->elems[(__start) + i]); \
+            elem_t __elem = (__src)->elems[(__start) + i]; \
+            (__dst)->elems[(__dst_start) + i] = arena__copy((__dst)->arena, __elem, arena__size(__elem)); \
         } \
+    } else if ((__src)->copy_enabled) { \
+        (__dst)->copy_enabled = true; \
+        (__dst)->operator_copy_n = (__src)->operator_copy_n; \
+        (__dst)->operator_delete_n = (__src)->operator_delete_n; \
+        COPY_N(__src, (__dst)->elems + (__dst_start), (__src)->elems + (__start), __n_elems); \
     } else { \
         (__dst)->copy_enabled = false; \
-        memcpy((__dst)->elems, (__src)->elems + (__start), sizeof(elem_t) * (__n_elems)); \
+        memcpy((__dst)->elems + (__dst_start), (__src)->elems + (__start), sizeof(elem_t) * (__n_elems)); \
     } \
     (__dst)->length = (__src)->length; \
 })
 
+/**
+ * Pointers are compared by the SIMD kernels of 'ptr_search', inline values byte by byte
+ */
 #define PTR_SEARCH(__ptr, __start, __end, __elem) \
 ({ \
-    elem_t *__elems = (__ptr)->elems; \
     size_t __pos = (__start); \
-    while (__pos < (__end) && __elems[__pos] != (__elem)) { \
-        __pos++; \
+    if ((__ptr)->elem_size) { \
+        while (__pos < (__end) && memcmp(SLOT(__ptr, __pos), (__elem), (__ptr)->elem_size)) { \
+            __pos++; \
+        } \
+        __pos = __pos == (__end) ? SIZE_MAX : __pos; \
+    } else { \
+        size_t __found_ptr = ptr_search((__ptr)->elems + __pos, (__end) - __pos, (__elem)); \
+        __pos = __found_ptr == SIZE_MAX ? SIZE_MAX : __pos + __found_ptr; \
     } \
-    __pos == (__end) ? SIZE_MAX : __pos; \
+    __pos; \
 })
 
 #define SEARCH(__ptr, __start, __end, __elem, __match) \
 ({ \
-    elem_t *__elems = (__ptr)->elems; \
     size_t __pos = (__start); \
-    while (__pos < (__end) && !(__match)(__elems[__pos], (__elem))) { \
+    while (__pos < (__end) && !(__match)(ELEM(__ptr, __pos), (__elem))) { \
         __pos++; \
     } \
     __pos == (__end) ? SIZE_MAX : __pos; \
 })
 
-#define ARRAY_CMP(__ptr_1, __ptr_2, __match, __n_elems) \
+#define ARRAY_CMP(__ptr_1, __start_1, __ptr_2, __start_2, __match, __n_elems) \
 ({ \
-    int __result_cmp = true; \
+    int __result_cmp = (__ptr_1)->elem_size == (__ptr_2)->elem_size; \
     for (size_t i = 0; i < (__n_elems) && __result_cmp; i++) { \
-        __result_cmp &= (__match)((__ptr_1)[i], (__ptr_2)[i]); \
+        __result_cmp &= (__match)(ELEM(__ptr_1, (__start_1) + i), ELEM(__ptr_2, (__start_2) + i)); \
     } \
     (char)__result_cmp; \
 })
 
-#define FOREACH(__ptr, __func, __user_data, __start, __end) do { \
+#define FOREACH_ALL(__ptr, __func, __user_data, __start, __end) do { \
+    for (size_t i = (__start); i < (__end); i++) { \
+        (__func)(ELEM(__ptr, i), (__user_data)); \
+    } \
+} while(false)
+
+/**
+ * Without copy, a pointer stored several times is visited once: the visited pointers are remembered in the
+ * scratch set '__seen', or searched among the previous slots if the set cannot be sized
+ */
+#define FOREACH(__ptr, __func, __user_data, __start, __end, __seen) do { \
     elem_t *__elems = (__ptr)->elems; \
     char __repeated; \
-    if ((__ptr)->copy_enabled) { \
+    if ((__ptr)->copy_enabled || (__ptr)->elem_size) { \
+        FOREACH_ALL(__ptr, __func, __user_data, __start, __end); \
+    } else if (ptr_set__reset((__seen), (__end) - (__start)) == SUCCESS) { \
         for (size_t i = (__start); i < (__end); i++) { \
-            (__func)(__elems[i], (__user_data)); \
+            if (ptr_set__insert((__seen), __elems[i]) > 0) { \
+                (__func)(__elems[i], (__user_data)); \
+            } \
         } \
     } else { \
         __repeated = false; \
@@ -111,35 +402,44 @@
     } \
 } while(false)
 
-#define FILTER(__ptr, __start, __end, __pred, __user_data) \
+#define FILTER(__ptr, __start, __end, __pred, __user_data) do { \
     elem_t *__elems = (__ptr)->elems; \
-    size_t k = 0; \
-    for (size_t i = (__start); i < (__end); i++) { \
-        if ((__pred)(__elems[i], (__user_data))) { \
-            __elems[k] = __elems[i]; \
-            k++; \
-        } else { \
-            (__ptr)->operator_delete(__elems[i]); \
+    size_t k = (__start); \
+    if ((__ptr)->elem_size) { \
+        for (size_t i = (__start); i < (__end); i++) { \
+            if ((__pred)(SLOT(__ptr, i), (__user_data))) { \
+                if (k != i) memcpy(SLOT(__ptr, k), SLOT(__ptr, i), (__ptr)->elem_size); \
+                k++; \
+            } \
+        } \
+    } else { \
+        for (size_t i = (__start); i < (__end); i++) { \
+            if ((__pred)(__elems[i], (__user_data))) { \
+                elem_t __kept = __elems[i]; \
+                __elems[i] = __elems[k]; \
+                __elems[k] = __kept; \
+                k++; \
+            } \
         } \
+        DELETE_N(__ptr, __elems + k, (__end) - k); \
     } \
-    (__ptr)->length = k
+    (__ptr)->length = k - (__start); \
+} while (false)
 
 #define ALL(__ptr, __start, __end, __pred, __user_data) \
 ({ \
-    elem_t *__elems = (__ptr)->elems; \
     int __result_all = true; \
     for (size_t i = (__start); i < (__end); i++) { \
-        __result_all &= (__pred)(__elems[i], (__user_data)); \
+        __result_all &= (__pred)(ELEM(__ptr, i), (__user_data)); \
     } \
     (char)__result_all; \
 })
 
 #define ANY(__ptr, __start, __end, __pred, __user_data) \
 ({ \
-    elem_t *__elems = (__ptr)->elems; \
     int __result_any = false; \
     for (size_t i = (__start); i < (__end) && !__result_any; i++) { \
-        __result_any |= (__pred)(__elems[i], (__user_data)); \
+        __result_any |= (__pred)(ELEM(__ptr, i), (__user_data)); \
     } \
     (char)__result_any; \
 })
@@ -148,32 +448,413 @@
     size_t __i, __j; \
     srand(__seed); \
     for (size_t i = (__start); i < (__end); i++) { \
-        __i = ((__start) + (size_t)(rand() % (int)((__start) + (__end)))); \
-        __j = ((__start) + (size_t)(rand() % (int)((__start) + (__end)))); \
+        __i = ((__start) + (size_t)(rand() % (int)((__end) - (__start)))); \
+        __j = ((__start) + (size_t)(rand() % (int)((__end) - (__start)))); \
         SWAP(__ptr, __i, __j); \
     } \
 } while (false)
 
-#define CLEAN_NULL_ELEMS(__ptr, __start, __end) \
+/**
+ * Values stored inline are never NULL, only pointers are removed
+ */
+#define CLEAN_NULL_ELEMS(__ptr, __start, __end) do { \
     elem_t *__elems = (__ptr)->elems; \
-    size_t k = 0; \
-    for (size_t i = (__start); i < (__end); i++) { \
-        if (__elems[i]) { \
-            __elems[k] = __elems[i]; \
-            k++; \
+    size_t k = (__start); \
+    if (!(__ptr)->elem_size) { \
+        for (size_t i = (__start); i < (__end); i++) { \
+            if (__elems[i]) { \
+                __elems[k] = __elems[i]; \
+                k++; \
+            } \
         } \
+        (__ptr)->length = k - (__start); \
     } \
-    (__ptr)->length = k
+} while (false)
 
+/**
+ * Copies allocated in an arena are all released at once without visiting them
+ */
 #define FREE_ELEMS(__ptr, __start, __end) do { \
     elem_t *__elems = (__ptr)->elems; \
-    if ((__ptr)->copy_enabled) { \
-        for (size_t i = (__start); i < (__end); i++) { \
-            (__ptr)->operator_delete(__elems[i]); \
-        } \
+    if ((__ptr)->arena) { \
+        arena__reset((__ptr)->arena); \
+    } else if ((__ptr)->copy_enabled) { \
+        DELETE_N(__ptr, __elems + (__start), (__end) - (__start)); \
     } \
     (__ptr)->back = 0; \
     (__ptr)->length = 0; \
 } while (false)
 
+///////////////////////////////////////////////////////////////////////////////
+///     RING BUFFER UTILITARIES
+///     (structures with 'front', 'back', 'length' and a power of two 'capacity')
+///////////////////////////////////////////////////////////////////////////////
+
+#define NEXT_POW2(__n) \
+({ \
+    size_t __pow = 1; \
+    while (__pow && __pow < (__n)) { \
+        __pow <<= 1; \
+    } \
+    __pow; \
+})
+
+#define RING_MASK(__ptr) \
+    ((__ptr)->capacity - 1)
+
+#define RING_INDEX(__ptr, __i) \
+    (((__ptr)->front + (__i)) & RING_MASK(__ptr))
+
+#define RING_IS_WRAPPED(__ptr) \
+    ((__ptr)->front + (__ptr)->length > (__ptr)->capacity)
+
+/**
+ * End of the first contiguous run, which starts at 'front'
+ */
+#define RING_HEAD_END(__ptr) \
+    (RING_IS_WRAPPED(__ptr) ? (__ptr)->capacity : (__ptr)->front + (__ptr)->length)
+
+/**
+ * End of the second contiguous run, which starts at 0 (empty if the ring is not wrapped)
+ */
+#define RING_TAIL_END(__ptr) \
+    (RING_IS_WRAPPED(__ptr) ? (__ptr)->front + (__ptr)->length - (__ptr)->capacity : 0)
+
+/**
+ * Converts a position in 'elems' to a position relative to 'front'
+ */
+#define RING_LOGICAL(__ptr, __pos) \
+    ((__pos) == SIZE_MAX ? SIZE_MAX : ((__pos) - (__ptr)->front) & RING_MASK(__ptr))
+
+/**
+ * Macro to apply 'MACRO' on both contiguous runs of the ring and combine the results with 'OP'
+ */
+#define RING_ON_RUNS(__ptr, __op, MACRO, ...) \
+    (MACRO(__ptr, (__ptr)->front, RING_HEAD_END(__ptr), __VA_ARGS__) __op MACRO(__ptr, 0, RING_TAIL_END(__ptr), __VA_ARGS__))
+
+/**
+ * Macro to search on both contiguous runs of the ring, returns a position relative to 'front'
+ */
+#define RING_SEARCH_ON_RUNS(__ptr, MACRO, ...) \
+({ \
+    size_t __found = MACRO(__ptr, (__ptr)->front, RING_HEAD_END(__ptr), __VA_ARGS__); \
+    if (__found == SIZE_MAX) { \
+        __found = MACRO(__ptr, 0, RING_TAIL_END(__ptr), __VA_ARGS__); \
+    } \
+    RING_LOGICAL(__ptr, __found); \
+})
+
+#define REVERSE_RANGE(__ptr, __start, __end) do { \
+    for (size_t __k = (__start), __l = (__end) - 1; __k < __l && __l != SIZE_MAX; __k++, __l--) { \
+        SWAP(__ptr, __k, __l); \
+    } \
+} while (false)
+
+/**
+ * Rotates the whole buffer in place so that 'front' becomes 0 and the elements are contiguous,
+ * only for the functions reordering or moving the elements anyway
+ */
+#define RING_LINEARIZE(__ptr) do { \
+    if (RING_IS_WRAPPED(__ptr)) { \
+        REVERSE_RANGE(__ptr, 0, (__ptr)->front); \
+        REVERSE_RANGE(__ptr, (__ptr)->front, (__ptr)->capacity); \
+        REVERSE_RANGE(__ptr, 0, (__ptr)->capacity); \
+        (__ptr)->front = 0; \
+        (__ptr)->back = (__ptr)->length & RING_MASK(__ptr); \
+    } \
+} while (false)
+
+/**
+ * Copies the elements of the ring '__src' from the slot '__dst_start' of '__dst', run by run
+ */
+#define RING_COPY(__dst, __dst_start, __src) do { \
+    size_t __head = RING_HEAD_END(__src) - (__src)->front; \
+    COPY_AT(__dst, __dst_start, __src, (__src)->front, __head); \
+    COPY_AT(__dst, (__dst_start) + __head, __src, 0, RING_TAIL_END(__src)); \
+} while (false)
+
+/**
+ * Compares two rings of the same length on the chunks where neither of them wraps
+ */
+#define RING_ARRAY_CMP(__ptr_1, __ptr_2, __match) \
+({ \
+    char __result_ring = (__ptr_1)->elem_size == (__ptr_2)->elem_size; \
+    for (size_t __done = 0, __n; __done < (__ptr_1)->length && __result_ring; __done += __n) { \
+        size_t __pos_1 = RING_INDEX(__ptr_1, __done); \
+        size_t __pos_2 = RING_INDEX(__ptr_2, __done); \
+        __n = (__ptr_1)->length - __done; \
+        __n = (__ptr_1)->capacity - __pos_1 < __n ? (__ptr_1)->capacity - __pos_1 : __n; \
+        __n = (__ptr_2)->capacity - __pos_2 < __n ? (__ptr_2)->capacity - __pos_2 : __n; \
+        __result_ring = ARRAY_CMP(__ptr_1, __pos_1, __ptr_2, __pos_2, __match, __n); \
+    } \
+    __result_ring; \
+})
+
+#define RING_FOREACH_ALL(__ptr, __func, __user_data) do { \
+    FOREACH_ALL(__ptr, __func, __user_data, (__ptr)->front, RING_HEAD_END(__ptr)); \
+    FOREACH_ALL(__ptr, __func, __user_data, 0, RING_TAIL_END(__ptr)); \
+} while (false)
+
+/**
+ * Same as 'FOREACH' on both runs of the ring, a pointer of the tail run already seen in the head run is skipped
+ */
+#define RING_FOREACH(__ptr, __func, __user_data, __seen) do { \
+    elem_t *__elems = (__ptr)->elems; \
+    char __repeated; \
+    if ((__ptr)->copy_enabled || (__ptr)->elem_size) { \
+        RING_FOREACH_ALL(__ptr, __func, __user_data); \
+    } else if (ptr_set__reset((__seen), (__ptr)->length) == SUCCESS) { \
+        for (size_t i = 0; i < (__ptr)->length; i++) { \
+            if (ptr_set__insert((__seen), __elems[RING_INDEX(__ptr, i)]) > 0) { \
+                (__func)(__elems[RING_INDEX(__ptr, i)], (__user_data)); \
+            } \
+        } \
+    } else { \
+        __repeated = false; \
+        for (size_t i = 0; i < (__ptr)->length; i++) { \
+            for (size_t j = 0; j < i && !__repeated; j++) { \
+                if (__elems[RING_INDEX(__ptr, i)] == __elems[RING_INDEX(__ptr, j)]) { \
+                    __repeated = true; \
+                } \
+            } \
+            if (!__repeated) { \
+                (__func)(__elems[RING_INDEX(__ptr, i)], (__user_data)); \
+            } \
+            __repeated = false; \
+        } \
+    } \
+} while (false)
+
+/**
+ * Reallocates the ring to a power of two capacity greater or equal to its length,
+ * only the smallest wrapped run is moved
+ */
+#define RING_RESIZE(__ptr, __new_capacity) \
+({ \
+    int __result_ring = FAILURE; \
+    size_t __old_cap = (__ptr)->capacity; \
+    size_t __new_cap = (__new_capacity); \
+    size_t __tail = RING_IS_WRAPPED(__ptr) ? __old_cap - (__ptr)->front : 0; \
+    size_t __head = RING_TAIL_END(__ptr); \
+    if (__new_cap == __old_cap) { \
+        __result_ring = SUCCESS; \
+    } else if (__new_cap > __old_cap) { \
+        if (!(__result_ring = RESIZE(__ptr, __new_cap)) && __tail) { \
+            if (__head <= __tail) { \
+                memcpy(SLOT(__ptr, __old_cap), (__ptr)->elems, SLOT_SIZE(__ptr) * __head); \
+            } else { \
+                memcpy(SLOT(__ptr, __new_cap - __tail), SLOT(__ptr, (__ptr)->front), SLOT_SIZE(__ptr) * __tail); \
+                (__ptr)->front = __new_cap - __tail; \
+            } \
+        } \
+    } else if ((__ptr)->length <= __new_cap) { \
+        if (__tail) { \
+            memmove(SLOT(__ptr, __new_cap - __tail), SLOT(__ptr, (__ptr)->front), SLOT_SIZE(__ptr) * __tail); \
+            (__ptr)->front = __new_cap - __tail; \
+        } else if ((__ptr)->front + (__ptr)->length > __new_cap) { \
+            memmove((__ptr)->elems, SLOT(__ptr, (__ptr)->front), SLOT_SIZE(__ptr) * (__ptr)->length); \
+            (__ptr)->front = 0; \
+        } \
+        __result_ring = RESIZE(__ptr, __new_cap); \
+    } \
+    (__ptr)->back = ((__ptr)->front + (__ptr)->length) & RING_MASK(__ptr); \
+    (char)__result_ring; \
+})
+
+#define RING_ENSURE_CAPACITY(__ptr, __policy) \
+({ \
+    int __result_ens = SUCCESS; \
+    if ((__ptr)->length == (__ptr)->capacity) { \
+        __result_ens = (__ptr)->capacity > SIZE_MAX / (__policy).growth_factor \
+                       ? FAILURE : RING_RESIZE(__ptr, (__ptr)->capacity * (__policy).growth_factor); \
+    } \
+    (char)__result_ens; \
+})
+
+#define RING_SHRINK(__ptr, __policy) do { \
+    if (SHOULD_SHRINK(__ptr, __policy)) { \
+        RING_RESIZE(__ptr, (__ptr)->capacity / (__policy).growth_factor); \
+    } \
+} while (false)
+
+/**
+ * Same as 'RESERVE_N' for rings, the grown capacity must stay a power of two
+ */
+#define RING_RESERVE_N(__ptr, __n_elems, __policy) \
+({ \
+    int __result_rsv = SUCCESS; \
+    size_t __needed = (__ptr)->length + (__n_elems); \
+    if (__needed > (__ptr)->capacity) { \
+        size_t __ring_grown = __needed < (__ptr)->length ? 0 : GROWN_CAPACITY((__ptr)->capacity, __needed, __policy); \
+        __result_rsv = !__ring_grown || (__ring_grown & (__ring_grown - 1)) ? FAILURE : RING_RESIZE(__ptr, __ring_grown); \
+    } \
+    (char)__result_rsv; \
+})
+
+#define RING_SHRINK_N(__ptr, __policy) do { \
+    size_t __new_capacity = SHRUNK_CAPACITY(__ptr, __policy); \
+    if (__new_capacity < (__ptr)->capacity) { \
+        RING_RESIZE(__ptr, __new_capacity); \
+    } \
+} while (false)
+
+/**
+ * Applies 'MACRO(ptr, position, offset, run_length, ...)' on the two contiguous runs of the 'n_elems' slots
+ * starting at position 'start', 'offset' is the number of slots of the previous run
+ */
+#define RING_ON_SLOTS(__ptr, __start, __n_elems, MACRO, ...) do { \
+    size_t __first = (__start); \
+    size_t __head_len = (__n_elems) < (__ptr)->capacity - __first ? (__n_elems) : (__ptr)->capacity - __first; \
+    MACRO(__ptr, __first, 0, __head_len, __VA_ARGS__); \
+    if ((__n_elems) > __head_len) { \
+        MACRO(__ptr, 0, __head_len, (__n_elems) - __head_len, __VA_ARGS__); \
+    } \
+} while (false)
+
+#define RING_STORE_RUN(__ptr, __pos, __offset, __len, __array) \
+    ELEMS_STORE(__ptr, __pos, (const char *)(__array) + (__offset) * SLOT_SIZE(__ptr), __len)
+
+#define RING_MOVE_RUN(__ptr, __pos, __offset, __len, __array) \
+    ELEMS_MOVE(__ptr, __pos, (const elem_t *)(__array) + (__offset), __len)
+
+#define RING_TAKE_RUN(__ptr, __pos, __offset, __len, __dst) \
+    ELEMS_TAKE(__ptr, __pos, (__dst) ? (char *)(__dst) + (__offset) * SLOT_SIZE(__ptr) : NULL, __len)
+
+#define RING_COPY_RUN(__ptr, __pos, __offset, __len, __unused) \
+    COPY_N(__ptr, &(__ptr)->elems[__pos], &(__ptr)->elems[__pos], __len)
+
+/**
+ * With a batch copy operator the addresses of the slots of 'array' are stored first, then copied in place
+ * run by run
+ */
+#define RING_FROM_ARRAY(__ptr, __array, __n_elems, __size) \
+    if ((__ptr)->operator_copy_n) { \
+        size_t __first_back = (__ptr)->back; \
+        for (size_t i = 0; i < (__n_elems); i++) { \
+            (__ptr)->elems[(__ptr)->back] = (elem_t)(__array); \
+            (__ptr)->back = ((__ptr)->back + 1) & RING_MASK(__ptr); \
+            PTR_INCREMENT(__array, __size); \
+        } \
+        RING_ON_SLOTS(__ptr, __first_back, __n_elems, RING_COPY_RUN, NULL); \
+    } else { \
+        for (size_t i = 0; i < (__n_elems); i++) { \
+            ELEM_STORE(__ptr, (__ptr)->back, __array); \
+            (__ptr)->back = ((__ptr)->back + 1) & RING_MASK(__ptr); \
+            PTR_INCREMENT(__array, __size); \
+        } \
+    } \
+    (__ptr)->length += (__n_elems)
+
+#define RING_FREE_ELEMS(__ptr) do { \
+    size_t __head_end = RING_HEAD_END(__ptr); \
+    size_t __tail_end = RING_TAIL_END(__ptr); \
+    FREE_ELEMS(__ptr, (__ptr)->front, __head_end); \
+    FREE_ELEMS(__ptr, 0, __tail_end); \
+    (__ptr)->front = 0; \
+} while (false)
+
+///////////////////////////////////////////////////////////////////////////////
+///     TYPED CONTAINERS UTILITARIES
+///     (used by the code generated with 'STACK_DEFINE' and 'QUEUE_DEFINE')
+///////////////////////////////////////////////////////////////////////////////
+
+#define TYPED_EQUAL(__a, __b) \
+    ((__a) == (__b))
+
+#define TYPED_LESS(__a, __b) \
+    ((__a) < (__b))
+
+#define TYPED_ID(__a) \
+    (__a)
+
+#define TYPED_SKIP(__a) \
+    ((void)(__a))
+
+#define TYPED_SWAP(T, __a, __b) do { \
+    T __temp = (__a); \
+    (__a) = (__b); \
+    (__b) = __temp; \
+} while (false)
+
+#define TYPED_INSERTION_THRESHOLD 16
+
+/**
+ * Defines 'NAME__typed_sort', an introsort of an array of 'T' comparing with 'LESS':
+ * quicksort around a median of three, heapsort once the recursion gets too deep
+ * and insertion sort on small ranges
+ */
+#define TYPED_SORT_DEFINE(T, NAME, LESS) \
+static void NAME##__sift_down(T *a, size_t root, const size_t n) { \
+    T v = a[root]; \
+    size_t child; \
+    while ((child = 2 * root + 1) < n) { \
+        if (child + 1 < n && LESS(a[child], a[child + 1])) child++; \
+        if (!LESS(v, a[child])) break; \
+        a[root] = a[child]; \
+        root = child; \
+    } \
+    a[root] = v; \
+} \
+\
+static void NAME##__heap_sort(T *a, const size_t n) { \
+    for (size_t i = n / 2; i-- > 0;) { \
+        NAME##__sift_down(a, i, n); \
+    } \
+    for (size_t i = n; i-- > 1;) { \
+        TYPED_SWAP(T, a[0], a[i]); \
+        NAME##__sift_down(a, 0, i); \
+    } \
+} \
+\
+static void NAME##__insertion_sort(T *a, const size_t n) { \
+    for (size_t i = 1; i < n; i++) { \
+        T v = a[i]; \
+        size_t j = i; \
+        for (; j && LESS(v, a[j - 1]); j--) { \
+            a[j] = a[j - 1]; \
+        } \
+        a[j] = v; \
+    } \
+} \
+\
+static void NAME##__intro_sort(T *a, size_t n, unsigned int depth) { \
+    while (n > TYPED_INSERTION_THRESHOLD) { \
+        if (!depth--) { \
+            NAME##__heap_sort(a, n); \
+            return; \
+        } \
+        size_t mid = n / 2, i = 0, j = n - 1; \
+        if (LESS(a[mid], a[0])) TYPED_SWAP(T, a[mid], a[0]); \
+        if (LESS(a[n - 1], a[mid])) TYPED_SWAP(T, a[n - 1], a[mid]); \
+        if (LESS(a[mid], a[0])) TYPED_SWAP(T, a[mid], a[0]); \
+        T pivot = a[mid]; \
+        while (true) { \
+            while (LESS(a[i], pivot)) i++; \
+            while (LESS(pivot, a[j])) j--; \
+            if (i >= j) break; \
+            TYPED_SWAP(T, a[i], a[j]); \
+            i++; \
+            j--; \
+        } \
+        size_t left = j + 1; \
+        if (left < n - left) { \
+            NAME##__intro_sort(a, left, depth); \
+            a += left; \
+            n -= left; \
+        } else { \
+            NAME##__intro_sort(a + left, n - left, depth); \
+            n = left; \
+        } \
+    } \
+    NAME##__insertion_sort(a, n); \
+} \
+\
+static inline void NAME##__typed_sort(T *a, const size_t n) { \
+    unsigned int depth = 0; \
+    for (size_t k = n; k > 1; k >>= 1) { \
+        depth += 2; \
+    } \
+    NAME##__intro_sort(a, n, depth); \
+}
+
 #endif
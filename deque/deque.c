@@ -0,0 +1,424 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "deque.h"
+#include "../common/vec.h"
+
+#define DEFAULT_DEQUE_CAPACITY 2
+
+///////////////////////////////////////////////////////////////////////////////
+///     DEQUE STRUCTURE
+///////////////////////////////////////////////////////////////////////////////
+
+struct DequeSt
+{
+    elem_t *elems;
+    size_t front;
+    size_t back;
+    size_t length;
+    size_t capacity;
+    size_t elem_size;
+    allocator_t allocator;
+    char copy_enabled;
+    copy_operator_t operator_copy;
+    delete_operator_t operator_delete;
+    copy_n_operator_t operator_copy_n;
+    delete_n_operator_t operator_delete_n;
+    size_operator_t operator_size;
+    Arena arena;
+    PtrSet seen;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+///     DEQUE MACRO UTILITARIES
+///////////////////////////////////////////////////////////////////////////////
+
+static inline elem_t id(elem_t e) {
+    return e;
+}
+
+static inline void skip(elem_t e) {
+    return;
+}
+
+/**
+ * Macro to allocate all memory used by the deque, the capacity is rounded up to a power of two
+ */
+#define DEQUE_INIT(__allocator, __copy_op, __delete_op, __n_elems) \
+({ \
+    allocator_t __alloc = (__allocator); \
+    size_t __capacity = NEXT_POW2((__n_elems) < DEFAULT_DEQUE_CAPACITY ? DEFAULT_DEQUE_CAPACITY : (__n_elems)); \
+    Deque __ptr = __capacity ? ALLOC(__alloc, sizeof(struct DequeSt)) : NULL; \
+    if (__ptr) { \
+        __ptr->allocator = __alloc; \
+        __ptr->elem_size = 0; \
+        __ptr->operator_size = NULL; \
+        __ptr->arena = NULL; \
+        __ptr->seen = NULL; \
+        __ptr->elems = ALLOC(__alloc, sizeof(elem_t) * __capacity); \
+        if (__ptr->elems) { \
+            __ptr->front = 0; \
+            __ptr->back = 0; \
+            __ptr->length = 0; \
+            __ptr->capacity = __capacity; \
+            __ptr->copy_enabled = __copy_op ? true : false; \
+            __ptr->operator_copy = __copy_op ? __copy_op : id; \
+            __ptr->operator_delete = __delete_op ? __delete_op : skip; \
+            __ptr->operator_copy_n = NULL; \
+            __ptr->operator_delete_n = NULL; \
+        } else { \
+            DEALLOC(__alloc, __ptr); \
+            __ptr = NULL; \
+        } \
+    } \
+    __ptr; \
+})
+
+///////////////////////////////////////////////////////////////////////////////
+///     DEQUE FUNCTIONS TO EXPORT
+///////////////////////////////////////////////////////////////////////////////
+
+Deque deque__empty_copy_disabled(void) {
+    return DEQUE_INIT(DEFAULT_ALLOCATOR, NULL, NULL, DEFAULT_DEQUE_CAPACITY);
+}
+
+Deque deque__empty_copy_enabled(const copy_operator_t copy_op, const delete_operator_t delete_op) {
+    if (!copy_op || !delete_op) return NULL;
+
+    return DEQUE_INIT(DEFAULT_ALLOCATOR, copy_op, delete_op, DEFAULT_DEQUE_CAPACITY);
+}
+
+Deque deque__empty_copy_enabled_n(const copy_operator_t copy_op, const delete_operator_t delete_op,
+                                  const copy_n_operator_t copy_n_op, const delete_n_operator_t delete_n_op) {
+    if (!copy_op || !delete_op) return NULL;
+
+    Deque d = DEQUE_INIT(DEFAULT_ALLOCATOR, copy_op, delete_op, DEFAULT_DEQUE_CAPACITY);
+    if (d) {
+        d->operator_copy_n = copy_n_op;
+        d->operator_delete_n = delete_n_op;
+    }
+
+    return d;
+}
+
+inline char deque__is_copy_enabled(const Deque d) {
+    return !d ? FAILURE : d->copy_enabled;
+}
+
+inline char deque__is_empty(const Deque d) {
+    return !d ? FAILURE : !d->length;
+}
+
+inline size_t deque__length(const Deque d) {
+    return !d ? SIZE_MAX : d->length;
+}
+
+char deque__push_front(const Deque d, const elem_t element) {
+    if (!d) return FAILURE;
+
+    if (RING_ENSURE_CAPACITY(d, DEFAULT_POLICY(DEFAULT_DEQUE_CAPACITY)) < 0) return FAILURE;
+
+    d->front = (d->front - 1) & RING_MASK(d);
+    d->elems[d->front] = d->operator_copy(element);
+    d->length++;
+
+    return SUCCESS;
+}
+
+char deque__push_back(const Deque d, const elem_t element) {
+    if (!d) return FAILURE;
+
+    if (RING_ENSURE_CAPACITY(d, DEFAULT_POLICY(DEFAULT_DEQUE_CAPACITY)) < 0) return FAILURE;
+
+    d->elems[d->back] = d->operator_copy(element);
+    d->back = (d->back + 1) & RING_MASK(d);
+    d->length++;
+
+    return SUCCESS;
+}
+
+char deque__pop_front(const Deque d, elem_t *front) {
+    if (!d || !d->length) return FAILURE;
+
+    if (front) {
+        *front = d->elems[d->front];
+    } else {
+        d->operator_delete(d->elems[d->front]);
+    }
+
+    d->front = (d->front + 1) & RING_MASK(d);
+    d->length--;
+
+    RING_SHRINK(d, DEFAULT_POLICY(DEFAULT_DEQUE_CAPACITY));
+
+    return SUCCESS;
+}
+
+char deque__pop_back(const Deque d, elem_t *back) {
+    if (!d || !d->length) return FAILURE;
+
+    d->back = (d->back - 1) & RING_MASK(d);
+
+    if (back) {
+        *back = d->elems[d->back];
+    } else {
+        d->operator_delete(d->elems[d->back]);
+    }
+
+    d->length--;
+
+    RING_SHRINK(d, DEFAULT_POLICY(DEFAULT_DEQUE_CAPACITY));
+
+    return SUCCESS;
+}
+
+char deque__remove_nth(const Deque d, const size_t i) {
+    if (!d || i >= d->length) return FAILURE;
+
+    d->operator_delete(d->elems[RING_INDEX(d, i)]);
+    d->elems[RING_INDEX(d, i)] = NULL;
+
+    return SUCCESS;
+}
+
+char deque__peek_front(const Deque d, elem_t *front) {
+    if (!d || !d->length || !front) return FAILURE;
+
+    *front = d->operator_copy(d->elems[d->front]);
+
+    return SUCCESS;
+}
+
+char deque__peek_back(const Deque d, elem_t *back) {
+    if (!d || !d->length || !back) return FAILURE;
+
+    *back = d->operator_copy(d->elems[RING_INDEX(d, d->length - 1)]);
+
+    return SUCCESS;
+}
+
+char deque__peek_nth(const Deque d, const size_t i, elem_t *nth) {
+    if (!d || !d->length || !nth || i >= d->length) return FAILURE;
+
+    *nth = d->operator_copy(d->elems[RING_INDEX(d, i)]);
+
+    return SUCCESS;
+}
+
+char deque__swap(const Deque d, const size_t i, const size_t j) {
+    if (!d || i >= d->length || j >= d->length) return FAILURE;
+
+    SWAP(d, RING_INDEX(d, i), RING_INDEX(d, j));
+
+    return SUCCESS;
+}
+
+Deque deque__copy(const Deque d) {
+    if (!d) return NULL;
+
+    Deque copy = DEQUE_INIT(d->allocator, d->operator_copy, d->operator_delete, d->length);
+    if (!copy) return NULL;
+
+    RING_COPY(copy, 0, d);
+
+    copy->front = 0;
+    copy->back = d->length & RING_MASK(copy);
+
+    return copy;
+}
+
+Deque deque__from_array(Deque d, void *A, const size_t n_elems, const size_t size) {
+    if (!A) return NULL;
+
+    if (!d) {
+        if (!(d = DEQUE_INIT(DEFAULT_ALLOCATOR, NULL, NULL, n_elems))) return NULL;
+    } else {
+        if (d->length + n_elems > d->capacity && RING_RESIZE(d, NEXT_POW2(d->length + n_elems)) < 0) return NULL;
+    }
+
+    RING_FROM_ARRAY(d, A, n_elems, size);
+
+    return d;
+}
+
+elem_t *deque__dump(const Deque d) {
+    if (!d || !d->length) return NULL;
+
+    elem_t *res = malloc(sizeof(elem_t) * d->length);
+    if (!res) return NULL;
+
+    RING_LINEARIZE(d);
+    memcpy(res, d->elems + d->front, sizeof(elem_t) * d->length);
+    RESIZE(d, DEFAULT_DEQUE_CAPACITY);
+
+    d->front = 0;
+    d->back = 0;
+    d->length = 0;
+
+    return res;
+}
+
+elem_t *deque__to_array(const Deque d) {
+    if (!d || !d->length) return NULL;
+
+    elem_t *res = malloc(sizeof(elem_t) * d->length);
+    if (!res) return NULL;
+
+    size_t head = RING_HEAD_END(d) - d->front;
+    if (d->copy_enabled) {
+        COPY_N(d, res, d->elems + d->front, head);
+        COPY_N(d, res + head, d->elems, RING_TAIL_END(d));
+    } else {
+        memcpy(res, d->elems + d->front, sizeof(elem_t) * head);
+        memcpy(res + head, d->elems, sizeof(elem_t) * RING_TAIL_END(d));
+    }
+
+    return res;
+}
+
+size_t deque__ptr_search(const Deque d, const elem_t elem) {
+    if (!d) return SIZE_MAX;
+
+    return RING_SEARCH_ON_RUNS(d, PTR_SEARCH, elem);
+}
+
+size_t deque__search(const Deque d, const elem_t elem, const compare_func_t match) {
+    if (!d || !match) return SIZE_MAX;
+
+    return RING_SEARCH_ON_RUNS(d, SEARCH, elem, match);
+}
+
+char deque__ptr_contains(const Deque d, const elem_t elem) {
+    if (!d) return FAILURE;
+
+    return RING_SEARCH_ON_RUNS(d, PTR_SEARCH, elem) != SIZE_MAX;
+}
+
+char deque__contains(const Deque d, const elem_t elem, const compare_func_t match) {
+    if (!d || !match) return FAILURE;
+
+    return RING_SEARCH_ON_RUNS(d, SEARCH, elem, match) != SIZE_MAX;
+}
+
+char deque__cmp(const Deque d, const Deque e, const compare_func_t match) {
+    if (!d || !e || !match) return FAILURE;
+
+    if (d == e) return true;
+    if (d->length != e->length) return false;
+
+    return RING_ARRAY_CMP(d, e, match);
+}
+
+void deque__foreach(const Deque d, const applying_func_t func, void *user_data) {
+    if (!d || !func) return;
+
+    if (!d->copy_enabled && !d->elem_size && !d->seen) {
+        d->seen = ptr_set__empty(&d->allocator);
+    }
+    RING_FOREACH(d, func, user_data, d->seen);
+}
+
+void deque__foreach_all(const Deque d, const applying_func_t func, void *user_data) {
+    if (!d || !func) return;
+
+    RING_FOREACH_ALL(d, func, user_data);
+}
+
+void deque__filter(const Deque d, const filter_func_t pred, void *user_data) {
+    if (!d || !pred) return;
+
+    RING_LINEARIZE(d);
+    FILTER(d, d->front, d->front + d->length, pred, user_data);
+
+    d->back = (d->front + d->length) & RING_MASK(d);
+}
+
+char deque__all(const Deque d, const filter_func_t pred, void *user_data) {
+    if (!d || !pred) return FAILURE;
+
+    return RING_ON_RUNS(d, &&, ALL, pred, user_data);
+}
+
+char deque__any(const Deque d, const filter_func_t pred, void *user_data) {
+    if (!d || !pred) return FAILURE;
+
+    return RING_ON_RUNS(d, ||, ANY, pred, user_data);
+}
+
+void deque__reverse(const Deque d) {
+    if (!d || d->length < 2) return;
+
+    for (size_t i = 0, j = d->length - 1; i < j; i++, j--) {
+        SWAP(d, RING_INDEX(d, i), RING_INDEX(d, j));
+    }
+}
+
+void deque__shuffle(const Deque d, const unsigned int seed) {
+    if (!d) return;
+
+    RING_LINEARIZE(d);
+    SHUFFLE(d, d->front, d->front + d->length, seed);
+}
+
+void deque__sort(const Deque d, const compare_func_t cmp) {
+    if (!d || !cmp) return;
+
+    RING_LINEARIZE(d);
+    qsort(d->elems + d->front, d->length, sizeof(elem_t), cmp);
+}
+
+void deque__clean_NULL(const Deque d) {
+    if (!d) return;
+
+    RING_LINEARIZE(d);
+    CLEAN_NULL_ELEMS(d, d->front, d->front + d->length);
+
+    d->back = (d->front + d->length) & RING_MASK(d);
+}
+
+void deque__clear(const Deque d) {
+    if (!d) return;
+
+    RING_FREE_ELEMS(d);
+    RESIZE(d, DEFAULT_DEQUE_CAPACITY);
+}
+
+void deque__free(const Deque d) {
+    if (!d) return;
+
+    RING_FREE_ELEMS(d);
+
+    ptr_set__free(d->seen);
+    allocator_t allocator = d->allocator;
+    DEALLOC(allocator, d->elems);
+    DEALLOC(allocator, d);
+}
+
+void deque__debug(const Deque d, const debug_func_t debug) {
+    setvbuf (stdout, NULL, _IONBF, 0);
+
+    printf("\n");
+    if (!d) {
+        printf("\tInvalid deque (NULL)");
+    } else if (!debug) {
+        printf("\tInvalid degug function (NULL)");
+    } else {
+        deque__is_copy_enabled(d) ? printf("\tDeque with copy enabled:")
+                                  : printf("\tDeque with copy disabled:");
+        printf("\n\tDeque size: %lu\n\tDeque capacity: %lu\n\tDeque front: %lu\n\tDeque back: %lu\n\tDeque content: \n\t", d->length
+                                                                                                                         , d->capacity
+                                                                                                                         , d->front
+                                                                                                                         , d->back);
+        printf("{ ");
+        for (size_t i = 0; i < d->capacity; i++) {
+            if (((i - d->front) & RING_MASK(d)) < d->length) {
+                debug(d->elems[i]);
+            } else {
+                printf("_ ");
+            }
+        }
+        printf("}");
+    }
+    printf("\n");
+}
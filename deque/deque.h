@@ -0,0 +1,411 @@
+#ifndef __DEQUE_H__
+#define __DEQUE_H__
+
+#include "../common/defs.h"
+
+
+/**
+ * Implementation of a double ended queue Abstract Data Type
+ *
+ * Notes :
+ * 1) You have to correctly implement copy, delete and debug operators
+ * by handling NULL value, otherwise you can end up with an undefined behaviour.
+ * The prototypes of these functions are:
+ * elem_t (*copy_op)(elem_t)
+ * void (*delete_op)(elem_t)
+ * void (*debug_op)(elem_t)
+ *
+ * 2) 'deque__peek_front', 'deque__peek_back', 'deque__peek_nth', 'deque__pop_front' and 'deque__pop_back' return a dynamically allocated pointer to an element of
+ * the deque in order to make it survive independently of the deque life cycle.
+ * The user has to manually free the return pointer after usage.
+ *
+ * 3) The deque is stored as a ring buffer with a power of two capacity, positions given to or returned by
+ * the deque functions are always relative to the front of the deque (0 is the front element).
+ *
+ * 4) A deque created by 'deque__empty_copy_enabled_n' is also given batch copy and delete operators, called once
+ * per contiguous run of elements by the functions handling several elements at once (copy, from_array, to_array,
+ * filter, clear and free), so that the copies can be allocated or released together. Either of them may be NULL,
+ * the functions then call the operator of a single element on each element of the run. The prototypes of these
+ * functions are:
+ * void (*copy_n_op)(elem_t *dst, const elem_t *src, size_t n)
+ * void (*delete_n_op)(elem_t *elems, size_t n)
+ * 'dst' and 'src' may be the same array, the copies then replace the originals.
+ *
+ * 5) Only the functions writing to the ring buffer move the stored elements: push_front, push_back and from_array
+ * may move the slots to a larger array, pop_front, pop_back, remove_nth, dump, clear and free delete or hand over
+ * the elements, and swap, filter, reverse, shuffle, sort and clean_NULL change what a slot holds. The other
+ * functions (peek, search, contains, cmp, all, any, copy, to_array and the foreach functions) read the slots in
+ * place, a position returned by a search stays valid until one of the functions above is called.
+ */
+typedef struct DequeSt * Deque;
+
+
+/**
+ * @brief create an empty deque with copy disabled
+ * @note complexity: O(1)
+ * @return a pointer to deque on success, NULL on failure
+ */
+Deque deque__empty_copy_disabled(void);
+
+
+/**
+ * @brief create an empty deque with copy enabled
+ * @note complexity: O(1)
+ * @param copy_op copy operator
+ * @param delete_op delete operator
+ * @return a pointer to deque on success, NULL on failure
+ */
+Deque deque__empty_copy_enabled(const copy_operator_t copy_op, const delete_operator_t delete_op);
+
+
+/**
+ * @brief create an empty deque with copy enabled and batch copy and delete operators
+ * @note complexity: O(1)
+ * @param copy_op copy operator
+ * @param delete_op delete operator
+ * @param copy_n_op batch copy operator, may be NULL
+ * @param delete_n_op batch delete operator, may be NULL
+ * @return a pointer to deque on success, NULL on failure
+ */
+Deque deque__empty_copy_enabled_n(const copy_operator_t copy_op, const delete_operator_t delete_op,
+                                  const copy_n_operator_t copy_n_op, const delete_n_operator_t delete_n_op);
+
+
+/**
+ * @brief checks if the deque has the copy operator enabled
+ * @note complexity: O(1)
+ * @param d the deque
+ * @return 1 if the deque has copy enabled, 0 if not, -1 on failure
+ */
+char deque__is_copy_enabled(const Deque d);
+
+
+/**
+ * @brief checks if the deque is empty
+ * @note complexity: O(1)
+ * @param d the deque
+ * @return 1 if the deque is empty, 0 if not, -1 on failure
+ */
+char deque__is_empty(const Deque d);
+
+
+/**
+ * @brief number of elements in the deque
+ * @note complexity: O(1)
+ * @param d the deque
+ * @return  the number of elements contained in the deque on success, SIZE_MAX on failure
+ */
+size_t deque__length(const Deque d);
+
+
+/**
+ * @brief adds an element at the front of the deque
+ * @note complexity: O(1)
+ * @param d the deque
+ * @param element the element to add
+ * @return 0 on success, -1 on failure
+ */
+char deque__push_front(const Deque d, const elem_t element);
+
+
+/**
+ * @brief adds an element at the back of the deque
+ * @note complexity: O(1)
+ * @param d the deque
+ * @param element the element to add
+ * @return 0 on success, -1 on failure
+ */
+char deque__push_back(const Deque d, const elem_t element);
+
+
+/**
+ * @brief retrieve a copy of the front element (similar to 'deque__peek_front' but the element is removed of the deque)
+ * @details the element is stored in 'front' variable and must be manually freed by user afterward
+ * @note complexity: O(1)
+ * @param d the deque
+ * @param front pointer to storage variable
+ * @return 0 on success, -1 on failure
+ */
+char deque__pop_front(const Deque d, elem_t *front);
+
+
+/**
+ * @brief retrieve a copy of the back element (similar to 'deque__peek_back' but the element is removed of the deque)
+ * @details the element is stored in 'back' variable and must be manually freed by user afterward
+ * @note complexity: O(1)
+ * @param d the deque
+ * @param back pointer to storage variable
+ * @return 0 on success, -1 on failure
+ */
+char deque__pop_back(const Deque d, elem_t *back);
+
+
+/**
+ * @brief remove the element in the nth position
+ * @details the deleted item is still part of the deque as a null value instead
+ * @note complexity: O(1)
+ * @param d the deque
+ * @param i position
+ * @return 0 on success, -1 on failure
+ */
+char deque__remove_nth(const Deque d, const size_t i);
+
+
+/**
+ * @brief retrieve the element on the front of the deque without removing it
+ * @details the element is stored in 'front' variable and must be manually freed by user afterward
+ * @note complexity: O(1)
+ * @param d the deque
+ * @param front pointer to storage variable
+ * @return 0 on success, -1 on failure
+ */
+char deque__peek_front(const Deque d, elem_t *front);
+
+
+/**
+ * @brief retrieve the element on the back of the deque without removing it
+ * @details the element is stored in 'back' variable and must be manually freed by user afterward
+ * @note complexity: O(1)
+ * @param d the deque
+ * @param back pointer to storage variable
+ * @return 0 on success, -1 on failure
+ */
+char deque__peek_back(const Deque d, elem_t *back);
+
+
+/**
+ * @brief Retrieve the element at 'i' position of the deque without removing it
+ * @details The element is stored in 'nth' variable and must be manually freed by user afterward
+ * @note complexity: O(1)
+ * @param d the deque
+ * @param i position
+ * @param nth pointer to storage variable
+ * @return 0 on success, -1 on failure
+ */
+char deque__peek_nth(const Deque d, const size_t i, elem_t *nth);
+
+
+/**
+ * @brief swaps two elements of the deque
+ * @note complexity: O(1)
+ * @param d the deque
+ * @param i position of the first element
+ * @param j position of the second element
+ * @return 0 on success, -1 on failure
+ */
+char deque__swap(const Deque d, const size_t i, const size_t j);
+
+
+/**
+ * @brief retrieves a copy of the entire deque
+ * @details if copy is enabled the new one contains a copy of all elements of the original deque
+ * @note complexity: O(n)
+ * @param d the deque
+ * @return a pointer to deque on success, NULL on failure
+ */
+Deque deque__copy(const Deque d);
+
+
+/**
+ * @brief pushes at the back the first 'n_elems' elements of the given array
+ * @details if d == NULL creates a new deque with copy disabled by default
+ * @details if A == NULL returns the deque unaltered
+ * @note complexity: O(n)
+ * @param d the deque
+ * @param A the array
+ * @param n_elems number of elements to push, must be less than or equal to the length of the array
+ * @param size byte size of the elements contained in the given array
+ * @return a pointer to deque on success, NULL on failure
+ */
+Deque deque__from_array(Deque d, void *A, const size_t n_elems, const size_t size);
+
+
+/**
+ * @brief dump all elements of the deque into an array
+ * @details the array must be manually freed by user afterward, the deque is empty after use of this function
+ * @note complexity: O(n)
+ * @param d the deque
+ * @return a pointer to dynamically allocated array on success, NULL on failure
+ */
+elem_t *deque__dump(const Deque d);
+
+
+/**
+ * @brief retrieves a copy of all items in a deque stored in array
+ * @details the array must be manually freed by user afterward
+ * @note complexity: O(n)
+ * @param d the deque
+ * @return a pointer to dynamically allocated array on success, NULL on failure
+ */
+elem_t *deque__to_array(const Deque d);
+
+
+/**
+ * @brief search the given pointer
+ * @note complexity: O(n)
+ * @param d the deque
+ * @param elem the pointer to search
+ * @return the position of the pointer in the deque if it is contained in it, SIZE_MAX if not, SIZE_MAX on failure
+ */
+size_t deque__ptr_search(const Deque d, const elem_t elem);
+
+
+/**
+ * @brief search the given element
+ * @note complexity: O(n)
+ * @param d the deque
+ * @param elem the element to search
+ * @param match the matching function
+ * @return the position of the element in the deque if it is contained in it, SIZE_MAX if not, SIZE_MAX on failure
+ */
+size_t deque__search(const Deque d, const elem_t elem, const compare_func_t match);
+
+
+/**
+ * @brief checks if a given pointer is on the deque
+ * @note complexity: O(n)
+ * @param d the deque
+ * @param elem the pointer
+ * @return 1 if the pointer is on the deque, 0 if not, -1 on failure
+ */
+char deque__ptr_contains(const Deque d, const elem_t elem);
+
+
+/**
+ * @brief checks if a given element is on the deque
+ * @note complexity: O(n)
+ * @param d the deque
+ * @param elem the element
+ * @param match the matching function
+ * @return 1 if the element is on the deque, 0 if not, -1 on failure
+ */
+char deque__contains(const Deque d, const elem_t elem, const compare_func_t match);
+
+
+/**
+ * @brief compare two deques including all their elements
+ * @note complexity: O(n)
+ * @param d first deque
+ * @param e second deque
+ * @param match the matching function
+ * @return 1 if the deques are equal including all their elements, 0 if not, -1 on failure
+ */
+char deque__cmp(const Deque d, const Deque e, const compare_func_t match);
+
+
+/**
+ * @brief verifies that all elements of the deque satisfy the predicate
+ * @note complexity: O(n)
+ * @param d the deque
+ * @param pred the predicate
+ * @param user_data optional data to be used as an additional argument of the predicate
+ * @return 1 if all elements satisfy the predicate, 0 if not, -1 on failure
+ */
+char deque__all(const Deque d, const filter_func_t pred, void *user_data);
+
+
+/**
+ * @brief verifies that at least one element of the deque satisfies the predicate
+ * @note complexity: O(n)
+ * @param d the deque
+ * @param pred the predicate
+ * @param user_data optional data to be used as an additional argument of the predicate
+ * @return 1 if any element satisfies the predicate , 0 if not, -1 on failure
+ */
+char deque__any(const Deque d, const filter_func_t pred, void *user_data);
+
+
+/**
+ * @brief maps the given function to the deque
+ * @details with copy disabled, a pointer stored several times is given to the function once, the pointers
+ * already visited are remembered in a scratch table kept by the deque until 'free'
+ * @note complexity: O(n), on average with copy disabled
+ * @param d the deque
+ * @param func the applying function
+ * @param user_data optional data to be used as an additional argument of the application function
+ */
+void deque__foreach(const Deque d, const applying_func_t func, void *user_data);
+
+
+/**
+ * @brief maps the given function to every element of the deque, including the pointers stored several times
+ * @details same as 'deque__foreach' with copy enabled, for copy disabled deques whose pointers are known to be unique
+ * @note complexity: O(n)
+ * @param d the deque
+ * @param func the applying function
+ * @param user_data optional data to be used as an additional argument of the application function
+ */
+void deque__foreach_all(const Deque d, const applying_func_t func, void *user_data);
+
+
+/**
+ * @brief filter the given deque using a predicate
+ * @note complexity: O(n)
+ * @param d the deque
+ * @param pred the predicate
+ * @param user_data optional data to be used as an additional argument of the predicate
+ */
+void deque__filter(const Deque d, const filter_func_t pred, void *user_data);
+
+
+/**
+ * @brief reverse the deque
+ * @note complexity: O(n)
+ * @param d the deque
+ */
+void deque__reverse(const Deque d);
+
+
+/**
+ * @brief shuffles the deque
+ * @note complexity: O(n)
+ * @param d the deque
+ * */
+void deque__shuffle(const Deque d, const unsigned int seed);
+
+
+/**
+ * @brief uses qsort to sort the deque elements using the given compare function
+ * @note complexity: O(n*log(n))
+ * @param d the deque
+ * @param cmp the compare function
+ */
+void deque__sort(const Deque d, const compare_func_t cmp);
+
+
+/**
+ * @brief removes all NULL pointers in the deque
+ * @note complexity: O(n)
+ * @param d the deque
+ */
+void deque__clean_NULL(const Deque d);
+
+
+/**
+ * @brief removes all elements in the deque
+ * @details if copy is enabled frees all allocated memory used by these elements, the deque is still usable afterwards
+ * @note complexity: O(n) with copy enabled, O(1) with copy disabled
+ * @param d the deque
+ */
+void deque__clear(const Deque d);
+
+
+/**
+ * @brief frees all allocated memory used by the deque
+ * @details if copy is enabled frees all memory used by the elements in the deque
+ * @note complexity: O(n) with copy enabled, O(1) with copy disabled
+ * @param d the deque
+ */
+void deque__free(const Deque d);
+
+
+/**
+ * @brief prints the deque's content
+ * @note complexity: O(n)
+ * @param d the deque
+ * @param debug the debug function
+ */
+void deque__debug(const Deque d, const debug_func_t debug);
+
+
+#endif
@@ -0,0 +1,202 @@
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+
+#include "mpmc_queue.h"
+#include "../common/vec.h"
+
+#define MPMC_SPIN_LIMIT 64
+
+///////////////////////////////////////////////////////////////////////////////
+///     MPMC QUEUE STRUCTURE
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A slot can be written at position 'p' when its sequence equals 'p',
+ * and read at position 'p' when its sequence equals 'p + 1'
+ */
+typedef struct
+{
+    atomic_size_t sequence;
+    elem_t elem;
+} slot_t;
+
+struct MpmcQueueSt
+{
+    slot_t *slots;
+    size_t capacity;
+    char copy_enabled;
+    copy_operator_t operator_copy;
+    delete_operator_t operator_delete;
+
+    _Alignas(CACHE_LINE_SIZE) atomic_size_t enqueue_pos;
+
+    _Alignas(CACHE_LINE_SIZE) atomic_size_t dequeue_pos;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+///     MPMC QUEUE MACRO UTILITARIES
+///////////////////////////////////////////////////////////////////////////////
+
+static inline elem_t id(elem_t e) {
+    return e;
+}
+
+static inline void skip(elem_t e) {
+    return;
+}
+
+/**
+ * Macro to allocate all memory used by the queue, the capacity is rounded up to a power of two of at least 2
+ * slots: with a single slot the sequence of a full slot equals the next enqueue position
+ */
+#define MPMC_QUEUE_INIT(__copy_op, __delete_op, __n_elems) \
+({ \
+    size_t __capacity = NEXT_POW2((__n_elems) > 2 ? (__n_elems) : 2); \
+    MpmcQueue __ptr = __capacity ? aligned_alloc(CACHE_LINE_SIZE, sizeof(struct MpmcQueueSt)) : NULL; \
+    if (__ptr) { \
+        __ptr->slots = malloc(sizeof(slot_t) * __capacity); \
+        if (__ptr->slots) { \
+            for (size_t i = 0; i < __capacity; i++) { \
+                atomic_init(&__ptr->slots[i].sequence, i); \
+            } \
+            __ptr->capacity = __capacity; \
+            __ptr->copy_enabled = __copy_op ? true : false; \
+            __ptr->operator_copy = __copy_op ? __copy_op : id; \
+            __ptr->operator_delete = __delete_op ? __delete_op : skip; \
+            atomic_init(&__ptr->enqueue_pos, 0); \
+            atomic_init(&__ptr->dequeue_pos, 0); \
+        } else { \
+            free(__ptr); \
+            __ptr = NULL; \
+        } \
+    } \
+    __ptr; \
+})
+
+/**
+ * Macro to claim the slot at the current position of '__pos' once its sequence reaches 'position + __offset',
+ * evaluates to NULL if the slot is still used by the other side (queue full or empty)
+ */
+#define MPMC_CLAIM(__ptr, __pos, __offset) \
+({ \
+    slot_t *__slot = NULL; \
+    size_t __position = atomic_load_explicit(&(__ptr)->__pos, memory_order_relaxed); \
+    for (;;) { \
+        slot_t *__candidate = &(__ptr)->slots[__position & ((__ptr)->capacity - 1)]; \
+        size_t __seq = atomic_load_explicit(&__candidate->sequence, memory_order_acquire); \
+        intptr_t __diff = (intptr_t)__seq - (intptr_t)(__position + (__offset)); \
+        if (!__diff) { \
+            if (atomic_compare_exchange_weak_explicit(&(__ptr)->__pos, &__position, __position + 1, \
+                                                      memory_order_relaxed, memory_order_relaxed)) { \
+                __slot = __candidate; \
+                break; \
+            } \
+        } else if (__diff < 0) { \
+            break; \
+        } else { \
+            __position = atomic_load_explicit(&(__ptr)->__pos, memory_order_relaxed); \
+        } \
+    } \
+    __slot; \
+})
+
+/**
+ * Macro to retry '__try' until it succeeds, spinning first and then yielding the processor
+ */
+#define MPMC_WAIT(__try) \
+({ \
+    size_t __spins = 0; \
+    while ((__try) < 0) { \
+        if (++__spins > MPMC_SPIN_LIMIT) { \
+            sched_yield(); \
+        } \
+    } \
+    (char)SUCCESS; \
+})
+
+///////////////////////////////////////////////////////////////////////////////
+///     MPMC QUEUE FUNCTIONS TO EXPORT
+///////////////////////////////////////////////////////////////////////////////
+
+MpmcQueue mpmc_queue__empty_copy_disabled(const size_t capacity) {
+    return MPMC_QUEUE_INIT(NULL, NULL, capacity);
+}
+
+MpmcQueue mpmc_queue__empty_copy_enabled(const size_t capacity, const copy_operator_t copy_op, const delete_operator_t delete_op) {
+    if (!copy_op || !delete_op) return NULL;
+
+    return MPMC_QUEUE_INIT(copy_op, delete_op, capacity);
+}
+
+inline char mpmc_queue__is_copy_enabled(const MpmcQueue q) {
+    return !q ? FAILURE : q->copy_enabled;
+}
+
+inline size_t mpmc_queue__capacity(const MpmcQueue q) {
+    return !q ? SIZE_MAX : q->capacity;
+}
+
+size_t mpmc_queue__length(const MpmcQueue q) {
+    if (!q) return SIZE_MAX;
+
+    size_t head = atomic_load_explicit(&q->dequeue_pos, memory_order_acquire);
+    size_t tail = atomic_load_explicit(&q->enqueue_pos, memory_order_acquire);
+
+    return tail > head ? tail - head : 0;
+}
+
+char mpmc_queue__try_enqueue(const MpmcQueue q, const elem_t element) {
+    if (!q) return FAILURE;
+
+    slot_t *slot = MPMC_CLAIM(q, enqueue_pos, 0);
+    if (!slot) return FAILURE;
+
+    size_t position = atomic_load_explicit(&slot->sequence, memory_order_relaxed);
+    slot->elem = q->operator_copy(element);
+    atomic_store_explicit(&slot->sequence, position + 1, memory_order_release);
+
+    return SUCCESS;
+}
+
+char mpmc_queue__enqueue(const MpmcQueue q, const elem_t element) {
+    if (!q) return FAILURE;
+
+    return MPMC_WAIT(mpmc_queue__try_enqueue(q, element));
+}
+
+char mpmc_queue__try_dequeue(const MpmcQueue q, elem_t *front) {
+    if (!q) return FAILURE;
+
+    slot_t *slot = MPMC_CLAIM(q, dequeue_pos, 1);
+    if (!slot) return FAILURE;
+
+    size_t position = atomic_load_explicit(&slot->sequence, memory_order_relaxed) - 1;
+    elem_t elem = slot->elem;
+    atomic_store_explicit(&slot->sequence, position + q->capacity, memory_order_release);
+
+    if (front) {
+        *front = elem;
+    } else {
+        q->operator_delete(elem);
+    }
+
+    return SUCCESS;
+}
+
+char mpmc_queue__dequeue(const MpmcQueue q, elem_t *front) {
+    if (!q) return FAILURE;
+
+    return MPMC_WAIT(mpmc_queue__try_dequeue(q, front));
+}
+
+void mpmc_queue__free(const MpmcQueue q) {
+    if (!q) return;
+
+    if (q->copy_enabled) {
+        while (!mpmc_queue__try_dequeue(q, NULL));
+    }
+
+    free(q->slots);
+    free(q);
+}
@@ -0,0 +1,130 @@
+#ifndef __MPMC_QUEUE_H__
+#define __MPMC_QUEUE_H__
+
+#include <stddef.h>
+
+#include "../common/defs.h"
+
+
+/**
+ * Implementation of a bounded lock-free FIFO Abstract Data Type shared by any number of producer
+ * and consumer threads
+ *
+ * Notes :
+ * 1) You have to correctly implement copy and delete operators
+ * by handling NULL value, otherwise you can end up with an undefined behaviour.
+ * The prototypes of these functions are:
+ * elem_t (*copy_op)(elem_t)
+ * void (*delete_op)(elem_t)
+ *
+ * 2) Enqueue and dequeue functions are safe to call from any thread at the same time,
+ * 'mpmc_queue__free' must not run concurrently with them.
+ *
+ * 3) With copy enabled the copy is made by the producer when enqueuing, the element retrieved
+ * by a consumer is that copy and the user has to manually free it after usage.
+ *
+ * 4) Blocking functions busy wait, yielding the processor between attempts.
+ */
+typedef struct MpmcQueueSt * MpmcQueue;
+
+
+/**
+ * @brief create an empty bounded queue with copy disabled
+ * @note complexity: O(n)
+ * @param capacity maximum number of elements, rounded up to a power of two, 2 at least
+ * @return a pointer to queue on success, NULL on failure
+ */
+MpmcQueue mpmc_queue__empty_copy_disabled(const size_t capacity);
+
+
+/**
+ * @brief create an empty bounded queue with copy enabled
+ * @note complexity: O(n)
+ * @param capacity maximum number of elements, rounded up to a power of two, 2 at least
+ * @param copy_op copy operator
+ * @param delete_op delete operator
+ * @return a pointer to queue on success, NULL on failure
+ */
+MpmcQueue mpmc_queue__empty_copy_enabled(const size_t capacity, const copy_operator_t copy_op, const delete_operator_t delete_op);
+
+
+/**
+ * @brief checks if the queue has the copy operator enabled
+ * @note complexity: O(1)
+ * @param q the queue
+ * @return 1 if the queue has copy enabled, 0 if not, -1 on failure
+ */
+char mpmc_queue__is_copy_enabled(const MpmcQueue q);
+
+
+/**
+ * @brief maximum number of elements the queue can hold
+ * @note complexity: O(1)
+ * @param q the queue
+ * @return the capacity of the queue on success, SIZE_MAX on failure
+ */
+size_t mpmc_queue__capacity(const MpmcQueue q);
+
+
+/**
+ * @brief number of elements in the queue
+ * @details the value is only a snapshot when producers or consumers are running
+ * @note complexity: O(1)
+ * @param q the queue
+ * @return the number of elements contained in the queue on success, SIZE_MAX on failure
+ */
+size_t mpmc_queue__length(const MpmcQueue q);
+
+
+/**
+ * @brief adds an element in the queue if there is room for it
+ * @note complexity: O(1)
+ * @param q the queue
+ * @param element the element to add
+ * @return 0 on success, -1 on failure or if the queue is full
+ */
+char mpmc_queue__try_enqueue(const MpmcQueue q, const elem_t element);
+
+
+/**
+ * @brief adds an element in the queue, waiting for room if the queue is full
+ * @note complexity: O(1) when the queue is not full
+ * @param q the queue
+ * @param element the element to add
+ * @return 0 on success, -1 on failure
+ */
+char mpmc_queue__enqueue(const MpmcQueue q, const elem_t element);
+
+
+/**
+ * @brief retrieve the front element and remove it of the queue if the queue is not empty
+ * @details the element is stored in 'front' variable and must be manually freed by user afterward if copy is enabled
+ * @note complexity: O(1)
+ * @param q the queue
+ * @param front pointer to storage variable, if NULL the element is deleted
+ * @return 0 on success, -1 on failure or if the queue is empty
+ */
+char mpmc_queue__try_dequeue(const MpmcQueue q, elem_t *front);
+
+
+/**
+ * @brief retrieve the front element and remove it of the queue, waiting for one if the queue is empty
+ * @details the element is stored in 'front' variable and must be manually freed by user afterward if copy is enabled
+ * @note complexity: O(1) when the queue is not empty
+ * @param q the queue
+ * @param front pointer to storage variable, if NULL the element is deleted
+ * @return 0 on success, -1 on failure
+ */
+char mpmc_queue__dequeue(const MpmcQueue q, elem_t *front);
+
+
+/**
+ * @brief frees all allocated memory used by the queue
+ * @details if copy is enabled frees all memory used by the elements in the queue
+ * @note complexity: O(n)
+ * @param q the queue
+ */
+void mpmc_queue__free(const MpmcQueue q);
+
+
+#endif
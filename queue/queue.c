@@ -1,11 +1,18 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
+#include <unistd.h>
 
 #include "queue.h"
 #include "../common/vec.h"
+#include "../common/parallel_sort.h"
+#include "../common/radix_sort.h"
+#include "../common/hash_index.h"
+#include "../common/stream.h"
 
 #define DEFAULT_QUEUE_CAPACITY 2
+#define SPILL_FILE_NAME "/queue_spillXXXXXX"
 
 ///////////////////////////////////////////////////////////////////////////////
 ///     QUEUE STRUCTURE
@@ -18,9 +25,50 @@ struct QueueSt
     size_t back;
     size_t length;
     size_t capacity;
+    size_t elem_size;
+    allocator_t allocator;
+    capacity_policy_t policy;
     char copy_enabled;
     copy_operator_t operator_copy;
     delete_operator_t operator_delete;
+    copy_n_operator_t operator_copy_n;
+    delete_n_operator_t operator_delete_n;
+    size_operator_t operator_size;
+    Arena arena;
+    PtrSet seen;
+    HashIndex index;
+    size_t index_base;
+    struct QueueSpillSt *spill;
+};
+
+/**
+ * Segment file of 'n_elems' elements, unlinked as soon as it is created so that it disappears with its descriptor
+ */
+typedef struct
+{
+    int fd;
+    size_t n_elems;
+    uint64_t n_bytes;
+} spill_segment_t;
+
+/**
+ * The elements of a spilling queue are, in order: the 'head_len' first elements of the ring, the elements of the
+ * segments from 'segments[first]' on, then the other elements of the ring. 'head_len' is meaningless while
+ * nothing is spilled
+ */
+struct QueueSpillSt
+{
+    char *path;
+    size_t watermark;
+    size_t seg_len;
+    elem_writer_t writer;
+    elem_reader_t reader;
+    spill_segment_t *segments;
+    size_t first;
+    size_t n_segments;
+    size_t segments_capacity;
+    size_t head_len;
+    queue_spill_stats_t stats;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -36,49 +84,740 @@ static inline void skip(elem_t e) {
 }
 
 /**
- * Macro to allocate all memory used by the queue
+ * Macro to allocate all memory used by the queue, the capacity is rounded up to a power of two
  */
-#define QUEUE_INIT(__copy_op, __delete_op, __n_elems) \
+#define QUEUE_INIT(__allocator, __copy_op, __delete_op, __size_op, __n_elems, __elem_size) \
 ({ \
-    Queue __ptr = malloc(sizeof(struct QueueSt)); \
+    allocator_t __alloc = (__allocator); \
+    size_t __capacity = NEXT_POW2((__n_elems) < DEFAULT_QUEUE_CAPACITY ? DEFAULT_QUEUE_CAPACITY : (__n_elems)); \
+    Queue __ptr = __capacity ? ALLOC(__alloc, sizeof(struct QueueSt)) : NULL; \
     if (__ptr) { \
-        __ptr->elems = malloc(sizeof(elem_t) * (__n_elems)); \
+        __ptr->allocator = __alloc; \
+        __ptr->policy = DEFAULT_POLICY(DEFAULT_QUEUE_CAPACITY); \
+        __ptr->elem_size = (__elem_size); \
+        __ptr->elems = ALLOC(__alloc, SLOT_SIZE(__ptr) * __capacity); \
         if (__ptr->elems) { \
             __ptr->front = 0; \
             __ptr->back = 0; \
             __ptr->length = 0; \
-            __ptr->capacity = (__n_elems); \
-            __ptr->copy_enabled = __copy_op ? true : false; \
-            __ptr->operator_copy = __copy_op ? __copy_op : id; \
-            __ptr->operator_delete = __delete_op ? __delete_op : skip; \
-        } else { \
-            free(__ptr); \
+            __ptr->capacity = __capacity; \
+            __ptr->copy_enabled = __copy_op || __size_op ? true : false; \
+            __ptr->operator_copy = __copy_op ? __copy_op : __size_op ? arena__clone : id; \
+            __ptr->operator_delete = __delete_op ? __delete_op : __size_op ? arena__release : skip; \
+            __ptr->operator_copy_n = NULL; \
+            __ptr->operator_delete_n = NULL; \
+            __ptr->operator_size = (__size_op); \
+            __ptr->arena = __size_op ? arena__empty() : NULL; \
+            __ptr->index = NULL; \
+            __ptr->seen = NULL; \
+            __ptr->index_base = 0; \
+            __ptr->spill = NULL; \
+        } \
+        if (!__ptr->elems || (__size_op && !__ptr->arena)) { \
+            if (__ptr->elems) DEALLOC(__alloc, __ptr->elems); \
+            DEALLOC(__alloc, __ptr); \
             __ptr = NULL; \
         } \
     } \
     __ptr; \
 })
 
+///////////////////////////////////////////////////////////////////////////////
+///     QUEUE INDEX UTILITARIES
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Positions in the hash index are the positions relative to the front plus 'index_base',
+ * which grows with the dequeues. NULL pointers are not indexed
+ */
+#define IS_INDEXED(__ptr, __i) \
+    ((__ptr)->elem_size || (__ptr)->elems[RING_INDEX(__ptr, __i)])
+
+static elem_t index_get(const void *q, size_t pos) {
+    const struct QueueSt *queue = q;
+    return ELEM(queue, RING_INDEX(queue, pos - queue->index_base));
+}
+
+static void index_remove(const Queue q, const size_t i) {
+    if (q->index && IS_INDEXED(q, i)) {
+        hash_index__remove(q->index, ELEM(q, RING_INDEX(q, i)), q->index_base + i);
+    }
+}
+
 /**
- * Macro to shift entire queue to the left of the elems array
+ * Indexes the elements from position 'start' to the back, or none of them on failure
  */
-#define QUEUE_SHIFT(__ptr) \
-    memmove(__ptr->elems, __ptr->elems + __ptr->front, sizeof(elem_t) * __ptr->length); \
-    __ptr->front = 0; \
-    __ptr->back = __ptr->length
+static char index_range(const Queue q, const size_t start) {
+    for (size_t i = start; i < q->length; i++) {
+        if (IS_INDEXED(q, i) && hash_index__insert(q->index, ELEM(q, RING_INDEX(q, i)), q->index_base + i) < 0) {
+            while (i-- > start) {
+                index_remove(q, i);
+            }
+            return FAILURE;
+        }
+    }
+    return SUCCESS;
+}
+
+/**
+ * Reindexes all the elements after they moved, the table already had room for all of them
+ */
+static void index_rebuild(const Queue q) {
+    if (!q->index) return;
+
+    hash_index__clear(q->index);
+    q->index_base = 0;
+    index_range(q, 0);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///     QUEUE SPILL UTILITARIES
+///////////////////////////////////////////////////////////////////////////////
+
+#define IS_SPILLED(__ptr) \
+    ((__ptr)->spill && (__ptr)->spill->stats.n_spilled)
+
+/**
+ * The front of the queue is in the oldest segment once the head of the ring is dequeued
+ */
+#define SPILL_HEAD_IS_EMPTY(__ptr) \
+    (IS_SPILLED(__ptr) && !(__ptr)->spill->head_len)
+
+/**
+ * The element at position 'i' is in one of the segments
+ */
+#define IS_IN_SEGMENTS(__ptr, __i) \
+    (IS_SPILLED(__ptr) && (__i) >= (__ptr)->spill->head_len \
+     && (__i) - (__ptr)->spill->head_len < (__ptr)->spill->stats.n_spilled)
+
+static inline uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * Moves 'n_elems' slots from position 'from' to position 'to', both relative to the front, the ranges may overlap
+ */
+static void ring_move(const Queue q, const size_t to, const size_t from, const size_t n_elems) {
+    size_t size = SLOT_SIZE(q);
+
+    for (size_t k = 0; k < n_elems; k++) {
+        size_t i = to > from ? n_elems - 1 - k : k;
+        memcpy(SLOT(q, RING_INDEX(q, to + i)), SLOT(q, RING_INDEX(q, from + i)), size);
+    }
+}
+
+/**
+ * Writes the 'n_elems' elements from position 'i' to the stream, inline values are written run by run
+ */
+static char write_range(const Queue q, const Stream st, const size_t i, const size_t n_elems, const elem_writer_t writer) {
+    char res = SUCCESS;
+
+    if (q->elem_size) {
+        size_t pos = RING_INDEX(q, i);
+        size_t head = n_elems < q->capacity - pos ? n_elems : q->capacity - pos;
+        res = stream__write_raw(st, SLOT(q, pos), q->elem_size * head);
+        res = res < 0 ? res : stream__write_raw(st, q->elems, q->elem_size * (n_elems - head));
+    } else {
+        for (size_t k = 0; res == SUCCESS && k < n_elems; k++) {
+            res = stream__write_elem(st, q->elems[RING_INDEX(q, i + k)], writer);
+        }
+    }
+
+    return res;
+}
+
+/**
+ * Deletes the 'n_elems' pointers built by a reader in the slots from 'pos' which were taken back from the queue,
+ * with the delete operator of the queue if it owns them and with 'delete_op' otherwise
+ */
+static void drop_slots(const Queue q, const size_t pos, const size_t n_elems, const delete_operator_t delete_op) {
+    if (q->elem_size || q->copy_enabled || !delete_op) {
+        RING_ON_SLOTS(q, pos, n_elems, RING_TAKE_RUN, NULL);
+        return;
+    }
+
+    for (size_t k = 0; k < n_elems; k++) {
+        delete_op(q->elems[(pos + k) & RING_MASK(q)]);
+    }
+}
+
+/**
+ * Reads 'n_elems' elements in the slots from 'pos' (a position in 'elems', not relative to the front),
+ * the pointers already read are deleted on failure like 'drop_slots' does
+ */
+static char read_slots(const Queue q, const Stream st, const size_t pos, const size_t n_elems, const elem_reader_t reader,
+                       const delete_operator_t delete_op) {
+    if (q->elem_size) {
+        size_t head = n_elems < q->capacity - pos ? n_elems : q->capacity - pos;
+        char res = stream__read_raw(st, SLOT(q, pos), q->elem_size * head);
+        return res < 0 ? res : stream__read_raw(st, q->elems, q->elem_size * (n_elems - head));
+    }
+
+    size_t n_read = 0;
+    while (n_read < n_elems && stream__read_elem(st, reader, &q->elems[(pos + n_read) & RING_MASK(q)]) == SUCCESS) {
+        n_read++;
+    }
+    if (n_read < n_elems) {
+        drop_slots(q, pos, n_read, delete_op);
+        return FAILURE;
+    }
+
+    return SUCCESS;
+}
+
+/**
+ * Writes the 'seg_len' elements following the head of the ring to a new segment file, then removes them
+ * from the ring by moving the head forward. The ring is left unaltered on failure
+ */
+static char spill_segment(const Queue q) {
+    struct QueueSpillSt *sp = q->spill;
+    size_t n_elems = sp->seg_len;
+
+    if (sp->first + sp->stats.n_segments == sp->segments_capacity) {
+        if (sp->first) {
+            memmove(sp->segments, sp->segments + sp->first, sizeof(spill_segment_t) * sp->stats.n_segments);
+            sp->first = 0;
+        } else {
+            size_t capacity = sp->segments_capacity ? sp->segments_capacity * 2 : DEFAULT_QUEUE_CAPACITY;
+            spill_segment_t *segments = REALLOC(q->allocator, sp->segments, sizeof(spill_segment_t) * capacity);
+            if (!segments) return FAILURE;
+            sp->segments = segments;
+            sp->segments_capacity = capacity;
+        }
+    }
+
+    memcpy(sp->path + strlen(sp->path) - 6, "XXXXXX", 6);
+    int fd = mkstemp(sp->path);
+    if (fd < 0) return FAILURE;
+    unlink(sp->path);
+
+    Stream st = stream__open(fd, &q->allocator);
+    stream_header_t header = {STREAM_QUEUE, q->elem_size ? STREAM_FIXED_SIZE : 0, q->elem_size, n_elems};
+    char res = !st ? FAILURE : stream__write_header(st, &header);
+    res = res < 0 ? res : write_range(q, st, sp->head_len, n_elems, sp->writer);
+    res = res < 0 ? res : stream__flush(st);
+    stream__free(st);
+
+    off_t n_bytes = res < 0 ? -1 : lseek(fd, 0, SEEK_CUR);
+    if (n_bytes < 0 || lseek(fd, 0, SEEK_SET) < 0) {
+        close(fd);
+        return FAILURE;
+    }
+
+    RING_ON_SLOTS(q, RING_INDEX(q, sp->head_len), n_elems, RING_TAKE_RUN, NULL);
+    ring_move(q, n_elems, 0, sp->head_len);
+    q->front = (q->front + n_elems) & RING_MASK(q);
+    q->length -= n_elems;
+
+    sp->segments[sp->first + sp->stats.n_segments] = (spill_segment_t){fd, n_elems, (uint64_t)n_bytes};
+    sp->stats.n_segments++;
+    sp->stats.n_spilled += n_elems;
+    sp->stats.spilled_bytes += (uint64_t)n_bytes;
+    sp->stats.total_spilled_bytes += (uint64_t)n_bytes;
+
+    return SUCCESS;
+}
+
+/**
+ * Spills segments while the ring holds more than 'watermark' elements and more than one segment after its head,
+ * the back of the queue always stays in the ring. Elements which cannot be written stay in memory
+ */
+static void spill_excess(const Queue q) {
+    struct QueueSpillSt *sp = q->spill;
+    if (!sp) return;
+
+    while (q->length > sp->watermark) {
+        size_t head_len = sp->stats.n_spilled ? sp->head_len : sp->seg_len;
+        if (q->length - head_len <= sp->seg_len) return;
+
+        sp->head_len = head_len;
+        if (spill_segment(q) < 0) return;
+    }
+}
+
+/**
+ * Reads the oldest segment in the slots from 'pos' (a position in 'elems') then closes it,
+ * the segment is kept on failure
+ */
+static char spill_load(const Queue q, const size_t pos) {
+    struct QueueSpillSt *sp = q->spill;
+    spill_segment_t *seg = &sp->segments[sp->first];
+    uint64_t start = now_ns();
+
+    Stream st = stream__open(seg->fd, &q->allocator);
+    stream_header_t header;
+    char res = FAILURE;
+    if (st && stream__read_header(st, &header) == SUCCESS && header.count == seg->n_elems) {
+        res = read_slots(q, st, pos, seg->n_elems, sp->reader, NULL);
+    }
+    stream__free(st);
+    if (res < 0) {
+        lseek(seg->fd, 0, SEEK_SET);
+        return FAILURE;
+    }
+    close(seg->fd);
+
+    uint64_t ns = now_ns() - start;
+    sp->stats.n_reloads++;
+    sp->stats.reload_ns_total += ns;
+    sp->stats.reload_ns_max = ns > sp->stats.reload_ns_max ? ns : sp->stats.reload_ns_max;
+    sp->stats.n_spilled -= seg->n_elems;
+    sp->stats.spilled_bytes -= seg->n_bytes;
+    sp->stats.n_segments--;
+    sp->first = sp->stats.n_segments ? sp->first + 1 : 0;
+
+    return SUCCESS;
+}
+
+/**
+ * Loads the oldest segment in front of the ring, it becomes the head
+ */
+static char spill_reload(const Queue q) {
+    size_t n_elems = q->spill->segments[q->spill->first].n_elems;
+    if (queue__reserve(q, q->length + n_elems) < 0) return FAILURE;
+
+    size_t pos = (q->front - n_elems) & RING_MASK(q);
+    if (spill_load(q, pos) < 0) return FAILURE;
+
+    q->front = pos;
+    q->length += n_elems;
+    q->spill->head_len = n_elems;
+
+    return SUCCESS;
+}
+
+/**
+ * Loads all the segments back in the ring between its head and its other elements, for the functions moving
+ * the elements. On failure the segments loaded so far join the head
+ */
+static char spill_load_all(const Queue q) {
+    if (!IS_SPILLED(q)) return SUCCESS;
+
+    struct QueueSpillSt *sp = q->spill;
+    size_t n_spilled = sp->stats.n_spilled;
+    size_t tail_len = q->length - sp->head_len;
+    if (q->length + n_spilled < q->length || queue__reserve(q, q->length + n_spilled) < 0) return FAILURE;
+
+    ring_move(q, sp->head_len + n_spilled, sp->head_len, tail_len);
+    char res = SUCCESS;
+    while (res == SUCCESS && sp->stats.n_segments) {
+        size_t n_elems = sp->segments[sp->first].n_elems;
+        if ((res = spill_load(q, RING_INDEX(q, sp->head_len))) == SUCCESS) {
+            sp->head_len += n_elems;
+            q->length += n_elems;
+        }
+    }
+    if (res < 0) {
+        ring_move(q, sp->head_len, sp->head_len + sp->stats.n_spilled, tail_len);
+    }
+    q->back = RING_INDEX(q, q->length);
+
+    return res;
+}
+
+/**
+ * Converts the position 'i' of an element to its position in the ring, relative to the front,
+ * the segments are loaded back first if the element is in one of them
+ */
+static size_t ring_position(const Queue q, const size_t i) {
+    if (!IS_SPILLED(q) || i < q->spill->head_len) return i;
+    if (i >= q->spill->head_len + q->spill->stats.n_spilled) return i - q->spill->stats.n_spilled;
+
+    return spill_load_all(q) < 0 ? SIZE_MAX : i;
+}
+
+/**
+ * Cursor over the parts of a queue in order: the head of the ring, each segment, then the other elements of
+ * the ring. 'part' is a view sharing the operators of the queue, a segment is read in 'buffer' and its elements
+ * are deleted when the cursor moves on, so that reading functions leave the segments on disk and the ring as it is
+ */
+typedef struct
+{
+    struct QueueSt part;
+    void *buffer;
+    size_t next;
+    char owned;
+} spill_cursor_t;
+
+static void spill_cursor_init(const Queue q, spill_cursor_t *c) {
+    c->part = *q;
+    c->part.index = NULL;
+    c->part.spill = NULL;
+    c->part.length = 0;
+    c->buffer = NULL;
+    c->next = 0;
+    c->owned = false;
+}
+
+static void spill_cursor_drop(spill_cursor_t *c) {
+    if (c->owned && !c->part.elem_size) {
+        DELETE_N(&c->part, c->part.elems, c->part.length);
+    }
+    c->part.length = 0;
+    c->owned = false;
+}
+
+static void spill_cursor_free(const Queue q, spill_cursor_t *c) {
+    spill_cursor_drop(c);
+    if (c->buffer) DEALLOC(q->allocator, c->buffer);
+}
+
+/**
+ * Reads the segment 'seg' in the buffer of the cursor, the segment file is rewound for the next reads
+ */
+static char spill_cursor_read(const Queue q, spill_cursor_t *c, const spill_segment_t *seg) {
+    size_t capacity = NEXT_POW2(q->spill->seg_len);
+    if (!c->buffer && !(c->buffer = ALLOC(q->allocator, SLOT_SIZE(q) * capacity))) return FAILURE;
+
+    c->part.elems = c->buffer;
+    c->part.capacity = capacity;
+    c->part.front = 0;
+
+    Stream st = stream__open(seg->fd, &q->allocator);
+    stream_header_t header;
+    char res = FAILURE;
+    if (st && stream__read_header(st, &header) == SUCCESS && header.count == seg->n_elems && seg->n_elems <= capacity) {
+        res = read_slots(&c->part, st, 0, seg->n_elems, q->spill->reader, NULL);
+    }
+    stream__free(st);
+    lseek(seg->fd, 0, SEEK_SET);
+    if (res < 0) return FAILURE;
+
+    c->part.length = seg->n_elems;
+    c->owned = true;
+
+    return SUCCESS;
+}
+
+/**
+ * Moves the cursor to the next part, an unspilled queue is a single part followed by an empty one
+ * @return true if the cursor is on a part, false after the last one, -1 if a segment cannot be read
+ */
+static char spill_cursor_next(const Queue q, spill_cursor_t *c) {
+    size_t n_segments = IS_SPILLED(q) ? q->spill->stats.n_segments : 0;
+    size_t head_len = IS_SPILLED(q) ? q->spill->head_len : q->length;
+    size_t k = c->next++;
+
+    spill_cursor_drop(c);
+    if (k > n_segments + 1) return false;
+    if (k && k <= n_segments) {
+        return spill_cursor_read(q, c, &q->spill->segments[q->spill->first + k - 1]) < 0 ? FAILURE : true;
+    }
+
+    c->part.elems = q->elems;
+    c->part.capacity = q->capacity;
+    c->part.front = k ? RING_INDEX(q, head_len) : q->front;
+    c->part.length = k ? q->length - head_len : head_len;
+    c->part.back = RING_INDEX(&c->part, c->part.length);
+
+    return true;
+}
+
+/**
+ * Evaluates 'EXPR' on each part of the queue in order, '__part' pointing to it, while the result is '__go_on'.
+ * Returns the last result, or -1 if a segment cannot be read
+ */
+#define ON_PARTS(__ptr, __part, __go_on, EXPR) \
+({ \
+    spill_cursor_t __parts_cursor; \
+    char __parts_result = (__go_on), __parts_next = false; \
+    spill_cursor_init(__ptr, &__parts_cursor); \
+    while (__parts_result == (__go_on) && (__parts_next = spill_cursor_next(__ptr, &__parts_cursor)) == true) { \
+        Queue __part = &__parts_cursor.part; \
+        __parts_result = (char)(EXPR); \
+    } \
+    spill_cursor_free(__ptr, &__parts_cursor); \
+    (char)(__parts_next == FAILURE ? FAILURE : __parts_result); \
+})
+
+/**
+ * Same as 'RING_SEARCH_ON_RUNS' on each part of the queue, returns the position of the first element found
+ */
+#define SEARCH_ON_PARTS(__ptr, MACRO, ...) \
+({ \
+    size_t __offset = 0, __found_part = SIZE_MAX; \
+    char __res_search = ON_PARTS(__ptr, __part, true, \
+        (__found_part = RING_SEARCH_ON_RUNS(__part, MACRO, __VA_ARGS__)) == SIZE_MAX \
+        && (__offset += __part->length, true)); \
+    __res_search < 0 || __found_part == SIZE_MAX ? SIZE_MAX : __offset + __found_part; \
+})
+
+/**
+ * Applies the function 'POOL_FUNC' of the thread pool on both runs of each part of the queue, while it
+ * returns '__go_on'
+ */
+#define POOL_ON_PARTS(__ptr, __go_on, POOL_FUNC, __pool, __func, __user_data) \
+    ON_PARTS(__ptr, __part, __go_on, ({ \
+        char __res_pool = POOL_FUNC(__pool, SLOT(__part, __part->front), RING_HEAD_END(__part) - __part->front, \
+                                    SLOT_SIZE(__part), !__part->elem_size, __func, __user_data); \
+        __res_pool != (__go_on) ? __res_pool : POOL_FUNC(__pool, __part->elems, RING_TAIL_END(__part), \
+                                                         SLOT_SIZE(__part), !__part->elem_size, __func, __user_data); \
+    }))
+
+/**
+ * Copies the element at position 'i' of the segments, read from its segment, in 'nth'
+ */
+static char spill_peek(const Queue q, size_t i, elem_t *nth) {
+    struct QueueSpillSt *sp = q->spill;
+    spill_cursor_t c;
+    size_t k = 0;
+    while (i >= sp->segments[sp->first + k].n_elems) {
+        i -= sp->segments[sp->first + k++].n_elems;
+    }
+
+    spill_cursor_init(q, &c);
+    c.next = k + 1;
+    char res = spill_cursor_next(q, &c);
+    if (res == true) {
+        ELEM_LOAD(&c.part, i, nth, q->operator_copy);
+    }
+    spill_cursor_free(q, &c);
+
+    return res == true ? SUCCESS : FAILURE;
+}
+
+/**
+ * Compares two queues of the same length with at least one of them spilled, element by element along their parts
+ */
+static char spill_cmp(const Queue q, const Queue w, const compare_func_t match) {
+    spill_cursor_t c, d;
+    char res = q->elem_size == w->elem_size, next_q = true, next_w = true;
+    size_t i = 0, j = 0;
+
+    spill_cursor_init(q, &c);
+    spill_cursor_init(w, &d);
+    while (res == true) {
+        while (i == c.part.length && (next_q = spill_cursor_next(q, &c)) == true) {
+            i = 0;
+        }
+        while (j == d.part.length && (next_w = spill_cursor_next(w, &d)) == true) {
+            j = 0;
+        }
+        if (next_q != true || next_w != true) break;
+
+        res = match(ELEM(&c.part, RING_INDEX(&c.part, i)), ELEM(&d.part, RING_INDEX(&d.part, j))) ? true : false;
+        i++;
+        j++;
+    }
+    spill_cursor_free(q, &c);
+    spill_cursor_free(w, &d);
+
+    return next_q == FAILURE || next_w == FAILURE ? FAILURE : res;
+}
+
+/**
+ * Copies the segments after the elements already written to the stream, their records are already
+ * in the format of a saved queue
+ */
+static char spill_write_segments(const Queue q, const Stream st) {
+    struct QueueSpillSt *sp = q->spill;
+    char *buffer = ALLOC(q->allocator, STREAM_CHUNK_SIZE);
+    char res = !buffer || stream__flush(st) < 0 ? FAILURE : SUCCESS;
+
+    for (size_t k = 0; res == SUCCESS && k < sp->stats.n_segments; k++) {
+        spill_segment_t *seg = &sp->segments[sp->first + k];
+        for (uint64_t offset = STREAM_HEADER_SIZE; res == SUCCESS && offset < seg->n_bytes;) {
+            uint64_t n_left = seg->n_bytes - offset;
+            size_t n = n_left < STREAM_CHUNK_SIZE ? (size_t)n_left : STREAM_CHUNK_SIZE;
+            ssize_t n_read = pread(seg->fd, buffer, n, (off_t)offset);
+            if (n_read <= 0 || stream__write_raw(st, buffer, (size_t)n_read) < 0) {
+                res = FAILURE;
+            }
+            offset += n_read > 0 ? (uint64_t)n_read : 0;
+        }
+    }
+    if (buffer) DEALLOC(q->allocator, buffer);
+
+    return res;
+}
+
+/**
+ * Closes all the segments, their elements are lost
+ */
+static void spill_drop(const Queue q) {
+    struct QueueSpillSt *sp = q->spill;
+    if (!sp) return;
+
+    for (size_t k = 0; k < sp->stats.n_segments; k++) {
+        close(sp->segments[sp->first + k].fd);
+    }
+    sp->first = 0;
+    sp->head_len = 0;
+    sp->stats.n_segments = 0;
+    sp->stats.n_spilled = 0;
+    sp->stats.spilled_bytes = 0;
+}
+
+static void spill_free(const Queue q) {
+    struct QueueSpillSt *sp = q->spill;
+    if (!sp) return;
+
+    spill_drop(q);
+    if (sp->segments) DEALLOC(q->allocator, sp->segments);
+    DEALLOC(q->allocator, sp->path);
+    DEALLOC(q->allocator, sp);
+    q->spill = NULL;
+}
 
 ///////////////////////////////////////////////////////////////////////////////
 ///     QUEUE FUNCTIONS TO EXPORT
 ///////////////////////////////////////////////////////////////////////////////
 
 Queue queue__empty_copy_disabled(void) {
-    return QUEUE_INIT(NULL, NULL, DEFAULT_QUEUE_CAPACITY);
+    return QUEUE_INIT(DEFAULT_ALLOCATOR, NULL, NULL, NULL, DEFAULT_QUEUE_CAPACITY, 0);
 }
 
 Queue queue__empty_copy_enabled(const copy_operator_t copy_op, const delete_operator_t delete_op) {
     if (!copy_op || !delete_op) return NULL;
 
-    return QUEUE_INIT(copy_op, delete_op, DEFAULT_QUEUE_CAPACITY);
+    return QUEUE_INIT(DEFAULT_ALLOCATOR, copy_op, delete_op, NULL, DEFAULT_QUEUE_CAPACITY, 0);
+}
+
+Queue queue__empty_copy_enabled_n(const copy_operator_t copy_op, const delete_operator_t delete_op,
+                                  const copy_n_operator_t copy_n_op, const delete_n_operator_t delete_n_op) {
+    if (!copy_op || !delete_op) return NULL;
+
+    Queue q = QUEUE_INIT(DEFAULT_ALLOCATOR, copy_op, delete_op, NULL, DEFAULT_QUEUE_CAPACITY, 0);
+    if (q) {
+        q->operator_copy_n = copy_n_op;
+        q->operator_delete_n = delete_n_op;
+    }
+
+    return q;
+}
+
+Queue queue__empty_inline(const size_t elem_size) {
+    if (!elem_size) return NULL;
+
+    return QUEUE_INIT(DEFAULT_ALLOCATOR, NULL, NULL, NULL, DEFAULT_QUEUE_CAPACITY, elem_size);
+}
+
+Queue queue__empty_arena(const size_operator_t size_op) {
+    if (!size_op) return NULL;
+
+    return QUEUE_INIT(DEFAULT_ALLOCATOR, NULL, NULL, size_op, DEFAULT_QUEUE_CAPACITY, 0);
+}
+
+Queue queue__empty_with_allocator(const allocator_t *allocator, const copy_operator_t copy_op, const delete_operator_t delete_op) {
+    if (!allocator || !allocator->alloc || !allocator->realloc || !allocator->free || !copy_op != !delete_op) return NULL;
+
+    return QUEUE_INIT(*allocator, copy_op, delete_op, NULL, DEFAULT_QUEUE_CAPACITY, 0);
+}
+
+Queue queue__with_capacity(const size_t capacity) {
+    Queue q = QUEUE_INIT(DEFAULT_ALLOCATOR, NULL, NULL, NULL, capacity, 0);
+    if (q) {
+        q->policy.min_capacity = q->capacity;
+    }
+
+    return q;
+}
+
+Queue queue__adopt(elem_t *buffer, const size_t length, const size_t capacity, const size_t elem_size) {
+    if (!buffer || !capacity || length > capacity) return NULL;
+
+    Queue q = QUEUE_INIT(DEFAULT_ALLOCATOR, NULL, NULL, NULL, DEFAULT_QUEUE_CAPACITY, elem_size);
+    if (!q) return NULL;
+
+    /* the ring only uses a power of two capacity, the buffer grows when its largest one is too small */
+    size_t ring_capacity = NEXT_POW2(capacity);
+    if (ring_capacity != capacity) {
+        ring_capacity >>= 1;
+    }
+    if (ring_capacity < length) {
+        elem_t *grown = REALLOC(q->allocator, buffer, SLOT_SIZE(q) * ring_capacity * 2);
+        if (!grown) {
+            queue__free(q);
+            return NULL;
+        }
+        buffer = grown;
+        ring_capacity *= 2;
+    }
+
+    DEALLOC(q->allocator, q->elems);
+    q->elems = buffer;
+    q->capacity = ring_capacity;
+    q->length = length;
+    q->back = length & RING_MASK(q);
+
+    return q;
+}
+
+Queue queue__empty_indexed(const hash_func_t hash, const compare_func_t match) {
+    if (!hash || !match) return NULL;
+
+    Queue q = QUEUE_INIT(DEFAULT_ALLOCATOR, NULL, NULL, NULL, DEFAULT_QUEUE_CAPACITY, 0);
+    if (q && queue__set_index(q, hash, match) < 0) {
+        queue__free(q);
+        q = NULL;
+    }
+
+    return q;
+}
+
+char queue__set_index(const Queue q, const hash_func_t hash, const compare_func_t match) {
+    if (!q || !hash != !match || (hash && q->spill)) return FAILURE;
+
+    HashIndex index = hash ? hash_index__empty(hash, match, index_get, q, &q->allocator) : NULL;
+    if (hash && !index) return FAILURE;
+
+    hash_index__free(q->index);
+    q->index = index;
+    q->index_base = 0;
+    if (index && index_range(q, 0) < 0) {
+        hash_index__free(q->index);
+        q->index = NULL;
+        return FAILURE;
+    }
+
+    return SUCCESS;
+}
+
+inline char queue__is_indexed(const Queue q) {
+    return !q ? FAILURE : q->index != NULL;
+}
+
+char queue__set_spill(const Queue q, const char *dir, const size_t watermark, const elem_writer_t writer,
+                      const elem_reader_t reader) {
+    if (!q) return FAILURE;
+    if (dir && (!watermark || q->arena || q->index || access(dir, W_OK | X_OK) < 0
+                || (!q->elem_size && (!q->copy_enabled || !writer || !reader)))) return FAILURE;
+    if (spill_load_all(q) < 0) return FAILURE;
+
+    struct QueueSpillSt *sp = NULL;
+    if (dir) {
+        size_t dir_len = strlen(dir);
+        sp = ALLOC(q->allocator, sizeof(struct QueueSpillSt));
+        char *path = sp ? ALLOC(q->allocator, dir_len + sizeof(SPILL_FILE_NAME)) : NULL;
+        if (!path) {
+            if (sp) DEALLOC(q->allocator, sp);
+            return FAILURE;
+        }
+        memcpy(path, dir, dir_len);
+        memcpy(path + dir_len, SPILL_FILE_NAME, sizeof(SPILL_FILE_NAME));
+
+        memset(sp, 0, sizeof(struct QueueSpillSt));
+        sp->path = path;
+        sp->watermark = watermark;
+        sp->seg_len = watermark / 4 ? watermark / 4 : 1;
+        sp->writer = writer;
+        sp->reader = reader;
+    }
+    spill_free(q);
+    q->spill = sp;
+    spill_excess(q);
+
+    return SUCCESS;
+}
+
+char queue__spill_stats(const Queue q, queue_spill_stats_t *stats) {
+    if (!q || !q->spill || !stats) return FAILURE;
+
+    *stats = q->spill->stats;
+
+    return SUCCESS;
 }
 
 inline char queue__is_copy_enabled(const Queue q) {
@@ -90,56 +829,190 @@ inline char queue__is_empty(const Queue q) {
 }
 
 inline size_t queue__length(const Queue q) {
-    return !q ? SIZE_MAX : q->length;
+    return !q ? SIZE_MAX : q->length + (q->spill ? q->spill->stats.n_spilled : 0);
 }
 
-char queue__enqueue(const Queue q, const elem_t element) {
+inline size_t queue__elem_size(const Queue q) {
+    return !q ? SIZE_MAX : q->elem_size;
+}
+
+inline size_t queue__capacity(const Queue q) {
+    return !q ? SIZE_MAX : q->capacity;
+}
+
+char queue__set_policy(const Queue q, const capacity_policy_t *policy) {
+    if (!q || !policy || !POLICY_IS_VALID(*policy, true)) return FAILURE;
+
+    q->policy = *policy;
+    q->policy.min_capacity = NEXT_POW2(policy->min_capacity);
+
+    return SUCCESS;
+}
+
+char queue__reserve(const Queue q, const size_t n_elems) {
     if (!q) return FAILURE;
+    if (n_elems <= q->capacity) return SUCCESS;
+
+    size_t new_capacity = NEXT_POW2(n_elems);
+
+    return !new_capacity ? FAILURE : RING_RESIZE(q, new_capacity);
+}
+
+char queue__shrink_to_fit(const Queue q) {
+    if (!q) return FAILURE;
+
+    ptr_set__release(q->seen);
 
-    if (ENSURE_CAPACITY(q) < 0) return FAILURE;
+    size_t new_capacity = NEXT_POW2(q->length < q->policy.min_capacity ? q->policy.min_capacity : q->length);
 
-    q->elems[q->back] = q->operator_copy(element);
-    q->back++;
+    return new_capacity < q->capacity ? RING_RESIZE(q, new_capacity) : SUCCESS;
+}
+
+char queue__enqueue(const Queue q, const elem_t element) {
+    if (!q || (q->elem_size && !element)) return FAILURE;
+
+    if (RING_ENSURE_CAPACITY(q, q->policy) < 0) return FAILURE;
+    if (q->index && element && hash_index__insert(q->index, element, q->index_base + q->length) < 0) return FAILURE;
+
+    ELEM_STORE(q, q->back, element);
+    q->back = (q->back + 1) & RING_MASK(q);
     q->length++;
+    spill_excess(q);
 
     return SUCCESS;
 }
 
 char queue__dequeue(const Queue q, elem_t *front) {
-    size_t new_capacity;
     if (!q || !q->length) return FAILURE;
+    if (SPILL_HEAD_IS_EMPTY(q) && spill_reload(q) < 0) return FAILURE;
 
+    index_remove(q, 0);
     if (front) {
-        *front = q->elems[q->front];
-    } else {
+        ELEM_LOAD(q, q->front, front, q->arena ? q->operator_copy : id);
+    }
+    if (!q->elem_size && (!front || q->arena)) {
         q->operator_delete(q->elems[q->front]);
     }
 
-    q->front++;
+    q->front = (q->front + 1) & RING_MASK(q);
     q->length--;
+    q->index_base++;
+    if (q->spill && q->spill->head_len) q->spill->head_len--;
+
+    RING_SHRINK(q, q->policy);
+
+    return SUCCESS;
+}
+
+char queue__enqueue_n(const Queue q, const void *A, const size_t n_elems) {
+    if (!q || (!A && n_elems)) return FAILURE;
+    if (!n_elems) return SUCCESS;
+
+    if (RING_RESERVE_N(q, n_elems, q->policy) < 0) return FAILURE;
+
+    RING_ON_SLOTS(q, q->back, n_elems, RING_STORE_RUN, A);
+    q->back = (q->back + n_elems) & RING_MASK(q);
+    q->length += n_elems;
 
-    new_capacity = q->capacity>>1;
-    if (q->length < new_capacity && new_capacity >= DEFAULT_QUEUE_CAPACITY) {
-        QUEUE_SHIFT(q);
-        RESIZE(q, new_capacity);
+    if (q->index && index_range(q, q->length - n_elems) < 0) {
+        q->back = (q->back - n_elems) & RING_MASK(q);
+        q->length -= n_elems;
+        RING_ON_SLOTS(q, q->back, n_elems, RING_TAKE_RUN, NULL);
+        return FAILURE;
     }
+    spill_excess(q);
 
     return SUCCESS;
 }
 
+char queue__enqueue_owned(const Queue q, const elem_t element) {
+    if (!q || q->elem_size || q->arena) return FAILURE;
+
+    if (RING_ENSURE_CAPACITY(q, q->policy) < 0) return FAILURE;
+    if (q->index && element && hash_index__insert(q->index, element, q->index_base + q->length) < 0) return FAILURE;
+
+    q->elems[q->back] = element;
+    q->back = (q->back + 1) & RING_MASK(q);
+    q->length++;
+    spill_excess(q);
+
+    return SUCCESS;
+}
+
+char queue__enqueue_owned_n(const Queue q, const elem_t *A, const size_t n_elems) {
+    if (!q || q->elem_size || q->arena || (!A && n_elems)) return FAILURE;
+    if (!n_elems) return SUCCESS;
+
+    if (RING_RESERVE_N(q, n_elems, q->policy) < 0) return FAILURE;
+
+    RING_ON_SLOTS(q, q->back, n_elems, RING_MOVE_RUN, A);
+    q->back = (q->back + n_elems) & RING_MASK(q);
+    q->length += n_elems;
+
+    /* the elements are left to the caller on failure */
+    if (q->index && index_range(q, q->length - n_elems) < 0) {
+        q->back = (q->back - n_elems) & RING_MASK(q);
+        q->length -= n_elems;
+        return FAILURE;
+    }
+    spill_excess(q);
+
+    return SUCCESS;
+}
+
+size_t queue__dequeue_n(const Queue q, void *dst, const size_t n_elems) {
+    if (!q) return SIZE_MAX;
+
+    size_t length = queue__length(q);
+    size_t n_dequeued = n_elems < length ? n_elems : length;
+    if (!n_dequeued) return 0;
+
+    /* the ring is dequeued up to its head while segments are spilled, then the next segment is loaded */
+    size_t done = 0;
+    while (done < n_dequeued) {
+        if (SPILL_HEAD_IS_EMPTY(q) && spill_reload(q) < 0) break;
+
+        size_t n = n_dequeued - done;
+        if (IS_SPILLED(q) && n > q->spill->head_len) {
+            n = q->spill->head_len;
+        }
+        for (size_t i = 0; q->index && i < n; i++) {
+            index_remove(q, i);
+        }
+        char *taken = dst ? (char *)dst + done * SLOT_SIZE(q) : NULL;
+        RING_ON_SLOTS(q, q->front, n, RING_TAKE_RUN, taken);
+        q->front = (q->front + n) & RING_MASK(q);
+        q->length -= n;
+        q->index_base += n;
+        if (q->spill) {
+            q->spill->head_len -= n < q->spill->head_len ? n : q->spill->head_len;
+        }
+        done += n;
+    }
+
+    RING_SHRINK_N(q, q->policy);
+
+    return !done ? SIZE_MAX : done;
+}
+
 char queue__remove_nth(const Queue q, const size_t i) {
-    if (!q || i >= q->length) return FAILURE;
+    if (!q || q->elem_size || i >= queue__length(q)) return FAILURE;
+
+    size_t pos = ring_position(q, i);
+    if (pos == SIZE_MAX) return FAILURE;
 
-    q->operator_delete(q->elems[i]);
-    q->elems[i] = NULL;
+    index_remove(q, pos);
+    q->operator_delete(q->elems[RING_INDEX(q, pos)]);
+    q->elems[RING_INDEX(q, pos)] = NULL;
 
     return SUCCESS;
 }
 
 char queue__peek_front(const Queue q, elem_t *front) {
     if (!q || !q->length || !front) return FAILURE;
+    if (SPILL_HEAD_IS_EMPTY(q)) return spill_peek(q, 0, front);
 
-    *front = q->operator_copy(q->elems[q->front]);
+    ELEM_LOAD(q, q->front, front, q->operator_copy);
 
     return SUCCESS;
 }
@@ -147,23 +1020,74 @@ char queue__peek_front(const Queue q, elem_t *front) {
 char queue__peek_back(const Queue q, elem_t *back) {
     if (!q || !q->length || !back) return FAILURE;
 
-    *back = q->operator_copy(q->elems[q->back - 1]);
+    ELEM_LOAD(q, RING_INDEX(q, q->length - 1), back, q->operator_copy);
 
     return SUCCESS;
 }
 
 char queue__peek_nth(const Queue q, const size_t i, elem_t *nth) {
-    if (!q || !q->length || !nth || i < q->front || i >= q->back) return FAILURE;
+    if (!q || !q->length || !nth || i >= queue__length(q)) return FAILURE;
+    if (IS_IN_SEGMENTS(q, i)) return spill_peek(q, i - q->spill->head_len, nth);
 
-    *nth = q->operator_copy(q->elems[i]);
+    size_t pos = ring_position(q, i);
+    if (pos == SIZE_MAX) return FAILURE;
+
+    ELEM_LOAD(q, RING_INDEX(q, pos), nth, q->operator_copy);
 
     return SUCCESS;
 }
 
-char queue__swap(const Queue q, const size_t i, const size_t j) {
-    if (!q || i < q->front || i >= q->back || j < q->front || j >= q->back) return FAILURE;
+char queue__borrow_front(const Queue q, const void **front) {
+    if (!q || !q->length || !front) return FAILURE;
+    if (SPILL_HEAD_IS_EMPTY(q) && spill_reload(q) < 0) return FAILURE;
 
-    SWAP(q, i, j);
+    *front = ELEM(q, q->front);
+
+    return SUCCESS;
+}
+
+char queue__borrow_back(const Queue q, const void **back) {
+    if (!q || !q->length || !back) return FAILURE;
+
+    *back = ELEM(q, RING_INDEX(q, q->length - 1));
+
+    return SUCCESS;
+}
+
+char queue__borrow_nth(const Queue q, const size_t i, const void **nth) {
+    if (!q || !nth || i >= queue__length(q)) return FAILURE;
+
+    size_t pos = ring_position(q, i);
+    if (pos == SIZE_MAX) return FAILURE;
+
+    *nth = ELEM(q, RING_INDEX(q, pos));
+
+    return SUCCESS;
+}
+
+char queue__spans(const Queue q, span_t *first, span_t *second) {
+    if (!q || !first || !second || spill_load_all(q) < 0) return FAILURE;
+
+    size_t first_length = q->length < q->capacity - q->front ? q->length : q->capacity - q->front;
+
+    *first = (span_t){SLOT(q, q->front), first_length, SLOT_SIZE(q)};
+    *second = (span_t){SLOT(q, 0), q->length - first_length, SLOT_SIZE(q)};
+
+    return SUCCESS;
+}
+
+char queue__swap(const Queue q, const size_t i, const size_t j) {
+    if (!q || i >= queue__length(q) || j >= queue__length(q) || spill_load_all(q) < 0) return FAILURE;
+
+    if (q->index && i != j) {
+        index_remove(q, i);
+        index_remove(q, j);
+        SWAP(q, RING_INDEX(q, i), RING_INDEX(q, j));
+        if (IS_INDEXED(q, i)) hash_index__insert(q->index, ELEM(q, RING_INDEX(q, i)), q->index_base + i);
+        if (IS_INDEXED(q, j)) hash_index__insert(q->index, ELEM(q, RING_INDEX(q, j)), q->index_base + j);
+    } else {
+        SWAP(q, RING_INDEX(q, i), RING_INDEX(q, j));
+    }
 
     return SUCCESS;
 }
@@ -171,39 +1095,70 @@ char queue__swap(const Queue q, const size_t i, const size_t j) {
 Queue queue__copy(const Queue q) {
     if (!q) return NULL;
 
-    Queue copy = QUEUE_INIT(q->operator_copy, q->operator_delete, q->length);
+    size_t length = queue__length(q), offset = 0;
+    Queue copy = QUEUE_INIT(q->allocator, q->operator_copy, q->operator_delete, q->operator_size, length, q->elem_size);
     if (!copy) return NULL;
 
-    COPY(copy, q, q->front, q->length);
+    copy->policy = q->policy;
+    char res = ON_PARTS(q, part, true, ({ RING_COPY(copy, offset, part); offset += part->length; true; }));
 
     copy->front = 0;
-    copy->back = q->length;
+    copy->length = offset;
+    copy->back = offset & RING_MASK(copy);
+    if (res < 0) {
+        queue__free(copy);
+        return NULL;
+    }
+
+    if (q->index && queue__set_index(copy, hash_index__hash(q->index), hash_index__match(q->index)) < 0) {
+        queue__free(copy);
+        return NULL;
+    }
 
     return copy;
 }
 
 Queue queue__from_array(Queue q, void *A, const size_t n_elems, const size_t size) {
-    if (!A) return NULL;
+    if (!A || (q && q->elem_size && q->elem_size != size)) return NULL;
 
     if (!q) {
-        if (!(q = QUEUE_INIT(NULL, NULL, n_elems))) return NULL;
+        if (!(q = QUEUE_INIT(DEFAULT_ALLOCATOR, NULL, NULL, NULL, n_elems, 0))) return NULL;
     } else {
-        if (RESIZE(q, q->back + n_elems) < 0) return NULL;
+        if (queue__reserve(q, q->length + n_elems) < 0) return NULL;
     }
 
-    FROM_ARRAY(q, A, n_elems, size);
+    RING_FROM_ARRAY(q, A, n_elems, size);
+
+    if (q->index && index_range(q, q->length - n_elems) < 0) {
+        q->back = (q->back - n_elems) & RING_MASK(q);
+        q->length -= n_elems;
+        RING_ON_SLOTS(q, q->back, n_elems, RING_TAKE_RUN, NULL);
+        return NULL;
+    }
+    spill_excess(q);
 
     return q;
 }
 
 elem_t *queue__dump(const Queue q) {
-    if (!q || !q->length) return NULL;
+    if (!q || !q->length || spill_load_all(q) < 0) return NULL;
 
-    elem_t *res = malloc(sizeof(elem_t) * q->length);
+    elem_t *res = malloc(SLOT_SIZE(q) * q->length);
     if (!res) return NULL;
 
-    memcpy(res, q->elems + q->front, sizeof(elem_t) * q->length);
-    RESIZE(q, DEFAULT_QUEUE_CAPACITY);
+    RING_LINEARIZE(q);
+    if (q->arena) {
+        for (size_t i = 0; i < q->length; i++) {
+            res[i] = q->operator_copy(q->elems[q->front + i]);
+        }
+        arena__reset(q->arena);
+    } else {
+        memcpy(res, SLOT(q, q->front), SLOT_SIZE(q) * q->length);
+    }
+    if (q->policy.shrink_threshold) {
+        RESIZE(q, q->policy.min_capacity);
+    }
+    hash_index__clear(q->index);
 
     q->front = 0;
     q->back = 0;
@@ -212,128 +1167,346 @@ elem_t *queue__dump(const Queue q) {
     return res;
 }
 
+elem_t *queue__steal(const Queue q, size_t *length, size_t *capacity) {
+    if (!q || q->arena || spill_load_all(q) < 0) return NULL;
+
+    size_t min_capacity = NEXT_POW2(q->policy.min_capacity);
+    elem_t *elems = ALLOC(q->allocator, SLOT_SIZE(q) * min_capacity);
+    if (!elems) return NULL;
+
+    RING_LINEARIZE(q);
+    if (q->front) {
+        memmove(q->elems, SLOT(q, q->front), SLOT_SIZE(q) * q->length);
+    }
+
+    elem_t *res = q->elems;
+    if (length) *length = q->length;
+    if (capacity) *capacity = q->capacity;
+
+    q->elems = elems;
+    q->capacity = min_capacity;
+    q->front = 0;
+    q->back = 0;
+    q->length = 0;
+    hash_index__clear(q->index);
+
+    return res;
+}
+
+/**
+ * Copies the elements of a part of the queue, run by run, in 'dst'
+ */
+static void part_to_array(const Queue part, elem_t *dst) {
+    size_t head = RING_HEAD_END(part) - part->front;
+    if (part->copy_enabled) {
+        COPY_N(part, dst, part->elems + part->front, head);
+        COPY_N(part, dst + head, part->elems, RING_TAIL_END(part));
+    } else {
+        memcpy(dst, SLOT(part, part->front), SLOT_SIZE(part) * head);
+        memcpy((char *)dst + SLOT_SIZE(part) * head, part->elems, SLOT_SIZE(part) * RING_TAIL_END(part));
+    }
+}
+
 elem_t *queue__to_array(const Queue q) {
-    if (!q || !q->length) return NULL;
+    if (!q || !queue__length(q)) return NULL;
 
-    elem_t *res = malloc(sizeof(elem_t) * q->length);
+    elem_t *res = malloc(SLOT_SIZE(q) * queue__length(q));
     if (!res) return NULL;
 
-    size_t k = 0;
-    if (q->copy_enabled) {
-        for (size_t i = q->front; i < q->back; i++) {
-            res[k] = q->operator_copy(q->elems[i]);
-            k++;
-        }
-    } else {
-        memcpy(res, q->elems + q->front, sizeof(elem_t) * q->length);
+    size_t offset = 0;
+    char done = ON_PARTS(q, part, true, ({
+        part_to_array(part, (elem_t *)((char *)res + SLOT_SIZE(q) * offset));
+        offset += part->length;
+        true;
+    }));
+    if (done < 0) {
+        if (q->copy_enabled) DELETE_N(q, res, offset);
+        free(res);
+        return NULL;
     }
 
     return res;
 }
 
+char queue__serialize(const Queue q, const int fd, const elem_writer_t writer) {
+    if (!q || (!q->elem_size && !writer)) return FAILURE;
+
+    Stream st = stream__open(fd, &q->allocator);
+    if (!st) return FAILURE;
+
+    /* the spilled segments are copied as they are between the head and the other elements of the ring */
+    size_t head_len = IS_SPILLED(q) ? q->spill->head_len : q->length;
+    stream_header_t header = {STREAM_QUEUE, q->elem_size ? STREAM_FIXED_SIZE : 0, q->elem_size, queue__length(q)};
+    char res = stream__write_header(st, &header);
+    res = res < 0 ? res : write_range(q, st, 0, head_len, writer);
+    res = res < 0 || !IS_SPILLED(q) ? res : spill_write_segments(q, st);
+    res = res < 0 ? res : write_range(q, st, head_len, q->length - head_len, writer);
+    res = res < 0 ? res : stream__flush(st);
+    stream__free(st);
+
+    return res;
+}
+
+Queue queue__deserialize(Queue q, const int fd, const elem_reader_t reader, const delete_operator_t delete_op) {
+    if (q && q->arena) return NULL;
+
+    allocator_t allocator = q ? q->allocator : DEFAULT_ALLOCATOR;
+    Stream st = stream__open(fd, &allocator);
+    if (!st) return NULL;
+
+    stream_header_t header;
+    char fixed_size;
+    if (stream__read_header(st, &header) < 0 || header.kind != STREAM_QUEUE
+        || (fixed_size = header.flags & STREAM_FIXED_SIZE) != !!header.elem_size
+        || (q ? q->elem_size != header.elem_size : header.elem_size > SIZE_MAX)
+        || (!fixed_size && (!reader || (!delete_op && !(q && q->copy_enabled))))
+        || header.count > SIZE_MAX / (fixed_size ? header.elem_size : sizeof(elem_t))) {
+        stream__free(st);
+        return NULL;
+    }
+
+    size_t n_elems = (size_t)header.count;
+    Queue res = q;
+    if (!res) {
+        res = QUEUE_INIT(allocator, NULL, NULL, NULL, n_elems, (size_t)header.elem_size);
+    } else if (res->length + n_elems < res->length || queue__reserve(res, res->length + n_elems) < 0) {
+        res = NULL;
+    }
+    if (!res) {
+        stream__free(st);
+        return NULL;
+    }
+
+    char read = read_slots(res, st, res->back, n_elems, reader, delete_op);
+    stream__free(st);
+    if (read < 0) {
+        if (!q) queue__free(res);
+        return NULL;
+    }
+
+    res->back = (res->back + n_elems) & RING_MASK(res);
+    res->length += n_elems;
+    if (res->index && index_range(res, res->length - n_elems) < 0) {
+        res->back = (res->back - n_elems) & RING_MASK(res);
+        res->length -= n_elems;
+        drop_slots(res, res->back, n_elems, delete_op);
+        if (!q) queue__free(res);
+        return NULL;
+    }
+    spill_excess(res);
+
+    return res;
+}
+
 size_t queue__ptr_search(const Queue q, const elem_t elem) {
     if (!q) return SIZE_MAX;
 
-    return PTR_SEARCH(q, q->front, q->back, elem);
+    return SEARCH_ON_PARTS(q, PTR_SEARCH, elem);
 }
 
 size_t queue__search(const Queue q, const elem_t elem, const compare_func_t match) {
     if (!q || !match) return SIZE_MAX;
 
-    return SEARCH(q, q->front, q->back, elem, match);
+    if (q->index && elem && match == hash_index__match(q->index)) {
+        size_t pos = hash_index__find(q->index, elem);
+        return pos == SIZE_MAX ? SIZE_MAX : pos - q->index_base;
+    }
+
+    return SEARCH_ON_PARTS(q, SEARCH, elem, match);
 }
 
 char queue__ptr_contains(const Queue q, const elem_t elem) {
     if (!q) return FAILURE;
 
-    return PTR_SEARCH(q, q->front, q->back, elem) != SIZE_MAX;
+    return queue__ptr_search(q, elem) != SIZE_MAX;
 }
 
 char queue__contains(const Queue q, const elem_t elem, const compare_func_t match) {
     if (!q || !match) return FAILURE;
 
-    return SEARCH(q, q->front, q->back, elem, match) != SIZE_MAX;
+    return queue__search(q, elem, match) != SIZE_MAX;
 }
 
 char queue__cmp(const Queue q, const Queue w, const compare_func_t match) {
     if (!q || !w || !match) return FAILURE;
 
     if (q == w) return true;
-    if (q->length != w->length) return false;
+    if (queue__length(q) != queue__length(w)) return false;
+    if (IS_SPILLED(q) || IS_SPILLED(w)) return spill_cmp(q, w, match);
 
-    return ARRAY_CMP(q->elems + q->front, w->elems + w->front, match, q->length);
+    return RING_ARRAY_CMP(q, w, match);
 }
 
 void queue__foreach(const Queue q, const applying_func_t func, void *user_data) {
     if (!q || !func) return;
 
-    FOREACH(q, func, user_data, q->front, q->back);
+    if (!q->copy_enabled && !q->elem_size && !q->seen) {
+        q->seen = ptr_set__empty(&q->allocator);
+    }
+    ON_PARTS(q, part, true, ({ RING_FOREACH(part, func, user_data, part->seen); true; }));
+}
+
+void queue__foreach_all(const Queue q, const applying_func_t func, void *user_data) {
+    if (!q || !func) return;
+
+    ON_PARTS(q, part, true, ({ RING_FOREACH_ALL(part, func, user_data); true; }));
 }
 
 void queue__filter(const Queue q, const filter_func_t pred, void *user_data) {
-    if (!q || !pred) return;
+    if (!q || !pred || spill_load_all(q) < 0) return;
+
+    RING_LINEARIZE(q);
+    FILTER(q, q->front, q->front + q->length, pred, user_data);
+
+    q->back = (q->front + q->length) & RING_MASK(q);
+    index_rebuild(q);
+}
+
+char queue__foreach_parallel(const Queue q, const applying_func_t func, void *user_data, const ThreadPool pool) {
+    if (!q || !func || !pool) return FAILURE;
+
+    return POOL_ON_PARTS(q, SUCCESS, thread_pool__foreach, pool, func, user_data);
+}
+
+char queue__all_parallel(const Queue q, const filter_func_t pred, void *user_data, const ThreadPool pool) {
+    if (!q || !pred || !pool) return FAILURE;
+
+    return POOL_ON_PARTS(q, true, thread_pool__all, pool, pred, user_data);
+}
+
+char queue__any_parallel(const Queue q, const filter_func_t pred, void *user_data, const ThreadPool pool) {
+    if (!q || !pred || !pool) return FAILURE;
+
+    return POOL_ON_PARTS(q, false, thread_pool__any, pool, pred, user_data);
+}
 
-    FILTER(q, q->front, q->back, pred, user_data);
+char queue__filter_parallel(const Queue q, const filter_func_t pred, void *user_data, const ThreadPool pool) {
+    if (!q || !pred || !pool || spill_load_all(q) < 0) return FAILURE;
+    if (!q->length) return SUCCESS;
 
-    q->back = q->front + q->length;
+    size_t size = SLOT_SIZE(q);
+    char *scratch = ALLOC(q->allocator, q->length * (size + 1));
+    if (!scratch) return FAILURE;
+
+    char *kept = scratch + q->length * size;
+    RING_LINEARIZE(q);
+    size_t n_kept = thread_pool__filter(pool, SLOT(q, q->front), q->length, size, !q->elem_size, pred, user_data, scratch, kept);
+    if (n_kept == SIZE_MAX) {
+        DEALLOC(q->allocator, scratch);
+        return FAILURE;
+    }
+
+    if (!q->elem_size) {
+        size_t n_rejected = 0;
+        for (size_t i = 0; i < q->length; i++) {
+            if (!kept[i]) {
+                q->elems[q->front + n_rejected++] = q->elems[q->front + i];
+            }
+        }
+        DELETE_N(q, q->elems + q->front, n_rejected);
+    }
+    memcpy(SLOT(q, q->front), scratch, n_kept * size);
+    DEALLOC(q->allocator, scratch);
+
+    q->length = n_kept;
+    q->back = (q->front + q->length) & RING_MASK(q);
+    index_rebuild(q);
+
+    return SUCCESS;
 }
 
 char queue__all(const Queue q, const filter_func_t pred, void *user_data) {
     if (!q || !pred) return FAILURE;
 
-    return ALL(q, q->front, q->back, pred, user_data);
+    return ON_PARTS(q, part, true, RING_ON_RUNS(part, &&, ALL, pred, user_data));
 }
 
 char queue__any(const Queue q, const filter_func_t pred, void *user_data) {
     if (!q || !pred) return FAILURE;
 
-    return ANY(q, q->front, q->back, pred, user_data);
+    return ON_PARTS(q, part, false, RING_ON_RUNS(part, ||, ANY, pred, user_data));
 }
 
 void queue__reverse(const Queue q) {
-    if (!q || q->length < 2) return;
+    if (!q || spill_load_all(q) < 0 || q->length < 2) return;
 
-    for (size_t i = q->front, j = q->back - 1; i < j; i++, j--) {
-        SWAP(q, i, j);
+    for (size_t i = 0, j = q->length - 1; i < j; i++, j--) {
+        SWAP(q, RING_INDEX(q, i), RING_INDEX(q, j));
     }
+    index_rebuild(q);
 }
 
 void queue__shuffle(const Queue q, const unsigned int seed) {
-    if (!q) return;
+    if (!q || spill_load_all(q) < 0) return;
 
-    SHUFFLE(q, q->front, q->back, seed);
+    RING_LINEARIZE(q);
+    SHUFFLE(q, q->front, q->front + q->length, seed);
+    index_rebuild(q);
 }
 
 void queue__sort(const Queue q, const compare_func_t cmp) {
-    if (!q || !cmp) return;
+    if (!q || !cmp || spill_load_all(q) < 0) return;
 
-    qsort(q->elems + q->front, q->length, sizeof(elem_t), cmp);
+    RING_LINEARIZE(q);
+    qsort(SLOT(q, q->front), q->length, SLOT_SIZE(q), cmp);
+    index_rebuild(q);
+}
+
+char queue__sort_parallel(const Queue q, const compare_func_t cmp, const size_t n_threads, const char stable) {
+    if (!q || !cmp || !n_threads || spill_load_all(q) < 0) return FAILURE;
+
+    RING_LINEARIZE(q);
+
+    if (parallel_sort(SLOT(q, q->front), q->length, SLOT_SIZE(q), cmp, n_threads, stable, &q->allocator) < 0) return FAILURE;
+    index_rebuild(q);
+
+    return SUCCESS;
+}
+
+char queue__sort_by_key(const Queue q, const key_func_t key) {
+    if (!q || !key || spill_load_all(q) < 0) return FAILURE;
+
+    RING_LINEARIZE(q);
+
+    if (radix_sort(SLOT(q, q->front), q->length, SLOT_SIZE(q), key, !q->elem_size, &q->allocator) < 0) return FAILURE;
+    index_rebuild(q);
+
+    return SUCCESS;
 }
 
 void queue__clean_NULL(const Queue q) {
-    if (!q) return;
+    if (!q || spill_load_all(q) < 0) return;
 
-    CLEAN_NULL_ELEMS(q, q->front, q->back);
+    RING_LINEARIZE(q);
+    CLEAN_NULL_ELEMS(q, q->front, q->front + q->length);
 
-    q->back = q->front + q->length;
+    q->back = (q->front + q->length) & RING_MASK(q);
+    index_rebuild(q);
 }
 
 void queue__clear(const Queue q) {
     if (!q) return;
 
-    FREE_ELEMS(q, q->front, q->back);
-    RESIZE(q, DEFAULT_QUEUE_CAPACITY);
-
-    q->front = 0;
+    RING_FREE_ELEMS(q);
+    spill_drop(q);
+    hash_index__clear(q->index);
+    if (q->policy.shrink_threshold) {
+        RESIZE(q, q->policy.min_capacity);
+    }
 }
 
 void queue__free(const Queue q) {
     if (!q) return;
 
-    FREE_ELEMS(q, q->front, q->back);
+    RING_FREE_ELEMS(q);
 
-    free(q->elems);
-    free(q);
+    spill_free(q);
+    hash_index__free(q->index);
+    arena__free(q->arena);
+    ptr_set__free(q->seen);
+    allocator_t allocator = q->allocator;
+    DEALLOC(allocator, q->elems);
+    DEALLOC(allocator, q);
 }
 
 void queue__debug(const Queue q, const debug_func_t debug) {
@@ -353,13 +1526,16 @@ void queue__debug(const Queue q, const debug_func_t debug) {
                                                                                                                          , q->back);
         printf("{ ");
         for (size_t i = 0; i < q->capacity; i++) {
-            if (q->front <= i && i < q->back) {
-                debug(q->elems[i]);
+            if (((i - q->front) & RING_MASK(q)) < q->length) {
+                debug(ELEM(q, i));
             } else {
                 printf("_ ");
             }
         }
         printf("}");
+        if (q->spill) {
+            printf("\n\tQueue spilled: %lu elements in %lu segments", q->spill->stats.n_spilled, q->spill->stats.n_segments);
+        }
     }
     printf("\n");
 }
@@ -2,6 +2,7 @@
 #define __QUEUE_H__
 
 #include "../common/defs.h"
+#include "../common/thread_pool.h"
 
 
 /**
@@ -18,9 +19,75 @@
  * 2) 'queue__peek_front', 'queue__peek_back', 'queue_peek_nth' and 'queue__dequeue' return a dynamically allocated pointer to an element of
  * the queue in order to make it survive independently of the queue life cycle.
  * The user has to manually free the return pointer after usage.
+ *
+ * 3) The queue is stored as a ring buffer with a power of two capacity, positions given to or returned by
+ * the queue functions are always relative to the front of the queue (0 is the front element).
+ *
+ * 4) A queue created by 'queue__empty_inline' stores the values themselves contiguously instead of pointers.
+ * Elements given to the queue are pointers to a value of 'elem_size' bytes which is copied in, the storage
+ * variables given to dequeue and peek functions are pointers to a buffer of 'elem_size' bytes where the value
+ * is copied out. Predicates, compare and debug functions receive a pointer to the stored value.
+ *
+ * 5) A queue created by 'queue__empty_arena' copies the elements byte by byte in a slab allocator it owns (see common/arena.h),
+ * the elements must be flat values whose byte size is given by the size operator. The copies returned by the
+ * dequeue and peek functions are still allocated with malloc, clear and free release all the copies at once.
+ *
+ * 6) A queue created by 'queue__empty_indexed' or given an index by 'queue__set_index' maintains a hash table of the
+ * positions of its elements, counted from the creation of the index so that dequeues do not move them.
+ * 'queue__search' and 'queue__contains' look the element up in it in O(1) on average when they are given the
+ * match function of the index, and fall back to a linear search otherwise. The hash and match functions receive
+ * the elements like predicates do, matching elements must have the same hash. NULL pointers are not indexed.
+ * Functions moving several elements at once (filter, sort, reverse, shuffle...) rebuild the index in O(n).
+ * The elements must not be modified outside of the queue while they are indexed, and the callbacks of the foreach
+ * functions must not modify the fields read by the hash and match functions.
+ *
+ * 7) The borrow functions and 'queue__spans' give read access to the stored elements without copying them.
+ * A borrowed element or span stays valid until the next call to a function writing to the ring buffer:
+ * enqueue, enqueue_n, enqueue_owned, enqueue_owned_n, from_array, deserialize, reserve, shrink_to_fit and
+ * set_spill may move the slots to another array, dequeue, dequeue_n, remove_nth, dump, steal, clear and free
+ * delete or hand over the elements, and swap, filter, filter_parallel, reverse, shuffle, sort, sort_parallel,
+ * sort_by_key and clean_NULL change what a slot holds. The other functions (peek, borrow, search, contains, cmp,
+ * all, any, copy, to_array, serialize, the foreach functions and the parallel traversals) read the slots in
+ * place and keep them valid, except on a spilling queue where 'queue__spans' and the borrow functions may load
+ * segments back and move the slots (see note 9).
+ *
+ * 8) A queue created by 'queue__empty_copy_enabled_n' is also given batch copy and delete operators, called once
+ * per contiguous run of elements by the functions handling several elements at once (copy, from_array, to_array,
+ * enqueues of several elements, filter, clear and free), so that the copies can be allocated or released together.
+ * Either of them may be NULL, the functions then call the operator of a single element on each element of the run.
+ * The prototypes of these functions are:
+ * void (*copy_n_op)(elem_t *dst, const elem_t *src, size_t n)
+ * void (*delete_n_op)(elem_t *elems, size_t n)
+ * 'dst' and 'src' may be the same array, the copies then replace the originals.
+ *
+ * 9) A queue given a directory by 'queue__set_spill' keeps at most about 'watermark' elements in memory: once it holds
+ * more, the elements following its front are written by segments of 'watermark' / 4 elements to files of the
+ * directory, in the format of 'queue__serialize', and deleted from memory. The front and the back of the queue stay
+ * in memory, dequeues load the oldest segment back once they reach it. The length and the order of the queue do
+ * not change. The reading functions (peek, search, contains, cmp, all, any, copy, to_array, the foreach functions
+ * and the parallel traversals) read the segments with 'reader' one at a time in a buffer of one segment and leave
+ * them on disk, 'queue__serialize' copies them as they are. The functions moving or removing elements (filter,
+ * reverse, shuffle, the sorts, swap, remove_nth, dump, steal...), 'queue__spans' and 'queue__borrow_nth' given an
+ * element of a segment load all the segments back first and fail if they cannot, 'queue__borrow_front' loads the
+ * oldest one when the front is in it. Segment files are removed from the directory as soon as they are created and
+ * disappear when the queue is cleared or freed, or when the process exits.
  */
 typedef struct QueueSt * Queue;
 
+/**
+ * Metrics of a spilling queue, the first three describe the segments currently on disk
+ */
+typedef struct
+{
+    size_t n_spilled;
+    size_t n_segments;
+    uint64_t spilled_bytes;
+    uint64_t total_spilled_bytes;
+    size_t n_reloads;
+    uint64_t reload_ns_total;
+    uint64_t reload_ns_max;
+} queue_spill_stats_t;
+
 
 /**
  * @brief create an empty queue with copy disabled
@@ -40,6 +107,141 @@ Queue queue__empty_copy_disabled(void);
 Queue queue__empty_copy_enabled(const copy_operator_t copy_op, const delete_operator_t delete_op);
 
 
+/**
+ * @brief create an empty queue with copy enabled and batch copy and delete operators
+ * @note complexity: O(1)
+ * @param copy_op copy operator
+ * @param delete_op delete operator
+ * @param copy_n_op batch copy operator, may be NULL
+ * @param delete_n_op batch delete operator, may be NULL
+ * @return a pointer to queue on success, NULL on failure
+ */
+Queue queue__empty_copy_enabled_n(const copy_operator_t copy_op, const delete_operator_t delete_op,
+                                  const copy_n_operator_t copy_n_op, const delete_n_operator_t delete_n_op);
+
+
+/**
+ * @brief create an empty queue storing values of 'elem_size' bytes inline
+ * @details no copy and delete operators are needed, the values are copied byte by byte
+ * @note complexity: O(1)
+ * @param elem_size byte size of the values
+ * @return a pointer to queue on success, NULL on failure
+ */
+Queue queue__empty_inline(const size_t elem_size);
+
+
+/**
+ * @brief create an empty queue with copy enabled whose copies are allocated in an arena
+ * @details size_t (*size_op)(const void *) returns the byte size of the element to copy
+ * @note complexity: O(1)
+ * @param size_op size operator
+ * @return a pointer to queue on success, NULL on failure
+ */
+Queue queue__empty_arena(const size_operator_t size_op);
+
+
+/**
+ * @brief create an empty queue whose structure and array of elements are allocated by the given allocator
+ * @details copy is enabled if both operators are given, disabled if both are NULL
+ * @details the allocator is copied in the queue, its context must outlive the queue
+ * @note complexity: O(1)
+ * @param allocator the allocator
+ * @param copy_op copy operator
+ * @param delete_op delete operator
+ * @return a pointer to queue on success, NULL on failure
+ */
+Queue queue__empty_with_allocator(const allocator_t *allocator, const copy_operator_t copy_op, const delete_operator_t delete_op);
+
+
+/**
+ * @brief create an empty queue with copy disabled and room for 'capacity' elements, rounded up to a power of two
+ * @details this capacity is the minimum capacity of the policy, the queue never shrinks below it
+ * @note complexity: O(1)
+ * @param capacity initial capacity
+ * @return a pointer to queue on success, NULL on failure
+ */
+Queue queue__with_capacity(const size_t capacity);
+
+
+/**
+ * @brief create a queue on an existing array of elements without copying it
+ * @details the array must have been allocated with malloc, calloc or realloc and not through a custom allocator:
+ * the queue frees it or reallocates it with the default allocator when it grows.
+ * Its first 'length' slots hold the elements from the front to the back, pointers with copy disabled if
+ * 'elem_size' is null, packed values of 'elem_size' bytes like an inline queue otherwise.
+ * The ring only uses a power of two of slots: when 'capacity' is not a power of two, the slots above the largest
+ * power of two below it are never used, and the array is reallocated to the next one if they cannot hold the elements
+ * @note complexity: O(1), O(n) if the array is reallocated
+ * @param buffer the array
+ * @param length the number of elements
+ * @param capacity the number of slots of the array, all of them are used if it is a power of two
+ * @param elem_size the byte size of the values for an inline queue, 0 for pointers
+ * @return a pointer to queue on success, NULL on failure (the array is left to the caller)
+ */
+Queue queue__adopt(elem_t *buffer, const size_t length, const size_t capacity, const size_t elem_size);
+
+
+/**
+ * @brief create an empty queue with copy disabled and a hash index of its elements
+ * @note complexity: O(1)
+ * @param hash the hash function of the elements
+ * @param match the match function the index answers searches for
+ * @return a pointer to queue on success, NULL on failure
+ */
+Queue queue__empty_indexed(const hash_func_t hash, const compare_func_t match);
+
+
+/**
+ * @brief builds a hash index of the elements of the queue, replacing its current index
+ * @details with 'hash' and 'match' NULL the index is removed
+ * @details a spilling queue cannot be indexed
+ * @note complexity: O(n)
+ * @param q the queue
+ * @param hash the hash function of the elements
+ * @param match the match function the index answers searches for
+ * @return 0 on success, -1 on failure (the current index is kept)
+ */
+char queue__set_index(const Queue q, const hash_func_t hash, const compare_func_t match);
+
+
+/**
+ * @brief checks if the queue has a hash index
+ * @note complexity: O(1)
+ * @param q the queue
+ * @return 1 if the queue is indexed, 0 if not, -1 on failure
+ */
+char queue__is_indexed(const Queue q);
+
+
+/**
+ * @brief makes the queue spill the elements following its front to segment files once it holds more than 'watermark'
+ * elements in memory, replacing its current settings
+ * @details with 'dir' NULL the spilled elements are loaded back and the queue stops spilling
+ * @details inline queues need no writer nor reader, pointers are saved by 'writer' then deleted and loaded back
+ * by 'reader', so only queues with copy enabled may spill them. Arena and indexed queues cannot spill
+ * @note complexity: O(n)
+ * @param q the queue
+ * @param dir the directory of the segment files, which must be writable
+ * @param watermark the number of elements kept in memory, greater than 0
+ * @param writer the element writer, may be NULL if the queue is inline
+ * @param reader the element reader, may be NULL if the queue is inline
+ * @return 0 on success, -1 on failure
+ */
+char queue__set_spill(const Queue q, const char *dir, const size_t watermark, const elem_writer_t writer,
+                      const elem_reader_t reader);
+
+
+/**
+ * @brief gives the metrics of a spilling queue: elements, segments and bytes on disk, bytes written since
+ * 'queue__set_spill', number of segments loaded back and their total and maximum load time in nanoseconds
+ * @note complexity: O(1)
+ * @param q the queue
+ * @param stats storage of the metrics
+ * @return 0 on success, -1 on failure (or if the queue does not spill)
+ */
+char queue__spill_stats(const Queue q, queue_spill_stats_t *stats);
+
+
 /**
  * @brief checks if the queue has the copy operator enabled
  * @note complexity: O(1)
@@ -67,6 +269,55 @@ char queue__is_empty(const Queue q);
 size_t queue__length(const Queue q);
 
 
+/**
+ * @brief byte size of the values stored inline
+ * @note complexity: O(1)
+ * @param q the queue
+ * @return the byte size of the values, 0 if the queue stores pointers, SIZE_MAX on failure
+ */
+size_t queue__elem_size(const Queue q);
+
+
+/**
+ * @brief number of elements the queue can hold without reallocating
+ * @note complexity: O(1)
+ * @param q the queue
+ * @return the capacity of the queue on success, SIZE_MAX on failure
+ */
+size_t queue__capacity(const Queue q);
+
+
+/**
+ * @brief sets the capacity policy of the queue
+ * @details by default the capacity doubles when the queue is full and halves once less than a quarter of it is used
+ * @details the growth factor must be at least 2 and a power of two, the shrink threshold must be 0 (never shrink) or at least the growth factor
+ * @note complexity: O(1)
+ * @param q the queue
+ * @param policy the policy
+ * @return 0 on success, -1 on failure
+ */
+char queue__set_policy(const Queue q, const capacity_policy_t *policy);
+
+
+/**
+ * @brief makes room for at least 'n_elems' elements
+ * @note complexity: O(n) if the queue is reallocated, O(1) if not
+ * @param q the queue
+ * @param n_elems number of elements
+ * @return 0 on success, -1 on failure
+ */
+char queue__reserve(const Queue q, const size_t n_elems);
+
+
+/**
+ * @brief reduces the capacity to the number of elements rounded up to a power of two, without going below the minimum capacity of the policy
+ * @note complexity: O(n) if the queue is reallocated, O(1) if not
+ * @param q the queue
+ * @return 0 on success, -1 on failure
+ */
+char queue__shrink_to_fit(const Queue q);
+
+
 /**
  * @brief adds an element in the queue
  * @note complexity: O(1)
@@ -88,9 +339,62 @@ char queue__enqueue(const Queue q, const elem_t element);
 char queue__dequeue(const Queue q, elem_t *front);
 
 
+/**
+ * @brief adds the 'n_elems' elements of 'A' at the back of the queue, in order
+ * @details 'A' is an array of elements, or of values of 'elem_size' bytes for inline queues.
+ * The queue is reallocated at most once and elements are copied in one block per contiguous run
+ * of the ring unless copy is enabled
+ * @note complexity: O(n_elems)
+ * @param q the queue
+ * @param A the array of elements
+ * @param n_elems the number of elements of 'A'
+ * @return 0 on success, -1 on failure
+ */
+char queue__enqueue_n(const Queue q, const void *A, const size_t n_elems);
+
+
+/**
+ * @brief removes up to 'n_elems' elements from the front of the queue and stores them in 'dst', front first
+ * @details 'dst' must have room for 'n_elems' elements, or values of 'elem_size' bytes for inline queues.
+ * If 'dst' is NULL the elements are deleted. Like 'queue__dequeue', the stored elements are handed over
+ * and must be manually freed by user afterward
+ * @note complexity: O(n_elems)
+ * @param q the queue
+ * @param dst the array receiving the elements, or NULL
+ * @param n_elems the maximum number of elements to dequeue
+ * @return the number of elements dequeued on success, SIZE_MAX on failure
+ */
+size_t queue__dequeue_n(const Queue q, void *dst, const size_t n_elems);
+
+
+/**
+ * @brief adds an element already allocated by the caller at the back of the queue, without copying it
+ * @details with copy enabled the queue takes the element over and deletes it with its delete operator like its own
+ * copies, the caller must not free it anymore. With copy disabled it is the same as 'queue__enqueue'. Fails for
+ * inline and arena queues, which always copy the elements in
+ * @note complexity: O(1) amortized
+ * @param q the queue
+ * @param element the element
+ * @return 0 on success, -1 on failure (the element is left to the caller)
+ */
+char queue__enqueue_owned(const Queue q, const elem_t element);
+
+
+/**
+ * @brief adds the 'n_elems' elements of 'A', already allocated by the caller, at the back of the queue without copying them
+ * @details same as 'queue__enqueue_owned' for each element, the pointers are stored in one block per contiguous run
+ * @note complexity: O(n_elems)
+ * @param q the queue
+ * @param A the array of elements
+ * @param n_elems the number of elements of 'A'
+ * @return 0 on success, -1 on failure (the elements are left to the caller)
+ */
+char queue__enqueue_owned_n(const Queue q, const elem_t *A, const size_t n_elems);
+
+
 /**
  * @brief remove the element in the nth position
- * @details the deleted item is still part of the queue as a null value instead
+ * @details the deleted item is still part of the queue as a null value instead, fails on inline queues
  * @note complexity: O(1)
  * @param q the queue
  * @param i position
@@ -133,6 +437,57 @@ char queue__peek_back(const Queue q, elem_t *back);
 char queue__peek_nth(const Queue q, const size_t i, elem_t *nth);
 
 
+/**
+ * @brief lends the front element of the queue without copying it
+ * @details 'front' receives the stored pointer, or the address of the stored value if the queue is inline,
+ * it must not be freed and stays valid until the queue is modified (see note 7)
+ * @note complexity: O(1)
+ * @param q the queue
+ * @param front pointer to storage variable
+ * @return 0 on success, -1 on failure
+ */
+char queue__borrow_front(const Queue q, const void **front);
+
+
+/**
+ * @brief lends the back element of the queue without copying it
+ * @details 'back' receives the stored pointer, or the address of the stored value if the queue is inline,
+ * it must not be freed and stays valid until the queue is modified (see note 7)
+ * @note complexity: O(1)
+ * @param q the queue
+ * @param back pointer to storage variable
+ * @return 0 on success, -1 on failure
+ */
+char queue__borrow_back(const Queue q, const void **back);
+
+
+/**
+ * @brief lends the element at 'i' position of the queue without copying it
+ * @details 'nth' receives the stored pointer, or the address of the stored value if the queue is inline,
+ * it must not be freed and stays valid until the queue is modified (see note 7)
+ * @note complexity: O(1)
+ * @param q the queue
+ * @param i position
+ * @param nth pointer to storage variable
+ * @return 0 on success, -1 on failure
+ */
+char queue__borrow_nth(const Queue q, const size_t i, const void **nth);
+
+
+/**
+ * @brief lends the slots of the queue, from the front to the back, without copying them
+ * @details the slots wrap around the end of the ring buffer: 'first' receives the slots from the front, 'second'
+ * the remaining ones from the start of the buffer, with a null length if the queue does not wrap. The spans stay
+ * valid until the queue is modified (see note 7)
+ * @note complexity: O(1)
+ * @param q the queue
+ * @param first pointer to storage variable of the first run
+ * @param second pointer to storage variable of the second run
+ * @return 0 on success, -1 on failure
+ */
+char queue__spans(const Queue q, span_t *first, span_t *second);
+
+
 /**
  * @brief swaps two elements of the queue
  * @note complexity: O(1)
@@ -157,6 +512,7 @@ Queue queue__copy(const Queue q);
 /**
  * @brief enqueues the first 'n_elems' elements of the given array
  * @details if q == NULL creates a new queue with copy disabled by default
+ * @details if the queue is inline 'size' must be its 'elem_size'
  * @details if A == NULL returns the queue unaltered
  * @note complexity: O(n)
  * @param q the queue
@@ -171,6 +527,7 @@ Queue queue__from_array(Queue q, void *A, const size_t n_elems, const size_t siz
 /**
  * @brief dump all elements of the queue into an array
  * @details the array must be manually freed by user afterward, the queue is empty after use of this function
+ * @details the array of an inline queue holds the packed values
  * @note complexity: O(n)
  * @param q the queue
  * @return a pointer to dynamically allocated array on success, NULL on failure
@@ -178,9 +535,24 @@ Queue queue__from_array(Queue q, void *A, const size_t n_elems, const size_t siz
 elem_t *queue__dump(const Queue q);
 
 
+/**
+ * @brief detaches the array of elements of the queue and gives it to the caller without copying it
+ * @details the queue keeps working on a new array of the minimum capacity of its policy and is empty afterward.
+ * The array holds 'length' slots, after moving the elements to its start if needed, and has room for 'capacity' slots. It was allocated with the allocator
+ * of the queue and must be freed with it, with free for the default one. The elements are given with the array,
+ * copy enabled elements must be deleted by the caller. Fails for an arena queue, whose elements live in the arena
+ * @note complexity: O(1), O(n) if the elements do not start at the beginning of the buffer
+ * @param q the queue
+ * @param length optional pointer to storage variable of the number of elements
+ * @param capacity optional pointer to storage variable of the number of slots of the array
+ * @return the array on success, NULL on failure
+ */
+elem_t *queue__steal(const Queue q, size_t *length, size_t *capacity);
+
+
 /**
  * @brief retrieves a copy of all items in a queue stored in array
- * @details the array must be manually freed by user afterward
+ * @details the array must be manually freed by user afterward, the array of an inline queue holds the packed values
  * @note complexity: O(n)
  * @param q the queue
  * @return a pointer to dynamically allocated array on success, NULL on failure
@@ -188,8 +560,41 @@ elem_t *queue__dump(const Queue q);
 elem_t *queue__to_array(const Queue q);
 
 
+/**
+ * @brief writes the queue to a file descriptor in the binary format of common/stream.h, from front to back
+ * @details inline values are written as they are in one call per run of the ring buffer, pointers are encoded
+ * by 'writer' and written by chunks
+ * @note complexity: O(n)
+ * @param q the queue
+ * @param fd the file descriptor
+ * @param writer the element writer, may be NULL if the queue is inline
+ * @return 0 on success, -1 on failure
+ */
+char queue__serialize(const Queue q, const int fd, const elem_writer_t writer);
+
+
+/**
+ * @brief enqueues the elements of a queue read from a file descriptor, in the order they were enqueued
+ * @details if q == NULL creates a new queue, inline if the queue was inline and with copy disabled otherwise
+ * @details inline values are read straight into the slots, which must have the same size, pointers are built
+ * by 'reader', arena queues are not supported. The elements built are owned by the queue if it has copy enabled,
+ * otherwise they are owned by the user who has to delete them after usage, like the enqueued ones
+ * @details on failure the queue is left unaltered, the elements already built are deleted by the queue if it owns
+ * them and by 'delete_op' otherwise
+ * @note complexity: O(n)
+ * @param q the queue
+ * @param fd the file descriptor
+ * @param reader the element reader, may be NULL if the queue is inline
+ * @param delete_op the delete operator of the elements built by 'reader', may be NULL if the queue is inline or
+ * has copy enabled
+ * @return a pointer to queue on success, NULL on failure
+ */
+Queue queue__deserialize(Queue q, const int fd, const elem_reader_t reader, const delete_operator_t delete_op);
+
+
 /**
  * @brief search the given pointer
+ * @details on an inline queue searches a value equal byte by byte to the one pointed by 'elem'
  * @note complexity: O(n)
  * @param q the queue
  * @param elem the pointer to search
@@ -200,7 +605,8 @@ size_t queue__ptr_search(const Queue q, const elem_t elem);
 
 /**
  * @brief search the given element
- * @note complexity: O(n)
+ * @details uses the hash index if 'match' is the match function of the index of the queue
+ * @note complexity: O(n), O(1) on average with the hash index
  * @param q the queue
  * @param elem the element to search
  * @param match the matching function
@@ -221,7 +627,8 @@ char queue__ptr_contains(const Queue q, const elem_t elem);
 
 /**
  * @brief checks if a given element is on the queue
- * @note complexity: O(n)
+ * @details uses the hash index if 'match' is the match function of the index of the queue
+ * @note complexity: O(n), O(1) on average with the hash index
  * @param q the queue
  * @param elem the element
  * @param match the matching function
@@ -265,7 +672,9 @@ char queue__any(const Queue q, const filter_func_t pred, void *user_data);
 
 /**
  * @brief maps the given function to the queue
- * @note complexity: O(n) with copy enabled, O(n²) with copy disabled
+ * @details with copy disabled, a pointer stored several times is given to the function once, the pointers
+ * already visited are remembered in a scratch table kept by the queue until 'free' or 'shrink_to_fit'
+ * @note complexity: O(n), on average with copy disabled
  * @param q the queue
  * @param func the applying function
  * @param user_data optional data to be used as an additional argument of the application function
@@ -273,6 +682,17 @@ char queue__any(const Queue q, const filter_func_t pred, void *user_data);
 void queue__foreach(const Queue q, const applying_func_t func, void *user_data);
 
 
+/**
+ * @brief maps the given function to every element of the queue, including the pointers stored several times
+ * @details same as 'queue__foreach' with copy enabled or inline, for copy disabled queues whose pointers are known to be unique
+ * @note complexity: O(n)
+ * @param q the queue
+ * @param func the applying function
+ * @param user_data optional data to be used as an additional argument of the application function
+ */
+void queue__foreach_all(const Queue q, const applying_func_t func, void *user_data);
+
+
 /**
  * @brief filter the given queue using a predicate
  * @note complexity: O(n)
@@ -283,6 +703,63 @@ void queue__foreach(const Queue q, const applying_func_t func, void *user_data);
 void queue__filter(const Queue q, const filter_func_t pred, void *user_data);
 
 
+/**
+ * @brief maps the given function to the queue with the threads of 'pool' (see common/thread_pool.h)
+ * @details the function is called concurrently and must be thread safe. Like with 'queue__foreach_all', a pointer
+ * stored several times is given to the function each time
+ * @note complexity: O(n/n_threads)
+ * @param q the queue
+ * @param func the applying function
+ * @param user_data optional data to be used as an additional argument of the application function
+ * @param pool the thread pool
+ * @return 0 on success, -1 on failure
+ */
+char queue__foreach_parallel(const Queue q, const applying_func_t func, void *user_data, const ThreadPool pool);
+
+
+/**
+ * @brief checks if all elements of the queue satisfy the predicate with the threads of 'pool'
+ * @details the predicate is called concurrently and must be thread safe, the threads stop at the first element
+ * which does not satisfy it
+ * @note complexity: O(n/n_threads)
+ * @param q the queue
+ * @param pred the predicate
+ * @param user_data optional data to be used as an additional argument of the predicate
+ * @param pool the thread pool
+ * @return 1 if all elements satisfy the predicate, 0 if not, -1 on failure
+ */
+char queue__all_parallel(const Queue q, const filter_func_t pred, void *user_data, const ThreadPool pool);
+
+
+/**
+ * @brief checks if any element of the queue satisfies the predicate with the threads of 'pool'
+ * @details the predicate is called concurrently and must be thread safe, the threads stop at the first element
+ * which satisfies it
+ * @note complexity: O(n/n_threads)
+ * @param q the queue
+ * @param pred the predicate
+ * @param user_data optional data to be used as an additional argument of the predicate
+ * @param pool the thread pool
+ * @return 1 if any element satisfies the predicate, 0 if not, -1 on failure
+ */
+char queue__any_parallel(const Queue q, const filter_func_t pred, void *user_data, const ThreadPool pool);
+
+
+/**
+ * @brief filter the given queue using a predicate evaluated with the threads of 'pool'
+ * @details the predicate is called concurrently and must be thread safe. The kept elements are compacted in
+ * parallel and keep their order, the others are deleted by the calling thread. A scratch buffer of the size of
+ * the elements is taken from the allocator of the queue
+ * @note complexity: O(n/n_threads)
+ * @param q the queue
+ * @param pred the predicate
+ * @param user_data optional data to be used as an additional argument of the predicate
+ * @param pool the thread pool
+ * @return 0 on success, -1 on failure (the elements are left unchanged)
+ */
+char queue__filter_parallel(const Queue q, const filter_func_t pred, void *user_data, const ThreadPool pool);
+
+
 /**
  * @brief reverse the queue
  * @note complexity: O(n)
@@ -301,6 +778,7 @@ void queue__shuffle(const Queue q, const unsigned int seed);
 
 /**
  * @brief uses qsort to sort the queue elements using the given compare function
+ * @details the compare function receives pointers to the slots, which hold the values on an inline queue
  * @note complexity: O(n*log(n))
  * @param q the queue
  * @param cmp the compare function
@@ -308,6 +786,35 @@ void queue__shuffle(const Queue q, const unsigned int seed);
 void queue__sort(const Queue q, const compare_func_t cmp);
 
 
+/**
+ * @brief sorts the queue elements with a merge sort spread over up to 'n_threads' threads (see common/parallel_sort.h)
+ * @details the compare function receives pointers to the slots like with 'queue__sort'. Queues of less than
+ * PARALLEL_SORT_CUTOFF elements per thread use less threads, down to a sequential sort. If 'stable' is set,
+ * equal elements keep their order. A scratch buffer of the size of the elements is taken from the allocator
+ * of the queue, except for an unstable sequential sort
+ * @note complexity: O(n*log(n)/n_threads + n*log(n_threads))
+ * @param q the queue
+ * @param cmp the compare function
+ * @param n_threads the maximum number of threads, including the calling one
+ * @param stable keeps the order of equal elements if set
+ * @return 0 on success, -1 on failure (the elements are left unchanged)
+ */
+char queue__sort_parallel(const Queue q, const compare_func_t cmp, const size_t n_threads, const char stable);
+
+
+/**
+ * @brief sorts the queue elements by an integer key with a radix sort, without any comparison (see common/radix_sort.h)
+ * @details 'key' is called once per element and receives it like a predicate does, the stored pointer or the
+ * address of the value on an inline queue. Keys are ordered as unsigned integers and equal keys keep their order.
+ * Scratch buffers for the keys and the elements are taken from the allocator of the queue
+ * @note complexity: O(n)
+ * @param q the queue
+ * @param key the key extractor
+ * @return 0 on success, -1 on failure (the elements are left unchanged)
+ */
+char queue__sort_by_key(const Queue q, const key_func_t key);
+
+
 /**
  * @brief removes all NULL pointers in the queue
  * @note complexity: O(n)
@@ -319,7 +826,7 @@ void queue__clean_NULL(const Queue q);
 /**
  * @brief removes all elements in the queue
  * @details if copy is enabled frees all allocated memory used by these elements, the queue is still usable afterwards
- * @note complexity: O(n) with copy enabled, O(1) with copy disabled
+ * @note complexity: O(n) with copy enabled, O(1) with copy disabled or an arena
  * @param q the queue
  */
 void queue__clear(const Queue q);
@@ -328,7 +835,7 @@ void queue__clear(const Queue q);
 /**
  * @brief frees all allocated memory used by the queue
  * @details if copy is enabled frees all memory used by the elements in the queue
- * @note complexity: O(n) with copy enabled, O(1) with copy disabled
+ * @note complexity: O(n) with copy enabled, O(1) with copy disabled or an arena
  * @param q the queue
  */
 void queue__free(const Queue q);
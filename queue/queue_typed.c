@@ -0,0 +1,13 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "queue_typed.h"
+#include "../common/vec.h"
+
+///////////////////////////////////////////////////////////////////////////////
+///     TYPED QUEUES PROVIDED BY DEFAULT
+///////////////////////////////////////////////////////////////////////////////
+
+QUEUE_DEFINE(int, int, TYPED_EQUAL, TYPED_LESS, TYPED_ID, TYPED_SKIP)
+
+QUEUE_DEFINE(double, double, TYPED_EQUAL, TYPED_LESS, TYPED_ID, TYPED_SKIP)
@@ -0,0 +1,265 @@
+#ifndef __QUEUE_TYPED_H__
+#define __QUEUE_TYPED_H__
+
+#include <stddef.h>
+
+#include "../common/defs.h"
+
+#define DEFAULT_TYPED_QUEUE_CAPACITY 2
+
+
+/**
+ * Compile-time typed FIFO Abstract Data Types
+ *
+ * Notes :
+ * 1) 'QUEUE_DECLARE(T, NAME)' declares the type 'Queue_NAME' storing values of type 'T' and its functions
+ * 'queue_NAME__*', it belongs to a header. 'QUEUE_DEFINE(T, NAME, EQUAL, LESS, COPY, DELETE)' generates their
+ * implementation in a single source file, the last four arguments are macros or inline functions expanded
+ * in the generated code instead of being called through pointers:
+ * int EQUAL(T a, T b)
+ * int LESS(T a, T b)
+ * T COPY(T a)
+ * void DELETE(T a)
+ * 'TYPED_EQUAL', 'TYPED_LESS', 'TYPED_ID' and 'TYPED_SKIP' of 'vec.h' suit arithmetic types.
+ *
+ * 2) The generated functions behave like their 'Queue' counterparts with copy enabled: values are copied
+ * with 'COPY' when enqueued, 'queue_NAME__peek_*', 'queue_NAME__copy' and 'queue_NAME__to_array' return copies,
+ * values removed or freed by the queue go through 'DELETE'.
+ *
+ * 3) The queue is a ring buffer like 'Queue', positions are relative to the front of the queue.
+ * 'queue_NAME__sort' is an introsort using 'LESS', it is not stable.
+ *
+ * 4) Queues of int ('Queue_int') and double ('Queue_double') are provided by 'queue_typed.c'.
+ *
+ * Generated functions:
+ * Queue_NAME queue_NAME__empty(void)
+ * char       queue_NAME__is_empty(const Queue_NAME q)
+ * size_t     queue_NAME__length(const Queue_NAME q)
+ * char       queue_NAME__enqueue(const Queue_NAME q, const T element)
+ * char       queue_NAME__dequeue(const Queue_NAME q, T *front)                (if front is NULL the value is deleted)
+ * char       queue_NAME__peek_front(const Queue_NAME q, T *front)
+ * char       queue_NAME__peek_back(const Queue_NAME q, T *back)
+ * char       queue_NAME__peek_nth(const Queue_NAME q, const size_t i, T *nth)
+ * Queue_NAME queue_NAME__copy(const Queue_NAME q)
+ * Queue_NAME queue_NAME__from_array(Queue_NAME q, const T *A, const size_t n_elems)
+ * T         *queue_NAME__to_array(const Queue_NAME q)
+ * size_t     queue_NAME__search(const Queue_NAME q, const T elem)
+ * char       queue_NAME__contains(const Queue_NAME q, const T elem)
+ * void       queue_NAME__foreach(const Queue_NAME q, void (*func)(T *, void *), void *user_data)
+ * void       queue_NAME__sort(const Queue_NAME q)
+ * void       queue_NAME__reverse(const Queue_NAME q)
+ * void       queue_NAME__clear(const Queue_NAME q)
+ * void       queue_NAME__free(const Queue_NAME q)
+ * with the same return conventions as 'Queue': 0 on success, -1 on failure, SIZE_MAX or NULL on failure.
+ */
+#define QUEUE_DECLARE(T, NAME) \
+typedef struct Queue_##NAME##_St * Queue_##NAME; \
+Queue_##NAME queue_##NAME##__empty(void); \
+char queue_##NAME##__is_empty(const Queue_##NAME q); \
+size_t queue_##NAME##__length(const Queue_##NAME q); \
+char queue_##NAME##__enqueue(const Queue_##NAME q, const T element); \
+char queue_##NAME##__dequeue(const Queue_##NAME q, T *front); \
+char queue_##NAME##__peek_front(const Queue_##NAME q, T *front); \
+char queue_##NAME##__peek_back(const Queue_##NAME q, T *back); \
+char queue_##NAME##__peek_nth(const Queue_##NAME q, const size_t i, T *nth); \
+Queue_##NAME queue_##NAME##__copy(const Queue_##NAME q); \
+Queue_##NAME queue_##NAME##__from_array(Queue_##NAME q, const T *A, const size_t n_elems); \
+T *queue_##NAME##__to_array(const Queue_##NAME q); \
+size_t queue_##NAME##__search(const Queue_##NAME q, const T elem); \
+char queue_##NAME##__contains(const Queue_##NAME q, const T elem); \
+void queue_##NAME##__foreach(const Queue_##NAME q, void (*func)(T *, void *), void *user_data); \
+void queue_##NAME##__sort(const Queue_##NAME q); \
+void queue_##NAME##__reverse(const Queue_##NAME q); \
+void queue_##NAME##__clear(const Queue_##NAME q); \
+void queue_##NAME##__free(const Queue_##NAME q);
+
+/**
+ * 'elem_size' is only read by the 'vec.h' ring macros shared with 'Queue'
+ */
+#define QUEUE_DEFINE(T, NAME, EQUAL, LESS, COPY, DELETE) \
+struct Queue_##NAME##_St \
+{ \
+    T *elems; \
+    size_t front; \
+    size_t back; \
+    size_t length; \
+    size_t capacity; \
+    size_t elem_size; \
+    allocator_t allocator; \
+}; \
+\
+TYPED_SORT_DEFINE(T, queue_##NAME, LESS) \
+\
+static Queue_##NAME queue_##NAME##__init(const size_t n_elems) { \
+    size_t capacity = NEXT_POW2(n_elems < DEFAULT_TYPED_QUEUE_CAPACITY ? DEFAULT_TYPED_QUEUE_CAPACITY : n_elems); \
+    Queue_##NAME q = capacity ? ALLOC(DEFAULT_ALLOCATOR, sizeof(struct Queue_##NAME##_St)) : NULL; \
+    if (q) { \
+        q->allocator = DEFAULT_ALLOCATOR; \
+        q->elems = ALLOC(q->allocator, sizeof(T) * capacity); \
+        if (q->elems) { \
+            q->front = 0; \
+            q->back = 0; \
+            q->length = 0; \
+            q->capacity = capacity; \
+            q->elem_size = sizeof(T); \
+        } else { \
+            DEALLOC(q->allocator, q); \
+            q = NULL; \
+        } \
+    } \
+    return q; \
+} \
+\
+Queue_##NAME queue_##NAME##__empty(void) { \
+    return queue_##NAME##__init(DEFAULT_TYPED_QUEUE_CAPACITY); \
+} \
+\
+char queue_##NAME##__is_empty(const Queue_##NAME q) { \
+    return !q ? FAILURE : !q->length; \
+} \
+\
+size_t queue_##NAME##__length(const Queue_##NAME q) { \
+    return !q ? SIZE_MAX : q->length; \
+} \
+\
+char queue_##NAME##__enqueue(const Queue_##NAME q, const T element) { \
+    if (!q) return FAILURE; \
+    if (RING_ENSURE_CAPACITY(q, DEFAULT_POLICY(DEFAULT_TYPED_QUEUE_CAPACITY)) < 0) return FAILURE; \
+    q->elems[q->back] = COPY(element); \
+    q->back = (q->back + 1) & RING_MASK(q); \
+    q->length++; \
+    return SUCCESS; \
+} \
+\
+char queue_##NAME##__dequeue(const Queue_##NAME q, T *front) { \
+    if (!q || !q->length) return FAILURE; \
+    if (front) { \
+        *front = q->elems[q->front]; \
+    } else { \
+        DELETE(q->elems[q->front]); \
+    } \
+    q->front = (q->front + 1) & RING_MASK(q); \
+    q->length--; \
+    RING_SHRINK(q, DEFAULT_POLICY(DEFAULT_TYPED_QUEUE_CAPACITY)); \
+    return SUCCESS; \
+} \
+\
+char queue_##NAME##__peek_front(const Queue_##NAME q, T *front) { \
+    if (!q || !q->length || !front) return FAILURE; \
+    *front = COPY(q->elems[q->front]); \
+    return SUCCESS; \
+} \
+\
+char queue_##NAME##__peek_back(const Queue_##NAME q, T *back) { \
+    if (!q || !q->length || !back) return FAILURE; \
+    *back = COPY(q->elems[RING_INDEX(q, q->length - 1)]); \
+    return SUCCESS; \
+} \
+\
+char queue_##NAME##__peek_nth(const Queue_##NAME q, const size_t i, T *nth) { \
+    if (!q || !nth || i >= q->length) return FAILURE; \
+    *nth = COPY(q->elems[RING_INDEX(q, i)]); \
+    return SUCCESS; \
+} \
+\
+Queue_##NAME queue_##NAME##__copy(const Queue_##NAME q) { \
+    if (!q) return NULL; \
+    Queue_##NAME copy = queue_##NAME##__init(q->length); \
+    if (!copy) return NULL; \
+    for (size_t i = 0; i < q->length; i++) { \
+        copy->elems[i] = COPY(q->elems[RING_INDEX(q, i)]); \
+    } \
+    copy->length = q->length; \
+    copy->back = q->length & RING_MASK(copy); \
+    return copy; \
+} \
+\
+Queue_##NAME queue_##NAME##__from_array(Queue_##NAME q, const T *A, const size_t n_elems) { \
+    if (!A) return NULL; \
+    if (!q) { \
+        if (!(q = queue_##NAME##__init(n_elems))) return NULL; \
+    } else if (q->length + n_elems > q->capacity) { \
+        if (RING_RESIZE(q, NEXT_POW2(q->length + n_elems)) < 0) return NULL; \
+    } \
+    for (size_t i = 0; i < n_elems; i++) { \
+        q->elems[q->back] = COPY(A[i]); \
+        q->back = (q->back + 1) & RING_MASK(q); \
+    } \
+    q->length += n_elems; \
+    return q; \
+} \
+\
+T *queue_##NAME##__to_array(const Queue_##NAME q) { \
+    if (!q || !q->length) return NULL; \
+    T *res = malloc(sizeof(T) * q->length); \
+    if (!res) return NULL; \
+    for (size_t i = 0; i < q->length; i++) { \
+        res[i] = COPY(q->elems[RING_INDEX(q, i)]); \
+    } \
+    return res; \
+} \
+\
+size_t queue_##NAME##__search(const Queue_##NAME q, const T elem) { \
+    if (!q) return SIZE_MAX; \
+    size_t head_end = RING_HEAD_END(q); \
+    size_t tail_end = RING_TAIL_END(q); \
+    for (size_t i = q->front; i < head_end; i++) { \
+        if (EQUAL(q->elems[i], elem)) return i - q->front; \
+    } \
+    for (size_t i = 0; i < tail_end; i++) { \
+        if (EQUAL(q->elems[i], elem)) return head_end - q->front + i; \
+    } \
+    return SIZE_MAX; \
+} \
+\
+char queue_##NAME##__contains(const Queue_##NAME q, const T elem) { \
+    if (!q) return FAILURE; \
+    return queue_##NAME##__search(q, elem) != SIZE_MAX; \
+} \
+\
+void queue_##NAME##__foreach(const Queue_##NAME q, void (*func)(T *, void *), void *user_data) { \
+    if (!q || !func) return; \
+    for (size_t i = 0; i < q->length; i++) { \
+        func(&q->elems[RING_INDEX(q, i)], user_data); \
+    } \
+} \
+\
+void queue_##NAME##__sort(const Queue_##NAME q) { \
+    if (!q) return; \
+    RING_LINEARIZE(q); \
+    queue_##NAME##__typed_sort(q->elems + q->front, q->length); \
+} \
+\
+void queue_##NAME##__reverse(const Queue_##NAME q) { \
+    if (!q || q->length < 2) return; \
+    for (size_t i = 0, j = q->length - 1; i < j; i++, j--) { \
+        TYPED_SWAP(T, q->elems[RING_INDEX(q, i)], q->elems[RING_INDEX(q, j)]); \
+    } \
+} \
+\
+void queue_##NAME##__clear(const Queue_##NAME q) { \
+    if (!q) return; \
+    for (size_t i = 0; i < q->length; i++) { \
+        DELETE(q->elems[RING_INDEX(q, i)]); \
+    } \
+    q->front = 0; \
+    q->back = 0; \
+    q->length = 0; \
+    RESIZE(q, DEFAULT_TYPED_QUEUE_CAPACITY); \
+} \
+\
+void queue_##NAME##__free(const Queue_##NAME q) { \
+    if (!q) return; \
+    for (size_t i = 0; i < q->length; i++) { \
+        DELETE(q->elems[RING_INDEX(q, i)]); \
+    } \
+    DEALLOC(q->allocator, q->elems); \
+    DEALLOC(q->allocator, q); \
+}
+
+
+QUEUE_DECLARE(int, int)
+QUEUE_DECLARE(double, double)
+
+
+#endif
@@ -0,0 +1,204 @@
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "spsc_queue.h"
+#include "../common/vec.h"
+
+///////////////////////////////////////////////////////////////////////////////
+///     SPSC QUEUE STRUCTURE
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * 'head' is only written by the consumer and 'tail' only by the producer, each one lives on its own
+ * cache line next to the last value read of the opposite index so that the shared line is only
+ * reloaded when the queue looks full (producer) or empty (consumer)
+ */
+struct SpscQueueSt
+{
+    elem_t *elems;
+    size_t capacity;
+    char copy_enabled;
+    copy_operator_t operator_copy;
+    delete_operator_t operator_delete;
+
+    _Alignas(CACHE_LINE_SIZE) atomic_size_t head;
+    size_t cached_tail;
+
+    _Alignas(CACHE_LINE_SIZE) atomic_size_t tail;
+    size_t cached_head;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+///     SPSC QUEUE MACRO UTILITARIES
+///////////////////////////////////////////////////////////////////////////////
+
+static inline elem_t id(elem_t e) {
+    return e;
+}
+
+static inline void skip(elem_t e) {
+    return;
+}
+
+/**
+ * Macro to allocate all memory used by the queue, the capacity is rounded up to a power of two
+ */
+#define SPSC_QUEUE_INIT(__copy_op, __delete_op, __n_elems) \
+({ \
+    size_t __capacity = NEXT_POW2((__n_elems) ? (__n_elems) : 1); \
+    SpscQueue __ptr = __capacity ? aligned_alloc(CACHE_LINE_SIZE, sizeof(struct SpscQueueSt)) : NULL; \
+    if (__ptr) { \
+        __ptr->elems = malloc(sizeof(elem_t) * __capacity); \
+        if (__ptr->elems) { \
+            __ptr->capacity = __capacity; \
+            __ptr->copy_enabled = __copy_op ? true : false; \
+            __ptr->operator_copy = __copy_op ? __copy_op : id; \
+            __ptr->operator_delete = __delete_op ? __delete_op : skip; \
+            atomic_init(&__ptr->head, 0); \
+            atomic_init(&__ptr->tail, 0); \
+            __ptr->cached_head = 0; \
+            __ptr->cached_tail = 0; \
+        } else { \
+            free(__ptr); \
+            __ptr = NULL; \
+        } \
+    } \
+    __ptr; \
+})
+
+/**
+ * Macro to get the number of free slots seen by the producer, the consumer index is only reloaded
+ * when less than '__needed' slots are known to be free
+ */
+#define SPSC_FREE_SLOTS(__ptr, __tail, __needed) \
+({ \
+    size_t __free = (__ptr)->capacity - ((__tail) - (__ptr)->cached_head); \
+    if (__free < (__needed)) { \
+        (__ptr)->cached_head = atomic_load_explicit(&(__ptr)->head, memory_order_acquire); \
+        __free = (__ptr)->capacity - ((__tail) - (__ptr)->cached_head); \
+    } \
+    __free; \
+})
+
+/**
+ * Macro to get the number of available elements seen by the consumer, the producer index is only
+ * reloaded when less than '__needed' elements are known to be available
+ */
+#define SPSC_USED_SLOTS(__ptr, __head, __needed) \
+({ \
+    size_t __used = (__ptr)->cached_tail - (__head); \
+    if (__used < (__needed)) { \
+        (__ptr)->cached_tail = atomic_load_explicit(&(__ptr)->tail, memory_order_acquire); \
+        __used = (__ptr)->cached_tail - (__head); \
+    } \
+    __used; \
+})
+
+///////////////////////////////////////////////////////////////////////////////
+///     SPSC QUEUE FUNCTIONS TO EXPORT
+///////////////////////////////////////////////////////////////////////////////
+
+SpscQueue spsc_queue__empty_copy_disabled(const size_t capacity) {
+    return SPSC_QUEUE_INIT(NULL, NULL, capacity);
+}
+
+SpscQueue spsc_queue__empty_copy_enabled(const size_t capacity, const copy_operator_t copy_op, const delete_operator_t delete_op) {
+    if (!copy_op || !delete_op) return NULL;
+
+    return SPSC_QUEUE_INIT(copy_op, delete_op, capacity);
+}
+
+inline char spsc_queue__is_copy_enabled(const SpscQueue q) {
+    return !q ? FAILURE : q->copy_enabled;
+}
+
+inline size_t spsc_queue__capacity(const SpscQueue q) {
+    return !q ? SIZE_MAX : q->capacity;
+}
+
+size_t spsc_queue__length(const SpscQueue q) {
+    if (!q) return SIZE_MAX;
+
+    size_t head = atomic_load_explicit(&q->head, memory_order_acquire);
+    size_t tail = atomic_load_explicit(&q->tail, memory_order_acquire);
+
+    return tail - head;
+}
+
+char spsc_queue__enqueue(const SpscQueue q, const elem_t element) {
+    if (!q) return FAILURE;
+
+    size_t tail = atomic_load_explicit(&q->tail, memory_order_relaxed);
+    if (!SPSC_FREE_SLOTS(q, tail, 1)) return FAILURE;
+
+    q->elems[tail & (q->capacity - 1)] = q->operator_copy(element);
+    atomic_store_explicit(&q->tail, tail + 1, memory_order_release);
+
+    return SUCCESS;
+}
+
+size_t spsc_queue__enqueue_n(const SpscQueue q, const elem_t *elems, const size_t n_elems) {
+    if (!q || (!elems && n_elems)) return SIZE_MAX;
+
+    size_t tail = atomic_load_explicit(&q->tail, memory_order_relaxed);
+    size_t n = SPSC_FREE_SLOTS(q, tail, n_elems);
+    n = n < n_elems ? n : n_elems;
+
+    for (size_t i = 0; i < n; i++) {
+        q->elems[(tail + i) & (q->capacity - 1)] = q->operator_copy(elems[i]);
+    }
+    atomic_store_explicit(&q->tail, tail + n, memory_order_release);
+
+    return n;
+}
+
+char spsc_queue__dequeue(const SpscQueue q, elem_t *front) {
+    if (!q) return FAILURE;
+
+    size_t head = atomic_load_explicit(&q->head, memory_order_relaxed);
+    if (!SPSC_USED_SLOTS(q, head, 1)) return FAILURE;
+
+    elem_t elem = q->elems[head & (q->capacity - 1)];
+    atomic_store_explicit(&q->head, head + 1, memory_order_release);
+
+    if (front) {
+        *front = elem;
+    } else {
+        q->operator_delete(elem);
+    }
+
+    return SUCCESS;
+}
+
+size_t spsc_queue__dequeue_n(const SpscQueue q, elem_t *elems, const size_t n_elems) {
+    if (!q || (!elems && n_elems)) return SIZE_MAX;
+
+    size_t head = atomic_load_explicit(&q->head, memory_order_relaxed);
+    size_t n = SPSC_USED_SLOTS(q, head, n_elems);
+    n = n < n_elems ? n : n_elems;
+    if (!n) return 0;
+
+    size_t start = head & (q->capacity - 1);
+    size_t first_run = q->capacity - start < n ? q->capacity - start : n;
+    memcpy(elems, q->elems + start, sizeof(elem_t) * first_run);
+    memcpy(elems + first_run, q->elems, sizeof(elem_t) * (n - first_run));
+    atomic_store_explicit(&q->head, head + n, memory_order_release);
+
+    return n;
+}
+
+void spsc_queue__free(const SpscQueue q) {
+    if (!q) return;
+
+    if (q->copy_enabled) {
+        size_t head = atomic_load_explicit(&q->head, memory_order_acquire);
+        size_t tail = atomic_load_explicit(&q->tail, memory_order_acquire);
+        for (size_t i = head; i != tail; i++) {
+            q->operator_delete(q->elems[i & (q->capacity - 1)]);
+        }
+    }
+
+    free(q->elems);
+    free(q);
+}
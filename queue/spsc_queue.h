@@ -0,0 +1,131 @@
+#ifndef __SPSC_QUEUE_H__
+#define __SPSC_QUEUE_H__
+
+#include <stddef.h>
+
+#include "../common/defs.h"
+
+
+/**
+ * Implementation of a bounded lock-free FIFO Abstract Data Type for exactly one producer thread
+ * and one consumer thread
+ *
+ * Notes :
+ * 1) You have to correctly implement copy and delete operators
+ * by handling NULL value, otherwise you can end up with an undefined behaviour.
+ * The prototypes of these functions are:
+ * elem_t (*copy_op)(elem_t)
+ * void (*delete_op)(elem_t)
+ *
+ * 2) 'spsc_queue__enqueue' and 'spsc_queue__enqueue_n' must only be called by the producer thread,
+ * 'spsc_queue__dequeue' and 'spsc_queue__dequeue_n' must only be called by the consumer thread.
+ * Any other function must not run concurrently with them.
+ *
+ * 3) With copy enabled the copy is made by the producer when enqueuing, the element retrieved
+ * by the consumer is that copy and the user has to manually free it after usage.
+ */
+typedef struct SpscQueueSt * SpscQueue;
+
+
+/**
+ * @brief create an empty bounded queue with copy disabled
+ * @note complexity: O(1)
+ * @param capacity maximum number of elements, rounded up to a power of two
+ * @return a pointer to queue on success, NULL on failure
+ */
+SpscQueue spsc_queue__empty_copy_disabled(const size_t capacity);
+
+
+/**
+ * @brief create an empty bounded queue with copy enabled
+ * @note complexity: O(1)
+ * @param capacity maximum number of elements, rounded up to a power of two
+ * @param copy_op copy operator
+ * @param delete_op delete operator
+ * @return a pointer to queue on success, NULL on failure
+ */
+SpscQueue spsc_queue__empty_copy_enabled(const size_t capacity, const copy_operator_t copy_op, const delete_operator_t delete_op);
+
+
+/**
+ * @brief checks if the queue has the copy operator enabled
+ * @note complexity: O(1)
+ * @param q the queue
+ * @return 1 if the queue has copy enabled, 0 if not, -1 on failure
+ */
+char spsc_queue__is_copy_enabled(const SpscQueue q);
+
+
+/**
+ * @brief maximum number of elements the queue can hold
+ * @note complexity: O(1)
+ * @param q the queue
+ * @return the capacity of the queue on success, SIZE_MAX on failure
+ */
+size_t spsc_queue__capacity(const SpscQueue q);
+
+
+/**
+ * @brief number of elements in the queue
+ * @details the value is only a snapshot when the producer or the consumer are running
+ * @note complexity: O(1)
+ * @param q the queue
+ * @return the number of elements contained in the queue on success, SIZE_MAX on failure
+ */
+size_t spsc_queue__length(const SpscQueue q);
+
+
+/**
+ * @brief adds an element in the queue (producer only)
+ * @note complexity: O(1)
+ * @param q the queue
+ * @param element the element to add
+ * @return 0 on success, -1 on failure or if the queue is full
+ */
+char spsc_queue__enqueue(const SpscQueue q, const elem_t element);
+
+
+/**
+ * @brief adds up to 'n_elems' elements of the given array in the queue with a single publication (producer only)
+ * @note complexity: O(n)
+ * @param q the queue
+ * @param elems the elements to add
+ * @param n_elems number of elements of the array
+ * @return the number of elements added, which is less than 'n_elems' if the queue gets full, SIZE_MAX on failure
+ */
+size_t spsc_queue__enqueue_n(const SpscQueue q, const elem_t *elems, const size_t n_elems);
+
+
+/**
+ * @brief retrieve the front element and remove it of the queue (consumer only)
+ * @details the element is stored in 'front' variable and must be manually freed by user afterward if copy is enabled
+ * @note complexity: O(1)
+ * @param q the queue
+ * @param front pointer to storage variable, if NULL the element is deleted
+ * @return 0 on success, -1 on failure or if the queue is empty
+ */
+char spsc_queue__dequeue(const SpscQueue q, elem_t *front);
+
+
+/**
+ * @brief retrieve up to 'n_elems' front elements into the given array with a single release (consumer only)
+ * @details the elements must be manually freed by user afterward if copy is enabled
+ * @note complexity: O(n)
+ * @param q the queue
+ * @param elems storage array of at least 'n_elems' elements
+ * @param n_elems maximum number of elements to retrieve
+ * @return the number of elements retrieved, SIZE_MAX on failure
+ */
+size_t spsc_queue__dequeue_n(const SpscQueue q, elem_t *elems, const size_t n_elems);
+
+
+/**
+ * @brief frees all allocated memory used by the queue
+ * @details if copy is enabled frees all memory used by the elements in the queue
+ * @note complexity: O(n) with copy enabled, O(1) with copy disabled
+ * @param q the queue
+ */
+void spsc_queue__free(const SpscQueue q);
+
+
+#endif
@@ -0,0 +1,610 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "wal_queue.h"
+#include "queue.h"
+
+#define WAL_FILE_NAME "/queue.wal"
+#define WAL_TMP_FILE_NAME "/queue.wal.tmp"
+#define WAL_MAGIC "GWAL"
+#define WAL_VERSION 1
+#define WAL_HEADER_SIZE 16
+#define RECORD_HEADER_SIZE 8
+#define RECORD_CRC_SIZE 4
+#define RECORD_MAX_PAYLOAD UINT32_MAX
+#define WAL_BUFFER_SIZE 65536
+#define MAX_IO_SIZE ((size_t)1 << 30)
+
+typedef enum
+{
+    RECORD_ENQUEUE = 1,
+    RECORD_DEQUEUE = 2,
+} record_type_t;
+
+///////////////////////////////////////////////////////////////////////////////
+///     WAL QUEUE STRUCTURE
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * 'buffer' holds the 'used' bytes of the records of the operation being logged, 'log_bytes' is the size of the
+ * log and 'n_pending' the number of records written to it since the last commit. A record is its payload size
+ * on 4 bytes, its type and 3 null bytes, the payload, then the CRC-32 of all of them
+ */
+struct WalQueueSt
+{
+    Queue q;
+    int fd;
+    int dir_fd;
+    char *path;
+    char *tmp_path;
+    size_t elem_size;
+    elem_writer_t writer;
+    elem_reader_t reader;
+    delete_operator_t operator_delete;
+    wal_policy_t policy;
+    unsigned char *buffer;
+    size_t used;
+    size_t capacity;
+    size_t n_pending;
+    uint64_t first_pending_ns;
+    uint64_t log_bytes;
+    uint64_t compact_at;
+    wal_queue_stats_t stats;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+///     WAL QUEUE UTILITARIES
+///////////////////////////////////////////////////////////////////////////////
+
+static uint32_t crc_table[256];
+static pthread_once_t crc_once = PTHREAD_ONCE_INIT;
+
+/**
+ * Table of the reflected CRC-32 polynomial, built once by the first queue opened
+ */
+static void crc_init(void) {
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t c = i;
+        for (size_t k = 0; k < 8; k++) {
+            c = c & 1 ? 0xEDB88320 ^ (c >> 1) : c >> 1;
+        }
+        crc_table[i] = c;
+    }
+}
+
+static uint32_t crc32(const unsigned char *data, const size_t n_bytes) {
+    uint32_t c = 0xFFFFFFFF;
+    for (size_t i = 0; i < n_bytes; i++) {
+        c = crc_table[(c ^ data[i]) & 0xFF] ^ (c >> 8);
+    }
+    return ~c;
+}
+
+static inline void put_u32(unsigned char *p, uint32_t v) {
+    for (size_t i = 0; i < 4; i++) {
+        p[i] = (unsigned char)(v >> (8 * i));
+    }
+}
+
+static inline uint32_t get_u32(const unsigned char *p) {
+    uint32_t v = 0;
+    for (size_t i = 0; i < 4; i++) {
+        v |= (uint32_t)p[i] << (8 * i);
+    }
+    return v;
+}
+
+static inline void put_u64(unsigned char *p, uint64_t v) {
+    for (size_t i = 0; i < 8; i++) {
+        p[i] = (unsigned char)(v >> (8 * i));
+    }
+}
+
+static inline uint64_t get_u64(const unsigned char *p) {
+    uint64_t v = 0;
+    for (size_t i = 0; i < 8; i++) {
+        v |= (uint64_t)p[i] << (8 * i);
+    }
+    return v;
+}
+
+static inline uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * Partial writes and interrupted calls are resumed, large writes are split in calls of MAX_IO_SIZE bytes
+ */
+static char write_all(const int fd, const void *data, size_t n_bytes) {
+    const char *p = data;
+
+    while (n_bytes) {
+        ssize_t n = write(fd, p, n_bytes < MAX_IO_SIZE ? n_bytes : MAX_IO_SIZE);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return FAILURE;
+        p += n;
+        n_bytes -= (size_t)n;
+    }
+
+    return SUCCESS;
+}
+
+static char reserve(const WalQueue q, const size_t n_bytes) {
+    if (n_bytes <= q->capacity) return SUCCESS;
+
+    size_t capacity = q->capacity * 2 > n_bytes ? q->capacity * 2 : n_bytes;
+    unsigned char *buffer = realloc(q->buffer, capacity);
+    if (!buffer) return FAILURE;
+
+    q->buffer = buffer;
+    q->capacity = capacity;
+
+    return SUCCESS;
+}
+
+static char *join_path(const char *dir, const char *name) {
+    size_t dir_len = strlen(dir);
+    char *path = malloc(dir_len + strlen(name) + 1);
+    if (path) {
+        memcpy(path, dir, dir_len);
+        strcpy(path + dir_len, name);
+    }
+    return path;
+}
+
+/**
+ * Appends a record to the buffer, its payload is 'size' bytes of 'data' or, without 'data', the encoding of 'elem'
+ * by the element writer. The buffer is left unaltered on failure
+ */
+static char append_record(const WalQueue q, const record_type_t type, const void *data, size_t size, const void *elem) {
+    size_t start = q->used;
+    size_t offset = start + RECORD_HEADER_SIZE;
+    if (reserve(q, offset + (data ? size : 0) + RECORD_CRC_SIZE) < 0) return FAILURE;
+
+    if (data) {
+        memcpy(q->buffer + offset, data, size);
+    } else {
+        size = q->writer(elem, q->buffer + offset, q->capacity - offset);
+        if (size != SIZE_MAX && size > q->capacity - offset) {
+            if (size > SIZE_MAX - offset - RECORD_CRC_SIZE || reserve(q, offset + size + RECORD_CRC_SIZE) < 0) return FAILURE;
+            size = q->writer(elem, q->buffer + offset, q->capacity - offset);
+        }
+        if (size > q->capacity - offset) return FAILURE;
+    }
+    if (size > RECORD_MAX_PAYLOAD || reserve(q, offset + size + RECORD_CRC_SIZE) < 0) return FAILURE;
+
+    put_u32(q->buffer + start, (uint32_t)size);
+    put_u32(q->buffer + start + 4, type);
+    put_u32(q->buffer + offset + size, crc32(q->buffer + start, RECORD_HEADER_SIZE + size));
+    q->used = offset + size + RECORD_CRC_SIZE;
+
+    return SUCCESS;
+}
+
+static inline char append_elem(const WalQueue q, const void *elem) {
+    return q->elem_size ? append_record(q, RECORD_ENQUEUE, elem, q->elem_size, NULL)
+                        : append_record(q, RECORD_ENQUEUE, NULL, 0, elem);
+}
+
+static inline char append_dequeue(const WalQueue q, const size_t n_elems) {
+    unsigned char count[8];
+    put_u64(count, n_elems);
+    return append_record(q, RECORD_DEQUEUE, count, sizeof(count), NULL);
+}
+
+static char write_header(const WalQueue q, const int fd) {
+    unsigned char header[WAL_HEADER_SIZE] = {0};
+    memcpy(header, WAL_MAGIC, 4);
+    header[4] = (unsigned char)WAL_VERSION;
+    header[5] = (unsigned char)(WAL_VERSION >> 8);
+    put_u64(header + 8, q->elem_size);
+
+    return write_all(fd, header, WAL_HEADER_SIZE);
+}
+
+/**
+ * Replaces the log with the header and the enqueue records of the elements still queued, written to a temporary
+ * file renamed over the log. The buffer must be empty, the current log is kept on failure
+ */
+static char rewrite_log(const WalQueue q) {
+    int fd = open(q->tmp_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return FAILURE;
+
+    span_t spans[2];
+    char res = queue__spans(q->q, &spans[0], &spans[1]);
+    res = res < 0 ? res : write_header(q, fd);
+    uint64_t log_bytes = WAL_HEADER_SIZE;
+    for (size_t s = 0; res == SUCCESS && s < 2; s++) {
+        const char *slot = spans[s].slots;
+        for (size_t i = 0; res == SUCCESS && i < spans[s].length; i++, slot += spans[s].slot_size) {
+            res = append_elem(q, q->elem_size ? (const void *)slot : *(const elem_t *)slot);
+            if (res == SUCCESS && q->used >= WAL_BUFFER_SIZE) {
+                res = write_all(fd, q->buffer, q->used);
+                log_bytes += q->used;
+                q->used = 0;
+            }
+        }
+    }
+    res = res < 0 ? res : write_all(fd, q->buffer, q->used);
+    log_bytes += q->used;
+    q->used = 0;
+    if (res == SUCCESS && q->policy.fsync) {
+        res = fdatasync(fd) < 0 ? FAILURE : SUCCESS;
+    }
+    if (res < 0 || rename(q->tmp_path, q->path) < 0) {
+        close(fd);
+        unlink(q->tmp_path);
+        return FAILURE;
+    }
+
+    /* the rename is durable once the directory is synced, the new log is then the one to append to */
+    if (q->policy.fsync) {
+        fsync(q->dir_fd);
+    }
+    close(q->fd);
+    q->fd = fd;
+    q->log_bytes = log_bytes;
+    q->stats.n_compactions++;
+    if (q->policy.fsync) {
+        q->stats.n_syncs += 2;
+    }
+
+    return SUCCESS;
+}
+
+/**
+ * Cuts the log back to 'log_bytes' bytes, the next records are written from there
+ */
+static void truncate_log(const WalQueue q, const uint64_t log_bytes) {
+    if (ftruncate(q->fd, (off_t)log_bytes) == 0) {
+        lseek(q->fd, (off_t)log_bytes, SEEK_SET);
+    }
+    q->log_bytes = log_bytes;
+}
+
+/**
+ * Writes the records of the buffer to the log with a single write, so that they reach the page cache before
+ * the operation is applied. On failure the log is truncated back, in both cases the buffer is emptied
+ */
+static char write_records(const WalQueue q) {
+    char res = write_all(q->fd, q->buffer, q->used);
+    if (res == SUCCESS) {
+        q->log_bytes += q->used;
+    } else {
+        truncate_log(q, q->log_bytes);
+    }
+    q->used = 0;
+
+    return res;
+}
+
+/**
+ * Ends the group of pending records, synced if 'sync'. The records stay pending if the sync fails
+ */
+static char commit(const WalQueue q, const char sync) {
+    if (sync) {
+        if (fdatasync(q->fd) < 0) return FAILURE;
+        q->stats.n_syncs++;
+    }
+    if (q->n_pending) {
+        q->n_pending = 0;
+        q->stats.n_commits++;
+    }
+
+    if (q->policy.compact_bytes && q->log_bytes >= q->compact_at) {
+        rewrite_log(q);
+        q->compact_at = q->log_bytes * 2 > q->policy.compact_bytes ? q->log_bytes * 2 : q->policy.compact_bytes;
+    }
+
+    return SUCCESS;
+}
+
+/**
+ * Counts 'n_records' records written to the log and commits the group when it is full or too old,
+ * a group which fails to be synced stays pending and is retried with the next one
+ */
+static void record_done(const WalQueue q, const size_t n_records) {
+    if (!q->n_pending && q->policy.group_ns) {
+        q->first_pending_ns = now_ns();
+    }
+    q->n_pending += n_records;
+    q->stats.n_records += n_records;
+
+    if (q->n_pending >= q->policy.group_size
+        || (q->policy.group_ns && now_ns() - q->first_pending_ns >= q->policy.group_ns)) {
+        commit(q, q->policy.fsync);
+    }
+}
+
+/**
+ * Applies a record read from the log to the queue
+ */
+static char replay_record(const WalQueue q, const record_type_t type, const unsigned char *payload, const size_t size) {
+    if (type == RECORD_ENQUEUE && q->elem_size) {
+        return size != q->elem_size ? FAILURE : queue__enqueue(q->q, (elem_t)payload);
+    }
+    if (type == RECORD_ENQUEUE) {
+        elem_t elem = q->reader(payload, size);
+        if (!elem) return FAILURE;
+        if (queue__enqueue_owned(q->q, elem) < 0) {
+            q->operator_delete(elem);
+            return FAILURE;
+        }
+        return SUCCESS;
+    }
+    if (type == RECORD_DEQUEUE && size == 8) {
+        uint64_t n_elems = get_u64(payload);
+        if (n_elems > queue__length(q->q)) return FAILURE;
+        return queue__dequeue_n(q->q, NULL, (size_t)n_elems) == SIZE_MAX ? FAILURE : SUCCESS;
+    }
+
+    return FAILURE;
+}
+
+/**
+ * Replays the records of the log, the log is truncated after the last valid one when it ends with a torn or
+ * corrupted record. A valid record which cannot be applied fails without altering the log
+ */
+static char replay_log(const WalQueue q) {
+    unsigned char header[WAL_HEADER_SIZE];
+    ssize_t n = pread(q->fd, header, WAL_HEADER_SIZE, 0);
+    if (n != WAL_HEADER_SIZE || memcmp(header, WAL_MAGIC, 4) || (header[4] | header[5] << 8) != WAL_VERSION
+        || get_u64(header + 8) != q->elem_size) return FAILURE;
+
+    off_t file_size = lseek(q->fd, 0, SEEK_END);
+    if (file_size < 0) return FAILURE;
+
+    /* the buffer holds the bytes of the log from offset 'log_bytes' - 'pos', 'pos' is the next record */
+    uint64_t log_bytes = WAL_HEADER_SIZE;
+    size_t pos = 0;
+    size_t available = 0;
+    char eof = false;
+
+    for (;;) {
+        size_t size = available - pos >= RECORD_HEADER_SIZE ? get_u32(q->buffer + pos) : 0;
+        size_t record_size = RECORD_HEADER_SIZE + size + RECORD_CRC_SIZE;
+
+        if (available - pos < RECORD_HEADER_SIZE || available - pos < record_size) {
+            if (eof || log_bytes + record_size > (uint64_t)file_size) break;
+            memmove(q->buffer, q->buffer + pos, available - pos);
+            available -= pos;
+            pos = 0;
+            if (reserve(q, record_size > WAL_BUFFER_SIZE ? record_size : WAL_BUFFER_SIZE) < 0) return FAILURE;
+            n = pread(q->fd, q->buffer + available, q->capacity - available, (off_t)(log_bytes + available));
+            if (n < 0 && errno == EINTR) continue;
+            if (n < 0) return FAILURE;
+            eof = !n;
+            available += (size_t)n;
+            continue;
+        }
+
+        const unsigned char *record = q->buffer + pos;
+        if (get_u32(record + RECORD_HEADER_SIZE + size) != crc32(record, RECORD_HEADER_SIZE + size)) break;
+        if (replay_record(q, (record_type_t)record[4], record + RECORD_HEADER_SIZE, size) < 0) return FAILURE;
+
+        pos += record_size;
+        log_bytes += record_size;
+        q->stats.n_recovered++;
+    }
+    q->used = 0;
+
+    if ((uint64_t)file_size > log_bytes && ftruncate(q->fd, (off_t)log_bytes) < 0) return FAILURE;
+    if (lseek(q->fd, (off_t)log_bytes, SEEK_SET) < 0) return FAILURE;
+    q->log_bytes = log_bytes;
+
+    return SUCCESS;
+}
+
+/**
+ * Opens or creates the log of 'dir' then replays it in 'q', which is freed on failure
+ */
+static WalQueue wal_queue_open(WalQueue q, const char *dir, const wal_policy_t *policy) {
+    q->policy = policy ? *policy : WAL_DEFAULT_POLICY;
+    q->policy.group_size = q->policy.group_size ? q->policy.group_size : 1;
+    q->compact_at = q->policy.compact_bytes;
+    q->fd = -1;
+    q->dir_fd = open(dir, O_RDONLY | O_DIRECTORY);
+    q->path = join_path(dir, WAL_FILE_NAME);
+    q->tmp_path = join_path(dir, WAL_TMP_FILE_NAME);
+    q->buffer = malloc(WAL_BUFFER_SIZE);
+    q->capacity = WAL_BUFFER_SIZE;
+
+    char res = !pthread_once(&crc_once, crc_init) && q->dir_fd >= 0 && q->path && q->tmp_path && q->buffer ? SUCCESS : FAILURE;
+    if (res == SUCCESS) {
+        unlink(q->tmp_path);
+        q->fd = open(q->path, O_RDWR | O_CREAT, 0644);
+    }
+    off_t size = q->fd < 0 ? -1 : lseek(q->fd, 0, SEEK_END);
+    if (size < 0) {
+        res = FAILURE;
+    } else if (size < WAL_HEADER_SIZE) {
+        /* a log shorter than its header was created by a crash before the header was written, it is empty */
+        res = ftruncate(q->fd, 0) < 0 || lseek(q->fd, 0, SEEK_SET) < 0 || write_header(q, q->fd) < 0
+              || fdatasync(q->fd) < 0 || fsync(q->dir_fd) < 0 ? FAILURE : SUCCESS;
+        q->log_bytes = WAL_HEADER_SIZE;
+    } else {
+        res = replay_log(q);
+    }
+
+    if (res < 0) {
+        /* nothing is committed nor compacted from a queue which failed to open */
+        if (q->fd >= 0) {
+            close(q->fd);
+            q->fd = -1;
+        }
+        wal_queue__free(q);
+        return NULL;
+    }
+    if (q->policy.compact_bytes && q->log_bytes * 2 > q->compact_at) {
+        q->compact_at = q->log_bytes * 2;
+    }
+
+    return q;
+}
+
+/**
+ * Macro to allocate the structure of the queue, the log is opened by 'wal_queue_open'
+ */
+#define WAL_QUEUE_INIT(__queue, __elem_size, __writer, __reader, __delete_op) \
+({ \
+    Queue __inner = (__queue); \
+    WalQueue __ptr = __inner ? calloc(1, sizeof(struct WalQueueSt)) : NULL; \
+    if (__ptr) { \
+        __ptr->q = __inner; \
+        __ptr->elem_size = (__elem_size); \
+        __ptr->writer = (__writer); \
+        __ptr->reader = (__reader); \
+        __ptr->operator_delete = (__delete_op); \
+    } else { \
+        queue__free(__inner); \
+    } \
+    __ptr; \
+})
+
+///////////////////////////////////////////////////////////////////////////////
+///     WAL QUEUE FUNCTIONS TO EXPORT
+///////////////////////////////////////////////////////////////////////////////
+
+WalQueue wal_queue__open_inline(const char *dir, const size_t elem_size, const wal_policy_t *policy) {
+    if (!dir || !elem_size) return NULL;
+
+    WalQueue q = WAL_QUEUE_INIT(queue__empty_inline(elem_size), elem_size, NULL, NULL, NULL);
+
+    return !q ? NULL : wal_queue_open(q, dir, policy);
+}
+
+WalQueue wal_queue__open_copy_enabled(const char *dir, const copy_operator_t copy_op, const delete_operator_t delete_op,
+                                      const elem_writer_t writer, const elem_reader_t reader, const wal_policy_t *policy) {
+    if (!dir || !copy_op || !delete_op || !writer || !reader) return NULL;
+
+    WalQueue q = WAL_QUEUE_INIT(queue__empty_copy_enabled(copy_op, delete_op), 0, writer, reader, delete_op);
+
+    return !q ? NULL : wal_queue_open(q, dir, policy);
+}
+
+size_t wal_queue__length(const WalQueue q) {
+    return !q ? SIZE_MAX : queue__length(q->q);
+}
+
+char wal_queue__enqueue(const WalQueue q, const elem_t element) {
+    if (!q || !element) return FAILURE;
+
+    uint64_t mark = q->log_bytes;
+    if (append_elem(q, element) < 0 || write_records(q) < 0) return FAILURE;
+    if (queue__enqueue(q->q, element) < 0) {
+        truncate_log(q, mark);
+        return FAILURE;
+    }
+    record_done(q, 1);
+
+    return SUCCESS;
+}
+
+char wal_queue__enqueue_n(const WalQueue q, const void *A, const size_t n_elems) {
+    if (!q || (!A && n_elems)) return FAILURE;
+    if (!n_elems) return SUCCESS;
+
+    uint64_t mark = q->log_bytes;
+    char res = SUCCESS;
+    for (size_t i = 0; res == SUCCESS && i < n_elems; i++) {
+        const void *elem = q->elem_size ? (const char *)A + i * q->elem_size : ((const elem_t *)A)[i];
+        res = !elem ? FAILURE : append_elem(q, elem);
+    }
+    if (res < 0) {
+        q->used = 0;
+        return FAILURE;
+    }
+    if (write_records(q) < 0) return FAILURE;
+    if (queue__enqueue_n(q->q, A, n_elems) < 0) {
+        truncate_log(q, mark);
+        return FAILURE;
+    }
+
+    record_done(q, n_elems);
+
+    return SUCCESS;
+}
+
+char wal_queue__dequeue(const WalQueue q, elem_t *front) {
+    if (!q || !queue__length(q->q)) return FAILURE;
+
+    uint64_t mark = q->log_bytes;
+    if (append_dequeue(q, 1) < 0 || write_records(q) < 0) return FAILURE;
+    if (queue__dequeue(q->q, front) < 0) {
+        truncate_log(q, mark);
+        return FAILURE;
+    }
+    record_done(q, 1);
+
+    return SUCCESS;
+}
+
+size_t wal_queue__dequeue_n(const WalQueue q, void *dst, const size_t n_elems) {
+    if (!q) return SIZE_MAX;
+
+    size_t length = queue__length(q->q);
+    size_t n_dequeued = n_elems < length ? n_elems : length;
+    if (!n_dequeued) return 0;
+
+    uint64_t mark = q->log_bytes;
+    if (append_dequeue(q, n_dequeued) < 0 || write_records(q) < 0) return SIZE_MAX;
+    if (queue__dequeue_n(q->q, dst, n_dequeued) != n_dequeued) {
+        truncate_log(q, mark);
+        return SIZE_MAX;
+    }
+    record_done(q, 1);
+
+    return n_dequeued;
+}
+
+char wal_queue__peek_front(const WalQueue q, elem_t *front) {
+    if (!q) return FAILURE;
+
+    return queue__peek_front(q->q, front);
+}
+
+char wal_queue__sync(const WalQueue q) {
+    if (!q) return FAILURE;
+
+    return commit(q, true);
+}
+
+char wal_queue__compact(const WalQueue q) {
+    if (!q || commit(q, q->policy.fsync) < 0) return FAILURE;
+
+    return rewrite_log(q);
+}
+
+char wal_queue__stats(const WalQueue q, wal_queue_stats_t *stats) {
+    if (!q || !stats) return FAILURE;
+
+    *stats = q->stats;
+    stats->log_bytes = q->log_bytes;
+
+    return SUCCESS;
+}
+
+void wal_queue__free(const WalQueue q) {
+    if (!q) return;
+
+    if (q->fd >= 0) {
+        commit(q, q->policy.fsync);
+        close(q->fd);
+    }
+    if (q->dir_fd >= 0) {
+        close(q->dir_fd);
+    }
+    queue__free(q->q);
+    free(q->path);
+    free(q->tmp_path);
+    free(q->buffer);
+    free(q);
+}
@@ -0,0 +1,199 @@
+#ifndef __WAL_QUEUE_H__
+#define __WAL_QUEUE_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../common/defs.h"
+
+
+/**
+ * Implementation of a durable FIFO Abstract Data Type whose operations are appended to a write-ahead log
+ *
+ * Notes :
+ * 1) The elements are held in memory by a 'Queue' and every enqueue or dequeue is first appended as a record
+ * to the log 'queue.wal' of the directory given to the open functions. Opening a directory which already has
+ * a log replays it into a fresh queue, so that the queue is found as it was after its last committed record.
+ * A log shorter than its header, left by a crash during its creation, is an empty log.
+ * A record torn by a crash or a power loss is detected by its checksum, it is dropped with the records after it.
+ * A valid record which cannot be replayed, because memory is lacking or the element reader fails, makes the
+ * open function fail without altering the log.
+ *
+ * 2) Every operation writes its records to the log before it is applied, with a single write: once it returns
+ * they are in the page cache and survive a crash of the process. Only the fdatasync making them survive a crash
+ * of the system is grouped: records are committed once 'group_size' of them are pending, or at the next operation
+ * once the oldest pending record is older than 'group_ns' nanoseconds, with a single fdatasync. A 'group_size'
+ * of 1 syncs every operation, without 'fsync' the log is never synced. 'wal_queue__sync' commits the pending
+ * records at once, 'wal_queue__free' commits them before closing. An operation whose records cannot be written
+ * fails and leaves the queue and the log unaltered, a group which fails to be synced stays pending and is retried
+ * with the next group, only 'wal_queue__sync' and 'wal_queue__compact' report the failure.
+ *
+ * 3) Once the log grows past 'compact_bytes' it is compacted at the next commit: the elements still queued are
+ * written to a new log which atomically replaces the old one. The next compaction happens once the log doubled
+ * or reached 'compact_bytes' again, whichever is larger.
+ *
+ * 4) A queue opened by 'wal_queue__open_inline' logs and stores the values themselves, like 'queue__empty_inline'.
+ * A queue opened by 'wal_queue__open_copy_enabled' logs the elements through an element writer and rebuilds them
+ * through an element reader when the log is replayed (see common/defs.h), elements cannot be NULL.
+ *
+ * 5) The functions of a queue must not run concurrently, and a directory must not be opened by two queues at once.
+ * Distinct queues may be opened and used by distinct threads.
+ */
+typedef struct WalQueueSt * WalQueue;
+
+/**
+ * Group commit policy of the log, see note 2 and 3
+ */
+typedef struct
+{
+    size_t group_size;
+    uint64_t group_ns;
+    char fsync;
+    uint64_t compact_bytes;
+} wal_policy_t;
+
+#define WAL_DEFAULT_POLICY \
+    ((wal_policy_t){128, 1000000, true, (uint64_t)64 << 20})
+
+/**
+ * Metrics of the log since the queue was opened
+ */
+typedef struct
+{
+    size_t n_recovered;
+    size_t n_records;
+    size_t n_commits;
+    size_t n_syncs;
+    size_t n_compactions;
+    uint64_t log_bytes;
+} wal_queue_stats_t;
+
+
+/**
+ * @brief open the durable queue of values of 'elem_size' bytes logged in 'dir', replaying its log if it has one
+ * @note complexity: O(size of the log)
+ * @param dir the directory of the log, which must exist
+ * @param elem_size the byte size of the values, which must be the one the log was written with
+ * @param policy the group commit policy, WAL_DEFAULT_POLICY if NULL
+ * @return a pointer to queue on success, NULL on failure
+ */
+WalQueue wal_queue__open_inline(const char *dir, const size_t elem_size, const wal_policy_t *policy);
+
+
+/**
+ * @brief open the durable queue of pointers logged in 'dir', replaying its log if it has one
+ * @note complexity: O(size of the log)
+ * @param dir the directory of the log, which must exist
+ * @param copy_op copy operator
+ * @param delete_op delete operator
+ * @param writer the element writer of the records
+ * @param reader the element reader rebuilding the elements of the records
+ * @param policy the group commit policy, WAL_DEFAULT_POLICY if NULL
+ * @return a pointer to queue on success, NULL on failure
+ */
+WalQueue wal_queue__open_copy_enabled(const char *dir, const copy_operator_t copy_op, const delete_operator_t delete_op,
+                                      const elem_writer_t writer, const elem_reader_t reader, const wal_policy_t *policy);
+
+
+/**
+ * @brief number of elements in the queue
+ * @note complexity: O(1)
+ * @param q the queue
+ * @return the number of elements contained in the queue on success, SIZE_MAX on failure
+ */
+size_t wal_queue__length(const WalQueue q);
+
+
+/**
+ * @brief logs then adds an element in the queue
+ * @note complexity: O(1), amortized O(n) when the log is compacted
+ * @param q the queue
+ * @param element the element to add
+ * @return 0 on success, -1 on failure (the queue and the log are left unaltered)
+ */
+char wal_queue__enqueue(const WalQueue q, const elem_t element);
+
+
+/**
+ * @brief logs then adds the 'n_elems' elements of the given array in the queue, counted as 'n_elems' pending records
+ * @note complexity: O(n)
+ * @param q the queue
+ * @param A the values for an inline queue, the pointers otherwise
+ * @param n_elems number of elements of the array
+ * @return 0 on success, -1 on failure like 'wal_queue__enqueue'
+ */
+char wal_queue__enqueue_n(const WalQueue q, const void *A, const size_t n_elems);
+
+
+/**
+ * @brief logs the removal of the front element then retrieves it
+ * @details the element is stored in 'front' variable and must be manually freed by user afterward for a queue of pointers
+ * @note complexity: O(1), amortized O(n) when the log is compacted
+ * @param q the queue
+ * @param front pointer to storage variable, if NULL the element is deleted
+ * @return 0 on success, -1 on failure or if the queue is empty (the queue and the log are left unaltered)
+ */
+char wal_queue__dequeue(const WalQueue q, elem_t *front);
+
+
+/**
+ * @brief logs the removal of up to 'n_elems' front elements in a single record then retrieves them
+ * @note complexity: O(n)
+ * @param q the queue
+ * @param dst storage array of at least 'n_elems' slots, if NULL the elements are deleted
+ * @param n_elems maximum number of elements to retrieve
+ * @return the number of elements retrieved, SIZE_MAX on failure
+ */
+size_t wal_queue__dequeue_n(const WalQueue q, void *dst, const size_t n_elems);
+
+
+/**
+ * @brief retrieve the front element without logging anything
+ * @details the element is stored in 'front' variable and must be manually freed by user afterward for a queue of pointers
+ * @note complexity: O(1)
+ * @param q the queue
+ * @param front pointer to storage variable
+ * @return 0 on success, -1 on failure or if the queue is empty
+ */
+char wal_queue__peek_front(const WalQueue q, elem_t *front);
+
+
+/**
+ * @brief commits the pending records with an fdatasync, whatever the policy
+ * @note complexity: O(number of pending records)
+ * @param q the queue
+ * @return 0 on success, -1 on failure (the records stay pending)
+ */
+char wal_queue__sync(const WalQueue q);
+
+
+/**
+ * @brief commits the pending records then replaces the log with the records of the elements still queued
+ * @note complexity: O(n)
+ * @param q the queue
+ * @return 0 on success, -1 on failure (the current log is kept)
+ */
+char wal_queue__compact(const WalQueue q);
+
+
+/**
+ * @brief gives the metrics of the log: records replayed at open, records appended, commits, fdatasyncs and
+ * compactions since open, and the current byte size of the log
+ * @note complexity: O(1)
+ * @param q the queue
+ * @param stats storage of the metrics
+ * @return 0 on success, -1 on failure
+ */
+char wal_queue__stats(const WalQueue q, wal_queue_stats_t *stats);
+
+
+/**
+ * @brief commits the pending records, closes the log and frees all allocated memory used by the queue
+ * @details the log stays in its directory, the elements of a queue of pointers are deleted
+ * @note complexity: O(n)
+ * @param q the queue
+ */
+void wal_queue__free(const WalQueue q);
+
+
+#endif
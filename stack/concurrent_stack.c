@@ -0,0 +1,250 @@
+#include <stdatomic.h>
+#include <stdlib.h>
+
+#include "concurrent_stack.h"
+
+#define ELIMINATION_SIZE 16
+#define ELIMINATION_SPINS 128
+
+///////////////////////////////////////////////////////////////////////////////
+///     CONCURRENT STACK STRUCTURE
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Nodes are never freed while the stack lives: they move between the stack and a free list,
+ * both referenced by a 64 bits word holding a modification tag (high half) and 'index + 1' of
+ * the first node (low half, 0 for an empty list), so that a recycled node never fools a CAS (ABA)
+ */
+typedef struct
+{
+    _Atomic uint32_t next;
+    _Atomic(elem_t) elem;
+} node_t;
+
+/**
+ * An elimination slot holds a tag and the reference of a node offered by a pusher, 0 when free
+ */
+typedef struct
+{
+    _Alignas(CACHE_LINE_SIZE) _Atomic uint64_t offer;
+} elimination_slot_t;
+
+struct ConcurrentStackSt
+{
+    node_t *nodes;
+    size_t capacity;
+    char copy_enabled;
+    copy_operator_t operator_copy;
+    delete_operator_t operator_delete;
+
+    _Alignas(CACHE_LINE_SIZE) _Atomic uint64_t top;
+
+    _Alignas(CACHE_LINE_SIZE) _Atomic uint64_t free_list;
+
+    elimination_slot_t elimination[ELIMINATION_SIZE];
+};
+
+static _Thread_local uint32_t elimination_seed = 2463534242u;
+
+///////////////////////////////////////////////////////////////////////////////
+///     CONCURRENT STACK MACRO UTILITARIES
+///////////////////////////////////////////////////////////////////////////////
+
+static inline elem_t id(elem_t e) {
+    return e;
+}
+
+static inline void skip(elem_t e) {
+    return;
+}
+
+#define TAGGED(__tag, __ref) \
+    (((uint64_t)(__tag) << 32) | (uint64_t)(__ref))
+
+#define TAG_OF(__word) \
+    ((uint32_t)((__word) >> 32))
+
+#define REF_OF(__word) \
+    ((uint32_t)(__word))
+
+#define NODE(__ptr, __ref) \
+    (&(__ptr)->nodes[(__ref) - 1])
+
+/**
+ * Returned by 'tagged_try_pop' when the list was not empty but another thread won the CAS
+ */
+#define CONTENDED UINT32_MAX
+
+/**
+ * Macro to allocate all memory used by the stack, every node starts in the free list
+ */
+#define CONCURRENT_STACK_INIT(__copy_op, __delete_op, __n_elems) \
+({ \
+    size_t __capacity = (__n_elems); \
+    ConcurrentStack __ptr = __capacity && __capacity < UINT32_MAX ? aligned_alloc(CACHE_LINE_SIZE, sizeof(struct ConcurrentStackSt)) : NULL; \
+    if (__ptr) { \
+        __ptr->nodes = malloc(sizeof(node_t) * __capacity); \
+        if (__ptr->nodes) { \
+            for (size_t i = 0; i < __capacity; i++) { \
+                atomic_init(&__ptr->nodes[i].next, i + 1 < __capacity ? (uint32_t)(i + 2) : 0); \
+                atomic_init(&__ptr->nodes[i].elem, NULL); \
+            } \
+            for (size_t i = 0; i < ELIMINATION_SIZE; i++) { \
+                atomic_init(&__ptr->elimination[i].offer, 0); \
+            } \
+            __ptr->capacity = __capacity; \
+            __ptr->copy_enabled = __copy_op ? true : false; \
+            __ptr->operator_copy = __copy_op ? __copy_op : id; \
+            __ptr->operator_delete = __delete_op ? __delete_op : skip; \
+            atomic_init(&__ptr->top, 0); \
+            atomic_init(&__ptr->free_list, TAGGED(0, 1)); \
+        } else { \
+            free(__ptr); \
+            __ptr = NULL; \
+        } \
+    } \
+    __ptr; \
+})
+
+static inline char tagged_try_push(_Atomic uint64_t *list, node_t *nodes, uint32_t ref) {
+    uint64_t old = atomic_load_explicit(list, memory_order_relaxed);
+    atomic_store_explicit(&nodes[ref - 1].next, REF_OF(old), memory_order_relaxed);
+
+    return atomic_compare_exchange_weak_explicit(list, &old, TAGGED(TAG_OF(old) + 1, ref),
+                                                 memory_order_release, memory_order_relaxed) ? SUCCESS : FAILURE;
+}
+
+static inline uint32_t tagged_try_pop(_Atomic uint64_t *list, node_t *nodes) {
+    uint64_t old = atomic_load_explicit(list, memory_order_acquire);
+    uint32_t ref = REF_OF(old);
+    if (!ref) return 0;
+
+    uint32_t next = atomic_load_explicit(&nodes[ref - 1].next, memory_order_relaxed);
+
+    return atomic_compare_exchange_weak_explicit(list, &old, TAGGED(TAG_OF(old) + 1, next),
+                                                 memory_order_acquire, memory_order_relaxed) ? ref : CONTENDED;
+}
+
+static inline elimination_slot_t *random_slot(const ConcurrentStack s) {
+    elimination_seed ^= elimination_seed << 13;
+    elimination_seed ^= elimination_seed >> 17;
+    elimination_seed ^= elimination_seed << 5;
+
+    return &s->elimination[elimination_seed % ELIMINATION_SIZE];
+}
+
+/**
+ * Offers the node 'ref' in a random elimination slot and waits for a popper to take it
+ */
+static char eliminate_push(const ConcurrentStack s, uint32_t ref) {
+    elimination_slot_t *slot = random_slot(s);
+    uint64_t old = atomic_load_explicit(&slot->offer, memory_order_relaxed);
+    if (REF_OF(old)) return FAILURE;
+
+    uint64_t posted = TAGGED(TAG_OF(old) + 1, ref);
+    if (!atomic_compare_exchange_strong_explicit(&slot->offer, &old, posted, memory_order_release, memory_order_relaxed)) {
+        return FAILURE;
+    }
+
+    for (size_t i = 0; i < ELIMINATION_SPINS; i++) {
+        if (atomic_load_explicit(&slot->offer, memory_order_relaxed) != posted) return SUCCESS;
+    }
+
+    return atomic_compare_exchange_strong_explicit(&slot->offer, &posted, TAGGED(TAG_OF(posted) + 1, 0),
+                                                   memory_order_relaxed, memory_order_relaxed) ? FAILURE : SUCCESS;
+}
+
+/**
+ * Takes the node offered in a random elimination slot, returns 0 if there is none
+ */
+static uint32_t eliminate_pop(const ConcurrentStack s) {
+    elimination_slot_t *slot = random_slot(s);
+    uint64_t old = atomic_load_explicit(&slot->offer, memory_order_relaxed);
+    uint32_t ref = REF_OF(old);
+    if (!ref) return 0;
+
+    return atomic_compare_exchange_strong_explicit(&slot->offer, &old, TAGGED(TAG_OF(old) + 1, 0),
+                                                   memory_order_acquire, memory_order_relaxed) ? ref : 0;
+}
+
+static inline uint32_t alloc_node(const ConcurrentStack s) {
+    uint32_t ref;
+    while ((ref = tagged_try_pop(&s->free_list, s->nodes)) == CONTENDED);
+
+    return ref;
+}
+
+static inline void release_node(const ConcurrentStack s, uint32_t ref) {
+    while (tagged_try_push(&s->free_list, s->nodes, ref) < 0);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///     CONCURRENT STACK FUNCTIONS TO EXPORT
+///////////////////////////////////////////////////////////////////////////////
+
+ConcurrentStack concurrent_stack__empty_copy_disabled(const size_t capacity) {
+    return CONCURRENT_STACK_INIT(NULL, NULL, capacity);
+}
+
+ConcurrentStack concurrent_stack__empty_copy_enabled(const size_t capacity, const copy_operator_t copy_op, const delete_operator_t delete_op) {
+    if (!copy_op || !delete_op) return NULL;
+
+    return CONCURRENT_STACK_INIT(copy_op, delete_op, capacity);
+}
+
+inline char concurrent_stack__is_copy_enabled(const ConcurrentStack s) {
+    return !s ? FAILURE : s->copy_enabled;
+}
+
+char concurrent_stack__is_empty(const ConcurrentStack s) {
+    return !s ? FAILURE : !REF_OF(atomic_load_explicit(&s->top, memory_order_acquire));
+}
+
+inline size_t concurrent_stack__capacity(const ConcurrentStack s) {
+    return !s ? SIZE_MAX : s->capacity;
+}
+
+char concurrent_stack__push(const ConcurrentStack s, const elem_t element) {
+    if (!s) return FAILURE;
+
+    uint32_t ref = alloc_node(s);
+    if (!ref) return FAILURE;
+
+    atomic_store_explicit(&NODE(s, ref)->elem, s->operator_copy(element), memory_order_relaxed);
+
+    while (tagged_try_push(&s->top, s->nodes, ref) < 0 && eliminate_push(s, ref) < 0);
+
+    return SUCCESS;
+}
+
+char concurrent_stack__pop(const ConcurrentStack s, elem_t *top) {
+    if (!s) return FAILURE;
+
+    uint32_t ref;
+    while ((ref = tagged_try_pop(&s->top, s->nodes)) == CONTENDED) {
+        if ((ref = eliminate_pop(s))) break;
+    }
+    if (!ref) return FAILURE;
+
+    elem_t elem = atomic_load_explicit(&NODE(s, ref)->elem, memory_order_relaxed);
+    release_node(s, ref);
+
+    if (top) {
+        *top = elem;
+    } else {
+        s->operator_delete(elem);
+    }
+
+    return SUCCESS;
+}
+
+void concurrent_stack__free(const ConcurrentStack s) {
+    if (!s) return;
+
+    if (s->copy_enabled) {
+        while (!concurrent_stack__pop(s, NULL));
+    }
+
+    free(s->nodes);
+    free(s);
+}
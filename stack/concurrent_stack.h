@@ -0,0 +1,109 @@
+#ifndef __CONCURRENT_STACK_H__
+#define __CONCURRENT_STACK_H__
+
+#include <stddef.h>
+
+#include "../common/defs.h"
+
+
+/**
+ * Implementation of a bounded lock-free FILO Abstract Data Type shared by any number of threads
+ *
+ * Notes :
+ * 1) You have to correctly implement copy and delete operators
+ * by handling NULL value, otherwise you can end up with an undefined behaviour.
+ * The prototypes of these functions are:
+ * elem_t (*copy_op)(elem_t)
+ * void (*delete_op)(elem_t)
+ *
+ * 2) Push and pop are safe to call from any thread at the same time,
+ * 'concurrent_stack__free' must not run concurrently with them.
+ *
+ * 3) With copy enabled the copy is made when pushing, the element retrieved by 'concurrent_stack__pop'
+ * is that copy and the user has to manually free it after usage.
+ *
+ * 4) Under contention a push and a pop may exchange their element through an elimination array
+ * without touching the top of the stack, both operations are then linearized at the exchange.
+ */
+typedef struct ConcurrentStackSt * ConcurrentStack;
+
+
+/**
+ * @brief create an empty bounded stack with copy disabled
+ * @note complexity: O(n)
+ * @param capacity maximum number of elements, must be less than UINT32_MAX
+ * @return a pointer to stack on success, NULL on failure
+ */
+ConcurrentStack concurrent_stack__empty_copy_disabled(const size_t capacity);
+
+
+/**
+ * @brief create an empty bounded stack with copy enabled
+ * @note complexity: O(n)
+ * @param capacity maximum number of elements, must be less than UINT32_MAX
+ * @param copy_op copy operator
+ * @param delete_op delete operator
+ * @return a pointer to stack on success, NULL on failure
+ */
+ConcurrentStack concurrent_stack__empty_copy_enabled(const size_t capacity, const copy_operator_t copy_op, const delete_operator_t delete_op);
+
+
+/**
+ * @brief checks if the stack has the copy operator enabled
+ * @note complexity: O(1)
+ * @param s the stack
+ * @return 1 if the stack has copy enabled, 0 if not, -1 on failure
+ */
+char concurrent_stack__is_copy_enabled(const ConcurrentStack s);
+
+
+/**
+ * @brief checks if the stack is empty
+ * @details the value is only a snapshot when other threads are running
+ * @note complexity: O(1)
+ * @param s the stack
+ * @return 1 if the stack is empty, 0 if not, -1 on failure
+ */
+char concurrent_stack__is_empty(const ConcurrentStack s);
+
+
+/**
+ * @brief maximum number of elements the stack can hold
+ * @note complexity: O(1)
+ * @param s the stack
+ * @return the capacity of the stack on success, SIZE_MAX on failure
+ */
+size_t concurrent_stack__capacity(const ConcurrentStack s);
+
+
+/**
+ * @brief adds an element in the stack
+ * @note complexity: O(1) amortized, lock-free
+ * @param s the stack
+ * @param element the element to add
+ * @return 0 on success, -1 on failure or if the stack is full
+ */
+char concurrent_stack__push(const ConcurrentStack s, const elem_t element);
+
+
+/**
+ * @brief retrieve the top element and remove it of the stack
+ * @details the element is stored in 'top' variable and must be manually freed by user afterward if copy is enabled
+ * @note complexity: O(1) amortized, lock-free
+ * @param s the stack
+ * @param top pointer to storage variable, if NULL the element is deleted
+ * @return 0 on success, -1 on failure or if the stack is empty
+ */
+char concurrent_stack__pop(const ConcurrentStack s, elem_t *top);
+
+
+/**
+ * @brief frees all allocated memory used by the stack
+ * @details if copy is enabled frees all memory used by the elements in the stack
+ * @note complexity: O(n)
+ * @param s the stack
+ */
+void concurrent_stack__free(const ConcurrentStack s);
+
+
+#endif
@@ -4,6 +4,10 @@
 
 #include "stack.h"
 #include "../common/vec.h"
+#include "../common/parallel_sort.h"
+#include "../common/radix_sort.h"
+#include "../common/hash_index.h"
+#include "../common/stream.h"
 
 #define DEFAULT_STACK_CAPACITY 2
 
@@ -17,9 +21,18 @@ struct StackSt
     size_t back;
     size_t length;
     size_t capacity;
+    size_t elem_size;
+    allocator_t allocator;
+    capacity_policy_t policy;
     char copy_enabled;
     copy_operator_t operator_copy;
     delete_operator_t operator_delete;
+    copy_n_operator_t operator_copy_n;
+    delete_n_operator_t operator_delete_n;
+    size_operator_t operator_size;
+    Arena arena;
+    PtrSet seen;
+    HashIndex index;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -37,38 +50,184 @@ static inline void skip(elem_t e) {
 /**
  * Macro to allocate all memory used by the stack
  */
-#define STACK_INIT(__copy_op, __delete_op, __n_elems) \
+#define STACK_INIT(__allocator, __copy_op, __delete_op, __size_op, __n_elems, __elem_size) \
 ({ \
-    Stack __ptr = malloc(sizeof(struct StackSt)); \
+    allocator_t __alloc = (__allocator); \
+    Stack __ptr = ALLOC(__alloc, sizeof(struct StackSt)); \
     if (__ptr) { \
-        __ptr->elems = malloc(sizeof(elem_t) * (__n_elems)); \
+        __ptr->allocator = __alloc; \
+        __ptr->policy = DEFAULT_POLICY(DEFAULT_STACK_CAPACITY); \
+        __ptr->elem_size = (__elem_size); \
+        __ptr->elems = ALLOC(__alloc, SLOT_SIZE(__ptr) * (__n_elems)); \
         if (__ptr->elems) { \
             __ptr->back = 0; \
             __ptr->length = 0; \
             __ptr->capacity = (__n_elems); \
-            __ptr->copy_enabled = __copy_op ? true : false; \
-            __ptr->operator_copy = __copy_op ? __copy_op : id; \
-            __ptr->operator_delete = __delete_op ? __delete_op : skip; \
-        } else { \
-            free(__ptr); \
+            __ptr->copy_enabled = __copy_op || __size_op ? true : false; \
+            __ptr->operator_copy = __copy_op ? __copy_op : __size_op ? arena__clone : id; \
+            __ptr->operator_delete = __delete_op ? __delete_op : __size_op ? arena__release : skip; \
+            __ptr->operator_copy_n = NULL; \
+            __ptr->operator_delete_n = NULL; \
+            __ptr->operator_size = (__size_op); \
+            __ptr->arena = __size_op ? arena__empty() : NULL; \
+            __ptr->index = NULL; \
+            __ptr->seen = NULL; \
+        } \
+        if (!__ptr->elems || (__size_op && !__ptr->arena)) { \
+            if (__ptr->elems) DEALLOC(__alloc, __ptr->elems); \
+            DEALLOC(__alloc, __ptr); \
             __ptr = NULL; \
         } \
     } \
     __ptr; \
 })
 
+///////////////////////////////////////////////////////////////////////////////
+///     STACK INDEX UTILITARIES
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Positions in the hash index are the positions in 'elems', NULL pointers are not indexed
+ */
+#define IS_INDEXED(__ptr, __i) \
+    ((__ptr)->elem_size || (__ptr)->elems[__i])
+
+static elem_t index_get(const void *s, size_t pos) {
+    return ELEM((const struct StackSt *)s, pos);
+}
+
+static void index_remove(const Stack s, const size_t i) {
+    if (s->index && IS_INDEXED(s, i)) {
+        hash_index__remove(s->index, ELEM(s, i), i);
+    }
+}
+
+/**
+ * Indexes the elements from position 'start' to the top, or none of them on failure
+ */
+static char index_range(const Stack s, const size_t start) {
+    for (size_t i = start; i < s->length; i++) {
+        if (IS_INDEXED(s, i) && hash_index__insert(s->index, ELEM(s, i), i) < 0) {
+            while (i-- > start) {
+                index_remove(s, i);
+            }
+            return FAILURE;
+        }
+    }
+    return SUCCESS;
+}
+
+/**
+ * Reindexes all the elements after they moved, the table already had room for all of them
+ */
+static void index_rebuild(const Stack s) {
+    if (!s->index) return;
+
+    hash_index__clear(s->index);
+    index_range(s, 0);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 ///     STACK FUNCTIONS TO EXPORT
 ///////////////////////////////////////////////////////////////////////////////
 
 Stack stack__empty_copy_disabled(void) {
-    return STACK_INIT(NULL, NULL, DEFAULT_STACK_CAPACITY);
+    return STACK_INIT(DEFAULT_ALLOCATOR, NULL, NULL, NULL, DEFAULT_STACK_CAPACITY, 0);
 }
 
 Stack stack__empty_copy_enabled(const copy_operator_t copy_op, const delete_operator_t delete_op) {
     if (!copy_op || !delete_op) return NULL;
 
-    return STACK_INIT(copy_op, delete_op, DEFAULT_STACK_CAPACITY);
+    return STACK_INIT(DEFAULT_ALLOCATOR, copy_op, delete_op, NULL, DEFAULT_STACK_CAPACITY, 0);
+}
+
+Stack stack__empty_copy_enabled_n(const copy_operator_t copy_op, const delete_operator_t delete_op,
+                                  const copy_n_operator_t copy_n_op, const delete_n_operator_t delete_n_op) {
+    if (!copy_op || !delete_op) return NULL;
+
+    Stack s = STACK_INIT(DEFAULT_ALLOCATOR, copy_op, delete_op, NULL, DEFAULT_STACK_CAPACITY, 0);
+    if (s) {
+        s->operator_copy_n = copy_n_op;
+        s->operator_delete_n = delete_n_op;
+    }
+
+    return s;
+}
+
+Stack stack__empty_inline(const size_t elem_size) {
+    if (!elem_size) return NULL;
+
+    return STACK_INIT(DEFAULT_ALLOCATOR, NULL, NULL, NULL, DEFAULT_STACK_CAPACITY, elem_size);
+}
+
+Stack stack__empty_arena(const size_operator_t size_op) {
+    if (!size_op) return NULL;
+
+    return STACK_INIT(DEFAULT_ALLOCATOR, NULL, NULL, size_op, DEFAULT_STACK_CAPACITY, 0);
+}
+
+Stack stack__empty_with_allocator(const allocator_t *allocator, const copy_operator_t copy_op, const delete_operator_t delete_op) {
+    if (!allocator || !allocator->alloc || !allocator->realloc || !allocator->free || !copy_op != !delete_op) return NULL;
+
+    return STACK_INIT(*allocator, copy_op, delete_op, NULL, DEFAULT_STACK_CAPACITY, 0);
+}
+
+Stack stack__with_capacity(const size_t capacity) {
+    size_t min_capacity = capacity < DEFAULT_STACK_CAPACITY ? DEFAULT_STACK_CAPACITY : capacity;
+    Stack s = STACK_INIT(DEFAULT_ALLOCATOR, NULL, NULL, NULL, min_capacity, 0);
+    if (s) {
+        s->policy.min_capacity = min_capacity;
+    }
+
+    return s;
+}
+
+Stack stack__adopt(elem_t *buffer, const size_t length, const size_t capacity, const size_t elem_size) {
+    if (!buffer || !capacity || length > capacity) return NULL;
+
+    Stack s = STACK_INIT(DEFAULT_ALLOCATOR, NULL, NULL, NULL, DEFAULT_STACK_CAPACITY, elem_size);
+    if (!s) return NULL;
+
+    DEALLOC(s->allocator, s->elems);
+    s->elems = buffer;
+    s->capacity = capacity;
+    s->length = length;
+    s->back = length;
+
+    return s;
+}
+
+Stack stack__empty_indexed(const hash_func_t hash, const compare_func_t match) {
+    if (!hash || !match) return NULL;
+
+    Stack s = STACK_INIT(DEFAULT_ALLOCATOR, NULL, NULL, NULL, DEFAULT_STACK_CAPACITY, 0);
+    if (s && stack__set_index(s, hash, match) < 0) {
+        stack__free(s);
+        s = NULL;
+    }
+
+    return s;
+}
+
+char stack__set_index(const Stack s, const hash_func_t hash, const compare_func_t match) {
+    if (!s || !hash != !match) return FAILURE;
+
+    HashIndex index = hash ? hash_index__empty(hash, match, index_get, s, &s->allocator) : NULL;
+    if (hash && !index) return FAILURE;
+
+    hash_index__free(s->index);
+    s->index = index;
+    if (index && index_range(s, 0) < 0) {
+        hash_index__free(s->index);
+        s->index = NULL;
+        return FAILURE;
+    }
+
+    return SUCCESS;
+}
+
+inline char stack__is_indexed(const Stack s) {
+    return !s ? FAILURE : s->index != NULL;
 }
 
 inline char stack__is_copy_enabled(const Stack s) {
@@ -83,12 +242,45 @@ inline size_t stack__length(const Stack s) {
     return !s ? SIZE_MAX : s->length;
 }
 
-char stack__push(const Stack s, const elem_t element) {
+inline size_t stack__elem_size(const Stack s) {
+    return !s ? SIZE_MAX : s->elem_size;
+}
+
+inline size_t stack__capacity(const Stack s) {
+    return !s ? SIZE_MAX : s->capacity;
+}
+
+char stack__set_policy(const Stack s, const capacity_policy_t *policy) {
+    if (!s || !policy || !POLICY_IS_VALID(*policy, false)) return FAILURE;
+
+    s->policy = *policy;
+
+    return SUCCESS;
+}
+
+char stack__reserve(const Stack s, const size_t n_elems) {
+    if (!s) return FAILURE;
+
+    return n_elems > s->capacity ? RESIZE(s, n_elems) : SUCCESS;
+}
+
+char stack__shrink_to_fit(const Stack s) {
     if (!s) return FAILURE;
 
-    if (ENSURE_CAPACITY(s) < 0) return FAILURE;
+    ptr_set__release(s->seen);
+
+    size_t new_capacity = s->length < s->policy.min_capacity ? s->policy.min_capacity : s->length;
+
+    return new_capacity < s->capacity ? RESIZE(s, new_capacity) : SUCCESS;
+}
+
+char stack__push(const Stack s, const elem_t element) {
+    if (!s || (s->elem_size && !element)) return FAILURE;
 
-    s->elems[s->length] = s->operator_copy(element);
+    if (ENSURE_CAPACITY(s, s->policy) < 0) return FAILURE;
+    if (s->index && element && hash_index__insert(s->index, element, s->length) < 0) return FAILURE;
+
+    ELEM_STORE(s, s->length, element);
     s->back++;
     s->length++;
 
@@ -96,29 +288,99 @@ char stack__push(const Stack s, const elem_t element) {
 }
 
 char stack__pop(const Stack s, elem_t *top) {
-    size_t new_capacity;
     if (!s || !s->length) return FAILURE;
 
+    index_remove(s, s->length-1);
     if (top) {
-        *top = s->elems[s->length-1];
-    } else {
+        ELEM_LOAD(s, s->length-1, top, s->arena ? s->operator_copy : id);
+    }
+    if (!s->elem_size && (!top || s->arena)) {
         s->operator_delete(s->elems[s->length-1]);
     }
 
     s->back--;
     s->length--;
 
-    new_capacity = s->capacity>>1;
-    if (s->length < new_capacity && new_capacity >= DEFAULT_STACK_CAPACITY) {
-        RESIZE(s, new_capacity);
+    SHRINK(s, s->policy);
+
+    return SUCCESS;
+}
+
+char stack__push_n(const Stack s, const void *A, const size_t n_elems) {
+    if (!s || (!A && n_elems)) return FAILURE;
+    if (!n_elems) return SUCCESS;
+
+    if (RESERVE_N(s, n_elems, s->policy) < 0) return FAILURE;
+
+    ELEMS_STORE(s, s->length, A, n_elems);
+    s->back += n_elems;
+    s->length += n_elems;
+
+    if (s->index && index_range(s, s->length - n_elems) < 0) {
+        s->back -= n_elems;
+        s->length -= n_elems;
+        ELEMS_TAKE(s, s->length, NULL, n_elems);
+        return FAILURE;
+    }
+
+    return SUCCESS;
+}
+
+char stack__push_owned(const Stack s, const elem_t element) {
+    if (!s || s->elem_size || s->arena) return FAILURE;
+
+    if (ENSURE_CAPACITY(s, s->policy) < 0) return FAILURE;
+    if (s->index && element && hash_index__insert(s->index, element, s->length) < 0) return FAILURE;
+
+    s->elems[s->length] = element;
+    s->back++;
+    s->length++;
+
+    return SUCCESS;
+}
+
+char stack__push_owned_n(const Stack s, const elem_t *A, const size_t n_elems) {
+    if (!s || s->elem_size || s->arena || (!A && n_elems)) return FAILURE;
+    if (!n_elems) return SUCCESS;
+
+    if (RESERVE_N(s, n_elems, s->policy) < 0) return FAILURE;
+
+    ELEMS_MOVE(s, s->length, A, n_elems);
+    s->back += n_elems;
+    s->length += n_elems;
+
+    /* the elements are left to the caller on failure */
+    if (s->index && index_range(s, s->length - n_elems) < 0) {
+        s->back -= n_elems;
+        s->length -= n_elems;
+        return FAILURE;
     }
 
     return SUCCESS;
 }
 
+size_t stack__pop_n(const Stack s, void *dst, const size_t n_elems) {
+    if (!s) return SIZE_MAX;
+
+    size_t n_popped = n_elems < s->length ? n_elems : s->length;
+    if (!n_popped) return 0;
+
+    for (size_t i = s->length - n_popped; s->index && i < s->length; i++) {
+        index_remove(s, i);
+    }
+    ELEMS_TAKE(s, s->length - n_popped, dst, n_popped);
+    s->back -= n_popped;
+    s->length -= n_popped;
+
+    SHRINK_N(s, s->policy);
+
+    return n_popped;
+}
+
 char stack__remove_nth(const Stack s, const size_t i) {
-    if (!s || i >= s->length) return FAILURE;
+    if (!s || s->elem_size || i >= s->length) return FAILURE;
 
+    index_remove(s, i);
     s->operator_delete(s->elems[i]);
     s->elems[i] = NULL;
 
@@ -128,7 +390,7 @@ char stack__remove_nth(const Stack s, const size_t i) {
 char stack__peek_top(const Stack s, elem_t *top) {
     if (!s || !s->length || !top) return FAILURE;
 
-    *top = s->operator_copy(s->elems[s->length-1]);
+    ELEM_LOAD(s, s->length-1, top, s->operator_copy);
 
     return SUCCESS;
 }
@@ -136,7 +398,31 @@ char stack__peek_top(const Stack s, elem_t *top) {
 char stack__peek_nth(const Stack s, const size_t i, elem_t *nth) {
     if (!s || !s->length || !nth || i >= s->length) return FAILURE;
 
-    *nth = s->operator_copy(s->elems[i]);
+    ELEM_LOAD(s, i, nth, s->operator_copy);
+
+    return SUCCESS;
+}
+
+char stack__borrow_top(const Stack s, const void **top) {
+    if (!s || !s->length || !top) return FAILURE;
+
+    *top = ELEM(s, s->length - 1);
+
+    return SUCCESS;
+}
+
+char stack__borrow_nth(const Stack s, const size_t i, const void **nth) {
+    if (!s || !nth || i >= s->length) return FAILURE;
+
+    *nth = ELEM(s, i);
+
+    return SUCCESS;
+}
+
+char stack__span(const Stack s, span_t *span) {
+    if (!s || !span) return FAILURE;
+
+    *span = (span_t){SLOT(s, 0), s->length, SLOT_SIZE(s)};
 
     return SUCCESS;
 }
@@ -144,7 +430,15 @@ char stack__peek_nth(const Stack s, const size_t i, elem_t *nth) {
 char stack__swap(const Stack s, const size_t i, const size_t j) {
     if (!s || i >= s->length || j >= s->length) return FAILURE;
 
-    SWAP(s, i, j);
+    if (s->index && i != j) {
+        index_remove(s, i);
+        index_remove(s, j);
+        SWAP(s, i, j);
+        if (IS_INDEXED(s, i)) hash_index__insert(s->index, ELEM(s, i), i);
+        if (IS_INDEXED(s, j)) hash_index__insert(s->index, ELEM(s, j), j);
+    } else {
+        SWAP(s, i, j);
+    }
 
     return SUCCESS;
 }
@@ -152,39 +446,82 @@ char stack__swap(const Stack s, const size_t i, const size_t j) {
 Stack stack__copy(const Stack s) {
     if (!s) return NULL;
 
-    Stack copy = STACK_INIT(s->operator_copy, s->operator_delete, s->length);
+    Stack copy = STACK_INIT(s->allocator, s->operator_copy, s->operator_delete, s->operator_size, s->length, s->elem_size);
     if (!copy) return NULL;
 
+    copy->policy = s->policy;
     COPY(copy, s, 0, s->length);
+    copy->back = copy->length;
+
+    if (s->index && stack__set_index(copy, hash_index__hash(s->index), hash_index__match(s->index)) < 0) {
+        stack__free(copy);
+        return NULL;
+    }
 
     return copy;
 }
 
 Stack stack__from_array(Stack s, void *A, const size_t n_elems, const size_t size) {
-    if (!A) return NULL;
+    if (!A || (s && s->elem_size && s->elem_size != size)) return NULL;
 
     if (!s) {
-        if (!(s = STACK_INIT(NULL, NULL, n_elems))) return NULL;
+        if (!(s = STACK_INIT(DEFAULT_ALLOCATOR, NULL, NULL, NULL, n_elems, 0))) return NULL;
     } else {
-        if (RESIZE(s, s->back + n_elems) < 0) return NULL;
+        if (stack__reserve(s, s->back + n_elems) < 0) return NULL;
     }
 
     FROM_ARRAY(s, A, n_elems, size);
 
+    if (s->index && index_range(s, s->length - n_elems) < 0) {
+        s->back -= n_elems;
+        s->length -= n_elems;
+        ELEMS_TAKE(s, s->length, NULL, n_elems);
+        return NULL;
+    }
+
     return s;
 }
 
 elem_t *stack__dump(const Stack s) {
     if (!s || !s->length) return NULL;
 
-    elem_t *res = malloc(sizeof(elem_t) * s->length);
+    elem_t *res = malloc(SLOT_SIZE(s) * s->length);
     if (!res) return NULL;
 
-    memcpy(res, s->elems, sizeof(elem_t) * s->length);
-    RESIZE(s, DEFAULT_STACK_CAPACITY);
+    if (s->arena) {
+        for (size_t i = 0; i < s->length; i++) {
+            res[i] = s->operator_copy(s->elems[i]);
+        }
+        arena__reset(s->arena);
+    } else {
+        memcpy(res, s->elems, SLOT_SIZE(s) * s->length);
+    }
+    if (s->policy.shrink_threshold) {
+        RESIZE(s, s->policy.min_capacity);
+    }
+    hash_index__clear(s->index);
+
+    s->back = 0;
+    s->length = 0;
+
+    return res;
+}
+
+elem_t *stack__steal(const Stack s, size_t *length, size_t *capacity) {
+    if (!s || s->arena) return NULL;
 
+    elem_t *elems = ALLOC(s->allocator, SLOT_SIZE(s) * s->policy.min_capacity);
+    if (!elems) return NULL;
+
+    elem_t *res = s->elems;
+    if (length) *length = s->length;
+    if (capacity) *capacity = s->capacity;
+
+    s->elems = elems;
+    s->capacity = s->policy.min_capacity;
     s->back = 0;
     s->length = 0;
+    hash_index__clear(s->index);
 
     return res;
 }
@@ -192,15 +529,93 @@ elem_t *stack__dump(const Stack s) {
 elem_t *stack__to_array(const Stack s) {
     if (!s || !s->length) return NULL;
 
-    elem_t *res = malloc(sizeof(elem_t) * s->length);
+    elem_t *res = malloc(SLOT_SIZE(s) * s->length);
     if (!res) return NULL;
 
     if (s->copy_enabled) {
-        for (size_t i = 0; i < s->length; i++) {
-            res[i] = s->operator_copy(s->elems[i]);
+        COPY_N(s, res, s->elems, s->length);
+    } else {
+        memcpy(res, s->elems, SLOT_SIZE(s) * s->length);
+    }
+
+    return res;
+}
+
+char stack__serialize(const Stack s, const int fd, const elem_writer_t writer) {
+    if (!s || (!s->elem_size && !writer)) return FAILURE;
+
+    Stream st = stream__open(fd, &s->allocator);
+    if (!st) return FAILURE;
+
+    stream_header_t header = {STREAM_STACK, s->elem_size ? STREAM_FIXED_SIZE : 0, s->elem_size, s->length};
+    char res = stream__write_header(st, &header);
+    if (s->elem_size) {
+        res = res < 0 ? res : stream__write_raw(st, s->elems, s->elem_size * s->length);
+    } else {
+        for (size_t i = 0; res == SUCCESS && i < s->length; i++) {
+            res = stream__write_elem(st, s->elems[i], writer);
         }
+        res = res < 0 ? res : stream__flush(st);
+    }
+    stream__free(st);
+
+    return res;
+}
+
+Stack stack__deserialize(Stack s, const int fd, const elem_reader_t reader, const delete_operator_t delete_op) {
+    if (s && s->arena) return NULL;
+
+    allocator_t allocator = s ? s->allocator : DEFAULT_ALLOCATOR;
+    Stream st = stream__open(fd, &allocator);
+    if (!st) return NULL;
+
+    stream_header_t header;
+    char fixed_size;
+    if (stream__read_header(st, &header) < 0 || header.kind != STREAM_STACK
+        || (fixed_size = header.flags & STREAM_FIXED_SIZE) != !!header.elem_size
+        || (s ? s->elem_size != header.elem_size : header.elem_size > SIZE_MAX)
+        || (!fixed_size && (!reader || (!delete_op && !(s && s->copy_enabled))))
+        || header.count > SIZE_MAX / (fixed_size ? header.elem_size : sizeof(elem_t))) {
+        stream__free(st);
+        return NULL;
+    }
+
+    size_t n_elems = (size_t)header.count;
+    Stack res = s;
+    if (!res) {
+        res = STACK_INIT(allocator, NULL, NULL, NULL, n_elems ? n_elems : DEFAULT_STACK_CAPACITY, (size_t)header.elem_size);
+    } else if (res->back + n_elems < res->back || stack__reserve(res, res->back + n_elems) < 0) {
+        res = NULL;
+    }
+    if (!res) {
+        stream__free(st);
+        return NULL;
+    }
+
+    size_t n_read = 0;
+    if (fixed_size) {
+        n_read = stream__read_raw(st, SLOT(res, res->back), res->elem_size * n_elems) < 0 ? 0 : n_elems;
     } else {
-        memcpy(res, s->elems, sizeof(elem_t) * s->length);
+        while (n_read < n_elems && stream__read_elem(st, reader, &res->elems[res->back + n_read]) == SUCCESS) {
+            n_read++;
+        }
+    }
+    stream__free(st);
+
+    res->back += n_read;
+    res->length += n_read;
+    if (n_read < n_elems || (res->index && index_range(res, res->length - n_read) < 0)) {
+        res->back -= n_read;
+        res->length -= n_read;
+        if (fixed_size || res->copy_enabled) {
+            ELEMS_TAKE(res, res->length, NULL, n_read);
+        } else {
+            for (size_t i = 0; i < n_read; i++) {
+                delete_op(res->elems[res->length + i]);
+            }
+        }
+        if (!s) stack__free(res);
+        return NULL;
     }
 
     return res;
@@ -215,6 +630,10 @@ size_t stack__ptr_search(const Stack s, const elem_t elem) {
 size_t stack__search(const Stack s, const elem_t elem, const compare_func_t match) {
     if (!s || !match) return SIZE_MAX;
 
+    if (s->index && elem && match == hash_index__match(s->index)) {
+        return hash_index__find(s->index, elem);
+    }
+
     return SEARCH(s, 0, s->length, elem, match);
 }
 
@@ -227,7 +646,7 @@ char stack__ptr_contains(const Stack s, const elem_t elem) {
 char stack__contains(const Stack s, const elem_t elem, const compare_func_t match) {
     if (!s || !match) return FAILURE;
 
-    return SEARCH(s, 0, s->length, elem, match) != SIZE_MAX;
+    return stack__search(s, elem, match) != SIZE_MAX;
 }
 
 char stack__cmp(const Stack s, const Stack t, const compare_func_t match) {
@@ -236,7 +655,7 @@ char stack__cmp(const Stack s, const Stack t, const compare_func_t match) {
     if (s == t) return true;
     if (s->length != t->length) return false;
 
-    return ARRAY_CMP(s->elems, t->elems, match, s->length);
+    return ARRAY_CMP(s, 0, t, 0, match, s->length);
 }
 
 char stack__all(const Stack s, const filter_func_t pred, void *user_data) {
@@ -254,13 +673,78 @@ char stack__any(const Stack s, const filter_func_t pred, void *user_data) {
 void stack__foreach(const Stack s, const applying_func_t func, void *user_data) {
     if (!s || !func) return;
 
-    FOREACH(s, func, user_data, 0, s->length);
+    if (!s->copy_enabled && !s->elem_size && !s->seen) {
+        s->seen = ptr_set__empty(&s->allocator);
+    }
+    FOREACH(s, func, user_data, 0, s->length, s->seen);
+}
+
+void stack__foreach_all(const Stack s, const applying_func_t func, void *user_data) {
+    if (!s || !func) return;
+
+    FOREACH_ALL(s, func, user_data, 0, s->length);
 }
 
 void stack__filter(const Stack s, const filter_func_t pred, void *user_data) {
     if (!s || !pred) return;
 
     FILTER(s, 0, s->length, pred, user_data);
+    s->back = s->length;
+    index_rebuild(s);
+}
+
+char stack__foreach_parallel(const Stack s, const applying_func_t func, void *user_data, const ThreadPool pool) {
+    if (!s || !func || !pool) return FAILURE;
+
+    if (thread_pool__foreach(pool, SLOT(s, 0), s->length, SLOT_SIZE(s), !s->elem_size, func, user_data) < 0) return FAILURE;
+
+    return SUCCESS;
+}
+
+char stack__all_parallel(const Stack s, const filter_func_t pred, void *user_data, const ThreadPool pool) {
+    if (!s || !pred || !pool) return FAILURE;
+
+    return thread_pool__all(pool, SLOT(s, 0), s->length, SLOT_SIZE(s), !s->elem_size, pred, user_data);
+}
+
+char stack__any_parallel(const Stack s, const filter_func_t pred, void *user_data, const ThreadPool pool) {
+    if (!s || !pred || !pool) return FAILURE;
+
+    return thread_pool__any(pool, SLOT(s, 0), s->length, SLOT_SIZE(s), !s->elem_size, pred, user_data);
+}
+
+char stack__filter_parallel(const Stack s, const filter_func_t pred, void *user_data, const ThreadPool pool) {
+    if (!s || !pred || !pool) return FAILURE;
+    if (!s->length) return SUCCESS;
+
+    size_t size = SLOT_SIZE(s);
+    char *scratch = ALLOC(s->allocator, s->length * (size + 1));
+    if (!scratch) return FAILURE;
+
+    char *kept = scratch + s->length * size;
+    size_t n_kept = thread_pool__filter(pool, SLOT(s, 0), s->length, size, !s->elem_size, pred, user_data, scratch, kept);
+    if (n_kept == SIZE_MAX) {
+        DEALLOC(s->allocator, scratch);
+        return FAILURE;
+    }
+
+    if (!s->elem_size) {
+        size_t n_rejected = 0;
+        for (size_t i = 0; i < s->length; i++) {
+            if (!kept[i]) {
+                s->elems[n_rejected++] = s->elems[i];
+            }
+        }
+        DELETE_N(s, s->elems, n_rejected);
+    }
+    memcpy(SLOT(s, 0), scratch, n_kept * size);
+    DEALLOC(s->allocator, scratch);
+
+    s->length = n_kept;
+    s->back = s->length;
+    index_rebuild(s);
+
+    return SUCCESS;
 }
 
 void stack__reverse(const Stack s) {
@@ -269,31 +753,57 @@ void stack__reverse(const Stack s) {
     for (size_t i = 0, j = s->length - 1; i < j; i++, j--) {
         SWAP(s, i, j);
     }
+    index_rebuild(s);
 }
 
 void stack__shuffle(const Stack s, const unsigned int seed) {
     if (!s) return;
 
     SHUFFLE(s, 0, s->length, seed);
+    index_rebuild(s);
 }
 
 void stack__sort(const Stack s, const compare_func_t cmp) {
     if (!s || !cmp) return;
 
-    qsort(s->elems, s->length, sizeof(elem_t), cmp);
+    qsort(s->elems, s->length, SLOT_SIZE(s), cmp);
+    index_rebuild(s);
+}
+
+char stack__sort_parallel(const Stack s, const compare_func_t cmp, const size_t n_threads, const char stable) {
+    if (!s || !cmp || !n_threads) return FAILURE;
+
+    if (parallel_sort(s->elems, s->length, SLOT_SIZE(s), cmp, n_threads, stable, &s->allocator) < 0) return FAILURE;
+    index_rebuild(s);
+
+    return SUCCESS;
+}
+
+char stack__sort_by_key(const Stack s, const key_func_t key) {
+    if (!s || !key) return FAILURE;
+
+    if (radix_sort(s->elems, s->length, SLOT_SIZE(s), key, !s->elem_size, &s->allocator) < 0) return FAILURE;
+    index_rebuild(s);
+
+    return SUCCESS;
 }
 
 void stack__clean_NULL(Stack s) {
     if (!s) return;
 
     CLEAN_NULL_ELEMS(s, 0, s->length);
+    s->back = s->length;
+    index_rebuild(s);
 }
 
 void stack__clear(const Stack s) {
     if (!s) return;
 
     FREE_ELEMS(s, 0, s->length);
-    RESIZE(s, DEFAULT_STACK_CAPACITY);
+    hash_index__clear(s->index);
+    if (s->policy.shrink_threshold) {
+        RESIZE(s, s->policy.min_capacity);
+    }
 }
 
 void stack__free(const Stack s) {
@@ -301,8 +811,12 @@ void stack__free(const Stack s) {
 
     FREE_ELEMS(s, 0, s->length);
 
-    free(s->elems);
-    free(s);
+    hash_index__free(s->index);
+    arena__free(s->arena);
+    ptr_set__free(s->seen);
+    allocator_t allocator = s->allocator;
+    DEALLOC(allocator, s->elems);
+    DEALLOC(allocator, s);
 }
 
 void stack__debug(const Stack s, const debug_func_t debug) {
@@ -320,7 +834,7 @@ void stack__debug(const Stack s, const debug_func_t debug) {
         printf("{ ");
         for (size_t i = 0; i < s->capacity; i++) {
             if (i < s->length) {
-                debug(s->elems[i]);
+                debug(ELEM(s, i));
             } else {
                 printf("_ ");
             }
@@ -2,6 +2,7 @@
 #define __STACK_H__
 
 #include "../common/defs.h"
+#include "../common/thread_pool.h"
 
 
 /**
@@ -18,6 +19,40 @@
  * 2) 'stack__peek_top' and 'stack__pop' return a dynamically allocated pointer to an element in the
  * the stack in order to make it survive independently of the stack life cycle.
  * The user has to manually free the return pointer after usage.
+ *
+ * 3) A stack created by 'stack__empty_inline' stores the values themselves contiguously instead of pointers.
+ * Elements given to the stack are pointers to a value of 'elem_size' bytes which is copied in, the storage
+ * variables given to pop and peek functions are pointers to a buffer of 'elem_size' bytes where the value
+ * is copied out. Predicates, compare and debug functions receive a pointer to the stored value.
+ *
+ * 4) A stack created by 'stack__empty_arena' copies the elements byte by byte in a slab allocator it owns (see common/arena.h),
+ * the elements must be flat values whose byte size is given by the size operator. The copies returned by the
+ * pop and peek functions are still allocated with malloc, clear and free release all the copies at once.
+ *
+ * 5) A stack created by 'stack__empty_indexed' or given an index by 'stack__set_index' maintains a hash table of the
+ * positions in the stack. 'stack__search' and 'stack__contains' look the element up in it in O(1) on average
+ * when they are given the match function of the index, and fall back to a linear search otherwise. The hash and match
+ * functions receive the elements like predicates do, matching elements must have the same hash. NULL pointers
+ * are not indexed. Functions moving several elements at once (filter, sort, reverse, shuffle...) rebuild the index
+ * in O(n). The elements must not be modified outside of the stack while they are indexed, and the callbacks of
+ * the foreach functions must not modify the fields read by the hash and match functions.
+ *
+ * 6) The borrow functions and 'stack__span' give read access to the stored elements without copying them.
+ * A borrowed element or span stays valid until the next call to a function writing to the stack buffer:
+ * push, push_n, push_owned, push_owned_n, from_array, deserialize, reserve and shrink_to_fit may move the slots
+ * to another array, pop, pop_n, remove_nth, dump, steal, clear and free delete or hand over the elements, and
+ * swap, filter, filter_parallel, reverse, shuffle, sort, sort_parallel, sort_by_key and clean_NULL change what a
+ * slot holds. The other functions (peek, borrow, search, contains, cmp, all, any, copy, to_array, serialize, the
+ * foreach functions and the parallel traversals) read the slots in place and keep them valid.
+ *
+ * 7) A stack created by 'stack__empty_copy_enabled_n' is also given batch copy and delete operators, called once
+ * per contiguous run of elements by the functions handling several elements at once (copy, from_array, to_array,
+ * pushes of several elements, filter, clear and free), so that the copies can be allocated or released together.
+ * Either of them may be NULL, the functions then call the operator of a single element on each element of the run.
+ * The prototypes of these functions are:
+ * void (*copy_n_op)(elem_t *dst, const elem_t *src, size_t n)
+ * void (*delete_n_op)(elem_t *elems, size_t n)
+ * 'dst' and 'src' may be the same array, the copies then replace the originals.
  */
 typedef struct StackSt * Stack;
 
@@ -40,6 +75,109 @@ Stack stack__empty_copy_disabled(void);
 Stack stack__empty_copy_enabled(const copy_operator_t copy_op, const delete_operator_t delete_op);
 
 
+/**
+ * @brief create an empty stack with copy enabled and batch copy and delete operators
+ * @note complexity: O(1)
+ * @param copy_op copy operator
+ * @param delete_op delete operator
+ * @param copy_n_op batch copy operator, may be NULL
+ * @param delete_n_op batch delete operator, may be NULL
+ * @return a pointer to stack on success, NULL on failure
+ */
+Stack stack__empty_copy_enabled_n(const copy_operator_t copy_op, const delete_operator_t delete_op,
+                                  const copy_n_operator_t copy_n_op, const delete_n_operator_t delete_n_op);
+
+
+/**
+ * @brief create an empty stack storing values of 'elem_size' bytes inline
+ * @details no copy and delete operators are needed, the values are copied byte by byte
+ * @note complexity: O(1)
+ * @param elem_size byte size of the values
+ * @return a pointer to stack on success, NULL on failure
+ */
+Stack stack__empty_inline(const size_t elem_size);
+
+
+/**
+ * @brief create an empty stack with copy enabled whose copies are allocated in an arena
+ * @details size_t (*size_op)(const void *) returns the byte size of the element to copy
+ * @note complexity: O(1)
+ * @param size_op size operator
+ * @return a pointer to stack on success, NULL on failure
+ */
+Stack stack__empty_arena(const size_operator_t size_op);
+
+
+/**
+ * @brief create an empty stack whose structure and array of elements are allocated by the given allocator
+ * @details copy is enabled if both operators are given, disabled if both are NULL
+ * @details the allocator is copied in the stack, its context must outlive the stack
+ * @note complexity: O(1)
+ * @param allocator the allocator
+ * @param copy_op copy operator
+ * @param delete_op delete operator
+ * @return a pointer to stack on success, NULL on failure
+ */
+Stack stack__empty_with_allocator(const allocator_t *allocator, const copy_operator_t copy_op, const delete_operator_t delete_op);
+
+
+/**
+ * @brief create an empty stack with copy disabled and room for 'capacity' elements
+ * @details 'capacity' is the minimum capacity of the policy, the stack never shrinks below it
+ * @note complexity: O(1)
+ * @param capacity initial capacity
+ * @return a pointer to stack on success, NULL on failure
+ */
+Stack stack__with_capacity(const size_t capacity);
+
+
+/**
+ * @brief create a stack on an existing array of elements without copying it
+ * @details the array must have been allocated with malloc, calloc or realloc and not through a custom allocator:
+ * the stack frees it or reallocates it with the default allocator when it grows.
+ * Its first 'length' slots hold the elements from the bottom to the top, pointers with copy disabled if
+ * 'elem_size' is null, packed values of 'elem_size' bytes like an inline stack otherwise
+ * @note complexity: O(1)
+ * @param buffer the array
+ * @param length the number of elements
+ * @param capacity the number of slots of the array
+ * @param elem_size the byte size of the values for an inline stack, 0 for pointers
+ * @return a pointer to stack on success, NULL on failure (the array is left to the caller)
+ */
+Stack stack__adopt(elem_t *buffer, const size_t length, const size_t capacity, const size_t elem_size);
+
+
+/**
+ * @brief create an empty stack with copy disabled and a hash index of its elements
+ * @note complexity: O(1)
+ * @param hash the hash function of the elements
+ * @param match the match function the index answers searches for
+ * @return a pointer to stack on success, NULL on failure
+ */
+Stack stack__empty_indexed(const hash_func_t hash, const compare_func_t match);
+
+
+/**
+ * @brief builds a hash index of the elements of the stack, replacing its current index
+ * @details with 'hash' and 'match' NULL the index is removed
+ * @note complexity: O(n)
+ * @param s the stack
+ * @param hash the hash function of the elements
+ * @param match the match function the index answers searches for
+ * @return 0 on success, -1 on failure (the current index is kept)
+ */
+char stack__set_index(const Stack s, const hash_func_t hash, const compare_func_t match);
+
+
+/**
+ * @brief checks if the stack has a hash index
+ * @note complexity: O(1)
+ * @param s the stack
+ * @return 1 if the stack is indexed, 0 if not, -1 on failure
+ */
+char stack__is_indexed(const Stack s);
+
+
 /**
  * @brief checks if the stack has the copy operator enabled
  * @note complexity: O(1)
@@ -67,6 +205,55 @@ char stack__is_empty(const Stack s);
 size_t stack__length(const Stack s);
 
 
+/**
+ * @brief byte size of the values stored inline
+ * @note complexity: O(1)
+ * @param s the stack
+ * @return the byte size of the values, 0 if the stack stores pointers, SIZE_MAX on failure
+ */
+size_t stack__elem_size(const Stack s);
+
+
+/**
+ * @brief number of elements the stack can hold without reallocating
+ * @note complexity: O(1)
+ * @param s the stack
+ * @return the capacity of the stack on success, SIZE_MAX on failure
+ */
+size_t stack__capacity(const Stack s);
+
+
+/**
+ * @brief sets the capacity policy of the stack
+ * @details by default the capacity doubles when the stack is full and halves once less than a quarter of it is used
+ * @details the growth factor must be at least 2, the shrink threshold must be 0 (never shrink) or at least the growth factor
+ * @note complexity: O(1)
+ * @param s the stack
+ * @param policy the policy
+ * @return 0 on success, -1 on failure
+ */
+char stack__set_policy(const Stack s, const capacity_policy_t *policy);
+
+
+/**
+ * @brief makes room for at least 'n_elems' elements
+ * @note complexity: O(n) if the stack is reallocated, O(1) if not
+ * @param s the stack
+ * @param n_elems number of elements
+ * @return 0 on success, -1 on failure
+ */
+char stack__reserve(const Stack s, const size_t n_elems);
+
+
+/**
+ * @brief reduces the capacity to the number of elements, without going below the minimum capacity of the policy
+ * @note complexity: O(n) if the stack is reallocated, O(1) if not
+ * @param s the stack
+ * @return 0 on success, -1 on failure
+ */
+char stack__shrink_to_fit(const Stack s);
+
+
 /**
  * @brief adds an element in the stack
  * @note complexity: O(1)
@@ -88,9 +275,62 @@ char stack__push(const Stack s, const elem_t element);
 char stack__pop(const Stack s, elem_t *top);
 
 
+/**
+ * @brief adds the 'n_elems' elements of 'A' in the stack, the last one ends on the top
+ * @details 'A' is an array of elements, or of values of 'elem_size' bytes for inline stacks.
+ * The stack is reallocated at most once and elements are copied in one block unless copy is enabled
+ * @note complexity: O(n_elems)
+ * @param s the stack
+ * @param A the array of elements
+ * @param n_elems the number of elements of 'A'
+ * @return 0 on success, -1 on failure
+ */
+char stack__push_n(const Stack s, const void *A, const size_t n_elems);
+
+
+/**
+ * @brief removes up to 'n_elems' elements from the top of the stack and stores them in 'dst'
+ * @details 'dst' receives the elements in the order they were pushed, the former top last, so popping
+ * what 'stack__push_n' pushed gives back the same array. It must have room for 'n_elems' elements,
+ * or values of 'elem_size' bytes for inline stacks. If 'dst' is NULL the elements are deleted.
+ * Like 'stack__pop', the stored elements are handed over and must be manually freed by user afterward
+ * @note complexity: O(n_elems)
+ * @param s the stack
+ * @param dst the array receiving the elements, or NULL
+ * @param n_elems the maximum number of elements to pop
+ * @return the number of elements popped on success, SIZE_MAX on failure
+ */
+size_t stack__pop_n(const Stack s, void *dst, const size_t n_elems);
+
+
+/**
+ * @brief adds an element already allocated by the caller on the top of the stack, without copying it
+ * @details with copy enabled the stack takes the element over and deletes it with its delete operator like its own
+ * copies, the caller must not free it anymore. With copy disabled it is the same as 'stack__push'. Fails for
+ * inline and arena stacks, which always copy the elements in
+ * @note complexity: O(1) amortized
+ * @param s the stack
+ * @param element the element
+ * @return 0 on success, -1 on failure (the element is left to the caller)
+ */
+char stack__push_owned(const Stack s, const elem_t element);
+
+
+/**
+ * @brief adds the 'n_elems' elements of 'A', already allocated by the caller, on the top of the stack without copying them
+ * @details same as 'stack__push_owned' for each element, the pointers are stored in one block
+ * @note complexity: O(n_elems)
+ * @param s the stack
+ * @param A the array of elements
+ * @param n_elems the number of elements of 'A'
+ * @return 0 on success, -1 on failure (the elements are left to the caller)
+ */
+char stack__push_owned_n(const Stack s, const elem_t *A, const size_t n_elems);
+
+
 /**
  * @brief remove the element in the nth position
- * @details the deleted item is still part of the stack as a null value instead
+ * @details the deleted item is still part of the stack as a null value instead, fails on inline stacks
  * @note complexity: O(1)
  * @param s the stack
  * @param i position
@@ -122,6 +362,42 @@ char stack__peek_top(const Stack s, elem_t *top);
 char stack__peek_nth(const Stack s, const size_t i, elem_t *nth);
 
 
+/**
+ * @brief lends the top element of the stack without copying it
+ * @details 'top' receives the stored pointer, or the address of the stored value if the stack is inline,
+ * it must not be freed and stays valid until the stack is modified (see note 6)
+ * @note complexity: O(1)
+ * @param s the stack
+ * @param top pointer to storage variable
+ * @return 0 on success, -1 on failure
+ */
+char stack__borrow_top(const Stack s, const void **top);
+
+
+/**
+ * @brief lends the element at 'i' position of the stack without copying it
+ * @details 'nth' receives the stored pointer, or the address of the stored value if the stack is inline,
+ * it must not be freed and stays valid until the stack is modified (see note 6)
+ * @note complexity: O(1)
+ * @param s the stack
+ * @param i position
+ * @param nth pointer to storage variable
+ * @return 0 on success, -1 on failure
+ */
+char stack__borrow_nth(const Stack s, const size_t i, const void **nth);
+
+
+/**
+ * @brief lends the slots of the stack, from the bottom to the top, without copying them
+ * @details the span stays valid until the stack is modified (see note 6)
+ * @note complexity: O(1)
+ * @param s the stack
+ * @param span pointer to storage variable
+ * @return 0 on success, -1 on failure
+ */
+char stack__span(const Stack s, span_t *span);
+
+
 /**
  * @brief swaps two elements of the stack
  * @note complexity: O(1)
@@ -146,6 +422,7 @@ Stack stack__copy(const Stack s);
 /**
  * @brief pushes the first 'n_elems' elements of the given array
  * @details if s == NULL creates a new stack with copy disabled by default
+ * @details if the stack is inline 'size' must be its 'elem_size'
  * @details if A == NULL returns the stack unaltered
  * @note complexity: O(n)
  * @param s the stack
@@ -160,6 +437,7 @@ Stack stack__from_array(Stack s, void *A, const size_t n_elems, const size_t siz
 /**
  * @brief dump all elements of the stack into an array
  * @details the array must be manually freed by user afterward, the stack is empty after use of this function
+ * @details the array of an inline stack holds the packed values
  * @note complexity: O(n)
  * @param s the stack
  * @return a pointer to dynamically allocated array on success, NULL on failure
@@ -167,9 +445,24 @@ Stack stack__from_array(Stack s, void *A, const size_t n_elems, const size_t siz
 elem_t *stack__dump(const Stack s);
 
 
+/**
+ * @brief detaches the array of elements of the stack and gives it to the caller without copying it
+ * @details the stack keeps working on a new array of the minimum capacity of its policy and is empty afterward.
+ * The array holds 'length' slots, and has room for 'capacity' slots. It was allocated with the allocator
+ * of the stack and must be freed with it, with free for the default one. The elements are given with the array,
+ * copy enabled elements must be deleted by the caller. Fails for an arena stack, whose elements live in the arena
+ * @note complexity: O(1)
+ * @param s the stack
+ * @param length optional pointer to storage variable of the number of elements
+ * @param capacity optional pointer to storage variable of the number of slots of the array
+ * @return the array on success, NULL on failure
+ */
+elem_t *stack__steal(const Stack s, size_t *length, size_t *capacity);
+
+
 /**
  * @brief retrieves a copy of all elements of the stack into an array
- * @details the array must be manually freed by user afterward
+ * @details the array must be manually freed by user afterward, the array of an inline stack holds the packed values
  * @note complexity: O(n)
  * @param s the stack
  * @return a pointer to dynamically allocated array on success, NULL on failure
@@ -177,8 +470,40 @@ elem_t *stack__dump(const Stack s);
 elem_t *stack__to_array(const Stack s);
 
 
+/**
+ * @brief writes the stack to a file descriptor in the binary format of common/stream.h, from bottom to top
+ * @details inline values are written as they are in one call, pointers are encoded by 'writer' and written by chunks
+ * @note complexity: O(n)
+ * @param s the stack
+ * @param fd the file descriptor
+ * @param writer the element writer, may be NULL if the stack is inline
+ * @return 0 on success, -1 on failure
+ */
+char stack__serialize(const Stack s, const int fd, const elem_writer_t writer);
+
+
+/**
+ * @brief pushes the elements of a stack read from a file descriptor, in the order they were pushed
+ * @details if s == NULL creates a new stack, inline if the stack was inline and with copy disabled otherwise
+ * @details inline values are read in one call straight into the slots, which must have the same size, pointers are
+ * built by 'reader', arena stacks are not supported. The elements built are owned by the stack if it has copy
+ * enabled, otherwise they are owned by the user who has to delete them after usage, like the pushed ones
+ * @details on failure the stack is left unaltered, the elements already built are deleted by the stack if it owns
+ * them and by 'delete_op' otherwise
+ * @note complexity: O(n)
+ * @param s the stack
+ * @param fd the file descriptor
+ * @param reader the element reader, may be NULL if the stack is inline
+ * @param delete_op the delete operator of the elements built by 'reader', may be NULL if the stack is inline or
+ * has copy enabled
+ * @return a pointer to stack on success, NULL on failure
+ */
+Stack stack__deserialize(Stack s, const int fd, const elem_reader_t reader, const delete_operator_t delete_op);
+
+
 /**
  * @brief search the given pointer
+ * @details on an inline stack searches a value equal byte by byte to the one pointed by 'elem'
  * @note complexity: O(n)
  * @param s the stack
  * @param elem the pointer to search
@@ -189,7 +514,8 @@ size_t stack__ptr_search(const Stack s, const elem_t elem);
 
 /**
  * @brief search the given element
- * @note complexity: O(n)
+ * @details uses the hash index if 'match' is the match function of the index of the stack
+ * @note complexity: O(n), O(1) on average with the hash index
  * @param s the stack
  * @param elem the element to search
  * @param match the matching function
@@ -210,7 +536,8 @@ char stack__ptr_contains(const Stack s, const elem_t elem);
 
 /**
  * @brief checks if a given element is on the stack
- * @note complexity: O(n)
+ * @details uses the hash index if 'match' is the match function of the index of the stack
+ * @note complexity: O(n), O(1) on average with the hash index
  * @param s the stack
  * @param elem the element
  * @param match the matching function
@@ -254,7 +581,9 @@ char stack__any(const Stack s, const filter_func_t pred, void *user_data);
 
 /**
  * @brief maps the given function to the stack
- * @note complexity: O(n) with copy enabled, O(n²) with copy disabled
+ * @details with copy disabled, a pointer stored several times is given to the function once, the pointers
+ * already visited are remembered in a scratch table kept by the stack until 'free' or 'shrink_to_fit'
+ * @note complexity: O(n), on average with copy disabled
  * @param s the stack
  * @param func the applying function
  * @param user_data optional data to be used as an additional argument of the application function
@@ -262,6 +591,17 @@ char stack__any(const Stack s, const filter_func_t pred, void *user_data);
 void stack__foreach(const Stack s, const applying_func_t func, void *user_data);
 
 
+/**
+ * @brief maps the given function to every element of the stack, including the pointers stored several times
+ * @details same as 'stack__foreach' with copy enabled or inline, for copy disabled stacks whose pointers are known to be unique
+ * @note complexity: O(n)
+ * @param s the stack
+ * @param func the applying function
+ * @param user_data optional data to be used as an additional argument of the application function
+ */
+void stack__foreach_all(const Stack s, const applying_func_t func, void *user_data);
+
+
 /**
  * @brief filter the given stack using a predicate
  * @note complexity: O(n)
@@ -272,6 +612,63 @@ void stack__foreach(const Stack s, const applying_func_t func, void *user_data);
 void stack__filter(const Stack s, const filter_func_t pred, void *user_data);
 
 
+/**
+ * @brief maps the given function to the stack with the threads of 'pool' (see common/thread_pool.h)
+ * @details the function is called concurrently and must be thread safe. Like with 'stack__foreach_all', a pointer
+ * stored several times is given to the function each time
+ * @note complexity: O(n/n_threads)
+ * @param s the stack
+ * @param func the applying function
+ * @param user_data optional data to be used as an additional argument of the application function
+ * @param pool the thread pool
+ * @return 0 on success, -1 on failure
+ */
+char stack__foreach_parallel(const Stack s, const applying_func_t func, void *user_data, const ThreadPool pool);
+
+
+/**
+ * @brief checks if all elements of the stack satisfy the predicate with the threads of 'pool'
+ * @details the predicate is called concurrently and must be thread safe, the threads stop at the first element
+ * which does not satisfy it
+ * @note complexity: O(n/n_threads)
+ * @param s the stack
+ * @param pred the predicate
+ * @param user_data optional data to be used as an additional argument of the predicate
+ * @param pool the thread pool
+ * @return 1 if all elements satisfy the predicate, 0 if not, -1 on failure
+ */
+char stack__all_parallel(const Stack s, const filter_func_t pred, void *user_data, const ThreadPool pool);
+
+
+/**
+ * @brief checks if any element of the stack satisfies the predicate with the threads of 'pool'
+ * @details the predicate is called concurrently and must be thread safe, the threads stop at the first element
+ * which satisfies it
+ * @note complexity: O(n/n_threads)
+ * @param s the stack
+ * @param pred the predicate
+ * @param user_data optional data to be used as an additional argument of the predicate
+ * @param pool the thread pool
+ * @return 1 if any element satisfies the predicate, 0 if not, -1 on failure
+ */
+char stack__any_parallel(const Stack s, const filter_func_t pred, void *user_data, const ThreadPool pool);
+
+
+/**
+ * @brief filter the given stack using a predicate evaluated with the threads of 'pool'
+ * @details the predicate is called concurrently and must be thread safe. The kept elements are compacted in
+ * parallel and keep their order, the others are deleted by the calling thread. A scratch buffer of the size of
+ * the elements is taken from the allocator of the stack
+ * @note complexity: O(n/n_threads)
+ * @param s the stack
+ * @param pred the predicate
+ * @param user_data optional data to be used as an additional argument of the predicate
+ * @param pool the thread pool
+ * @return 0 on success, -1 on failure (the elements are left unchanged)
+ */
+char stack__filter_parallel(const Stack s, const filter_func_t pred, void *user_data, const ThreadPool pool);
+
+
 /**
  * @brief reverse the stack
  * @note complexity: O(n)
@@ -290,6 +687,7 @@ void stack__shuffle(const Stack s, const unsigned int seed);
 
 /**
  * @brief uses qsort to sort the stack elements using the given compare function
+ * @details the compare function receives pointers to the slots, which hold the values on an inline stack
  * @note complexity: O(n*log(n))
  * @param s the stack
  * @param cmp the compare function
@@ -297,6 +695,35 @@ void stack__shuffle(const Stack s, const unsigned int seed);
 void stack__sort(const Stack s, const compare_func_t cmp);
 
 
+/**
+ * @brief sorts the stack elements with a merge sort spread over up to 'n_threads' threads (see common/parallel_sort.h)
+ * @details the compare function receives pointers to the slots like with 'stack__sort'. Stacks of less than
+ * PARALLEL_SORT_CUTOFF elements per thread use less threads, down to a sequential sort. If 'stable' is set,
+ * equal elements keep their order. A scratch buffer of the size of the elements is taken from the allocator
+ * of the stack, except for an unstable sequential sort
+ * @note complexity: O(n*log(n)/n_threads + n*log(n_threads))
+ * @param s the stack
+ * @param cmp the compare function
+ * @param n_threads the maximum number of threads, including the calling one
+ * @param stable keeps the order of equal elements if set
+ * @return 0 on success, -1 on failure (the elements are left unchanged)
+ */
+char stack__sort_parallel(const Stack s, const compare_func_t cmp, const size_t n_threads, const char stable);
+
+
+/**
+ * @brief sorts the stack elements by an integer key with a radix sort, without any comparison (see common/radix_sort.h)
+ * @details 'key' is called once per element and receives it like a predicate does, the stored pointer or the
+ * address of the value on an inline stack. Keys are ordered as unsigned integers and equal keys keep their order.
+ * Scratch buffers for the keys and the elements are taken from the allocator of the stack
+ * @note complexity: O(n)
+ * @param s the stack
+ * @param key the key extractor
+ * @return 0 on success, -1 on failure (the elements are left unchanged)
+ */
+char stack__sort_by_key(const Stack s, const key_func_t key);
+
+
 /**
  * @brief removes all NULL pointers in the stack
  * @note complexity: O(n)
@@ -308,7 +735,7 @@ void stack__clean_NULL(const Stack s);
 /**
  * @brief removes all elements in the stack
  * @details if copy is enabled frees all allocated memory used by these elements, the stack is still usable afterwards
- * @note complexity: O(n) with copy enabled, O(1) with copy disabled
+ * @note complexity: O(n) with copy enabled, O(1) with copy disabled or an arena
  * @param s the stack
  */
 void stack__clear(const Stack s);
@@ -317,7 +744,7 @@ void stack__clear(const Stack s);
 /**
  * @brief frees all allocated memory used by the stack
  * @details if copy is enabled frees all memory used by the elements in the stack
- * @note complexity: O(n) with copy enabled, O(1) with copy disabled
+ * @note complexity: O(n) with copy enabled, O(1) with copy disabled or an arena
  * @param s the stack
  */
 void stack__free(const Stack s);
@@ -0,0 +1,13 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "stack_typed.h"
+#include "../common/vec.h"
+
+///////////////////////////////////////////////////////////////////////////////
+///     TYPED STACKS PROVIDED BY DEFAULT
+///////////////////////////////////////////////////////////////////////////////
+
+STACK_DEFINE(int, int, TYPED_EQUAL, TYPED_LESS, TYPED_ID, TYPED_SKIP)
+
+STACK_DEFINE(double, double, TYPED_EQUAL, TYPED_LESS, TYPED_ID, TYPED_SKIP)
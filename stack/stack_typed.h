@@ -0,0 +1,243 @@
+#ifndef __STACK_TYPED_H__
+#define __STACK_TYPED_H__
+
+#include <stddef.h>
+
+#include "../common/defs.h"
+
+#define DEFAULT_TYPED_STACK_CAPACITY 2
+
+
+/**
+ * Compile-time typed FILO Abstract Data Types
+ *
+ * Notes :
+ * 1) 'STACK_DECLARE(T, NAME)' declares the type 'Stack_NAME' storing values of type 'T' and its functions
+ * 'stack_NAME__*', it belongs to a header. 'STACK_DEFINE(T, NAME, EQUAL, LESS, COPY, DELETE)' generates their
+ * implementation in a single source file, the last four arguments are macros or inline functions expanded
+ * in the generated code instead of being called through pointers:
+ * int EQUAL(T a, T b)
+ * int LESS(T a, T b)
+ * T COPY(T a)
+ * void DELETE(T a)
+ * 'TYPED_EQUAL', 'TYPED_LESS', 'TYPED_ID' and 'TYPED_SKIP' of 'vec.h' suit arithmetic types.
+ *
+ * 2) The generated functions behave like their 'Stack' counterparts with copy enabled: values are copied
+ * with 'COPY' when pushed, 'stack_NAME__peek_*', 'stack_NAME__copy' and 'stack_NAME__to_array' return copies,
+ * values removed or freed by the stack go through 'DELETE'.
+ *
+ * 3) 'stack_NAME__sort' is an introsort using 'LESS', it is not stable.
+ *
+ * 4) Stacks of int ('Stack_int') and double ('Stack_double') are provided by 'stack_typed.c'.
+ *
+ * Generated functions:
+ * Stack_NAME stack_NAME__empty(void)
+ * char       stack_NAME__is_empty(const Stack_NAME s)
+ * size_t     stack_NAME__length(const Stack_NAME s)
+ * char       stack_NAME__push(const Stack_NAME s, const T element)
+ * char       stack_NAME__pop(const Stack_NAME s, T *top)                      (if top is NULL the value is deleted)
+ * char       stack_NAME__peek_top(const Stack_NAME s, T *top)
+ * char       stack_NAME__peek_nth(const Stack_NAME s, const size_t i, T *nth)
+ * Stack_NAME stack_NAME__copy(const Stack_NAME s)
+ * Stack_NAME stack_NAME__from_array(Stack_NAME s, const T *A, const size_t n_elems)
+ * T         *stack_NAME__to_array(const Stack_NAME s)
+ * size_t     stack_NAME__search(const Stack_NAME s, const T elem)
+ * char       stack_NAME__contains(const Stack_NAME s, const T elem)
+ * void       stack_NAME__foreach(const Stack_NAME s, void (*func)(T *, void *), void *user_data)
+ * void       stack_NAME__sort(const Stack_NAME s)
+ * void       stack_NAME__reverse(const Stack_NAME s)
+ * void       stack_NAME__clear(const Stack_NAME s)
+ * void       stack_NAME__free(const Stack_NAME s)
+ * with the same return conventions as 'Stack': 0 on success, -1 on failure, SIZE_MAX or NULL on failure.
+ */
+#define STACK_DECLARE(T, NAME) \
+typedef struct Stack_##NAME##_St * Stack_##NAME; \
+Stack_##NAME stack_##NAME##__empty(void); \
+char stack_##NAME##__is_empty(const Stack_##NAME s); \
+size_t stack_##NAME##__length(const Stack_##NAME s); \
+char stack_##NAME##__push(const Stack_##NAME s, const T element); \
+char stack_##NAME##__pop(const Stack_##NAME s, T *top); \
+char stack_##NAME##__peek_top(const Stack_##NAME s, T *top); \
+char stack_##NAME##__peek_nth(const Stack_##NAME s, const size_t i, T *nth); \
+Stack_##NAME stack_##NAME##__copy(const Stack_##NAME s); \
+Stack_##NAME stack_##NAME##__from_array(Stack_##NAME s, const T *A, const size_t n_elems); \
+T *stack_##NAME##__to_array(const Stack_##NAME s); \
+size_t stack_##NAME##__search(const Stack_##NAME s, const T elem); \
+char stack_##NAME##__contains(const Stack_##NAME s, const T elem); \
+void stack_##NAME##__foreach(const Stack_##NAME s, void (*func)(T *, void *), void *user_data); \
+void stack_##NAME##__sort(const Stack_##NAME s); \
+void stack_##NAME##__reverse(const Stack_##NAME s); \
+void stack_##NAME##__clear(const Stack_##NAME s); \
+void stack_##NAME##__free(const Stack_##NAME s);
+
+/**
+ * 'elem_size' is only read by the 'vec.h' macros shared with 'Stack'
+ */
+#define STACK_DEFINE(T, NAME, EQUAL, LESS, COPY, DELETE) \
+struct Stack_##NAME##_St \
+{ \
+    T *elems; \
+    size_t back; \
+    size_t length; \
+    size_t capacity; \
+    size_t elem_size; \
+    allocator_t allocator; \
+}; \
+\
+TYPED_SORT_DEFINE(T, stack_##NAME, LESS) \
+\
+static Stack_##NAME stack_##NAME##__init(const size_t capacity) { \
+    Stack_##NAME s = ALLOC(DEFAULT_ALLOCATOR, sizeof(struct Stack_##NAME##_St)); \
+    if (s) { \
+        s->allocator = DEFAULT_ALLOCATOR; \
+        s->elems = ALLOC(s->allocator, sizeof(T) * capacity); \
+        if (s->elems) { \
+            s->back = 0; \
+            s->length = 0; \
+            s->capacity = capacity; \
+            s->elem_size = sizeof(T); \
+        } else { \
+            DEALLOC(s->allocator, s); \
+            s = NULL; \
+        } \
+    } \
+    return s; \
+} \
+\
+Stack_##NAME stack_##NAME##__empty(void) { \
+    return stack_##NAME##__init(DEFAULT_TYPED_STACK_CAPACITY); \
+} \
+\
+char stack_##NAME##__is_empty(const Stack_##NAME s) { \
+    return !s ? FAILURE : !s->length; \
+} \
+\
+size_t stack_##NAME##__length(const Stack_##NAME s) { \
+    return !s ? SIZE_MAX : s->length; \
+} \
+\
+char stack_##NAME##__push(const Stack_##NAME s, const T element) { \
+    if (!s) return FAILURE; \
+    if (ENSURE_CAPACITY(s, DEFAULT_POLICY(DEFAULT_TYPED_STACK_CAPACITY)) < 0) return FAILURE; \
+    s->elems[s->length] = COPY(element); \
+    s->back++; \
+    s->length++; \
+    return SUCCESS; \
+} \
+\
+char stack_##NAME##__pop(const Stack_##NAME s, T *top) { \
+    if (!s || !s->length) return FAILURE; \
+    s->back--; \
+    s->length--; \
+    if (top) { \
+        *top = s->elems[s->length]; \
+    } else { \
+        DELETE(s->elems[s->length]); \
+    } \
+    SHRINK(s, DEFAULT_POLICY(DEFAULT_TYPED_STACK_CAPACITY)); \
+    return SUCCESS; \
+} \
+\
+char stack_##NAME##__peek_top(const Stack_##NAME s, T *top) { \
+    if (!s || !s->length || !top) return FAILURE; \
+    *top = COPY(s->elems[s->length - 1]); \
+    return SUCCESS; \
+} \
+\
+char stack_##NAME##__peek_nth(const Stack_##NAME s, const size_t i, T *nth) { \
+    if (!s || !nth || i >= s->length) return FAILURE; \
+    *nth = COPY(s->elems[i]); \
+    return SUCCESS; \
+} \
+\
+Stack_##NAME stack_##NAME##__copy(const Stack_##NAME s) { \
+    if (!s) return NULL; \
+    Stack_##NAME copy = stack_##NAME##__init(s->length ? s->length : DEFAULT_TYPED_STACK_CAPACITY); \
+    if (!copy) return NULL; \
+    for (size_t i = 0; i < s->length; i++) { \
+        copy->elems[i] = COPY(s->elems[i]); \
+    } \
+    copy->back = copy->length = s->length; \
+    return copy; \
+} \
+\
+Stack_##NAME stack_##NAME##__from_array(Stack_##NAME s, const T *A, const size_t n_elems) { \
+    if (!A) return NULL; \
+    if (!s) { \
+        if (!(s = stack_##NAME##__init(n_elems ? n_elems : DEFAULT_TYPED_STACK_CAPACITY))) return NULL; \
+    } else if (s->length + n_elems > s->capacity) { \
+        if (RESIZE(s, s->length + n_elems) < 0) return NULL; \
+    } \
+    for (size_t i = 0; i < n_elems; i++) { \
+        s->elems[s->length + i] = COPY(A[i]); \
+    } \
+    s->back = s->length += n_elems; \
+    return s; \
+} \
+\
+T *stack_##NAME##__to_array(const Stack_##NAME s) { \
+    if (!s || !s->length) return NULL; \
+    T *res = malloc(sizeof(T) * s->length); \
+    if (!res) return NULL; \
+    for (size_t i = 0; i < s->length; i++) { \
+        res[i] = COPY(s->elems[i]); \
+    } \
+    return res; \
+} \
+\
+size_t stack_##NAME##__search(const Stack_##NAME s, const T elem) { \
+    if (!s) return SIZE_MAX; \
+    for (size_t i = 0; i < s->length; i++) { \
+        if (EQUAL(s->elems[i], elem)) return i; \
+    } \
+    return SIZE_MAX; \
+} \
+\
+char stack_##NAME##__contains(const Stack_##NAME s, const T elem) { \
+    if (!s) return FAILURE; \
+    return stack_##NAME##__search(s, elem) != SIZE_MAX; \
+} \
+\
+void stack_##NAME##__foreach(const Stack_##NAME s, void (*func)(T *, void *), void *user_data) { \
+    if (!s || !func) return; \
+    for (size_t i = 0; i < s->length; i++) { \
+        func(&s->elems[i], user_data); \
+    } \
+} \
+\
+void stack_##NAME##__sort(const Stack_##NAME s) { \
+    if (!s) return; \
+    stack_##NAME##__typed_sort(s->elems, s->length); \
+} \
+\
+void stack_##NAME##__reverse(const Stack_##NAME s) { \
+    if (!s || s->length < 2) return; \
+    for (size_t i = 0, j = s->length - 1; i < j; i++, j--) { \
+        TYPED_SWAP(T, s->elems[i], s->elems[j]); \
+    } \
+} \
+\
+void stack_##NAME##__clear(const Stack_##NAME s) { \
+    if (!s) return; \
+    for (size_t i = 0; i < s->length; i++) { \
+        DELETE(s->elems[i]); \
+    } \
+    s->back = 0; \
+    s->length = 0; \
+    RESIZE(s, DEFAULT_TYPED_STACK_CAPACITY); \
+} \
+\
+void stack_##NAME##__free(const Stack_##NAME s) { \
+    if (!s) return; \
+    for (size_t i = 0; i < s->length; i++) { \
+        DELETE(s->elems[i]); \
+    } \
+    DEALLOC(s->allocator, s->elems); \
+    DEALLOC(s->allocator, s); \
+}
+
+STACK_DECLARE(int, int)
+STACK_DECLARE(double, double)
+
+
+#endif
@@ -0,0 +1,220 @@
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "ws_deque.h"
+
+#define DEFAULT_WS_DEQUE_CAPACITY 32
+
+///////////////////////////////////////////////////////////////////////////////
+///     WORK-STEALING DEQUE STRUCTURE
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Circular buffer indexed by the absolute positions 'top' and 'bottom' modulo its capacity,
+ * replaced buffers are chained through 'retired' until the deque is freed
+ */
+typedef struct buffer_t
+{
+    size_t capacity;
+    struct buffer_t *retired;
+    _Atomic(elem_t) elems[];
+} buffer_t;
+
+struct WsDequeSt
+{
+    _Atomic(buffer_t *) buffer;
+    char copy_enabled;
+    copy_operator_t operator_copy;
+    delete_operator_t operator_delete;
+
+    _Alignas(CACHE_LINE_SIZE) _Atomic int64_t top;
+
+    _Alignas(CACHE_LINE_SIZE) _Atomic int64_t bottom;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+///     WORK-STEALING DEQUE MACRO UTILITARIES
+///////////////////////////////////////////////////////////////////////////////
+
+static inline elem_t id(elem_t e) {
+    return e;
+}
+
+static inline void skip(elem_t e) {
+    return;
+}
+
+#define BUFFER_SLOT(__buf, __pos) \
+    (&(__buf)->elems[(size_t)(__pos) & ((__buf)->capacity - 1)])
+
+/**
+ * Macro to allocate all memory used by the deque
+ */
+#define WS_DEQUE_INIT(__copy_op, __delete_op, __n_elems) \
+({ \
+    WsDeque __ptr = aligned_alloc(CACHE_LINE_SIZE, sizeof(struct WsDequeSt)); \
+    if (__ptr) { \
+        buffer_t *__buf = buffer_alloc(__n_elems); \
+        if (__buf) { \
+            atomic_init(&__ptr->buffer, __buf); \
+            __ptr->copy_enabled = __copy_op ? true : false; \
+            __ptr->operator_copy = __copy_op ? __copy_op : id; \
+            __ptr->operator_delete = __delete_op ? __delete_op : skip; \
+            atomic_init(&__ptr->top, 0); \
+            atomic_init(&__ptr->bottom, 0); \
+        } else { \
+            free(__ptr); \
+            __ptr = NULL; \
+        } \
+    } \
+    __ptr; \
+})
+
+static buffer_t *buffer_alloc(size_t capacity) {
+    buffer_t *buf = malloc(sizeof(buffer_t) + sizeof(_Atomic(elem_t)) * capacity);
+    if (buf) {
+        buf->capacity = capacity;
+        buf->retired = NULL;
+    }
+
+    return buf;
+}
+
+/**
+ * Doubles the buffer, only the owner calls it so the elements between 'top' and 'bottom' cannot move,
+ * a thief still reading the old buffer finds the same elements at the same positions
+ */
+static buffer_t *buffer_grow(const WsDeque d, buffer_t *old, int64_t top, int64_t bottom) {
+    buffer_t *buf = buffer_alloc(old->capacity << 1);
+    if (!buf) return NULL;
+
+    for (int64_t i = top; i < bottom; i++) {
+        atomic_store_explicit(BUFFER_SLOT(buf, i), atomic_load_explicit(BUFFER_SLOT(old, i), memory_order_relaxed), memory_order_relaxed);
+    }
+    buf->retired = old;
+    atomic_store_explicit(&d->buffer, buf, memory_order_release);
+
+    return buf;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///     WORK-STEALING DEQUE FUNCTIONS TO EXPORT
+///////////////////////////////////////////////////////////////////////////////
+
+WsDeque ws_deque__empty_copy_disabled(void) {
+    return WS_DEQUE_INIT(NULL, NULL, DEFAULT_WS_DEQUE_CAPACITY);
+}
+
+WsDeque ws_deque__empty_copy_enabled(const copy_operator_t copy_op, const delete_operator_t delete_op) {
+    if (!copy_op || !delete_op) return NULL;
+
+    return WS_DEQUE_INIT(copy_op, delete_op, DEFAULT_WS_DEQUE_CAPACITY);
+}
+
+inline char ws_deque__is_copy_enabled(const WsDeque d) {
+    return !d ? FAILURE : d->copy_enabled;
+}
+
+char ws_deque__is_empty(const WsDeque d) {
+    return !d ? FAILURE : !ws_deque__length(d);
+}
+
+size_t ws_deque__length(const WsDeque d) {
+    if (!d) return SIZE_MAX;
+
+    int64_t top = atomic_load_explicit(&d->top, memory_order_acquire);
+    int64_t bottom = atomic_load_explicit(&d->bottom, memory_order_acquire);
+
+    return bottom > top ? (size_t)(bottom - top) : 0;
+}
+
+char ws_deque__push(const WsDeque d, const elem_t element) {
+    if (!d) return FAILURE;
+
+    int64_t bottom = atomic_load_explicit(&d->bottom, memory_order_relaxed);
+    int64_t top = atomic_load_explicit(&d->top, memory_order_acquire);
+    buffer_t *buf = atomic_load_explicit(&d->buffer, memory_order_relaxed);
+
+    if ((size_t)(bottom - top) >= buf->capacity) {
+        if (!(buf = buffer_grow(d, buf, top, bottom))) return FAILURE;
+    }
+
+    atomic_store_explicit(BUFFER_SLOT(buf, bottom), d->operator_copy(element), memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&d->bottom, bottom + 1, memory_order_relaxed);
+
+    return SUCCESS;
+}
+
+char ws_deque__pop(const WsDeque d, elem_t *bottom_elem) {
+    if (!d) return FAILURE;
+
+    int64_t bottom = atomic_load_explicit(&d->bottom, memory_order_relaxed) - 1;
+    buffer_t *buf = atomic_load_explicit(&d->buffer, memory_order_relaxed);
+    atomic_store_explicit(&d->bottom, bottom, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    int64_t top = atomic_load_explicit(&d->top, memory_order_relaxed);
+
+    if (top > bottom) {
+        atomic_store_explicit(&d->bottom, bottom + 1, memory_order_relaxed);
+        return FAILURE;
+    }
+
+    elem_t elem = atomic_load_explicit(BUFFER_SLOT(buf, bottom), memory_order_relaxed);
+    if (top == bottom) {
+        // last element, race against the thieves for it
+        char won = atomic_compare_exchange_strong_explicit(&d->top, &top, top + 1,
+                                                           memory_order_seq_cst, memory_order_relaxed);
+        atomic_store_explicit(&d->bottom, bottom + 1, memory_order_relaxed);
+        if (!won) return FAILURE;
+    }
+
+    if (bottom_elem) {
+        *bottom_elem = elem;
+    } else {
+        d->operator_delete(elem);
+    }
+
+    return SUCCESS;
+}
+
+char ws_deque__steal(const WsDeque d, elem_t *top_elem) {
+    if (!d) return FAILURE;
+
+    int64_t top = atomic_load_explicit(&d->top, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    int64_t bottom = atomic_load_explicit(&d->bottom, memory_order_acquire);
+
+    if (top >= bottom) return FAILURE;
+
+    buffer_t *buf = atomic_load_explicit(&d->buffer, memory_order_acquire);
+    elem_t elem = atomic_load_explicit(BUFFER_SLOT(buf, top), memory_order_relaxed);
+    if (!atomic_compare_exchange_strong_explicit(&d->top, &top, top + 1, memory_order_seq_cst, memory_order_relaxed)) {
+        return FAILURE;
+    }
+
+    if (top_elem) {
+        *top_elem = elem;
+    } else {
+        d->operator_delete(elem);
+    }
+
+    return SUCCESS;
+}
+
+void ws_deque__free(const WsDeque d) {
+    if (!d) return;
+
+    if (d->copy_enabled) {
+        while (!ws_deque__pop(d, NULL));
+    }
+
+    buffer_t *buf = atomic_load_explicit(&d->buffer, memory_order_relaxed);
+    while (buf) {
+        buffer_t *retired = buf->retired;
+        free(buf);
+        buf = retired;
+    }
+    free(d);
+}
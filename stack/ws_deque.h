@@ -0,0 +1,122 @@
+#ifndef __WS_DEQUE_H__
+#define __WS_DEQUE_H__
+
+#include <stddef.h>
+
+#include "../common/defs.h"
+
+
+/**
+ * Implementation of an unbounded lock-free work-stealing deque (Chase-Lev)
+ *
+ * Notes :
+ * 1) You have to correctly implement copy and delete operators
+ * by handling NULL value, otherwise you can end up with an undefined behaviour.
+ * The prototypes of these functions are:
+ * elem_t (*copy_op)(elem_t)
+ * void (*delete_op)(elem_t)
+ *
+ * 2) The deque has a single owner thread, the only one allowed to call 'ws_deque__push' and 'ws_deque__pop'
+ * which work as a stack at the bottom end. Any number of other threads may call 'ws_deque__steal'
+ * at the same time to take the oldest element at the top end. 'ws_deque__free' must not run concurrently
+ * with any of them.
+ *
+ * 3) The buffer doubles when full like 'Stack' does, the buffers it replaces may still be read by thieves
+ * so they are only released by 'ws_deque__free'.
+ *
+ * 4) With copy enabled the copy is made when pushing, the element retrieved by 'ws_deque__pop' or
+ * 'ws_deque__steal' is that copy and the user has to manually free it after usage.
+ */
+typedef struct WsDequeSt * WsDeque;
+
+
+/**
+ * @brief create an empty work-stealing deque with copy disabled
+ * @note complexity: O(1)
+ * @return a pointer to deque on success, NULL on failure
+ */
+WsDeque ws_deque__empty_copy_disabled(void);
+
+
+/**
+ * @brief create an empty work-stealing deque with copy enabled
+ * @note complexity: O(1)
+ * @param copy_op copy operator
+ * @param delete_op delete operator
+ * @return a pointer to deque on success, NULL on failure
+ */
+WsDeque ws_deque__empty_copy_enabled(const copy_operator_t copy_op, const delete_operator_t delete_op);
+
+
+/**
+ * @brief checks if the deque has the copy operator enabled
+ * @note complexity: O(1)
+ * @param d the deque
+ * @return 1 if the deque has copy enabled, 0 if not, -1 on failure
+ */
+char ws_deque__is_copy_enabled(const WsDeque d);
+
+
+/**
+ * @brief checks if the deque is empty
+ * @details the value is only a snapshot when thieves are running
+ * @note complexity: O(1)
+ * @param d the deque
+ * @return 1 if the deque is empty, 0 if not, -1 on failure
+ */
+char ws_deque__is_empty(const WsDeque d);
+
+
+/**
+ * @brief number of elements in the deque
+ * @details the value is only a snapshot when thieves are running
+ * @note complexity: O(1)
+ * @param d the deque
+ * @return the number of elements on success, SIZE_MAX on failure
+ */
+size_t ws_deque__length(const WsDeque d);
+
+
+/**
+ * @brief adds an element at the bottom of the deque, owner thread only
+ * @note complexity: O(1) amortized, lock-free
+ * @param d the deque
+ * @param element the element to add
+ * @return 0 on success, -1 on failure
+ */
+char ws_deque__push(const WsDeque d, const elem_t element);
+
+
+/**
+ * @brief retrieve the bottom element, the last pushed, and remove it of the deque, owner thread only
+ * @details the element is stored in 'bottom' variable and must be manually freed by user afterward if copy is enabled
+ * @note complexity: O(1), lock-free
+ * @param d the deque
+ * @param bottom pointer to storage variable, if NULL the element is deleted
+ * @return 0 on success, -1 on failure or if the deque is empty
+ */
+char ws_deque__pop(const WsDeque d, elem_t *bottom);
+
+
+/**
+ * @brief retrieve the top element, the oldest, and remove it of the deque, from any thread
+ * @details the element is stored in 'top' variable and must be manually freed by user afterward if copy is enabled,
+ * a thief that loses the race against the owner or another thief gets -1 and may try again
+ * @note complexity: O(1), lock-free
+ * @param d the deque
+ * @param top pointer to storage variable, if NULL the element is deleted
+ * @return 0 on success, -1 on failure, if the deque is empty or if another thread took the element
+ */
+char ws_deque__steal(const WsDeque d, elem_t *top);
+
+
+/**
+ * @brief frees all allocated memory used by the deque
+ * @details if copy is enabled frees all memory used by the elements in the deque
+ * @note complexity: O(n)
+ * @param d the deque
+ */
+void ws_deque__free(const WsDeque d);
+
+
+#endif
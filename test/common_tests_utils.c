@@ -1,3 +1,5 @@
+#include <string.h>
+
 #include "common_tests_utils.h"
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -23,6 +25,35 @@ void print_test_summary(int nb_success, int nb_tests) {
         printf("TESTS SUMMARY: \t\x1B[31m%d\x1B[0m/%d\n", nb_success, nb_tests);
 }
 
+///////////////////////////////////////////////////////////////////////////////
+///     COUNTING ALLOCATOR
+///////////////////////////////////////////////////////////////////////////////
+
+static void *counting_alloc(void *ctx, size_t size) {
+    alloc_counter_t *counter = ctx;
+    counter->n_allocs++;
+    counter->n_bytes += size;
+    return malloc(size);
+}
+
+static void *counting_realloc(void *ctx, void *ptr, size_t size) {
+    alloc_counter_t *counter = ctx;
+    counter->n_reallocs++;
+    counter->n_bytes += size;
+    return realloc(ptr, size);
+}
+
+static void counting_free(void *ctx, void *ptr) {
+    alloc_counter_t *counter = ctx;
+    counter->n_frees++;
+    free(ptr);
+}
+
+allocator_t counting_allocator(alloc_counter_t *counter) {
+    allocator_t allocator = {counting_alloc, counting_realloc, counting_free, counter};
+    return allocator;
+}
+
 
 ///////////////////////////////////////////////////////////////////////////////
 ///     OPERATOR FUNCTIONS FOR INT
@@ -42,6 +73,47 @@ void operator_delete(void *p_value) {
     free(p_value);
 }
 
+size_t operator_size(const void *p_value) {
+    return sizeof(int);
+}
+
+batch_counter_t batch_calls;
+
+void operator_copy_n(elem_t *dst, const elem_t *src, size_t n) {
+    batch_calls.n_copy_calls++;
+    batch_calls.n_copied += n;
+    for (size_t i = 0; i < n; i++) {
+        dst[i] = operator_copy(src[i]);
+    }
+}
+
+void operator_delete_n(elem_t *elems, size_t n) {
+    batch_calls.n_delete_calls++;
+    batch_calls.n_deleted += n;
+    for (size_t i = 0; i < n; i++) {
+        operator_delete(elems[i]);
+    }
+}
+
+size_t operator_write_u32(const void *elem, void *buffer, size_t capacity) {
+    u32 value = *(const u32 *)elem;
+    size_t size = value == STREAM_BIG_VALUE ? STREAM_BIG_PAYLOAD : sizeof(u32);
+
+    if (size <= capacity) {
+        memset(buffer, 0, size);
+        memcpy(buffer, &value, sizeof(u32));
+    }
+    return size;
+}
+
+elem_t operator_read_u32(const void *payload, size_t size) {
+    if (size < sizeof(u32)) return NULL;
+
+    u32 *value = malloc(sizeof(u32));
+    if (value) memcpy(value, payload, sizeof(u32));
+    return value;
+}
+
 int operator_compare(const void *v1, const void *v2) {
     if (v1 == NULL || v2 == NULL) {
         printf("NULL value compared");
@@ -59,6 +131,13 @@ int operator_compare(const void *v1, const void *v2) {
         return 1;
 }
 
+int operator_compare_inline(const void *v1, const void *v2) {
+    u32 arg1 = *(u32 *)v1;
+    u32 arg2 = *(u32 *)v2;
+
+    return (arg1 > arg2) - (arg1 < arg2);
+}
+
 int operator_match(const void *v1, const void *v2) {
     if (v1 == v2) return 1;
     if (v1 == NULL || v2 == NULL) return 0;
@@ -6,6 +6,8 @@
 #include <stdlib.h>
 #include <time.h>
 
+#include "../common/defs.h"
+
 #ifndef TEST_SUCCESS
 #define TEST_SUCCESS 1
 #endif
@@ -114,6 +116,16 @@
 
 typedef unsigned int u32;
 
+/**
+ * Calls and bytes counted by the allocator returned by 'counting_allocator'
+ */
+typedef struct {
+    size_t n_allocs;
+    size_t n_reallocs;
+    size_t n_frees;
+    size_t n_bytes;
+} alloc_counter_t;
+
 ///////////////////////////////////////////////////////////////////////////////
 ///     COMMON TESTS FUNCTIONS
 ///////////////////////////////////////////////////////////////////////////////
@@ -133,13 +145,22 @@ void print_test_result(int result, int *nb_success, int *nb_tests);
  */
 void print_test_summary(int nb_success, int nb_tests);
 
+/**
+ * @brief Allocator forwarding to malloc, realloc and free while counting the calls and requested bytes
+ * @param counter the counter updated by the allocator
+ * @return the allocator
+ */
+allocator_t counting_allocator(alloc_counter_t *counter);
+
 ///////////////////////////////////////////////////////////////////////////////
 ///     OPERATORS FOR ADT TESTS
 ///////////////////////////////////////////////////////////////////////////////
 
 void *operator_copy(void *p_value);
 void operator_delete(void *p_value);
+size_t operator_size(const void *p_value);
 int operator_compare(const void *v1, const void *v2);
+int operator_compare_inline(const void *v1, const void *v2);
 int operator_match(const void *v1, const void *v2);
 void operator_debug_i32(const int *p_value);
 void operator_debug_u32(const u32 *p_value);
@@ -148,4 +169,30 @@ void plus_op(const void *a, void *user_data);
 void *bin_plus_op(const void *a, const void *b, void *user_data);
 char predicate(const void *v, void *user_data);
 
+/**
+ * Batch operators copying and deleting each element like 'operator_copy' and 'operator_delete',
+ * the number of calls and of elements handled are counted in 'batch_calls'
+ */
+typedef struct
+{
+    size_t n_copy_calls;
+    size_t n_copied;
+    size_t n_delete_calls;
+    size_t n_deleted;
+} batch_counter_t;
+
+extern batch_counter_t batch_calls;
+
+void operator_copy_n(elem_t *dst, const elem_t *src, size_t n);
+void operator_delete_n(elem_t *elems, size_t n);
+
+/**
+ * Element writer and reader of u32 values, the payload of STREAM_BIG_VALUE is padded to STREAM_BIG_PAYLOAD bytes
+ */
+#define STREAM_BIG_VALUE 500
+#define STREAM_BIG_PAYLOAD 100000
+
+size_t operator_write_u32(const void *elem, void *buffer, size_t capacity);
+elem_t operator_read_u32(const void *payload, size_t size);
+
 #endif
@@ -0,0 +1,165 @@
+#include <pthread.h>
+
+#include "common_tests_utils.h"
+#include "../stack/concurrent_stack.h"
+#include "../common/defs.h"
+
+#define CONCURRENT_STACK_CREATE(A, B, N) \
+    ConcurrentStack A = NULL, B = NULL; \
+    A = concurrent_stack__empty_copy_enabled(N, operator_copy, operator_delete); \
+    B = concurrent_stack__empty_copy_disabled(N)
+
+#define CONCURRENT_STACK_FREE(A, B, C, D) \
+    FREE(concurrent_stack__free, A, B, C, D)
+
+#define N_THREADS 8
+#define N_ROUNDS 100000
+
+typedef struct {
+    ConcurrentStack s;
+    size_t id;
+    size_t sum;
+    bool result;
+} worker_t;
+
+////////////////////////////////////////////////////////////////////
+///     TEST SUITE
+////////////////////////////////////////////////////////////////////
+
+static bool test_concurrent_stack__empty(void)
+{
+    printf("%s... ", __func__);
+
+    bool result;
+    CONCURRENT_STACK_CREATE(s, t, 5);
+
+    result = (s && t
+           && concurrent_stack__is_copy_enabled(s) == 1
+           && concurrent_stack__is_copy_enabled(t) == 0
+           && concurrent_stack__capacity(s) == 5
+           && concurrent_stack__capacity(t) == 5
+           && concurrent_stack__is_empty(s) == 1
+           && concurrent_stack__is_empty(t) == 1) ? TEST_SUCCESS : TEST_FAILURE;
+
+    CONCURRENT_STACK_FREE(s, t, NULL, NULL);
+    return result;
+}
+
+static bool test_concurrent_stack__push_on_full_stack(void)
+{
+    printf("%s... ", __func__);
+
+    bool result = TEST_SUCCESS;
+    u32 elems[5] = {0, 1, 2, 3, 4};
+    CONCURRENT_STACK_CREATE(s, t, 4);
+
+    for (u32 i = 0; i < 4; i++) {
+        result &= !concurrent_stack__push(s, &elems[i]) && !concurrent_stack__push(t, &elems[i]);
+    }
+    result &= concurrent_stack__push(s, &elems[4]) == -1 && concurrent_stack__push(t, &elems[4]) == -1;
+    result &= !concurrent_stack__is_empty(s) && !concurrent_stack__is_empty(t);
+
+    CONCURRENT_STACK_FREE(s, t, NULL, NULL);
+    return result;
+}
+
+static bool test_concurrent_stack__pop_on_empty_stack(void)
+{
+    printf("%s... ", __func__);
+
+    bool result;
+    elem_t top = NULL;
+    CONCURRENT_STACK_CREATE(s, t, 4);
+
+    result = (concurrent_stack__pop(s, &top) == -1 && concurrent_stack__pop(t, &top) == -1) ? TEST_SUCCESS : TEST_FAILURE;
+
+    CONCURRENT_STACK_FREE(s, t, NULL, NULL);
+    return result;
+}
+
+static bool test_concurrent_stack__push_and_pop_order(void)
+{
+    printf("%s... ", __func__);
+
+    bool result = TEST_SUCCESS;
+    u32 elems[16];
+    elem_t top_s = NULL;
+    elem_t top_t = NULL;
+    CONCURRENT_STACK_CREATE(s, t, 8);
+
+    for (u32 round = 0; round < 2; round++) {
+        for (u32 i = 0; i < 8; i++) {
+            elems[8 * round + i] = 8 * round + i;
+            result &= !concurrent_stack__push(s, &elems[8 * round + i]) && !concurrent_stack__push(t, &elems[8 * round + i]);
+        }
+        for (u32 i = 0; i < 8; i++) {
+            result &= !concurrent_stack__pop(s, &top_s) && !concurrent_stack__pop(t, &top_t);
+            result &= *(u32 *)top_s == 8 * round + 7 - i && top_t == &elems[8 * round + 7 - i];
+            free(top_s);
+        }
+    }
+    result &= concurrent_stack__is_empty(s) && concurrent_stack__is_empty(t);
+
+    CONCURRENT_STACK_FREE(s, t, NULL, NULL);
+    return result;
+}
+
+static void *push_pop_worker(void *arg)
+{
+    worker_t *worker = arg;
+    elem_t top;
+    worker->result = TEST_SUCCESS;
+    for (size_t i = 1; i <= N_ROUNDS; i++) {
+        worker->result &= !concurrent_stack__push(worker->s, (elem_t)(worker->id * N_ROUNDS + i));
+        worker->result &= !concurrent_stack__pop(worker->s, &top);
+        worker->sum += (size_t)top;
+    }
+    return NULL;
+}
+
+static bool test_concurrent_stack__concurrent_push_and_pop(void)
+{
+    printf("%s... ", __func__);
+
+    bool result = TEST_SUCCESS;
+    pthread_t threads[N_THREADS];
+    worker_t workers[N_THREADS];
+    size_t sum = 0, expected = 0;
+    ConcurrentStack s = concurrent_stack__empty_copy_disabled(N_THREADS);
+
+    for (size_t i = 0; i < N_THREADS; i++) {
+        workers[i].s = s;
+        workers[i].id = i;
+        workers[i].sum = 0;
+        pthread_create(&threads[i], NULL, push_pop_worker, &workers[i]);
+    }
+    for (size_t i = 0; i < N_THREADS; i++) {
+        pthread_join(threads[i], NULL);
+        result &= workers[i].result;
+        sum += workers[i].sum;
+        expected += i * N_ROUNDS * N_ROUNDS + (size_t)N_ROUNDS * (N_ROUNDS + 1) / 2;
+    }
+
+    result &= sum == expected && concurrent_stack__is_empty(s);
+
+    CONCURRENT_STACK_FREE(s, NULL, NULL, NULL);
+    return result;
+}
+
+
+int main(void)
+{
+    int nb_success = 0;
+    int nb_tests = 0;
+    printf("----------- TEST CONCURRENT STACK -----------\n");
+
+    print_test_result(test_concurrent_stack__empty(), &nb_success, &nb_tests);
+    print_test_result(test_concurrent_stack__push_on_full_stack(), &nb_success, &nb_tests);
+    print_test_result(test_concurrent_stack__pop_on_empty_stack(), &nb_success, &nb_tests);
+    print_test_result(test_concurrent_stack__push_and_pop_order(), &nb_success, &nb_tests);
+    print_test_result(test_concurrent_stack__concurrent_push_and_pop(), &nb_success, &nb_tests);
+
+    print_test_summary(nb_success, nb_tests);
+
+    return TEST_SUCCESS;
+}
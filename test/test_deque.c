@@ -0,0 +1,815 @@
+#include "common_tests_utils.h"
+#include "../deque/deque.h"
+#include "../common/defs.h"
+
+#define DEQUE_CREATE(A, B) \
+    Deque A = NULL, B = NULL; \
+    A = deque__empty_copy_enabled(operator_copy, operator_delete); \
+    B = deque__empty_copy_disabled()
+
+#define DEQUE_FROM_ARRAY(N, __elems, A, B) \
+    TEST_FROM_ARRAY(deque__push_back, N, __elems, A, B)
+
+#define DEQUE_DEBUG_char(A, B, C) \
+    DEBUG_char(deque__debug, A, B, C)
+
+#define DEQUE_DEBUG_u32(A, B, C) \
+    DEBUG_u32(deque__debug, A, B, C)
+
+#define DEQUE_FREE(A, B, C, D) \
+    FREE(deque__free, A, B, C, D)
+
+#define TEST_ON_EMPTY_DEQUE(__name, __expr) \
+static bool __name(char debug) \
+{ \
+    printf("%s... ", __func__); \
+    bool result = TEST_SUCCESS; \
+    DEQUE_CREATE(d, e); \
+    __expr \
+    bool __empty_assertion = deque__is_empty(d) == 1 && deque__is_empty(e) == 1; \
+    DEQUE_DEBUG_u32(d, e, "\n\tDeques after:"); \
+    DEQUE_FREE(d, e, NULL, NULL); \
+    return result && __empty_assertion; \
+}
+
+#define TEST_ON_NON_EMPTY_DEQUE(__name, __rand, __expr) \
+static bool __name(char debug) \
+{ \
+    printf("%s... ", __func__); \
+    bool result = TEST_SUCCESS; \
+    elem_t *A = NULL, *B = NULL; \
+    DEQUE_CREATE(d, e); \
+    u32 N = 8; \
+    u32 *elems = malloc(sizeof(u32) * N); \
+    for (u32 i = 0; i < N; i++) { \
+        elems[i] = __rand ? (u32)rand() % 20 : i; \
+    } \
+    DEQUE_FROM_ARRAY(N, elems, d, e); \
+    DEQUE_DEBUG_u32(d, e, "\n\tDeques before:"); \
+    __expr \
+    DEQUE_DEBUG_u32(d, e, "\n\tDeques after:"); \
+    if (A) { \
+        for (u32 i = 0; i < N; i++) { \
+            free(A[i]); \
+        } \
+        free(A); \
+    } \
+    free(B); \
+    free(elems); \
+    DEQUE_FREE(d, e, NULL, NULL); \
+    return result; \
+}
+
+////////////////////////////////////////////////////////////////////
+///     TEST SUITE
+////////////////////////////////////////////////////////////////////
+
+static bool test_deque__empty_copy_disabled(char debug)
+{
+    printf("%s... ", __func__);
+
+    bool result;
+    Deque d = deque__empty_copy_disabled();
+
+    result = d ? TEST_SUCCESS : TEST_FAILURE;
+
+    if (debug) deque__debug(d, (void (*)(elem_t))operator_debug_i32);
+
+    DEQUE_FREE(d, NULL, NULL, NULL);
+    return result;
+}
+
+static bool test_deque__empty_copy_enabled(char debug)
+{
+    printf("%s... ", __func__);
+
+    bool result;
+    Deque d = deque__empty_copy_enabled(operator_copy, operator_delete);
+
+    result = d ? TEST_SUCCESS : TEST_FAILURE;
+
+    if (debug) deque__debug(d, (void (*)(elem_t))operator_debug_i32);
+
+    DEQUE_FREE(d, NULL, NULL, NULL);
+    return result;
+}
+
+static bool test_deque__is_copy_enabled(void)
+{
+    printf("%s... ", __func__);
+
+    bool result;
+    DEQUE_CREATE(d, e);
+
+    result = (deque__is_copy_enabled(d) && !deque__is_copy_enabled(e)) ? TEST_SUCCESS : TEST_FAILURE;
+
+    DEQUE_FREE(d, e, NULL, NULL);
+    return result;
+}
+
+/* SIZE */
+TEST_ON_NON_EMPTY_DEQUE (
+    test_deque__length, true,
+    result = (deque__length(d) == N && deque__length(e) == N) ? TEST_SUCCESS : TEST_FAILURE;
+)
+
+/* IS_EMPTY */
+TEST_ON_EMPTY_DEQUE(
+    test_deque__is_empty_on_empty_deque,
+    ;
+)
+
+TEST_ON_NON_EMPTY_DEQUE (
+    test_deque__is_empty_on_non_empty_deque, true,
+    result = (!deque__is_empty(d) && !deque__is_empty(e)) ? TEST_SUCCESS : TEST_FAILURE;
+)
+
+/* PUSH_BACK */
+TEST_ON_NON_EMPTY_DEQUE (
+    test_deque__push_back, false,
+    result = (deque__length(d) == N && deque__length(e) == N) ? TEST_SUCCESS : TEST_FAILURE;
+    result &= COMPARE2(deque__peek_nth, deque__length(d), elems, d, true);
+    result &= COMPARE2(deque__peek_nth, deque__length(e), elems, e, false);
+)
+
+/* POP_FRONT */
+TEST_ON_EMPTY_DEQUE (
+    test_deque__pop_front_on_empty_deque,
+    result = (deque__pop_front(d, NULL) == -1 && deque__pop_front(e, NULL) == -1) ? TEST_SUCCESS : TEST_FAILURE;
+)
+
+TEST_ON_NON_EMPTY_DEQUE (
+    test_deque__pop_front_on_non_empty_deque, false,
+    elem_t front_d = NULL;
+    elem_t front_e = NULL;
+    for (u32 i = 0; i < N; i++) {
+        result &= !deque__pop_front(d, &front_d)
+               && !deque__pop_front(e, &front_e)
+               && deque__length(d) == N-i-1
+               && deque__length(e) == N-i-1
+               && *(u32 *)front_d == i
+               && *(u32 *)front_e == i;
+        free(front_d);
+    }
+)
+
+/* PUSH_FRONT */
+TEST_ON_EMPTY_DEQUE (
+    test_deque__push_front,
+    u32 N = 8;
+    u32 elems[8];
+    for (u32 i = 0; i < N; i++) {
+        elems[i] = N-i-1;
+        result &= !deque__push_front(d, &elems[i]) && !deque__push_front(e, &elems[i]);
+    }
+    result &= deque__length(d) == N && deque__length(e) == N;
+    result &= COMPARE3(deque__peek_nth, deque__length(d), d, 0, true);
+    result &= COMPARE3(deque__peek_nth, deque__length(e), e, 0, false);
+    deque__clear(d);
+    deque__clear(e);
+)
+
+/* POP_BACK */
+TEST_ON_EMPTY_DEQUE (
+    test_deque__pop_back_on_empty_deque,
+    result = (deque__pop_back(d, NULL) == -1 && deque__pop_back(e, NULL) == -1) ? TEST_SUCCESS : TEST_FAILURE;
+)
+
+TEST_ON_NON_EMPTY_DEQUE (
+    test_deque__pop_back_on_non_empty_deque, false,
+    elem_t back_d = NULL;
+    elem_t back_e = NULL;
+    for (u32 i = 0; i < N; i++) {
+        result &= !deque__pop_back(d, &back_d)
+               && !deque__pop_back(e, &back_e)
+               && deque__length(d) == N-i-1
+               && deque__length(e) == N-i-1
+               && *(u32 *)back_d == N-i-1
+               && *(u32 *)back_e == N-i-1;
+        free(back_d);
+    }
+)
+
+/* WRAPAROUND */
+TEST_ON_NON_EMPTY_DEQUE (
+    test_deque__push_front_pop_back_wraparound, false,
+    elem_t back_d = NULL;
+    elem_t back_e = NULL;
+    for (u32 i = 0; i < 3; i++) {
+        deque__pop_back(d, &back_d);
+        deque__pop_back(e, &back_e);
+        result &= !deque__push_front(d, back_d) && !deque__push_front(e, back_e);
+        free(back_d);
+    }
+    for (u32 i = 0; i < N; i++) {
+        elem_t nth_d = NULL;
+        elem_t nth_e = NULL;
+        deque__peek_nth(d, i, &nth_d);
+        deque__peek_nth(e, i, &nth_e);
+        result &= *(u32 *)nth_d == (i + N - 3) % N && *(u32 *)nth_e == (i + N - 3) % N;
+        free(nth_d);
+    }
+    result &= deque__search(d, &elems[0], operator_match) == 3 && deque__ptr_search(e, &elems[0]) == 3;
+)
+
+/* WRAPAROUND */
+TEST_ON_NON_EMPTY_DEQUE (
+    test_deque__push_back_pop_front_wraparound, false,
+    u32 extra[5];
+    for (u32 i = 0; i < 5; i++) {
+        extra[i] = N + i;
+    }
+    for (u32 i = 0; i < 4; i++) {
+        result &= !deque__pop_front(d, NULL) && !deque__pop_front(e, NULL);
+        result &= !deque__push_back(d, &extra[i]) && !deque__push_back(e, &extra[i]);
+    }
+    result &= COMPARE3(deque__peek_nth, deque__length(d), d, 4, true);
+    result &= COMPARE3(deque__peek_nth, deque__length(e), e, 4, false);
+    result &= deque__search(d, &extra[2], operator_match) == 6 && deque__ptr_search(e, &extra[2]) == 6;
+
+    A = deque__to_array(d);
+    B = deque__to_array(e);
+    for (u32 i = 0; i < N; i++) {
+        result &= *(u32 *)A[i] == i + 4 && *(u32 *)B[i] == i + 4;
+    }
+
+    /* the copy starts at the first slot, the two rings wrap at different positions */
+    Deque c = deque__copy(d);
+    result &= deque__cmp(d, c, operator_match) == 1 && deque__cmp(c, d, operator_match) == 1;
+    result &= COMPARE3(deque__peek_nth, deque__length(c), c, 4, true);
+    deque__free(c);
+
+    result &= !deque__push_back(d, &extra[4]) && !deque__push_back(e, &extra[4]);
+    result &= deque__length(d) == N + 1 && deque__length(e) == N + 1;
+    result &= COMPARE3(deque__peek_nth, deque__length(d), d, 4, true);
+    result &= COMPARE3(deque__peek_nth, deque__length(e), e, 4, false);
+)
+
+TEST_ON_NON_EMPTY_DEQUE (
+    test_deque__sort_and_filter_on_wrapped_deque, true,
+    u32 value = 2;
+    for (u32 i = 0; i < 5; i++) {
+        elem_t front_d = NULL;
+        elem_t front_e = NULL;
+        deque__pop_front(d, &front_d);
+        deque__pop_front(e, &front_e);
+        deque__push_back(d, front_d);
+        deque__push_back(e, front_e);
+        free(front_d);
+    }
+    deque__sort(d, operator_compare);
+    deque__sort(e, operator_compare);
+    result &= IS_SORTED(deque__peek_nth, deque__length(d), d, true);
+    result &= IS_SORTED(deque__peek_nth, deque__length(e), e, false);
+
+    deque__filter(d, predicate, &value);
+    result &= deque__all(d, predicate, &value) == 1 && deque__length(d) <= N;
+    result &= IS_SORTED(deque__peek_nth, deque__length(d), d, true);
+)
+
+/* REMOVE_NTH */
+TEST_ON_EMPTY_DEQUE (
+    test_deque__remove_nth_on_empty_deque,
+    result &= deque__remove_nth(d, 0) == -1;
+    result &= deque__remove_nth(e, 0) == -1;
+)
+
+TEST_ON_NON_EMPTY_DEQUE (
+    test_deque__remove_nth_on_non_empty_deque, true,
+    elem_t tmp = NULL;
+    for (u32 i = 0; i < N; i++) {
+        result &= deque__remove_nth(d, i) == 0;
+        result &= deque__remove_nth(e, i) == 0;
+        deque__peek_nth(d, i, &tmp);
+        result &= tmp == NULL;
+        deque__peek_nth(e, i, &tmp);
+        result &= tmp == NULL;
+    }
+)
+
+/* PEEK_FRONT */
+TEST_ON_EMPTY_DEQUE (
+    test_deque__peek_front_on_empty_deque,
+    result = (deque__peek_front(d, NULL) == -1 && deque__peek_front(e, NULL) == -1) ? TEST_SUCCESS : TEST_FAILURE;
+)
+TEST_ON_NON_EMPTY_DEQUE (
+    test_deque__peek_front_on_non_empty_deque, false,
+    elem_t front_d = NULL;
+    elem_t front_e = NULL;
+    result = (!deque__peek_front(d, &front_d)
+           && !deque__peek_front(e, &front_e)
+           && !deque__is_empty(d)
+           && !deque__is_empty(e)
+           && *(u32 *)front_d == 0
+           && *(u32 *)front_e == 0) ? TEST_SUCCESS : TEST_FAILURE;
+    free(front_d);
+)
+
+/* PEEK_BACK */
+TEST_ON_EMPTY_DEQUE (
+    test_deque__peek_back_on_empty_deque,
+    result = (deque__peek_back(d, NULL) == -1 && deque__peek_back(e, NULL) == -1) ? TEST_SUCCESS : TEST_FAILURE;
+)
+
+TEST_ON_NON_EMPTY_DEQUE (
+    test_deque__peek_back_on_non_empty_deque, false,
+    elem_t back_d = NULL;
+    elem_t back_e = NULL;
+    result = (!deque__peek_back(d, &back_d)
+           && !deque__peek_back(e, &back_e)
+           && !deque__is_empty(d)
+           && !deque__is_empty(e)
+           && *(u32 *)back_d == N-1
+           && *(u32 *)back_e == N-1) ? TEST_SUCCESS : TEST_FAILURE;
+    free(back_d);
+)
+
+/* PEEK_NTH */
+TEST_ON_EMPTY_DEQUE (
+    test_deque__peek_nth_on_empty_deque,
+    result = (deque__peek_nth(d, 0, NULL) == -1 && deque__peek_nth(e, 0, NULL) == -1) ? TEST_SUCCESS : TEST_FAILURE;
+)
+
+TEST_ON_NON_EMPTY_DEQUE (
+    test_deque__peek_nth_on_non_empty_deque, false,
+    elem_t nth_d = NULL;
+    elem_t nth_e = NULL;
+    result = (!deque__peek_nth(d, N>>1, &nth_d)
+           && !deque__peek_nth(e, N>>1, &nth_e)
+           && !deque__is_empty(d)
+           && !deque__is_empty(e)
+           && *(u32 *)nth_d == N>>1
+           && *(u32 *)nth_e == N>>1) ? TEST_SUCCESS : TEST_FAILURE;
+    free(nth_d);
+)
+
+/* SWAP */
+TEST_ON_EMPTY_DEQUE (
+    test_deque__swap_on_empty_deque,
+    deque__swap(d, 2, 5);
+    deque__swap(e, 2, 5);
+)
+
+TEST_ON_NON_EMPTY_DEQUE (
+    test_deque__swap_on_non_empty_deque, false,
+    elem_t pre_d1;
+    elem_t pre_d2;
+    elem_t post_d1;
+    elem_t post_d2;
+    elem_t pre_e1;
+    elem_t pre_e2;
+    elem_t post_e1;
+    elem_t post_e2;
+    deque__peek_nth(d, 2, &pre_d1);
+    deque__peek_nth(d, 5, &pre_d2);
+    deque__peek_nth(e, 2, &pre_e1);
+    deque__peek_nth(e, 5, &pre_e2);
+    result &= !deque__swap(d, 2, 5);
+    result &= !deque__swap(e, 2, 5);
+    deque__peek_nth(d, 2, &post_d1);
+    deque__peek_nth(d, 5, &post_d2);
+    deque__peek_nth(e, 2, &post_e1);
+    deque__peek_nth(e, 5, &post_e2);
+
+    result = *(u32*)pre_d1 == *(u32*)post_d2 && *(u32*)pre_d2 == *(u32*)post_d1;
+    result = *(u32*)pre_e1 == *(u32*)post_e2 && *(u32*)pre_e2 == *(u32*)post_e1;
+    free(pre_d1);
+    free(pre_d2);
+    free(post_d1);
+    free(post_d2);
+)
+
+/* COPY AND CMP */
+TEST_ON_EMPTY_DEQUE (
+    test_deque__copy_and_cmp_on_empty_deque,
+    Deque u = deque__copy(d);
+    Deque v = deque__copy(e);
+
+    result = (deque__cmp(u, d, operator_match)
+           && deque__cmp(v, e, operator_match)
+           && COMPARE(deque__peek_nth, deque__length(d), u, d, true)
+           && COMPARE(deque__peek_nth, deque__length(e), v, e, false)) ? TEST_SUCCESS : TEST_FAILURE;
+    DEQUE_FREE(u, v, NULL, NULL);
+)
+
+TEST_ON_NON_EMPTY_DEQUE (
+    test_deque__copy_and_cmp_on_non_empty_deque, false,
+    Deque u = deque__copy(d);
+    Deque v = deque__copy(e);
+
+    result = (deque__cmp(u, d, operator_match)
+           && deque__cmp(v, e, operator_match)
+           && COMPARE(deque__peek_nth, deque__length(d), u, d, true)
+           && COMPARE(deque__peek_nth, deque__length(e), v, e, false)) ? TEST_SUCCESS : TEST_FAILURE;
+    DEQUE_FREE(u, v, NULL, NULL);
+)
+
+static bool test_deque__from_array(char debug)
+{
+    printf("%s... ", __func__);
+
+    bool result;
+    char A[5] = {'a', 'b', 'c', 'd', 'e'};
+    char B[5] = {'f', 'g', 'h', 'i', 'j'};
+    u32 C[5] = {1, 2, 3, 4, 5};
+    DEQUE_CREATE(q_char, w_char);
+    DEQUE_CREATE(q_u32, w_u32);
+
+    result = (deque__from_array(q_char, A, 5, sizeof(char))
+           && (w_char = deque__from_array(w_char, A, 5, sizeof(char)))
+           && deque__from_array(q_char, B, 5, sizeof(char))
+           && deque__from_array(w_char, B, 5, sizeof(char))
+           && deque__from_array(q_u32, C, 5, sizeof(u32))
+           && (w_u32 = deque__from_array(w_u32, C, 5, sizeof(u32)))
+           && deque__length(q_char) == 10
+           && deque__length(w_char) == 10
+           && deque__length(q_u32) == 5
+           && deque__length(w_u32) == 5) ? TEST_SUCCESS : TEST_FAILURE;
+
+    result &= COMPARE2(deque__peek_nth, deque__length(q_u32), C, q_u32, true);
+    result &= COMPARE2(deque__peek_nth, deque__length(w_u32), C, w_u32, false);
+
+    DEQUE_DEBUG_char(q_char, w_char, "\n\tDeques after from_array:");
+    DEQUE_DEBUG_u32(q_u32, w_u32, " ");
+
+    DEQUE_FREE(q_char, w_char, q_u32, w_u32);
+    return result;
+}
+
+/* DUMP */
+TEST_ON_EMPTY_DEQUE (
+    test_deque__dump_on_empty_deque,
+    result = (deque__dump(d) == NULL && deque__dump(e) == NULL) ? TEST_SUCCESS : TEST_FAILURE;
+)
+
+TEST_ON_NON_EMPTY_DEQUE (
+    test_deque__dump_on_non_empty_deque, true,
+    A = deque__dump(d);
+    B = deque__dump(e);
+
+    result = (deque__is_empty(d) && deque__is_empty(e)) ? TEST_SUCCESS : TEST_FAILURE;
+
+    for (u32 i = 0; i < N; i++) {
+        result |= *(u32 *)A[i] != i || *(u32 *)B[i] != N;
+    }
+)
+
+/* TO_ARRAY*/
+TEST_ON_EMPTY_DEQUE (
+    test_deque__to_array_on_empty_deque,
+    result = (deque__to_array(d) == NULL && deque__to_array(e) == NULL) ? TEST_SUCCESS : TEST_FAILURE;
+)
+
+TEST_ON_NON_EMPTY_DEQUE (
+    test_deque__to_array_on_non_empty_deque, true,
+    A = deque__to_array(d);
+    B = deque__to_array(e);
+
+    result = (deque__length(d) == N && deque__length(e) == N) ? TEST_SUCCESS : TEST_FAILURE;
+
+    for (u32 i = 0; i < N; i++) {
+        result |= *(u32 *)A[i] != i || *(u32 *)B[i] != N;
+    }
+)
+
+/* PTR_SEARCH AND PTR_CONTAINS */
+TEST_ON_EMPTY_DEQUE (
+    test_deque__ptr_search_and_ptr_contains_on_empty_deque,
+    result &= !deque__ptr_contains(d, NULL) && deque__ptr_search(d, NULL) == SIZE_MAX;
+    result &= !deque__ptr_contains(e, NULL) && deque__ptr_search(e, NULL) == SIZE_MAX;
+)
+
+TEST_ON_NON_EMPTY_DEQUE (
+    test_deque__ptr_search_and_ptr_contains_on_non_empty_deque, true,
+    result &= !deque__ptr_contains(d, NULL) && deque__ptr_search(d, NULL) == SIZE_MAX;
+    result &= !deque__ptr_contains(e, NULL) && deque__ptr_search(e, NULL) == SIZE_MAX;
+
+    for (u32 i = 0; i < N; i++) {
+        result &= !deque__ptr_contains(d, elems + i) && deque__ptr_search(d, elems + i) == SIZE_MAX;
+        result &= deque__ptr_contains(e, elems + i) && deque__ptr_search(e, elems + i) == i;
+    }
+)
+
+/* SEARCH AND CONTAINS */
+TEST_ON_EMPTY_DEQUE (
+    test_deque__search_and_contains_on_empty_deque,
+    result &= !deque__contains(d, NULL, operator_match) && deque__search(d, NULL, operator_match) == SIZE_MAX;
+    result &= !deque__contains(e, NULL, operator_match) && deque__search(e, NULL, operator_match) == SIZE_MAX;
+)
+
+TEST_ON_NON_EMPTY_DEQUE (
+    test_deque__search_and_contains_on_non_empty_deque, false,
+    result &= !deque__contains(d, NULL, operator_match) && deque__search(d, NULL, operator_match) == SIZE_MAX;
+    result &= !deque__contains(e, NULL, operator_match) && deque__search(e, NULL, operator_match) == SIZE_MAX;
+
+    for (u32 i = 0; i < N; i++) {
+        result &= deque__contains(d, elems + i, operator_match) && deque__search(d, elems + i, operator_match) == i;
+        result &= deque__contains(e, elems + i, operator_match) && deque__search(e, elems + i, operator_match) == i;
+    }
+)
+
+/* CLEAN_NULL */
+TEST_ON_EMPTY_DEQUE (
+    test_deque__clean_NULL_on_empty_deque,
+    deque__clean_NULL(d);
+    deque__clean_NULL(e);
+)
+
+TEST_ON_NON_EMPTY_DEQUE (
+    test_deque__clean_NULL_on_non_empty_deque, false,
+
+    for (u32 i = 0; i < N; i+= 2) {
+        deque__remove_nth(d, i);
+        deque__remove_nth(e, i);
+    }
+
+    deque__clean_NULL(d);
+    deque__clean_NULL(e);
+
+    result = (deque__length(d) == N>>1 && deque__length(e) == N>>1) ? TEST_SUCCESS : TEST_FAILURE;
+
+)
+
+/* CLEAR */
+TEST_ON_EMPTY_DEQUE (
+    test_deque__clear_on_empty_deque,
+    deque__clear(d);
+    deque__clear(e);
+)
+
+TEST_ON_NON_EMPTY_DEQUE (
+    test_deque__clear_on_non_empty_deque, true,
+    deque__clear(d);
+    deque__clear(e);
+
+    result = (deque__is_empty(d) && deque__is_empty(e)) ? TEST_SUCCESS : TEST_FAILURE;
+)
+
+/* FOREACH */
+TEST_ON_EMPTY_DEQUE (
+    test_deque__foreach_on_empty_deque,
+    int value = 1;
+    deque__foreach(d, plus_op, &value);
+    deque__foreach(e, plus_op, &value);
+)
+
+TEST_ON_NON_EMPTY_DEQUE (
+    test_deque__foreach_on_non_empty_deque, false,
+    u32 value = 1;
+    deque__foreach(d, plus_op, &value);
+    deque__foreach(e, plus_op, &value);
+
+    result &= COMPARE3(deque__peek_nth, deque__length(d), d, value, true);
+    result &= COMPARE3(deque__peek_nth, deque__length(e), e, value, false);
+)
+
+/* FILTER AND ALL */
+TEST_ON_EMPTY_DEQUE (
+    test_deque__filter_and_all_on_empty_deque,
+    u32 value = 2;
+    deque__filter(d, predicate, &value);
+    deque__filter(e, predicate, &value);
+
+    result = deque__all(d, predicate, &value) == 1 && deque__all(e, predicate, &value) == 1;
+)
+
+TEST_ON_NON_EMPTY_DEQUE (
+    test_deque__filter_and_all_on_non_empty_deque, false,
+    u32 value1 = 2;
+    u32 value2 = 3;
+    deque__filter(d, predicate, &value1);
+    deque__filter(e, predicate, &value1);
+
+    result &= deque__all(d, predicate, &value1) == 1 && deque__all(e, predicate, &value1) == 1;
+    result &= deque__all(d, predicate, &value2) == 0 && deque__all(e, predicate, &value2) == 0;
+)
+
+/* ANY */
+TEST_ON_EMPTY_DEQUE (
+    test_deque__any_on_empty_deque,
+    u32 value = 2;
+
+    result = deque__any(d, predicate, &value) == 0 && deque__any(e, predicate, &value) == 0;
+)
+
+TEST_ON_NON_EMPTY_DEQUE (
+    test_deque__any_on_non_empty_deque, false,
+    u32 value1 = 2;
+    u32 value2 = 3;
+
+    result &= deque__any(d, predicate, &value1) == 1 && deque__any(e, predicate, &value1) == 1;
+    result &= deque__any(d, predicate, &value2) == 1 && deque__any(e, predicate, &value2) == 1;
+)
+
+/* REVERSE */
+TEST_ON_EMPTY_DEQUE (
+    test_deque__reverse_on_empty_deque,
+    deque__reverse(d);
+    deque__reverse(e);
+)
+
+TEST_ON_NON_EMPTY_DEQUE (
+    test_deque__reverse_on_non_empty_deque, false,
+    deque__reverse(d);
+    deque__reverse(e);
+
+    result &= IS_REVERSE(deque__peek_nth, deque__length(d), d, true);
+    result &= IS_REVERSE(deque__peek_nth, deque__length(e), e, false);
+)
+
+/* SHUFFLE */
+TEST_ON_EMPTY_DEQUE (
+    test_deque__shuffle_on_empty_deque,
+    deque__shuffle(d, 1);
+    deque__shuffle(e, 1);
+)
+
+TEST_ON_NON_EMPTY_DEQUE (
+    test_deque__shuffle_on_non_empty_deque, true,
+    deque__shuffle(d, 1);
+    A = deque__to_array(d);
+
+    result = TEST_FAILURE;
+    for (u32 i = 0; i < N; i++) {
+        result |= *(u32 *)A[i] != i;
+    }
+)
+
+/* SORT */
+TEST_ON_EMPTY_DEQUE (
+    test_deque__sort_on_empty_deque,
+    deque__sort(d, operator_compare);
+    deque__sort(e, operator_compare);
+
+    result &= IS_SORTED(deque__peek_nth, deque__length(d), d, true);
+    result &= IS_SORTED(deque__peek_nth, deque__length(e), e, false);
+)
+
+TEST_ON_NON_EMPTY_DEQUE (
+    test_deque__sort_on_non_empty_deque, true,
+    deque__sort(d, operator_compare);
+    deque__sort(e, operator_compare);
+
+    result &= IS_SORTED(deque__peek_nth, deque__length(d), d, true);
+    result &= IS_SORTED(deque__peek_nth, deque__length(e), e, false);
+)
+
+
+static void count_visits(const void *v, void *user_data)
+{
+    (*(size_t *)user_data)++;
+}
+
+
+static bool test_deque__foreach_visits_repeated_pointers_once(void)
+{
+    printf("%s... ", __func__);
+
+    bool result = TEST_SUCCESS;
+    u32 values[100];
+    elem_t ptrs[1000];
+    size_t n_visits = 0;
+    for (u32 i = 0; i < 1000; i++) {
+        ptrs[i] = i % 250 == 0 ? NULL : &values[i % 100];
+    }
+
+    Deque d = deque__empty_copy_disabled();
+    for (u32 i = 0; i < 1000; i++) {
+        result &= !deque__push_back(d, ptrs[i]);
+    }
+
+    deque__foreach(d, count_visits, &n_visits);
+    result &= n_visits == 101;
+    n_visits = 0;
+    deque__foreach(d, count_visits, &n_visits);
+    result &= n_visits == 101;
+    n_visits = 0;
+    deque__foreach_all(d, count_visits, &n_visits);
+    result &= n_visits == 1000;
+    n_visits = 0;
+
+    deque__free(d);
+
+    return result;
+}
+
+
+
+static char is_odd(const void *v, void *user_data)
+{
+    return v && *(const u32 *)v & 1;
+}
+
+
+/* every run of elements is copied or deleted by a single call of the batch operators */
+static bool test_deque__batch_operators(void)
+{
+    printf("%s... ", __func__);
+
+    bool result = TEST_SUCCESS;
+    u32 values[100];
+    elem_t *array, elem;
+    for (u32 i = 0; i < 100; i++) {
+        values[i] = i;
+    }
+
+    result &= !deque__empty_copy_enabled_n(NULL, operator_delete, operator_copy_n, operator_delete_n);
+
+    batch_calls = (batch_counter_t){0};
+    Deque d = deque__empty_copy_enabled_n(operator_copy, operator_delete, operator_copy_n, operator_delete_n);
+    result &= deque__from_array(d, values, 100, sizeof(u32)) == d;
+    array = deque__to_array(d);
+    for (u32 i = 0; array && i < 100; i++) {
+        result &= array[i] != &values[i] && *(u32 *)array[i] == i;
+        free(array[i]);
+    }
+    free(array);
+
+    Deque copy = deque__copy(d);
+    result &= deque__length(copy) == 100;
+    deque__clear(copy);
+    deque__free(copy);
+
+    deque__filter(d, is_odd, NULL);
+    result &= deque__length(d) == 50;
+    for (size_t i = 0; i < 50; i++) {
+        result &= !deque__peek_nth(d, i, &elem) && *(u32 *)elem == 2 * i + 1;
+        free(elem);
+    }
+    deque__free(d);
+
+    result &= batch_calls.n_copy_calls == 3 && batch_calls.n_copied == 300;
+    result &= batch_calls.n_delete_calls == 3 && batch_calls.n_deleted == 200;
+
+    return result;
+}
+
+
+int main(void)
+{
+    int nb_success = 0;
+    int nb_tests = 0;
+    printf("----------- TEST DEQUE -----------\n");
+
+    print_test_result(test_deque__empty_copy_disabled(false), &nb_success, &nb_tests);
+    print_test_result(test_deque__empty_copy_enabled(false), &nb_success, &nb_tests);
+    print_test_result(test_deque__is_copy_enabled(), &nb_success, &nb_tests);
+    print_test_result(test_deque__length(false), &nb_success, &nb_tests);
+    print_test_result(test_deque__is_empty_on_empty_deque(false), &nb_success, &nb_tests);
+    print_test_result(test_deque__is_empty_on_non_empty_deque(false), &nb_success, &nb_tests);
+
+    print_test_result(test_deque__push_back(false), &nb_success, &nb_tests);
+    print_test_result(test_deque__push_front(false), &nb_success, &nb_tests);
+    print_test_result(test_deque__pop_front_on_empty_deque(false), &nb_success, &nb_tests);
+    print_test_result(test_deque__pop_front_on_non_empty_deque(false), &nb_success, &nb_tests);
+    print_test_result(test_deque__pop_back_on_empty_deque(false), &nb_success, &nb_tests);
+    print_test_result(test_deque__pop_back_on_non_empty_deque(false), &nb_success, &nb_tests);
+    print_test_result(test_deque__push_front_pop_back_wraparound(false), &nb_success, &nb_tests);
+    print_test_result(test_deque__push_back_pop_front_wraparound(false), &nb_success, &nb_tests);
+    print_test_result(test_deque__sort_and_filter_on_wrapped_deque(false), &nb_success, &nb_tests);
+    print_test_result(test_deque__remove_nth_on_empty_deque(false), &nb_success, &nb_tests);
+    print_test_result(test_deque__remove_nth_on_non_empty_deque(false), &nb_success, &nb_tests);
+    print_test_result(test_deque__peek_front_on_empty_deque(false), &nb_success, &nb_tests);
+    print_test_result(test_deque__peek_front_on_non_empty_deque(false), &nb_success, &nb_tests);
+    print_test_result(test_deque__peek_back_on_empty_deque(false), &nb_success, &nb_tests);
+    print_test_result(test_deque__peek_back_on_non_empty_deque(false), &nb_success, &nb_tests);
+    print_test_result(test_deque__peek_nth_on_empty_deque(false), &nb_success, &nb_tests);
+    print_test_result(test_deque__peek_nth_on_non_empty_deque(false), &nb_success, &nb_tests);
+    print_test_result(test_deque__swap_on_empty_deque(false), &nb_success, &nb_tests);
+    print_test_result(test_deque__swap_on_non_empty_deque(false), &nb_success, &nb_tests);
+
+    print_test_result(test_deque__copy_and_cmp_on_empty_deque(false), &nb_success, &nb_tests);
+    print_test_result(test_deque__copy_and_cmp_on_non_empty_deque(false), &nb_success, &nb_tests);
+    print_test_result(test_deque__from_array(false), &nb_success, &nb_tests);
+    print_test_result(test_deque__dump_on_empty_deque(false), &nb_success, &nb_tests);
+    print_test_result(test_deque__dump_on_non_empty_deque(false), &nb_success, &nb_tests);
+    print_test_result(test_deque__to_array_on_empty_deque(false), &nb_success, &nb_tests);
+    print_test_result(test_deque__to_array_on_non_empty_deque(false), &nb_success, &nb_tests);
+    print_test_result(test_deque__ptr_search_and_ptr_contains_on_empty_deque(false), &nb_success, &nb_tests);
+    print_test_result(test_deque__ptr_search_and_ptr_contains_on_non_empty_deque(false), &nb_success, &nb_tests);
+    print_test_result(test_deque__search_and_contains_on_empty_deque(false), &nb_success, &nb_tests);
+    print_test_result(test_deque__search_and_contains_on_non_empty_deque(false), &nb_success, &nb_tests);
+    print_test_result(test_deque__clean_NULL_on_empty_deque(false), &nb_success, &nb_tests);
+    print_test_result(test_deque__clean_NULL_on_non_empty_deque(false), &nb_success, &nb_tests);
+    print_test_result(test_deque__clear_on_empty_deque(false), &nb_success, &nb_tests);
+    print_test_result(test_deque__clear_on_non_empty_deque(false), &nb_success, &nb_tests);
+
+    print_test_result(test_deque__foreach_on_empty_deque(false), &nb_success, &nb_tests);
+    print_test_result(test_deque__foreach_on_non_empty_deque(false), &nb_success, &nb_tests);
+    print_test_result(test_deque__filter_and_all_on_empty_deque(false), &nb_success, &nb_tests);
+    print_test_result(test_deque__filter_and_all_on_non_empty_deque(false), &nb_success, &nb_tests);
+    print_test_result(test_deque__any_on_empty_deque(false), &nb_success, &nb_tests);
+    print_test_result(test_deque__any_on_non_empty_deque(false), &nb_success, &nb_tests);
+    print_test_result(test_deque__reverse_on_empty_deque(false), &nb_success, &nb_tests);
+    print_test_result(test_deque__reverse_on_non_empty_deque(false), &nb_success, &nb_tests);
+    print_test_result(test_deque__shuffle_on_empty_deque(false), &nb_success, &nb_tests);
+    print_test_result(test_deque__shuffle_on_non_empty_deque(false), &nb_success, &nb_tests);
+    print_test_result(test_deque__sort_on_empty_deque(false), &nb_success, &nb_tests);
+    print_test_result(test_deque__sort_on_non_empty_deque(false), &nb_success, &nb_tests);
+    print_test_result(test_deque__foreach_visits_repeated_pointers_once(), &nb_success, &nb_tests);
+    print_test_result(test_deque__batch_operators(), &nb_success, &nb_tests);
+
+    print_test_summary(nb_success, nb_tests);
+
+    return TEST_SUCCESS;
+}
@@ -0,0 +1,196 @@
+#include <pthread.h>
+
+#include "common_tests_utils.h"
+#include "../queue/mpmc_queue.h"
+#include "../common/defs.h"
+
+#define MPMC_QUEUE_CREATE(A, B, N) \
+    MpmcQueue A = NULL, B = NULL; \
+    A = mpmc_queue__empty_copy_enabled(N, operator_copy, operator_delete); \
+    B = mpmc_queue__empty_copy_disabled(N)
+
+#define MPMC_QUEUE_FREE(A, B, C, D) \
+    FREE(mpmc_queue__free, A, B, C, D)
+
+#define N_THREADS 4
+#define N_TRANSFERS 200000
+
+typedef struct {
+    MpmcQueue q;
+    size_t sum;
+} worker_t;
+
+////////////////////////////////////////////////////////////////////
+///     TEST SUITE
+////////////////////////////////////////////////////////////////////
+
+static bool test_mpmc_queue__empty(void)
+{
+    printf("%s... ", __func__);
+
+    bool result;
+    MPMC_QUEUE_CREATE(q, w, 5);
+
+    result = (q && w
+           && mpmc_queue__is_copy_enabled(q) == 1
+           && mpmc_queue__is_copy_enabled(w) == 0
+           && mpmc_queue__capacity(q) == 8
+           && mpmc_queue__capacity(w) == 8
+           && mpmc_queue__length(q) == 0
+           && mpmc_queue__length(w) == 0) ? TEST_SUCCESS : TEST_FAILURE;
+
+    MPMC_QUEUE_FREE(q, w, NULL, NULL);
+    return result;
+}
+
+static bool test_mpmc_queue__try_enqueue_on_full_queue(void)
+{
+    printf("%s... ", __func__);
+
+    bool result = TEST_SUCCESS;
+    u32 elems[5] = {0, 1, 2, 3, 4};
+    MPMC_QUEUE_CREATE(q, w, 4);
+
+    for (u32 i = 0; i < 4; i++) {
+        result &= !mpmc_queue__try_enqueue(q, &elems[i]) && !mpmc_queue__try_enqueue(w, &elems[i]);
+    }
+    result &= mpmc_queue__try_enqueue(q, &elems[4]) == -1 && mpmc_queue__try_enqueue(w, &elems[4]) == -1;
+    result &= mpmc_queue__length(q) == 4 && mpmc_queue__length(w) == 4;
+
+    MPMC_QUEUE_FREE(q, w, NULL, NULL);
+    return result;
+}
+
+static bool test_mpmc_queue__capacity_one(void)
+{
+    printf("%s... ", __func__);
+
+    bool result = TEST_SUCCESS;
+    u32 elems[3] = {0, 1, 2};
+    elem_t front = NULL;
+    MPMC_QUEUE_CREATE(q, w, 1);
+
+    result &= mpmc_queue__capacity(q) == 2 && mpmc_queue__capacity(w) == 2;
+    for (u32 i = 0; i < 2; i++) {
+        result &= !mpmc_queue__try_enqueue(q, &elems[i]) && !mpmc_queue__try_enqueue(w, &elems[i]);
+    }
+    result &= mpmc_queue__try_enqueue(q, &elems[2]) == -1 && mpmc_queue__try_enqueue(w, &elems[2]) == -1;
+    result &= mpmc_queue__length(q) == 2 && mpmc_queue__length(w) == 2;
+    for (u32 i = 0; i < 2; i++) {
+        result &= !mpmc_queue__try_dequeue(q, &front) && *(u32 *)front == i;
+        free(front);
+        result &= !mpmc_queue__try_dequeue(w, &front) && *(u32 *)front == i;
+    }
+    result &= mpmc_queue__try_dequeue(q, &front) == -1 && mpmc_queue__try_dequeue(w, &front) == -1;
+
+    MPMC_QUEUE_FREE(q, w, NULL, NULL);
+    return result;
+}
+
+static bool test_mpmc_queue__try_dequeue_on_empty_queue(void)
+{
+    printf("%s... ", __func__);
+
+    bool result;
+    elem_t front = NULL;
+    MPMC_QUEUE_CREATE(q, w, 4);
+
+    result = (mpmc_queue__try_dequeue(q, &front) == -1 && mpmc_queue__try_dequeue(w, &front) == -1) ? TEST_SUCCESS : TEST_FAILURE;
+
+    MPMC_QUEUE_FREE(q, w, NULL, NULL);
+    return result;
+}
+
+static bool test_mpmc_queue__enqueue_dequeue_wraparound(void)
+{
+    printf("%s... ", __func__);
+
+    bool result = TEST_SUCCESS;
+    u32 elems[32];
+    elem_t front_q = NULL;
+    elem_t front_w = NULL;
+    MPMC_QUEUE_CREATE(q, w, 4);
+
+    for (u32 i = 0; i < 32; i++) {
+        elems[i] = i;
+        result &= !mpmc_queue__enqueue(q, &elems[i]) && !mpmc_queue__enqueue(w, &elems[i]);
+        if (i >= 3) {
+            result &= !mpmc_queue__dequeue(q, &front_q) && !mpmc_queue__dequeue(w, &front_w);
+            result &= *(u32 *)front_q == i - 3 && front_w == &elems[i - 3];
+            free(front_q);
+        }
+    }
+    result &= mpmc_queue__length(q) == 3 && mpmc_queue__length(w) == 3;
+
+    MPMC_QUEUE_FREE(q, w, NULL, NULL);
+    return result;
+}
+
+static void *producer(void *arg)
+{
+    worker_t *worker = arg;
+    for (size_t i = 1; i <= N_TRANSFERS; i++) {
+        mpmc_queue__enqueue(worker->q, (elem_t)i);
+    }
+    return NULL;
+}
+
+static void *consumer(void *arg)
+{
+    worker_t *worker = arg;
+    elem_t front;
+    for (size_t i = 1; i <= N_TRANSFERS; i++) {
+        mpmc_queue__dequeue(worker->q, &front);
+        worker->sum += (size_t)front;
+    }
+    return NULL;
+}
+
+static bool test_mpmc_queue__concurrent_producers_and_consumers(void)
+{
+    printf("%s... ", __func__);
+
+    bool result = TEST_SUCCESS;
+    pthread_t producers[N_THREADS];
+    pthread_t consumers[N_THREADS];
+    worker_t workers[N_THREADS];
+    size_t sum = 0;
+    MpmcQueue q = mpmc_queue__empty_copy_disabled(64);
+
+    for (size_t i = 0; i < N_THREADS; i++) {
+        workers[i].q = q;
+        workers[i].sum = 0;
+        pthread_create(&producers[i], NULL, producer, &workers[i]);
+        pthread_create(&consumers[i], NULL, consumer, &workers[i]);
+    }
+    for (size_t i = 0; i < N_THREADS; i++) {
+        pthread_join(producers[i], NULL);
+        pthread_join(consumers[i], NULL);
+        sum += workers[i].sum;
+    }
+
+    result &= sum == (size_t)N_THREADS * N_TRANSFERS * (N_TRANSFERS + 1) / 2;
+    result &= mpmc_queue__length(q) == 0;
+
+    MPMC_QUEUE_FREE(q, NULL, NULL, NULL);
+    return result;
+}
+
+
+int main(void)
+{
+    int nb_success = 0;
+    int nb_tests = 0;
+    printf("----------- TEST MPMC QUEUE -----------\n");
+
+    print_test_result(test_mpmc_queue__empty(), &nb_success, &nb_tests);
+    print_test_result(test_mpmc_queue__try_enqueue_on_full_queue(), &nb_success, &nb_tests);
+    print_test_result(test_mpmc_queue__capacity_one(), &nb_success, &nb_tests);
+    print_test_result(test_mpmc_queue__try_dequeue_on_empty_queue(), &nb_success, &nb_tests);
+    print_test_result(test_mpmc_queue__enqueue_dequeue_wraparound(), &nb_success, &nb_tests);
+    print_test_result(test_mpmc_queue__concurrent_producers_and_consumers(), &nb_success, &nb_tests);
+
+    print_test_summary(nb_success, nb_tests);
+
+    return TEST_SUCCESS;
+}
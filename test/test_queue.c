@@ -1,6 +1,10 @@
+#include <unistd.h>
+
 #include "common_tests_utils.h"
 #include "../queue/queue.h"
 #include "../common/defs.h"
+#include "../common/stream.h"
+#include "../common/arena.h"
 
 #define QUEUE_CREATE(A, B) \
     Queue A = NULL, B = NULL; \
@@ -153,6 +157,55 @@ TEST_ON_NON_EMPTY_QUEUE (
     }
 )
 
+/* WRAPAROUND */
+TEST_ON_NON_EMPTY_QUEUE (
+    test_queue__enqueue_dequeue_wraparound, false,
+    u32 extra[5];
+    for (u32 i = 0; i < 5; i++) {
+        extra[i] = N + i;
+    }
+    for (u32 i = 0; i < 4; i++) {
+        result &= !queue__dequeue(q, NULL) && !queue__dequeue(w, NULL);
+        result &= !queue__enqueue(q, &extra[i]) && !queue__enqueue(w, &extra[i]);
+    }
+    result &= COMPARE3(queue__peek_nth, queue__length(q), q, 4, true);
+    result &= COMPARE3(queue__peek_nth, queue__length(w), w, 4, false);
+    result &= queue__search(q, &extra[2], operator_match) == 6 && queue__ptr_search(w, &extra[2]) == 6;
+
+    A = queue__to_array(q);
+    B = queue__to_array(w);
+    for (u32 i = 0; i < N; i++) {
+        result &= *(u32 *)A[i] == i + 4 && *(u32 *)B[i] == i + 4;
+    }
+
+    result &= !queue__enqueue(q, &extra[4]) && !queue__enqueue(w, &extra[4]);
+    result &= queue__length(q) == N + 1 && queue__length(w) == N + 1;
+    result &= COMPARE3(queue__peek_nth, queue__length(q), q, 4, true);
+    result &= COMPARE3(queue__peek_nth, queue__length(w), w, 4, false);
+)
+
+TEST_ON_NON_EMPTY_QUEUE (
+    test_queue__sort_and_filter_on_wrapped_queue, true,
+    u32 value = 2;
+    for (u32 i = 0; i < 5; i++) {
+        elem_t front_q = NULL;
+        elem_t front_w = NULL;
+        queue__dequeue(q, &front_q);
+        queue__dequeue(w, &front_w);
+        queue__enqueue(q, front_q);
+        queue__enqueue(w, front_w);
+        free(front_q);
+    }
+    queue__sort(q, operator_compare);
+    queue__sort(w, operator_compare);
+    result &= IS_SORTED(queue__peek_nth, queue__length(q), q, true);
+    result &= IS_SORTED(queue__peek_nth, queue__length(w), w, false);
+
+    queue__filter(q, predicate, &value);
+    result &= queue__all(q, predicate, &value) == 1 && queue__length(q) <= N;
+    result &= IS_SORTED(queue__peek_nth, queue__length(q), q, true);
+)
+
 /* REMOVE_NTH */
 TEST_ON_EMPTY_QUEUE (
     test_queue__remove_nth_on_empty_queue,
@@ -541,6 +594,1064 @@ TEST_ON_NON_EMPTY_QUEUE (
 )
 
 
+static bool test_queue__inline_enqueue_dequeue_wraparound(void)
+{
+    printf("%s... ", __func__);
+
+    bool result = TEST_SUCCESS;
+    u32 elems[32], value;
+    Queue q = queue__empty_inline(sizeof(u32));
+
+    result &= q && queue__elem_size(q) == sizeof(u32) && !queue__is_copy_enabled(q);
+    for (u32 i = 0; i < 32; i++) {
+        elems[i] = i;
+        result &= !queue__enqueue(q, &elems[i]);
+        if (i % 3 == 2) {
+            result &= !queue__dequeue(q, (elem_t *)&value) && value == i / 3;
+        }
+    }
+    elems[31] = 42;
+
+    result &= queue__length(q) == 22 && queue__remove_nth(q, 0) == -1;
+    result &= !queue__peek_front(q, (elem_t *)&value) && value == 10;
+    result &= !queue__peek_back(q, (elem_t *)&value) && value == 31;
+
+    Queue w = queue__copy(q);
+    result &= queue__cmp(q, w, operator_match) == 1;
+
+    u32 *A = (u32 *)queue__to_array(q);
+    for (u32 i = 0; i < 22; i++) {
+        result &= A[i] == i + 10;
+        result &= !queue__peek_nth(w, i, (elem_t *)&value) && value == i + 10;
+    }
+
+    free(A);
+    QUEUE_FREE(q, w, NULL, NULL);
+    return result;
+}
+
+static bool test_queue__inline_search_foreach_filter_and_sort(void)
+{
+    printf("%s... ", __func__);
+
+    bool result = TEST_SUCCESS;
+    u32 elems[8], value = 3, two = 2;
+    for (u32 i = 0; i < 8; i++) {
+        elems[i] = (i * 5) % 8;
+    }
+    Queue q = queue__from_array(queue__empty_inline(sizeof(u32)), elems, 8, sizeof(u32));
+    for (u32 i = 0; i < 3; i++) {
+        queue__dequeue(q, (elem_t *)&value);
+        queue__enqueue(q, &value);
+    }
+
+    value = 3;
+    result &= queue__search(q, &value, operator_match) == 4 && queue__ptr_search(q, &value) == 4;
+    result &= queue__contains(q, &elems[2], operator_match) == 1;
+
+    queue__sort(q, operator_compare_inline);
+    for (u32 i = 0; i < 8; i++) {
+        result &= !queue__peek_nth(q, i, (elem_t *)&value) && value == i;
+    }
+
+    value = 1;
+    queue__foreach(q, plus_op, &value);
+    queue__filter(q, predicate, &two);
+    result &= queue__length(q) == 4 && queue__all(q, predicate, &two) == 1;
+    for (u32 i = 0; i < 4; i++) {
+        result &= !queue__peek_nth(q, i, (elem_t *)&value) && value == 2 * (i + 1);
+    }
+
+    queue__reverse(q);
+    result &= !queue__peek_front(q, (elem_t *)&value) && value == 8;
+
+    QUEUE_FREE(q, NULL, NULL, NULL);
+    return result;
+}
+
+static bool test_queue__arena_copies_and_clear(void)
+{
+    printf("%s... ", __func__);
+
+    bool result = TEST_SUCCESS;
+    u32 value, two = 2;
+    elem_t front = NULL;
+    Queue s = queue__empty_arena(operator_size);
+
+    result &= s && queue__is_copy_enabled(s) == 1 && queue__empty_arena(NULL) == NULL;
+    for (u32 round = 0; round < 2; round++) {
+        for (value = 0; value < 1000; value++) {
+            result &= !queue__enqueue(s, &value);
+        }
+        for (u32 i = 0; i < 10; i++) {
+            result &= !queue__dequeue(s, &front) && *(u32 *)front == i;
+            free(front);
+        }
+        result &= !queue__peek_front(s, &front) && *(u32 *)front == 10;
+        free(front);
+
+        Queue t = queue__copy(s);
+        result &= queue__cmp(s, t, operator_match) == 1 && !queue__dequeue(t, NULL);
+        queue__filter(t, predicate, &two);
+        result &= queue__length(t) == 494 && queue__all(t, predicate, &two) == 1;
+
+        elem_t *A = queue__dump(t);
+        for (size_t i = 0; i < 494; i++) {
+            free(A[i]);
+        }
+        free(A);
+        queue__free(t);
+
+        queue__clear(s);
+        result &= queue__is_empty(s) == 1;
+    }
+
+    QUEUE_FREE(s, NULL, NULL, NULL);
+    return result;
+}
+
+static size_t size_zero(const void *v)
+{
+    return 0;
+}
+
+static size_t size_large(const void *v)
+{
+    return 8 * ARENA_SLAB_SIZE;
+}
+
+static bool test_queue__arena_chunk_sizes(void)
+{
+    printf("%s... ", __func__);
+
+    bool result = TEST_SUCCESS;
+    u32 value = 0;
+    unsigned char *large = calloc(1, 8 * ARENA_SLAB_SIZE);
+
+    /* released empty chunks keep their free list link out of the next chunk */
+    Queue q = queue__empty_arena(size_zero);
+    for (u32 i = 0; i < 4; i++) {
+        result &= !queue__enqueue(q, &value);
+    }
+    for (u32 i = 0; i < 4; i++) {
+        result &= !queue__dequeue(q, NULL);
+    }
+    result &= !queue__enqueue(q, &value) && queue__length(q) == 1;
+    queue__free(q);
+
+    /* oversized chunks are freed as soon as they are released */
+    q = queue__empty_arena(size_large);
+    for (u32 i = 0; i < 100; i++) {
+        large[0] = (unsigned char)i;
+        result &= !queue__enqueue(q, large);
+        if (i) {
+            elem_t front = NULL;
+            result &= !queue__dequeue(q, &front) && *(unsigned char *)front == i - 1;
+            free(front);
+        }
+    }
+    result &= queue__length(q) == 1;
+    queue__free(q);
+
+    free(large);
+    return result;
+}
+
+static bool test_queue__custom_allocator(void)
+{
+    printf("%s... ", __func__);
+
+    bool result = TEST_SUCCESS;
+    u32 elems[100];
+    alloc_counter_t counter = {0, 0, 0, 0};
+    allocator_t allocator = counting_allocator(&counter);
+
+    result &= queue__empty_with_allocator(NULL, NULL, NULL) == NULL;
+    result &= queue__empty_with_allocator(&allocator, operator_copy, NULL) == NULL;
+
+    Queue s = queue__empty_with_allocator(&allocator, operator_copy, operator_delete);
+    result &= s && queue__is_copy_enabled(s) == 1 && counter.n_allocs == 2;
+    for (u32 i = 0; i < 100; i++) {
+        elems[i] = i;
+        result &= !queue__enqueue(s, &elems[i]);
+    }
+    size_t n_reallocs = counter.n_reallocs;
+    result &= n_reallocs > 0 && counter.n_bytes >= 100 * sizeof(elem_t);
+
+    Queue t = queue__copy(s);
+    result &= counter.n_allocs == 4;
+    for (u32 i = 0; i < 100; i++) {
+        result &= !queue__dequeue(t, NULL);
+    }
+    result &= counter.n_reallocs > n_reallocs;
+
+    queue__free(t);
+    queue__free(s);
+    result &= counter.n_frees == 4;
+
+    return result;
+}
+
+static bool test_queue__capacity_policy(void)
+{
+    printf("%s... ", __func__);
+
+    bool result = TEST_SUCCESS;
+    u32 elems[64];
+    capacity_policy_t never_shrink = {2, 0, 2};
+    capacity_policy_t invalid = {2, 1, 2};
+    Queue s = queue__with_capacity(100);
+
+    result &= !queue__enqueue(s, &elems[0]) && !queue__dequeue(s, NULL) && queue__capacity(s) == 128;
+    result &= !queue__reserve(s, 1000) && queue__capacity(s) == 1024;
+    for (u32 i = 0; i < 10; i++) {
+        elems[i] = i;
+        result &= !queue__enqueue(s, &elems[i]);
+    }
+    result &= !queue__shrink_to_fit(s) && queue__capacity(s) == 128 && queue__length(s) == 10;
+    queue__free(s);
+
+    s = queue__empty_copy_disabled();
+    result &= queue__set_policy(s, &invalid) == -1 && queue__set_policy(NULL, &never_shrink) == -1;
+    for (u32 i = 0; i < 64; i++) {
+        elems[i] = i;
+        result &= !queue__enqueue(s, &elems[i]);
+    }
+    result &= queue__capacity(s) == 64;
+    while (queue__length(s) > 16) {
+        result &= !queue__dequeue(s, NULL);
+    }
+    result &= queue__capacity(s) == 64;
+    result &= !queue__dequeue(s, NULL) && queue__capacity(s) == 32;
+
+    result &= !queue__set_policy(s, &never_shrink);
+    while (!queue__is_empty(s)) {
+        result &= !queue__dequeue(s, NULL);
+    }
+    queue__clear(s);
+    result &= queue__capacity(s) == 32;
+
+    queue__free(s);
+    return result;
+}
+
+
+static bool test_queue__enqueue_n_and_dequeue_n(void)
+{
+    printf("%s... ", __func__);
+
+    bool result = TEST_SUCCESS;
+    u32 values[300];
+    u32 inline_out[300];
+    elem_t ptrs[300], out[300];
+    for (u32 i = 0; i < 300; i++) {
+        values[i] = i;
+        ptrs[i] = &values[i];
+    }
+
+    Queue q = queue__empty_copy_disabled();
+    result &= queue__enqueue_n(NULL, ptrs, 10) == -1 && queue__enqueue_n(q, NULL, 10) == -1;
+    /* wrap the ring before the bulk calls */
+    result &= !queue__enqueue_n(q, ptrs, 2) && queue__dequeue_n(q, out, 1) == 1 && out[0] == ptrs[0];
+    result &= !queue__enqueue(q, ptrs[2]) && !queue__enqueue_n(q, ptrs + 3, 297) && queue__length(q) == 299;
+    result &= queue__capacity(q) == 512;
+    result &= queue__dequeue_n(q, out, 100) == 100;
+    for (u32 i = 0; i < 100; i++) {
+        result &= out[i] == ptrs[1 + i];
+    }
+    result &= !queue__enqueue_n(q, ptrs, 300) && queue__length(q) == 499;
+    result &= queue__dequeue_n(q, out, 300) == 300;
+    for (u32 i = 0; i < 199; i++) {
+        result &= out[i] == ptrs[101 + i];
+    }
+    for (u32 i = 0; i < 101; i++) {
+        result &= out[199 + i] == ptrs[i];
+    }
+    result &= queue__dequeue_n(q, NULL, 1000) == 199 && queue__is_empty(q) && queue__capacity(q) == 2;
+    result &= queue__dequeue_n(NULL, out, 1) == SIZE_MAX && queue__dequeue_n(q, out, 1) == 0;
+    queue__free(q);
+
+    q = queue__empty_copy_enabled(operator_copy, operator_delete);
+    result &= !queue__enqueue_n(q, ptrs, 300);
+    values[0] = 1000;
+    result &= queue__dequeue_n(q, out, 2) == 2 && *(u32 *)out[0] == 0 && *(u32 *)out[1] == 1;
+    free(out[0]);
+    free(out[1]);
+    values[0] = 0;
+    result &= queue__dequeue_n(q, NULL, 100) == 100 && queue__length(q) == 198;
+    queue__free(q);
+
+    q = queue__empty_inline(sizeof(u32));
+    result &= !queue__enqueue_n(q, values, 300) && queue__dequeue_n(q, inline_out, 300) == 300;
+    for (u32 i = 0; i < 300; i++) {
+        result &= inline_out[i] == values[i];
+    }
+    queue__free(q);
+
+    return result;
+}
+
+
+
+#define N_SORTED 100000
+
+/**
+ * Orders inline u32 values by their 12 high bits only, the low bits record the insertion order
+ */
+static int compare_high_bits(const void *v1, const void *v2)
+{
+    u32 arg1 = *(const u32 *)v1 >> 20;
+    u32 arg2 = *(const u32 *)v2 >> 20;
+
+    return (arg1 > arg2) - (arg1 < arg2);
+}
+
+static bool test_queue__sort_parallel(void)
+{
+    printf("%s... ", __func__);
+
+    bool result = TEST_SUCCESS;
+    static u32 values[N_SORTED];
+    u32 prev, cur;
+    Queue q = queue__empty_inline(sizeof(u32));
+
+    for (u32 i = 0; i < N_SORTED; i++) {
+        values[i] = ((i * 7919) % 16) << 20 | i;
+    }
+    result &= queue__sort_parallel(NULL, compare_high_bits, 4, true) == -1;
+    result &= queue__sort_parallel(q, NULL, 4, true) == -1 && queue__sort_parallel(q, compare_high_bits, 0, true) == -1;
+
+    result &= !queue__enqueue_n(q, values, N_SORTED);
+    /* wrap the ring before sorting, the values enqueued again get the last insertion ranks */
+    result &= queue__dequeue_n(q, NULL, 40000) == 40000;
+    for (u32 i = 0; i < 40000; i++) {
+        values[i] = (values[i] & ~0xFFFFFu) | (N_SORTED + i);
+    }
+    result &= !queue__enqueue_n(q, values, 40000);
+    result &= !queue__sort_parallel(q, compare_high_bits, 4, true) && queue__length(q) == N_SORTED;
+    result &= !queue__peek_nth(q, 0, (elem_t *)&prev);
+    for (u32 i = 1; i < N_SORTED; i++) {
+        result &= !queue__peek_nth(q, i, (elem_t *)&cur);
+        result &= prev >> 20 < cur >> 20 || (prev >> 20 == cur >> 20 && prev < cur);
+        prev = cur;
+    }
+
+    result &= !queue__sort_parallel(q, operator_compare_inline, 3, false);
+    result &= !queue__peek_nth(q, 0, (elem_t *)&prev);
+    for (u32 i = 1; i < N_SORTED; i++) {
+        result &= !queue__peek_nth(q, i, (elem_t *)&cur) && prev <= cur;
+        prev = cur;
+    }
+    queue__free(q);
+
+    q = queue__empty_copy_enabled(operator_copy, operator_delete);
+    for (u32 i = 0; i < 1000; i++) {
+        result &= !queue__enqueue(q, &values[i]);
+    }
+    result &= !queue__sort_parallel(q, operator_compare, 2, true);
+    result &= IS_SORTED(queue__peek_nth, queue__length(q), q, true);
+    queue__free(q);
+
+    return result;
+}
+
+
+static uint64_t key_high_bits(const void *v)
+{
+    return *(const u32 *)v >> 20;
+}
+
+static uint64_t key_reversed(const void *v)
+{
+    return UINT64_MAX - *(const u32 *)v;
+}
+
+static bool test_queue__sort_by_key(void)
+{
+    printf("%s... ", __func__);
+
+    bool result = TEST_SUCCESS;
+    u32 values[5000], value, prev;
+    elem_t ptrs[5000], elem;
+    Queue q = queue__empty_copy_disabled();
+
+    for (u32 i = 0; i < 5000; i++) {
+        values[i] = ((i * 7919) % 300) << 20 | i;
+        ptrs[i] = &values[i];
+    }
+    result &= queue__sort_by_key(NULL, key_high_bits) == -1 && queue__sort_by_key(q, NULL) == -1;
+    result &= !queue__sort_by_key(q, key_high_bits);
+
+    result &= !queue__enqueue_n(q, ptrs, 5000) && !queue__sort_by_key(q, key_high_bits);
+    result &= !queue__peek_nth(q, 0, &elem);
+    prev = *(u32 *)elem;
+    for (u32 i = 1; i < 5000; i++) {
+        result &= !queue__peek_nth(q, i, &elem);
+        value = *(u32 *)elem;
+        result &= prev >> 20 < value >> 20 || (prev >> 20 == value >> 20 && prev < value);
+        prev = value;
+    }
+    queue__free(q);
+
+    q = queue__empty_inline(sizeof(u32));
+    result &= !queue__enqueue_n(q, values, 5000) && !queue__sort_by_key(q, key_reversed);
+    result &= !queue__peek_nth(q, 0, (elem_t *)&prev);
+    for (u32 i = 1; i < 5000; i++) {
+        result &= !queue__peek_nth(q, i, (elem_t *)&value) && prev > value;
+        prev = value;
+    }
+    queue__free(q);
+
+    return result;
+}
+
+
+static bool test_queue__ptr_search_on_every_position(void)
+{
+    printf("%s... ", __func__);
+
+    bool result = TEST_SUCCESS;
+    u32 values[70];
+    elem_t ptrs[70];
+    for (u32 i = 0; i < 70; i++) {
+        ptrs[i] = &values[i];
+    }
+
+    /* lengths and positions around the widths of the SIMD kernels */
+    for (size_t n = 0; n < 70; n++) {
+        Queue q = queue__empty_copy_disabled();
+        result &= !queue__enqueue_n(q, ptrs, n);
+        /* shift the front so that the searched runs wrap around the ring */
+        result &= queue__dequeue_n(q, NULL, n / 2) == n / 2 && !queue__enqueue_n(q, ptrs, n / 2);
+        result &= queue__dequeue_n(q, NULL, n - n / 2) == n - n / 2 && !queue__enqueue_n(q, ptrs + n / 2, n - n / 2);
+        for (size_t i = 0; i < n; i++) {
+            result &= queue__ptr_search(q, ptrs[i]) == i && queue__ptr_contains(q, ptrs[i]) == 1;
+        }
+        result &= queue__ptr_search(q, ptrs[n]) == SIZE_MAX && !queue__ptr_contains(q, ptrs[n]);
+        result &= queue__ptr_search(q, NULL) == SIZE_MAX;
+        if (n > 9) {
+            result &= !queue__enqueue_n(q, ptrs + 3, 1) && queue__ptr_search(q, ptrs[3]) == 3;
+        }
+        queue__free(q);
+    }
+
+    return result;
+}
+
+
+static uint64_t hash_u32(const void *v)
+{
+    return *(const u32 *)v;
+}
+
+
+static int match_u32(const void *v1, const void *v2)
+{
+    return v1 && v2 && *(const u32 *)v1 == *(const u32 *)v2;
+}
+
+
+static char is_odd(const void *v, void *user_data)
+{
+    return v && *(const u32 *)v & 1;
+}
+
+
+/* the positions found through the index are the ones found by a linear search */
+static bool index_agrees(const Queue q)
+{
+    bool result = TEST_SUCCESS;
+    for (u32 key = 0; key <= 50; key++) {
+        result &= queue__search(q, &key, operator_match) == queue__search(q, &key, match_u32);
+        result &= queue__contains(q, &key, operator_match) == queue__contains(q, &key, match_u32);
+    }
+    return result;
+}
+
+
+static bool test_queue__hash_index(void)
+{
+    printf("%s... ", __func__);
+
+    bool result = TEST_SUCCESS;
+    u32 values[100], key = 7;
+    elem_t ptrs[100], elem;
+    for (u32 i = 0; i < 100; i++) {
+        values[i] = i % 50;
+        ptrs[i] = &values[i];
+    }
+
+    result &= !queue__empty_indexed(NULL, operator_match) && !queue__empty_indexed(hash_u32, NULL);
+    Queue q = queue__empty_indexed(hash_u32, operator_match);
+    result &= queue__is_indexed(q) == 1 && queue__search(q, &key, operator_match) == SIZE_MAX;
+    result &= queue__set_index(q, hash_u32, NULL) == -1 && queue__is_indexed(q) == 1;
+
+    result &= !queue__enqueue_n(q, ptrs, 100) && queue__search(q, &key, operator_match) == 7 && index_agrees(q);
+    result &= !queue__dequeue(q, &elem) && queue__dequeue_n(q, NULL, 10) == 10 && index_agrees(q);
+    for (u32 i = 0; i < 30; i++) {
+        result &= !queue__dequeue(q, &elem) && !queue__enqueue(q, elem);
+    }
+    result &= index_agrees(q);
+
+    result &= !queue__swap(q, 3, 60) && index_agrees(q);
+    queue__sort(q, operator_compare);
+    result &= index_agrees(q) && !queue__remove_nth(q, 12) && index_agrees(q);
+    queue__reverse(q);
+    result &= index_agrees(q);
+    queue__shuffle(q, 42);
+    result &= index_agrees(q);
+    queue__filter(q, is_odd, NULL);
+    result &= index_agrees(q) && queue__contains(q, &key, operator_match) == 1;
+
+    Queue copy = queue__copy(q);
+    result &= queue__is_indexed(copy) == 1 && index_agrees(copy);
+    queue__free(copy);
+
+    queue__clear(q);
+    result &= !queue__contains(q, &key, operator_match) && !queue__enqueue_n(q, ptrs, 10) && index_agrees(q);
+    result &= !queue__set_index(q, NULL, NULL) && !queue__is_indexed(q) && index_agrees(q);
+    queue__free(q);
+
+    q = queue__empty_inline(sizeof(u32));
+    result &= !queue__enqueue_n(q, values, 100) && !queue__set_index(q, hash_u32, operator_match);
+    result &= queue__is_indexed(q) == 1 && queue__search(q, &key, operator_match) == 7 && index_agrees(q);
+    result &= !queue__dequeue(q, (elem_t *)&key) && key == 0 && index_agrees(q);
+    queue__free(q);
+
+    return result;
+}
+
+
+static void count_visits(const void *v, void *user_data)
+{
+    (*(size_t *)user_data)++;
+}
+
+
+static bool test_queue__foreach_visits_repeated_pointers_once(void)
+{
+    printf("%s... ", __func__);
+
+    bool result = TEST_SUCCESS;
+    u32 values[100];
+    elem_t ptrs[1000];
+    size_t n_visits = 0;
+    for (u32 i = 0; i < 1000; i++) {
+        ptrs[i] = i % 250 == 0 ? NULL : &values[i % 100];
+    }
+
+    Queue q = queue__empty_copy_disabled();
+    result &= !queue__enqueue_n(q, ptrs, 1000);
+
+    queue__foreach(q, count_visits, &n_visits);
+    result &= n_visits == 101;
+    n_visits = 0;
+    queue__foreach(q, count_visits, &n_visits);
+    result &= n_visits == 101;
+    n_visits = 0;
+    queue__foreach_all(q, count_visits, &n_visits);
+    result &= n_visits == 1000;
+    n_visits = 0;
+
+    result &= !queue__shrink_to_fit(q);
+    queue__foreach(q, count_visits, &n_visits);
+    result &= n_visits == 101;
+    n_visits = 0;
+
+    /* a pointer of the wrapped run already visited in the first run is skipped */
+    result &= queue__dequeue_n(q, NULL, 300) == 300 && !queue__enqueue_n(q, ptrs, 300);
+    queue__foreach(q, count_visits, &n_visits);
+    result &= n_visits == 101;
+
+    queue__free(q);
+
+    return result;
+}
+
+
+static void add_atomic(const void *v, void *user_data)
+{
+    __atomic_fetch_add((uint64_t *)user_data, *(const u32 *)v, __ATOMIC_RELAXED);
+}
+
+
+static char below(const void *v, void *user_data)
+{
+    return *(const u32 *)v < *(u32 *)user_data;
+}
+
+
+static char is_even(const void *v, void *user_data)
+{
+    return !(*(const u32 *)v & 1);
+}
+
+
+static bool test_queue__parallel_traversals(void)
+{
+    printf("%s... ", __func__);
+
+    bool result = TEST_SUCCESS;
+    static u32 values[10000];
+    static elem_t ptrs[10000];
+    u32 bound = 10000, prev, value;
+    uint64_t sum = 0;
+    elem_t elem;
+    for (u32 i = 0; i < 10000; i++) {
+        values[i] = (i * 7919) % 10000;
+        ptrs[i] = &values[i];
+    }
+
+    ThreadPool pool = thread_pool__create(4);
+    Queue q = queue__empty_copy_disabled();
+    result &= thread_pool__size(pool) == 4 && !thread_pool__create(0);
+    result &= queue__any_parallel(NULL, below, &bound, pool) == -1 && queue__all_parallel(q, below, &bound, NULL) == -1;
+    result &= queue__foreach_parallel(q, NULL, NULL, pool) == -1 && queue__filter_parallel(q, NULL, NULL, pool) == -1;
+    result &= queue__all_parallel(q, below, &bound, pool) == 1 && queue__any_parallel(q, below, &bound, pool) == 0;
+    result &= !queue__filter_parallel(q, is_even, NULL, pool) && !queue__length(q);
+
+    result &= !queue__enqueue_n(q, ptrs, 10000);
+    for (u32 i = 0; i < 3000; i++) {
+        result &= !queue__dequeue(q, &elem) && !queue__enqueue(q, elem);
+    }
+    result &= !queue__foreach_parallel(q, add_atomic, &sum, pool) && sum == 9999ULL * 10000 / 2;
+    result &= queue__all_parallel(q, below, &bound, pool) == 1;
+    bound = 9999;
+    result &= queue__all_parallel(q, below, &bound, pool) == 0 && queue__any_parallel(q, below, &bound, pool) == 1;
+    bound = 0;
+    result &= queue__any_parallel(q, below, &bound, pool) == 0;
+
+    result &= !queue__filter_parallel(q, is_even, NULL, pool) && queue__length(q) == 5000;
+    result &= queue__all_parallel(q, is_even, NULL, pool) == 1;
+    result &= !queue__peek_nth(q, 0, &elem);
+    prev = *(u32 *)elem;
+    for (u32 i = 1; i < 5000; i++) {
+        result &= !queue__peek_nth(q, i, &elem);
+        value = *(u32 *)elem;
+        result &= (prev + 2 * 7919) % 10000 == value;
+        prev = value;
+    }
+    queue__free(q);
+
+    q = queue__empty_inline(sizeof(u32));
+    result &= !queue__enqueue_n(q, values, 10000) && !queue__filter_parallel(q, is_even, NULL, pool);
+    result &= queue__length(q) == 5000 && queue__all_parallel(q, is_even, NULL, pool) == 1;
+    queue__free(q);
+    thread_pool__free(pool);
+
+    return result;
+}
+
+
+static bool test_queue__borrow_and_span(void)
+{
+    printf("%s... ", __func__);
+
+    bool result = TEST_SUCCESS;
+    u32 values[100], rotated[100], value;
+    elem_t ptrs[100];
+    const void *borrowed, *other;
+    span_t first, second, first_after, second_after;
+    uint64_t sum = 0;
+    size_t n_visits = 0;
+    for (u32 i = 0; i < 100; i++) {
+        values[i] = i;
+        ptrs[i] = &values[i];
+    }
+
+    Queue q = queue__empty_copy_enabled(operator_copy, operator_delete);
+    result &= queue__borrow_front(q, &borrowed) == -1 && queue__borrow_back(q, &borrowed) == -1;
+    result &= !queue__spans(q, &first, &second) && first.length == 0 && second.length == 0;
+
+    result &= !queue__enqueue_n(q, ptrs, 100);
+    result &= !queue__borrow_front(q, &borrowed) && *(const u32 *)borrowed == 0 && borrowed != ptrs[0];
+    result &= !queue__borrow_back(q, &other) && *(const u32 *)other == 99;
+    result &= !queue__borrow_nth(q, 0, &other) && other == borrowed;
+    result &= queue__borrow_nth(q, 100, &other) == -1 && queue__borrow_front(NULL, &other) == -1;
+    result &= !queue__spans(q, &first, &second) && first.length == 100 && second.length == 0;
+
+    queue__free(q);
+    q = queue__empty_inline(sizeof(u32));
+    result &= !queue__enqueue_n(q, values, 100) && queue__dequeue_n(q, NULL, 60) == 60;
+    result &= !queue__enqueue_n(q, values, 60);
+    result &= !queue__spans(q, &first, &second) && second.length && first.length + second.length == 100;
+    for (size_t i = 0; i < 100; i++) {
+        const u32 *slot = i < first.length ? (const u32 *)first.slots + i : (const u32 *)second.slots + i - first.length;
+        result &= *slot == (i + 60) % 100 && !queue__borrow_nth(q, i, &borrowed) && borrowed == slot;
+    }
+
+    /* the reading functions walk the two runs without moving the elements */
+    for (u32 i = 0; i < 100; i++) {
+        rotated[i] = (i + 60) % 100;
+    }
+    Queue w = queue__empty_inline(sizeof(u32));
+    result &= !queue__enqueue_n(w, rotated, 100) && queue__cmp(q, w, operator_match) == 1;
+    queue__free(w);
+    w = queue__copy(q);
+    result &= queue__cmp(q, w, operator_match) == 1 && queue__cmp(w, q, operator_match) == 1;
+    result &= !queue__peek_nth(w, 0, (elem_t *)&value) && value == 60;
+    queue__free(w);
+    queue__foreach(q, add_atomic, &sum);
+    queue__foreach_all(q, count_visits, &n_visits);
+    result &= sum == 99 * 100 / 2 && n_visits == 100;
+    result &= !queue__spans(q, &first_after, &second_after);
+    result &= first_after.slots == first.slots && first_after.length == first.length;
+    result &= second_after.slots == second.slots && second_after.length == second.length;
+    queue__free(q);
+
+    return result;
+}
+
+
+static bool test_queue__steal_and_adopt(void)
+{
+    printf("%s... ", __func__);
+
+    bool result = TEST_SUCCESS;
+    u32 values[100], value;
+    elem_t ptrs[100], elem;
+    size_t length, capacity;
+    for (u32 i = 0; i < 100; i++) {
+        values[i] = i;
+        ptrs[i] = &values[i];
+    }
+
+    Queue q = queue__empty_copy_disabled();
+    result &= !queue__enqueue_n(q, ptrs, 100) && queue__dequeue_n(q, NULL, 30) == 30;
+    result &= !queue__enqueue_n(q, ptrs, 20);
+    elem_t *stolen = queue__steal(q, &length, &capacity);
+    result &= stolen && length == 90 && capacity >= 90 && !queue__length(q);
+    for (u32 i = 0; i < 90; i++) {
+        result &= stolen[i] == ptrs[(i + 30) % 100];
+    }
+    result &= !queue__enqueue(q, ptrs[0]) && queue__length(q) == 1;
+    queue__free(q);
+
+    result &= !queue__adopt(NULL, 0, 1, 0) && !queue__adopt(stolen, 91, 90, 0);
+    q = queue__adopt(stolen, length, capacity, 0);
+    result &= q && queue__length(q) == 90 && !queue__dequeue(q, &elem) && elem == ptrs[30];
+    result &= !queue__enqueue_n(q, ptrs, 100) && queue__length(q) == 189;
+    queue__free(q);
+
+    /* 100 slots: 64 are used, the array grows to 128 slots to hold 100 elements */
+    u32 *packed = malloc(sizeof(u32) * 100);
+    for (u32 i = 0; i < 100; i++) {
+        packed[i] = i;
+    }
+    q = queue__adopt((elem_t *)packed, 50, 100, sizeof(u32));
+    result &= q && !queue__dequeue(q, (elem_t *)&value) && value == 0 && queue__length(q) == 49;
+    queue__free(q);
+    packed = malloc(sizeof(u32) * 100);
+    for (u32 i = 0; i < 100; i++) {
+        packed[i] = i;
+    }
+    q = queue__adopt((elem_t *)packed, 100, 100, sizeof(u32));
+    result &= q && !queue__peek_back(q, (elem_t *)&value) && value == 99 && !queue__enqueue(q, &value);
+    result &= !queue__dequeue(q, (elem_t *)&value) && value == 0 && queue__length(q) == 100;
+    queue__free(q);
+
+    q = queue__empty_arena(operator_size);
+    result &= !queue__steal(q, NULL, NULL) && !queue__steal(NULL, NULL, NULL);
+    queue__free(q);
+
+    return result;
+}
+
+
+static bool test_queue__enqueue_owned(void)
+{
+    printf("%s... ", __func__);
+
+    bool result = TEST_SUCCESS;
+    elem_t owned[100], elem;
+    const void *borrowed;
+    for (u32 i = 0; i < 100; i++) {
+        owned[i] = malloc(sizeof(u32));
+        *(u32 *)owned[i] = i;
+    }
+
+    Queue q = queue__empty_copy_enabled(operator_copy, operator_delete);
+    result &= queue__enqueue_owned(NULL, owned[0]) == -1 && queue__enqueue_owned_n(q, NULL, 1) == -1;
+    result &= !queue__enqueue_owned(q, owned[0]) && !queue__borrow_back(q, &borrowed) && borrowed == owned[0];
+    result &= !queue__enqueue_owned_n(q, owned + 1, 59) && queue__dequeue_n(q, NULL, 50) == 50;
+    result &= !queue__enqueue_owned_n(q, owned + 60, 40) && !queue__borrow_back(q, &borrowed) && borrowed == owned[99];
+    result &= !queue__dequeue(q, &elem) && elem == owned[50];
+    free(elem);
+    queue__free(q);
+
+    q = queue__empty_inline(sizeof(u32));
+    result &= queue__enqueue_owned(q, &elem) == -1 && queue__enqueue_owned_n(q, owned, 1) == -1;
+    queue__free(q);
+    q = queue__empty_arena(operator_size);
+    result &= queue__enqueue_owned(q, &elem) == -1;
+    queue__free(q);
+
+    return result;
+}
+
+
+
+/* every run of elements is copied or deleted by a single call of the batch operators */
+static bool test_queue__batch_operators(void)
+{
+    printf("%s... ", __func__);
+
+    bool result = TEST_SUCCESS;
+    u32 values[100];
+    elem_t elems[100], *array;
+    const void *borrowed;
+    for (u32 i = 0; i < 100; i++) {
+        values[i] = i;
+        elems[i] = &values[i];
+    }
+
+    result &= !queue__empty_copy_enabled_n(NULL, operator_delete, operator_copy_n, operator_delete_n);
+
+    batch_calls = (batch_counter_t){0};
+    Queue q = queue__empty_copy_enabled_n(operator_copy, operator_delete, operator_copy_n, operator_delete_n);
+    result &= !queue__enqueue_n(q, elems, 100);
+    array = queue__to_array(q);
+    for (u32 i = 0; array && i < 100; i++) {
+        result &= array[i] != elems[i] && *(u32 *)array[i] == i;
+        free(array[i]);
+    }
+    free(array);
+
+    Queue copy = queue__copy(q);
+    result &= queue__length(copy) == 100;
+    queue__clear(copy);
+    queue__free(copy);
+
+    queue__filter(q, is_odd, NULL);
+    result &= queue__length(q) == 50;
+    for (size_t i = 0; i < 50; i++) {
+        result &= !queue__borrow_nth(q, i, &borrowed) && *(const u32 *)borrowed == 2 * i + 1;
+    }
+    result &= queue__from_array(q, values, 10, sizeof(u32)) == q && queue__length(q) == 60;
+    result &= !queue__borrow_back(q, &borrowed) && borrowed != &values[9] && *(const u32 *)borrowed == 9;
+    queue__free(q);
+
+    result &= batch_calls.n_copy_calls == 4 && batch_calls.n_copied == 310;
+    result &= batch_calls.n_delete_calls == 3 && batch_calls.n_deleted == 210;
+
+    /* a run wrapping around the end of the ring buffer is copied in two calls */
+    q = queue__empty_copy_enabled_n(operator_copy, operator_delete, operator_copy_n, NULL);
+    result &= !queue__enqueue_n(q, elems, 100) && queue__dequeue_n(q, NULL, 30) == 30;
+    result &= !queue__enqueue_n(q, elems, 50) && queue__length(q) == 120;
+    result &= batch_calls.n_copy_calls == 7 && batch_calls.n_copied == 460;
+    queue__free(q);
+    result &= batch_calls.n_delete_calls == 3;
+
+    return result;
+}
+
+
+
+/* containers written one after the other on the same file are read back identical, whatever their storage */
+static bool test_queue__serialize_and_deserialize(void)
+{
+    printf("%s... ", __func__);
+
+    bool result = TEST_SUCCESS;
+    enum { N_SERIAL = 20000 };
+    u32 value = 0;
+    elem_t elem;
+    FILE *file = tmpfile();
+    int fd = fileno(file);
+
+    Queue inl = queue__empty_inline(sizeof(u32));
+    Queue ptr = queue__empty_copy_enabled(operator_copy, operator_delete);
+    for (u32 i = 0; i < N_SERIAL; i++) {
+        queue__enqueue(inl, &i);
+        queue__enqueue(ptr, &i);
+    }
+    result &= queue__serialize(ptr, fd, NULL) == -1 && queue__serialize(NULL, fd, operator_write_u32) == -1;
+    result &= !queue__serialize(inl, fd, NULL) && !queue__serialize(ptr, fd, operator_write_u32);
+    queue__free(inl);
+    queue__free(ptr);
+
+    lseek(fd, 0, SEEK_SET);
+    inl = queue__deserialize(NULL, fd, NULL, NULL);
+    ptr = queue__deserialize(queue__empty_copy_enabled(operator_copy, operator_delete), fd, operator_read_u32, NULL);
+    result &= inl && ptr && queue__length(inl) == N_SERIAL && queue__length(ptr) == N_SERIAL;
+    for (u32 i = 0; result && i < N_SERIAL; i++) {
+        result &= !queue__dequeue(inl, (elem_t *)&value) && value == i;
+        result &= !queue__dequeue(ptr, &elem) && *(u32 *)elem == i;
+        free(elem);
+    }
+    result &= !queue__deserialize(inl, fd, NULL, NULL);
+
+    /* streams of another container, of other values or truncated leave the queue unaltered */
+    queue__enqueue(inl, &value);
+    result &= !ftruncate(fd, 0) && !lseek(fd, 0, SEEK_SET) && !queue__serialize(inl, fd, NULL);
+    result &= pwrite(fd, &(unsigned char){STREAM_STACK}, 1, 8) == 1 && !queue__dequeue(inl, NULL) && !lseek(fd, 0, SEEK_SET);
+    result &= !queue__deserialize(inl, fd, NULL, NULL) && queue__length(inl) == 0;
+
+    queue__enqueue(ptr, &value);
+    queue__enqueue(ptr, &value);
+    result &= !ftruncate(fd, 0) && !lseek(fd, 0, SEEK_SET) && !queue__serialize(ptr, fd, operator_write_u32);
+    lseek(fd, 0, SEEK_SET);
+    result &= !queue__deserialize(inl, fd, operator_read_u32, NULL) && queue__length(inl) == 0;
+    lseek(fd, 0, SEEK_SET);
+    result &= !queue__deserialize(NULL, fd, NULL, NULL) && !lseek(fd, 0, SEEK_SET);
+    result &= !queue__deserialize(NULL, fd, operator_read_u32, NULL) && !lseek(fd, 0, SEEK_SET);
+
+    /* the elements of a new queue are left to the user */
+    Queue loaded = queue__deserialize(NULL, fd, operator_read_u32, operator_delete);
+    result &= loaded && queue__is_copy_enabled(loaded) == 0 && queue__length(loaded) == 2;
+    while (loaded && !queue__dequeue(loaded, &elem)) {
+        free(elem);
+    }
+    queue__free(loaded);
+
+    /* the elements built before the failure are deleted by the queue if it owns them, by 'delete_op' otherwise */
+    result &= !ftruncate(fd, lseek(fd, 0, SEEK_END) - 1) && !lseek(fd, 0, SEEK_SET);
+    result &= !queue__deserialize(ptr, fd, operator_read_u32, NULL) && queue__length(ptr) == 2 && !lseek(fd, 0, SEEK_SET);
+    result &= !queue__deserialize(NULL, fd, operator_read_u32, operator_delete);
+
+    queue__free(inl);
+    queue__free(ptr);
+    fclose(file);
+
+    return result;
+}
+
+
+
+/* the elements after the front are spilled to segment files then loaded back in order */
+static bool test_queue__spill(void)
+{
+    printf("%s... ", __func__);
+
+    bool result = TEST_SUCCESS;
+    enum { N_SPILL = 5000, WATERMARK = 256 };
+    u32 value = 0, values[100];
+    elem_t elem, *array;
+    queue_spill_stats_t stats;
+    char dir[] = "/tmp/test_queueXXXXXX";
+    result &= mkdtemp(dir) != NULL;
+
+    Queue inl = queue__empty_inline(sizeof(u32));
+    Queue ptr = queue__empty_copy_enabled(operator_copy, operator_delete);
+    Queue cpy = queue__empty_copy_disabled();
+    result &= queue__set_spill(cpy, dir, WATERMARK, operator_write_u32, operator_read_u32) == -1;
+    result &= queue__set_spill(ptr, dir, WATERMARK, NULL, operator_read_u32) == -1;
+    result &= queue__set_spill(inl, "/nonexistent", WATERMARK, NULL, NULL) == -1;
+    result &= queue__set_spill(inl, dir, 0, NULL, NULL) == -1 && queue__spill_stats(inl, &stats) == -1;
+    result &= !queue__set_spill(inl, dir, WATERMARK, NULL, NULL);
+    result &= !queue__set_spill(ptr, dir, WATERMARK, operator_write_u32, operator_read_u32);
+    result &= queue__set_index(inl, hash_u32, operator_match) == -1;
+
+    for (u32 i = 0; i < N_SPILL; i++) {
+        queue__enqueue(inl, &i);
+        queue__enqueue(ptr, &i);
+    }
+    result &= !queue__spill_stats(inl, &stats) && stats.n_segments && stats.spilled_bytes;
+    result &= stats.n_spilled == stats.n_segments * (WATERMARK / 4) && stats.n_spilled > N_SPILL - 2 * WATERMARK;
+    result &= queue__length(inl) == N_SPILL && queue__length(ptr) == N_SPILL;
+    result &= !queue__peek_back(inl, (elem_t *)&value) && value == N_SPILL - 1;
+    result &= !queue__peek_nth(inl, N_SPILL - 2, (elem_t *)&value) && value == N_SPILL - 2;
+
+    /* dequeues and batch dequeues across the segments, with enqueues in between */
+    u32 next = 0, last = N_SPILL;
+    while (result && next < N_SPILL / 2) {
+        result &= !queue__peek_front(ptr, &elem) && *(u32 *)elem == next;
+        free(elem);
+        result &= !queue__dequeue(inl, (elem_t *)&value) && value == next;
+        result &= !queue__dequeue(ptr, &elem) && *(u32 *)elem == next;
+        free(elem);
+        next++;
+        result &= queue__dequeue_n(inl, values, 100) == 100;
+        for (u32 k = 0; k < 100; k++) {
+            result &= values[k] == next + k;
+        }
+        queue__dequeue_n(ptr, NULL, 100);
+        next += 100;
+        queue__enqueue(inl, &last);
+        queue__enqueue(ptr, &last);
+        last++;
+    }
+    result &= queue__length(inl) == last - next && queue__length(ptr) == last - next;
+    result &= !queue__spill_stats(ptr, &stats) && stats.n_reloads && stats.reload_ns_max <= stats.reload_ns_total;
+    result &= stats.total_spilled_bytes > stats.spilled_bytes;
+
+    /* serialized without loading the segments back */
+    FILE *file = tmpfile();
+    int fd = fileno(file);
+    result &= !queue__serialize(inl, fd, NULL) && !queue__spill_stats(inl, &stats) && stats.n_spilled;
+    lseek(fd, 0, SEEK_SET);
+    Queue loaded = queue__deserialize(NULL, fd, NULL, NULL);
+    result &= loaded && queue__length(loaded) == last - next;
+    for (u32 i = next; result && i < last; i++) {
+        result &= !queue__dequeue(loaded, (elem_t *)&value) && value == i;
+    }
+    queue__free(loaded);
+    fclose(file);
+
+    /* reading functions read the segments one at a time and leave them on disk */
+    size_t length = last - next, capacity = queue__capacity(ptr);
+    uint64_t sum = 0;
+    size_t n_visits = 0;
+    result &= !queue__spill_stats(ptr, &stats) && stats.n_spilled;
+    size_t n_spilled = stats.n_spilled;
+    array = queue__to_array(ptr);
+    for (u32 i = 0; result && i < length; i++) {
+        result &= array && *(u32 *)array[i] == next + i;
+        free(array[i]);
+    }
+    free(array);
+    result &= !queue__peek_nth(ptr, length / 2, &elem) && *(u32 *)elem == next + length / 2;
+    free(elem);
+    result &= queue__search(ptr, &(u32){next + (u32)length / 2}, operator_match) == length / 2;
+    result &= queue__contains(ptr, &(u32){last - 1}, operator_match) == 1;
+    result &= queue__contains(ptr, &(u32){last}, operator_match) == 0;
+    result &= queue__all(ptr, below, &last) == 1 && queue__any(ptr, is_even, NULL) == 1;
+    queue__foreach(ptr, add_atomic, &sum);
+    queue__foreach_all(ptr, count_visits, &n_visits);
+    result &= sum == ((uint64_t)next + last - 1) * length / 2 && n_visits == length;
+    ThreadPool pool = thread_pool__create(2);
+    result &= queue__all_parallel(ptr, below, &last, pool) == 1 && queue__any_parallel(ptr, below, &next, pool) == 0;
+    thread_pool__free(pool);
+    Queue w = queue__copy(ptr);
+    result &= w && queue__length(w) == length && queue__cmp(ptr, w, operator_match) == 1;
+    result &= !queue__dequeue(w, &elem) && queue__cmp(w, ptr, operator_match) == 0;
+    free(elem);
+    result &= !queue__enqueue(w, &(u32){next}) && queue__cmp(w, ptr, operator_match) == 0;
+    queue__free(w);
+    w = queue__copy(inl);
+    result &= queue__cmp(inl, w, operator_match) == 1 && queue__cmp(inl, ptr, operator_match) == 0;
+    queue__free(w);
+    result &= !queue__spill_stats(ptr, &stats) && stats.n_spilled == n_spilled && queue__capacity(ptr) == capacity;
+
+    /* functions reordering the elements load the segments back */
+    queue__reverse(ptr);
+    result &= !queue__spill_stats(ptr, &stats) && !stats.n_spilled && !stats.n_segments && !stats.spilled_bytes;
+    result &= !queue__peek_front(ptr, &elem) && *(u32 *)elem == last - 1;
+    free(elem);
+    result &= queue__search(inl, &(u32){last - 1}, operator_match) == last - 1 - next;
+
+    /* no longer spilling, then cleared and freed with segments on disk */
+    result &= !queue__set_spill(inl, NULL, 0, NULL, NULL) && queue__spill_stats(inl, &stats) == -1;
+    result &= queue__length(inl) == last - next && !queue__set_index(inl, hash_u32, operator_match);
+    for (u32 i = 0; i < N_SPILL; i++) {
+        queue__enqueue(ptr, &i);
+    }
+    result &= !queue__spill_stats(ptr, &stats) && stats.n_segments;
+    queue__clear(ptr);
+    result &= queue__length(ptr) == 0 && !queue__spill_stats(ptr, &stats) && !stats.n_segments;
+    for (u32 i = 0; i < N_SPILL; i++) {
+        queue__enqueue(ptr, &i);
+    }
+
+    queue__free(inl);
+    queue__free(ptr);
+    queue__free(cpy);
+    result &= !rmdir(dir);
+
+    return result;
+}
+
+
 int main(void)
 {
     int nb_success = 0;
@@ -557,6 +1668,8 @@ int main(void)
     print_test_result(test_queue__enqueue(false), &nb_success, &nb_tests);
     print_test_result(test_queue__dequeue_on_empty_queue(false), &nb_success, &nb_tests);
     print_test_result(test_queue__dequeue_on_non_empty_queue(false), &nb_success, &nb_tests);
+    print_test_result(test_queue__enqueue_dequeue_wraparound(false), &nb_success, &nb_tests);
+    print_test_result(test_queue__sort_and_filter_on_wrapped_queue(false), &nb_success, &nb_tests);
     print_test_result(test_queue__remove_nth_on_empty_queue(false), &nb_success, &nb_tests);
     print_test_result(test_queue__remove_nth_on_non_empty_queue(false), &nb_success, &nb_tests);
     print_test_result(test_queue__peek_front_on_empty_queue(false), &nb_success, &nb_tests);
@@ -597,6 +1710,26 @@ int main(void)
     print_test_result(test_queue__sort_on_empty_queue(false), &nb_success, &nb_tests);
     print_test_result(test_queue__sort_on_non_empty_queue(false), &nb_success, &nb_tests);
 
+    print_test_result(test_queue__inline_enqueue_dequeue_wraparound(), &nb_success, &nb_tests);
+    print_test_result(test_queue__inline_search_foreach_filter_and_sort(), &nb_success, &nb_tests);
+    print_test_result(test_queue__arena_copies_and_clear(), &nb_success, &nb_tests);
+    print_test_result(test_queue__arena_chunk_sizes(), &nb_success, &nb_tests);
+    print_test_result(test_queue__custom_allocator(), &nb_success, &nb_tests);
+    print_test_result(test_queue__capacity_policy(), &nb_success, &nb_tests);
+    print_test_result(test_queue__enqueue_n_and_dequeue_n(), &nb_success, &nb_tests);
+    print_test_result(test_queue__sort_parallel(), &nb_success, &nb_tests);
+    print_test_result(test_queue__sort_by_key(), &nb_success, &nb_tests);
+    print_test_result(test_queue__ptr_search_on_every_position(), &nb_success, &nb_tests);
+    print_test_result(test_queue__hash_index(), &nb_success, &nb_tests);
+    print_test_result(test_queue__foreach_visits_repeated_pointers_once(), &nb_success, &nb_tests);
+    print_test_result(test_queue__parallel_traversals(), &nb_success, &nb_tests);
+    print_test_result(test_queue__borrow_and_span(), &nb_success, &nb_tests);
+    print_test_result(test_queue__steal_and_adopt(), &nb_success, &nb_tests);
+    print_test_result(test_queue__enqueue_owned(), &nb_success, &nb_tests);
+    print_test_result(test_queue__batch_operators(), &nb_success, &nb_tests);
+    print_test_result(test_queue__serialize_and_deserialize(), &nb_success, &nb_tests);
+    print_test_result(test_queue__spill(), &nb_success, &nb_tests);
+
     print_test_summary(nb_success, nb_tests);
 
     return TEST_SUCCESS;
@@ -0,0 +1,105 @@
+#include "common_tests_utils.h"
+#include "../queue/queue_typed.h"
+#include "../common/defs.h"
+
+#define N_SORT 10000
+
+////////////////////////////////////////////////////////////////////
+///     TEST SUITE
+////////////////////////////////////////////////////////////////////
+
+static bool test_queue_typed__enqueue_dequeue_wraparound(void)
+{
+    printf("%s... ", __func__);
+
+    bool result = TEST_SUCCESS;
+    int value;
+    Queue_int q = queue_int__empty();
+
+    result &= q && queue_int__is_empty(q) == 1 && queue_int__dequeue(q, &value) == -1;
+    for (int i = 0; i < 40; i++) {
+        result &= !queue_int__enqueue(q, i);
+        if (i % 3 == 2) {
+            result &= !queue_int__dequeue(q, &value) && value == i / 3;
+        }
+    }
+    result &= queue_int__length(q) == 27;
+    result &= !queue_int__peek_front(q, &value) && value == 13;
+    result &= !queue_int__peek_back(q, &value) && value == 39;
+    result &= !queue_int__peek_nth(q, 5, &value) && value == 18;
+    result &= queue_int__search(q, 30) == 17 && queue_int__contains(q, 12) == 0;
+
+    Queue_int w = queue_int__copy(q);
+    int *A = queue_int__to_array(w);
+    for (int i = 0; i < 27; i++) {
+        result &= A[i] == i + 13;
+    }
+
+    queue_int__reverse(w);
+    result &= !queue_int__dequeue(w, &value) && value == 39;
+
+    free(A);
+    queue_int__free(q);
+    queue_int__free(w);
+    return result;
+}
+
+static bool test_queue_typed__sort_on_wrapped_queue(void)
+{
+    printf("%s... ", __func__);
+
+    bool result = TEST_SUCCESS;
+    long sum = 0, sorted_sum = 0;
+    int prev, value;
+    double values[4] = {2.5, -1.0, 3.25, 0.5};
+    Queue_int q = queue_int__empty();
+    Queue_double d = queue_double__from_array(NULL, values, 4);
+
+    srand(42);
+    for (int i = 0; i < N_SORT; i++) {
+        value = rand() % 1000;
+        queue_int__enqueue(q, value);
+    }
+    for (int i = 0; i < N_SORT / 3; i++) {
+        queue_int__dequeue(q, &value);
+        queue_int__enqueue(q, value);
+    }
+    for (size_t i = 0; i < N_SORT; i++) {
+        queue_int__peek_nth(q, i, &value);
+        sum += value;
+    }
+    queue_int__sort(q);
+
+    prev = -1;
+    for (size_t i = 0; i < N_SORT; i++) {
+        queue_int__peek_nth(q, i, &value);
+        result &= prev <= value;
+        sorted_sum += value;
+        prev = value;
+    }
+    result &= sum == sorted_sum;
+
+    double x;
+    queue_double__sort(d);
+    result &= !queue_double__dequeue(d, &x) && x < -0.5;
+    result &= !queue_double__peek_back(d, &x) && x > 3.0;
+
+    queue_int__free(q);
+    queue_double__free(d);
+    return result;
+}
+
+
+int main(void)
+{
+    int nb_success = 0;
+    int nb_tests = 0;
+    printf("----------- TEST TYPED QUEUE -----------\n");
+
+    print_test_result(test_queue_typed__enqueue_dequeue_wraparound(), &nb_success, &nb_tests);
+    print_test_result(test_queue_typed__sort_on_wrapped_queue(), &nb_success, &nb_tests);
+
+    print_test_summary(nb_success, nb_tests);
+
+    return TEST_SUCCESS;
+}
@@ -0,0 +1,186 @@
+#include <pthread.h>
+#include <sched.h>
+
+#include "common_tests_utils.h"
+#include "../queue/spsc_queue.h"
+#include "../common/defs.h"
+
+#define SPSC_QUEUE_CREATE(A, B, N) \
+    SpscQueue A = NULL, B = NULL; \
+    A = spsc_queue__empty_copy_enabled(N, operator_copy, operator_delete); \
+    B = spsc_queue__empty_copy_disabled(N)
+
+#define SPSC_QUEUE_FREE(A, B, C, D) \
+    FREE(spsc_queue__free, A, B, C, D)
+
+#define N_TRANSFERS 1000000
+
+////////////////////////////////////////////////////////////////////
+///     TEST SUITE
+////////////////////////////////////////////////////////////////////
+
+static bool test_spsc_queue__empty(void)
+{
+    printf("%s... ", __func__);
+
+    bool result;
+    SPSC_QUEUE_CREATE(q, w, 5);
+
+    result = (q && w
+           && spsc_queue__is_copy_enabled(q) == 1
+           && spsc_queue__is_copy_enabled(w) == 0
+           && spsc_queue__capacity(q) == 8
+           && spsc_queue__capacity(w) == 8
+           && spsc_queue__length(q) == 0
+           && spsc_queue__length(w) == 0) ? TEST_SUCCESS : TEST_FAILURE;
+
+    SPSC_QUEUE_FREE(q, w, NULL, NULL);
+    return result;
+}
+
+static bool test_spsc_queue__enqueue_on_full_queue(void)
+{
+    printf("%s... ", __func__);
+
+    bool result = TEST_SUCCESS;
+    u32 elems[5] = {0, 1, 2, 3, 4};
+    SPSC_QUEUE_CREATE(q, w, 4);
+
+    for (u32 i = 0; i < 4; i++) {
+        result &= !spsc_queue__enqueue(q, &elems[i]) && !spsc_queue__enqueue(w, &elems[i]);
+    }
+    result &= spsc_queue__enqueue(q, &elems[4]) == -1 && spsc_queue__enqueue(w, &elems[4]) == -1;
+    result &= spsc_queue__length(q) == 4 && spsc_queue__length(w) == 4;
+
+    SPSC_QUEUE_FREE(q, w, NULL, NULL);
+    return result;
+}
+
+static bool test_spsc_queue__dequeue_on_empty_queue(void)
+{
+    printf("%s... ", __func__);
+
+    bool result;
+    elem_t front = NULL;
+    SPSC_QUEUE_CREATE(q, w, 4);
+
+    result = (spsc_queue__dequeue(q, &front) == -1 && spsc_queue__dequeue(w, &front) == -1) ? TEST_SUCCESS : TEST_FAILURE;
+
+    SPSC_QUEUE_FREE(q, w, NULL, NULL);
+    return result;
+}
+
+static bool test_spsc_queue__enqueue_dequeue_wraparound(void)
+{
+    printf("%s... ", __func__);
+
+    bool result = TEST_SUCCESS;
+    u32 elems[32];
+    elem_t front_q = NULL;
+    elem_t front_w = NULL;
+    SPSC_QUEUE_CREATE(q, w, 4);
+
+    for (u32 i = 0; i < 32; i++) {
+        elems[i] = i;
+        result &= !spsc_queue__enqueue(q, &elems[i]) && !spsc_queue__enqueue(w, &elems[i]);
+        if (i >= 2) {
+            result &= !spsc_queue__dequeue(q, &front_q) && !spsc_queue__dequeue(w, &front_w);
+            result &= *(u32 *)front_q == i - 2 && front_w == &elems[i - 2];
+            free(front_q);
+        }
+    }
+    result &= spsc_queue__length(q) == 2 && spsc_queue__length(w) == 2;
+
+    SPSC_QUEUE_FREE(q, w, NULL, NULL);
+    return result;
+}
+
+static bool test_spsc_queue__enqueue_n_and_dequeue_n(void)
+{
+    printf("%s... ", __func__);
+
+    bool result = TEST_SUCCESS;
+    u32 elems[12];
+    elem_t ptrs[12];
+    elem_t out_q[12];
+    elem_t out_w[12];
+    SPSC_QUEUE_CREATE(q, w, 8);
+
+    for (u32 i = 0; i < 12; i++) {
+        elems[i] = i;
+        ptrs[i] = &elems[i];
+    }
+
+    result &= spsc_queue__enqueue_n(q, ptrs, 6) == 6 && spsc_queue__enqueue_n(w, ptrs, 6) == 6;
+    result &= spsc_queue__dequeue_n(q, out_q, 4) == 4 && spsc_queue__dequeue_n(w, out_w, 4) == 4;
+    result &= spsc_queue__enqueue_n(q, ptrs + 6, 6) == 6 && spsc_queue__enqueue_n(w, ptrs + 6, 6) == 6;
+    result &= spsc_queue__enqueue_n(q, ptrs, 1) == 0 && spsc_queue__enqueue_n(w, ptrs, 1) == 0;
+    result &= spsc_queue__dequeue_n(q, out_q + 4, 12) == 8 && spsc_queue__dequeue_n(w, out_w + 4, 12) == 8;
+
+    for (u32 i = 0; i < 12; i++) {
+        result &= *(u32 *)out_q[i] == i && out_w[i] == ptrs[i];
+        free(out_q[i]);
+    }
+
+    SPSC_QUEUE_FREE(q, w, NULL, NULL);
+    return result;
+}
+
+static void *producer(void *arg)
+{
+    SpscQueue q = arg;
+    for (size_t i = 1; i <= N_TRANSFERS; i++) {
+        while (spsc_queue__enqueue(q, (elem_t)i) < 0) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static bool test_spsc_queue__concurrent_transfer(void)
+{
+    printf("%s... ", __func__);
+
+    bool result = TEST_SUCCESS;
+    pthread_t thread;
+    elem_t batch[64];
+    size_t expected = 1;
+    SpscQueue q = spsc_queue__empty_copy_disabled(128);
+
+    pthread_create(&thread, NULL, producer, q);
+    while (expected <= N_TRANSFERS) {
+        size_t n = spsc_queue__dequeue_n(q, batch, 64);
+        if (!n) {
+            sched_yield();
+        }
+        for (size_t i = 0; i < n; i++) {
+            result &= (size_t)batch[i] == expected;
+            expected++;
+        }
+    }
+    pthread_join(thread, NULL);
+
+    result &= spsc_queue__length(q) == 0;
+
+    SPSC_QUEUE_FREE(q, NULL, NULL, NULL);
+    return result;
+}
+
+
+int main(void)
+{
+    int nb_success = 0;
+    int nb_tests = 0;
+    printf("----------- TEST SPSC QUEUE -----------\n");
+
+    print_test_result(test_spsc_queue__empty(), &nb_success, &nb_tests);
+    print_test_result(test_spsc_queue__enqueue_on_full_queue(), &nb_success, &nb_tests);
+    print_test_result(test_spsc_queue__dequeue_on_empty_queue(), &nb_success, &nb_tests);
+    print_test_result(test_spsc_queue__enqueue_dequeue_wraparound(), &nb_success, &nb_tests);
+    print_test_result(test_spsc_queue__enqueue_n_and_dequeue_n(), &nb_success, &nb_tests);
+    print_test_result(test_spsc_queue__concurrent_transfer(), &nb_success, &nb_tests);
+
+    print_test_summary(nb_success, nb_tests);
+
+    return TEST_SUCCESS;
+}
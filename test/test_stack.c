@@ -1,6 +1,9 @@
+#include <unistd.h>
+
 #include "common_tests_utils.h"
 #include "../stack/stack.h"
 #include "../common/defs.h"
+#include "../common/stream.h"
 
 #define STACK_CREATE(A, B) \
     Stack A = NULL, B = NULL; \
@@ -523,6 +526,811 @@ TEST_ON_NON_EMPTY_STACK (
 )
 
 
+static bool test_stack__inline_push_pop_and_peek(void)
+{
+    printf("%s... ", __func__);
+
+    bool result = TEST_SUCCESS;
+    u32 elems[8], value;
+    Stack s = stack__empty_inline(sizeof(u32));
+
+    result &= s && stack__elem_size(s) == sizeof(u32) && !stack__is_copy_enabled(s);
+    for (u32 i = 0; i < 8; i++) {
+        elems[i] = i;
+        result &= !stack__push(s, &elems[i]);
+    }
+    elems[0] = 42;
+
+    result &= !stack__peek_nth(s, 0, (elem_t *)&value) && value == 0;
+    result &= !stack__peek_top(s, (elem_t *)&value) && value == 7;
+    result &= stack__remove_nth(s, 0) == -1;
+
+    Stack t = stack__copy(s);
+    result &= stack__cmp(s, t, operator_match) == 1;
+
+    u32 *A = (u32 *)stack__to_array(s);
+    for (u32 i = 0; i < 8; i++) {
+        result &= A[i] == i;
+    }
+    for (u32 i = 0; i < 8; i++) {
+        result &= !stack__pop(s, (elem_t *)&value) && value == 7 - i;
+    }
+    result &= stack__pop(s, (elem_t *)&value) == -1 && stack__length(t) == 8;
+
+    free(A);
+    STACK_FREE(s, t, NULL, NULL);
+    return result;
+}
+
+static bool test_stack__inline_search_foreach_filter_and_sort(void)
+{
+    printf("%s... ", __func__);
+
+    bool result = TEST_SUCCESS;
+    u32 elems[8], value = 3, two = 2;
+    for (u32 i = 0; i < 8; i++) {
+        elems[i] = (i * 5) % 8;
+    }
+    Stack s = stack__from_array(stack__empty_inline(sizeof(u32)), elems, 8, sizeof(u32));
+
+    result &= stack__search(s, &value, operator_match) == 7 && stack__ptr_search(s, &value) == 7;
+    result &= stack__contains(s, &elems[2], operator_match) == 1;
+
+    stack__sort(s, operator_compare_inline);
+    for (u32 i = 0; i < 8; i++) {
+        result &= !stack__peek_nth(s, i, (elem_t *)&value) && value == i;
+    }
+
+    value = 1;
+    stack__foreach(s, plus_op, &value);
+    stack__filter(s, predicate, &two);
+    result &= stack__length(s) == 4 && stack__all(s, predicate, &two) == 1;
+    for (u32 i = 0; i < 4; i++) {
+        result &= !stack__peek_nth(s, i, (elem_t *)&value) && value == 2 * (i + 1);
+    }
+
+    stack__reverse(s);
+    result &= !stack__peek_top(s, (elem_t *)&value) && value == 2;
+
+    STACK_FREE(s, NULL, NULL, NULL);
+    return result;
+}
+
+static bool test_stack__arena_copies_and_clear(void)
+{
+    printf("%s... ", __func__);
+
+    bool result = TEST_SUCCESS;
+    u32 value, two = 2;
+    elem_t top = NULL;
+    Stack s = stack__empty_arena(operator_size);
+
+    result &= s && stack__is_copy_enabled(s) == 1 && stack__empty_arena(NULL) == NULL;
+    for (u32 round = 0; round < 2; round++) {
+        for (value = 0; value < 1000; value++) {
+            result &= !stack__push(s, &value);
+        }
+        for (u32 i = 0; i < 10; i++) {
+            result &= !stack__pop(s, &top) && *(u32 *)top == 999 - i;
+            free(top);
+        }
+        result &= !stack__peek_top(s, &top) && *(u32 *)top == 989;
+        free(top);
+
+        Stack t = stack__copy(s);
+        result &= stack__cmp(s, t, operator_match) == 1 && !stack__pop(t, NULL);
+        stack__filter(t, predicate, &two);
+        result &= stack__length(t) == 495 && stack__all(t, predicate, &two) == 1;
+
+        elem_t *A = stack__dump(t);
+        for (size_t i = 0; i < 495; i++) {
+            free(A[i]);
+        }
+        free(A);
+        stack__free(t);
+
+        stack__clear(s);
+        result &= stack__is_empty(s) == 1;
+    }
+
+    STACK_FREE(s, NULL, NULL, NULL);
+    return result;
+}
+
+static bool test_stack__custom_allocator(void)
+{
+    printf("%s... ", __func__);
+
+    bool result = TEST_SUCCESS;
+    u32 elems[100];
+    alloc_counter_t counter = {0, 0, 0, 0};
+    allocator_t allocator = counting_allocator(&counter);
+
+    result &= stack__empty_with_allocator(NULL, NULL, NULL) == NULL;
+    result &= stack__empty_with_allocator(&allocator, operator_copy, NULL) == NULL;
+
+    Stack s = stack__empty_with_allocator(&allocator, operator_copy, operator_delete);
+    result &= s && stack__is_copy_enabled(s) == 1 && counter.n_allocs == 2;
+    for (u32 i = 0; i < 100; i++) {
+        elems[i] = i;
+        result &= !stack__push(s, &elems[i]);
+    }
+    size_t n_reallocs = counter.n_reallocs;
+    result &= n_reallocs > 0 && counter.n_bytes >= 100 * sizeof(elem_t);
+
+    Stack t = stack__copy(s);
+    result &= counter.n_allocs == 4;
+    for (u32 i = 0; i < 100; i++) {
+        result &= !stack__pop(t, NULL);
+    }
+    result &= counter.n_reallocs > n_reallocs;
+
+    stack__free(t);
+    stack__free(s);
+    result &= counter.n_frees == 4;
+
+    return result;
+}
+
+static bool test_stack__capacity_policy(void)
+{
+    printf("%s... ", __func__);
+
+    bool result = TEST_SUCCESS;
+    u32 elems[64];
+    capacity_policy_t never_shrink = {2, 0, 2};
+    capacity_policy_t invalid = {2, 1, 2};
+    Stack s = stack__with_capacity(100);
+
+    result &= !stack__push(s, &elems[0]) && !stack__pop(s, NULL) && stack__capacity(s) == 100;
+    result &= !stack__reserve(s, 1000) && stack__capacity(s) == 1000;
+    for (u32 i = 0; i < 10; i++) {
+        elems[i] = i;
+        result &= !stack__push(s, &elems[i]);
+    }
+    result &= !stack__shrink_to_fit(s) && stack__capacity(s) == 100 && stack__length(s) == 10;
+    stack__free(s);
+
+    s = stack__empty_copy_disabled();
+    result &= stack__set_policy(s, &invalid) == -1 && stack__set_policy(NULL, &never_shrink) == -1;
+    for (u32 i = 0; i < 64; i++) {
+        elems[i] = i;
+        result &= !stack__push(s, &elems[i]);
+    }
+    result &= stack__capacity(s) == 64;
+    while (stack__length(s) > 16) {
+        result &= !stack__pop(s, NULL);
+    }
+    result &= stack__capacity(s) == 64;
+    result &= !stack__pop(s, NULL) && stack__capacity(s) == 32;
+
+    result &= !stack__set_policy(s, &never_shrink);
+    while (!stack__is_empty(s)) {
+        result &= !stack__pop(s, NULL);
+    }
+    stack__clear(s);
+    result &= stack__capacity(s) == 32;
+
+    stack__free(s);
+    return result;
+}
+
+
+static bool test_stack__push_n_and_pop_n(void)
+{
+    printf("%s... ", __func__);
+
+    bool result = TEST_SUCCESS;
+    u32 values[300];
+    u32 inline_out[300];
+    elem_t ptrs[300], out[300];
+    for (u32 i = 0; i < 300; i++) {
+        values[i] = i;
+        ptrs[i] = &values[i];
+    }
+
+    Stack s = stack__empty_copy_disabled();
+    result &= stack__push_n(NULL, ptrs, 10) == -1 && stack__push_n(s, NULL, 10) == -1;
+    result &= !stack__push_n(s, ptrs, 300) && stack__length(s) == 300 && stack__capacity(s) == 512;
+    result &= stack__pop_n(s, out, 100) == 100 && stack__length(s) == 200;
+    for (u32 i = 0; i < 100; i++) {
+        result &= out[i] == ptrs[200 + i];
+    }
+    result &= stack__pop_n(s, NULL, 1000) == 200 && stack__is_empty(s) && stack__capacity(s) == 2;
+    result &= stack__pop_n(NULL, out, 1) == SIZE_MAX && stack__pop_n(s, out, 1) == 0;
+    stack__free(s);
+
+    s = stack__empty_copy_enabled(operator_copy, operator_delete);
+    result &= !stack__push_n(s, ptrs, 300);
+    values[299] = 1000;
+    result &= stack__pop_n(s, out, 2) == 2 && *(u32 *)out[0] == 298 && *(u32 *)out[1] == 299;
+    free(out[0]);
+    free(out[1]);
+    result &= stack__pop_n(s, NULL, 100) == 100 && stack__length(s) == 198;
+    stack__free(s);
+
+    s = stack__empty_inline(sizeof(u32));
+    result &= !stack__push_n(s, values, 300) && stack__pop_n(s, inline_out, 300) == 300;
+    for (u32 i = 0; i < 300; i++) {
+        result &= inline_out[i] == values[i];
+    }
+    stack__free(s);
+
+    return result;
+}
+
+
+
+#define N_SORTED 100000
+
+/**
+ * Orders inline u32 values by their 12 high bits only, the low bits record the insertion order
+ */
+static int compare_high_bits(const void *v1, const void *v2)
+{
+    u32 arg1 = *(const u32 *)v1 >> 20;
+    u32 arg2 = *(const u32 *)v2 >> 20;
+
+    return (arg1 > arg2) - (arg1 < arg2);
+}
+
+static bool test_stack__sort_parallel(void)
+{
+    printf("%s... ", __func__);
+
+    bool result = TEST_SUCCESS;
+    static u32 values[N_SORTED];
+    u32 prev, cur;
+    Stack s = stack__empty_inline(sizeof(u32));
+
+    for (u32 i = 0; i < N_SORTED; i++) {
+        values[i] = ((i * 7919) % 16) << 20 | i;
+    }
+    result &= stack__sort_parallel(NULL, compare_high_bits, 4, true) == -1;
+    result &= stack__sort_parallel(s, NULL, 4, true) == -1 && stack__sort_parallel(s, compare_high_bits, 0, true) == -1;
+
+    result &= !stack__push_n(s, values, N_SORTED);
+    result &= !stack__sort_parallel(s, compare_high_bits, 4, true) && stack__length(s) == N_SORTED;
+    result &= !stack__peek_nth(s, 0, (elem_t *)&prev);
+    for (u32 i = 1; i < N_SORTED; i++) {
+        result &= !stack__peek_nth(s, i, (elem_t *)&cur);
+        result &= prev >> 20 < cur >> 20 || (prev >> 20 == cur >> 20 && prev < cur);
+        prev = cur;
+    }
+
+    result &= !stack__sort_parallel(s, operator_compare_inline, 3, false);
+    result &= !stack__peek_nth(s, 0, (elem_t *)&prev);
+    for (u32 i = 1; i < N_SORTED; i++) {
+        result &= !stack__peek_nth(s, i, (elem_t *)&cur) && prev <= cur;
+        prev = cur;
+    }
+    stack__free(s);
+
+    s = stack__empty_copy_enabled(operator_copy, operator_delete);
+    for (u32 i = 0; i < 1000; i++) {
+        result &= !stack__push(s, &values[i]);
+    }
+    result &= !stack__sort_parallel(s, operator_compare, 2, true);
+    result &= IS_SORTED(stack__peek_nth, stack__length(s), s, true);
+    stack__free(s);
+
+    return result;
+}
+
+
+static uint64_t key_high_bits(const void *v)
+{
+    return *(const u32 *)v >> 20;
+}
+
+static uint64_t key_reversed(const void *v)
+{
+    return UINT64_MAX - *(const u32 *)v;
+}
+
+static bool test_stack__sort_by_key(void)
+{
+    printf("%s... ", __func__);
+
+    bool result = TEST_SUCCESS;
+    u32 values[5000], value, prev;
+    elem_t ptrs[5000], elem;
+    Stack s = stack__empty_copy_disabled();
+
+    for (u32 i = 0; i < 5000; i++) {
+        values[i] = ((i * 7919) % 300) << 20 | i;
+        ptrs[i] = &values[i];
+    }
+    result &= stack__sort_by_key(NULL, key_high_bits) == -1 && stack__sort_by_key(s, NULL) == -1;
+    result &= !stack__sort_by_key(s, key_high_bits);
+
+    result &= !stack__push_n(s, ptrs, 5000) && !stack__sort_by_key(s, key_high_bits);
+    result &= !stack__peek_nth(s, 0, &elem);
+    prev = *(u32 *)elem;
+    for (u32 i = 1; i < 5000; i++) {
+        result &= !stack__peek_nth(s, i, &elem);
+        value = *(u32 *)elem;
+        result &= prev >> 20 < value >> 20 || (prev >> 20 == value >> 20 && prev < value);
+        prev = value;
+    }
+    stack__free(s);
+
+    s = stack__empty_inline(sizeof(u32));
+    result &= !stack__push_n(s, values, 5000) && !stack__sort_by_key(s, key_reversed);
+    result &= !stack__peek_nth(s, 0, (elem_t *)&prev);
+    for (u32 i = 1; i < 5000; i++) {
+        result &= !stack__peek_nth(s, i, (elem_t *)&value) && prev > value;
+        prev = value;
+    }
+    stack__free(s);
+
+    return result;
+}
+
+
+static bool test_stack__ptr_search_on_every_position(void)
+{
+    printf("%s... ", __func__);
+
+    bool result = TEST_SUCCESS;
+    u32 values[70];
+    elem_t ptrs[70];
+    for (u32 i = 0; i < 70; i++) {
+        ptrs[i] = &values[i];
+    }
+
+    /* lengths and positions around the widths of the SIMD kernels */
+    for (size_t n = 0; n < 70; n++) {
+        Stack s = stack__empty_copy_disabled();
+        result &= !stack__push_n(s, ptrs, n);
+        for (size_t i = 0; i < n; i++) {
+            result &= stack__ptr_search(s, ptrs[i]) == i && stack__ptr_contains(s, ptrs[i]) == 1;
+        }
+        result &= stack__ptr_search(s, ptrs[n]) == SIZE_MAX && !stack__ptr_contains(s, ptrs[n]);
+        result &= stack__ptr_search(s, NULL) == SIZE_MAX;
+        if (n > 9) {
+            result &= !stack__push_n(s, ptrs + 3, 1) && stack__ptr_search(s, ptrs[3]) == 3;
+        }
+        stack__free(s);
+    }
+
+    return result;
+}
+
+
+static uint64_t hash_u32(const void *v)
+{
+    return *(const u32 *)v;
+}
+
+
+static int match_u32(const void *v1, const void *v2)
+{
+    return v1 && v2 && *(const u32 *)v1 == *(const u32 *)v2;
+}
+
+
+static char is_odd(const void *v, void *user_data)
+{
+    return v && *(const u32 *)v & 1;
+}
+
+
+/* the positions found through the index are the ones found by a linear search */
+static bool index_agrees(const Stack s)
+{
+    bool result = TEST_SUCCESS;
+    for (u32 key = 0; key <= 50; key++) {
+        result &= stack__search(s, &key, operator_match) == stack__search(s, &key, match_u32);
+        result &= stack__contains(s, &key, operator_match) == stack__contains(s, &key, match_u32);
+    }
+    return result;
+}
+
+
+static bool test_stack__hash_index(void)
+{
+    printf("%s... ", __func__);
+
+    bool result = TEST_SUCCESS;
+    u32 values[100], key = 7;
+    elem_t ptrs[100], elem;
+    for (u32 i = 0; i < 100; i++) {
+        values[i] = i % 50;
+        ptrs[i] = &values[i];
+    }
+
+    result &= !stack__empty_indexed(NULL, operator_match) && !stack__empty_indexed(hash_u32, NULL);
+    Stack s = stack__empty_indexed(hash_u32, operator_match);
+    result &= stack__is_indexed(s) == 1 && stack__search(s, &key, operator_match) == SIZE_MAX;
+    result &= stack__set_index(s, hash_u32, NULL) == -1 && stack__is_indexed(s) == 1;
+
+    result &= !stack__push_n(s, ptrs, 100) && stack__search(s, &key, operator_match) == 7 && index_agrees(s);
+    result &= !stack__pop(s, &elem) && stack__pop_n(s, NULL, 10) == 10 && index_agrees(s);
+    result &= !stack__swap(s, 3, 60) && index_agrees(s);
+    stack__sort(s, operator_compare);
+    result &= index_agrees(s) && !stack__remove_nth(s, 12) && index_agrees(s);
+    stack__reverse(s);
+    result &= index_agrees(s);
+    stack__shuffle(s, 42);
+    result &= index_agrees(s);
+    stack__filter(s, is_odd, NULL);
+    result &= index_agrees(s) && stack__contains(s, &key, operator_match) == 1;
+
+    Stack copy = stack__copy(s);
+    result &= stack__is_indexed(copy) == 1 && index_agrees(copy);
+    stack__free(copy);
+
+    stack__clear(s);
+    result &= !stack__contains(s, &key, operator_match) && !stack__push_n(s, ptrs, 10) && index_agrees(s);
+    result &= !stack__set_index(s, NULL, NULL) && !stack__is_indexed(s) && index_agrees(s);
+    stack__free(s);
+
+    s = stack__empty_inline(sizeof(u32));
+    result &= !stack__push_n(s, values, 100) && !stack__set_index(s, hash_u32, operator_match);
+    result &= stack__is_indexed(s) == 1 && stack__search(s, &key, operator_match) == 7 && index_agrees(s);
+    result &= !stack__pop(s, (elem_t *)&key) && key == 49 && index_agrees(s);
+    stack__free(s);
+
+    return result;
+}
+
+
+static void count_visits(const void *v, void *user_data)
+{
+    (*(size_t *)user_data)++;
+}
+
+
+static bool test_stack__foreach_visits_repeated_pointers_once(void)
+{
+    printf("%s... ", __func__);
+
+    bool result = TEST_SUCCESS;
+    u32 values[100];
+    elem_t ptrs[1000];
+    size_t n_visits = 0;
+    for (u32 i = 0; i < 1000; i++) {
+        ptrs[i] = i % 250 == 0 ? NULL : &values[i % 100];
+    }
+
+    Stack s = stack__empty_copy_disabled();
+    result &= !stack__push_n(s, ptrs, 1000);
+
+    stack__foreach(s, count_visits, &n_visits);
+    result &= n_visits == 101;
+    n_visits = 0;
+    stack__foreach(s, count_visits, &n_visits);
+    result &= n_visits == 101;
+    n_visits = 0;
+    stack__foreach_all(s, count_visits, &n_visits);
+    result &= n_visits == 1000;
+    n_visits = 0;
+
+    result &= !stack__shrink_to_fit(s);
+    stack__foreach(s, count_visits, &n_visits);
+    result &= n_visits == 101;
+
+    stack__free(s);
+
+    return result;
+}
+
+
+static void add_atomic(const void *v, void *user_data)
+{
+    __atomic_fetch_add((uint64_t *)user_data, *(const u32 *)v, __ATOMIC_RELAXED);
+}
+
+
+static char below(const void *v, void *user_data)
+{
+    return *(const u32 *)v < *(u32 *)user_data;
+}
+
+
+static char is_even(const void *v, void *user_data)
+{
+    return !(*(const u32 *)v & 1);
+}
+
+
+static bool test_stack__parallel_traversals(void)
+{
+    printf("%s... ", __func__);
+
+    bool result = TEST_SUCCESS;
+    static u32 values[10000];
+    static elem_t ptrs[10000];
+    u32 bound = 10000, prev, value;
+    uint64_t sum = 0;
+    elem_t elem;
+    for (u32 i = 0; i < 10000; i++) {
+        values[i] = (i * 7919) % 10000;
+        ptrs[i] = &values[i];
+    }
+
+    ThreadPool pool = thread_pool__create(4);
+    Stack s = stack__empty_copy_disabled();
+    result &= thread_pool__size(pool) == 4 && !thread_pool__create(0);
+    result &= stack__any_parallel(NULL, below, &bound, pool) == -1 && stack__all_parallel(s, below, &bound, NULL) == -1;
+    result &= stack__foreach_parallel(s, NULL, NULL, pool) == -1 && stack__filter_parallel(s, NULL, NULL, pool) == -1;
+    result &= stack__all_parallel(s, below, &bound, pool) == 1 && stack__any_parallel(s, below, &bound, pool) == 0;
+    result &= !stack__filter_parallel(s, is_even, NULL, pool) && !stack__length(s);
+
+    result &= !stack__push_n(s, ptrs, 10000);
+    result &= !stack__foreach_parallel(s, add_atomic, &sum, pool) && sum == 9999ULL * 10000 / 2;
+    result &= stack__all_parallel(s, below, &bound, pool) == 1;
+    bound = 9999;
+    result &= stack__all_parallel(s, below, &bound, pool) == 0 && stack__any_parallel(s, below, &bound, pool) == 1;
+    bound = 0;
+    result &= stack__any_parallel(s, below, &bound, pool) == 0;
+
+    result &= !stack__filter_parallel(s, is_even, NULL, pool) && stack__length(s) == 5000;
+    result &= stack__all_parallel(s, is_even, NULL, pool) == 1;
+    result &= !stack__peek_nth(s, 0, &elem);
+    prev = *(u32 *)elem;
+    for (u32 i = 1; i < 5000; i++) {
+        result &= !stack__peek_nth(s, i, &elem);
+        value = *(u32 *)elem;
+        result &= (prev + 2 * 7919) % 10000 == value;
+        prev = value;
+    }
+    stack__free(s);
+
+    s = stack__empty_inline(sizeof(u32));
+    result &= !stack__push_n(s, values, 10000) && !stack__filter_parallel(s, is_even, NULL, pool);
+    result &= stack__length(s) == 5000 && stack__all_parallel(s, is_even, NULL, pool) == 1;
+    stack__free(s);
+    thread_pool__free(pool);
+
+    return result;
+}
+
+
+static bool test_stack__borrow_and_span(void)
+{
+    printf("%s... ", __func__);
+
+    bool result = TEST_SUCCESS;
+    u32 values[100];
+    elem_t ptrs[100];
+    const void *borrowed, *other;
+    span_t first;
+    for (u32 i = 0; i < 100; i++) {
+        values[i] = i;
+        ptrs[i] = &values[i];
+    }
+
+    Stack s = stack__empty_copy_enabled(operator_copy, operator_delete);
+    result &= stack__borrow_top(s, &borrowed) == -1 && stack__borrow_nth(s, 0, &borrowed) == -1;
+    result &= !stack__span(s, &first) && first.length == 0;
+
+    result &= !stack__push_n(s, ptrs, 100);
+    result &= !stack__borrow_top(s, &borrowed) && *(const u32 *)borrowed == 99 && borrowed != ptrs[99];
+    result &= !stack__borrow_nth(s, 40, &other) && *(const u32 *)other == 40;
+    result &= !stack__borrow_top(s, &other) && other == borrowed;
+    result &= stack__borrow_nth(s, 100, &other) == -1 && stack__borrow_top(NULL, &other) == -1;
+
+    result &= !stack__span(s, &first) && first.length == 100 && first.slot_size == sizeof(elem_t);
+    for (size_t i = 0; i < first.length; i++) {
+        result &= !stack__borrow_nth(s, i, &borrowed) && ((elem_t const *)first.slots)[i] == borrowed;
+    }
+    stack__free(s);
+
+    s = stack__empty_inline(sizeof(u32));
+    result &= !stack__push_n(s, values, 100) && !stack__span(s, &first) && first.slot_size == sizeof(u32);
+    for (size_t i = 0; i < first.length; i++) {
+        result &= ((const u32 *)first.slots)[i] == i;
+    }
+    result &= !stack__borrow_nth(s, 7, &borrowed) && borrowed == (const u32 *)first.slots + 7;
+    stack__free(s);
+
+    return result;
+}
+
+
+static bool test_stack__steal_and_adopt(void)
+{
+    printf("%s... ", __func__);
+
+    bool result = TEST_SUCCESS;
+    u32 values[100], value;
+    elem_t ptrs[100], elem;
+    size_t length, capacity;
+    for (u32 i = 0; i < 100; i++) {
+        values[i] = i;
+        ptrs[i] = &values[i];
+    }
+
+    Stack s = stack__empty_copy_disabled();
+    result &= !stack__push_n(s, ptrs, 100);
+    elem_t *stolen = stack__steal(s, &length, &capacity);
+    result &= stolen && length == 100 && capacity >= 100 && !stack__length(s);
+    for (u32 i = 0; i < 100; i++) {
+        result &= stolen[i] == ptrs[i];
+    }
+    result &= !stack__push(s, ptrs[0]) && stack__length(s) == 1;
+    stack__free(s);
+
+    result &= !stack__adopt(NULL, 0, 1, 0) && !stack__adopt(stolen, 101, 100, 0);
+    s = stack__adopt(stolen, length, capacity, 0);
+    result &= s && stack__length(s) == 100 && !stack__pop(s, &elem) && elem == ptrs[99];
+    result &= !stack__push_n(s, ptrs, 100) && stack__length(s) == 199;
+    stack__free(s);
+
+    u32 *packed = malloc(sizeof(u32) * 10);
+    for (u32 i = 0; i < 10; i++) {
+        packed[i] = i;
+    }
+    s = stack__adopt((elem_t *)packed, 10, 10, sizeof(u32));
+    result &= !stack__pop(s, (elem_t *)&value) && value == 9;
+    stack__free(s);
+
+    s = stack__empty_arena(operator_size);
+    result &= !stack__steal(s, NULL, NULL) && !stack__steal(NULL, NULL, NULL);
+    stack__free(s);
+
+    return result;
+}
+
+
+static bool test_stack__push_owned(void)
+{
+    printf("%s... ", __func__);
+
+    bool result = TEST_SUCCESS;
+    elem_t owned[100], elem;
+    const void *borrowed;
+    for (u32 i = 0; i < 100; i++) {
+        owned[i] = malloc(sizeof(u32));
+        *(u32 *)owned[i] = i;
+    }
+
+    Stack s = stack__empty_copy_enabled(operator_copy, operator_delete);
+    result &= stack__push_owned(NULL, owned[0]) == -1 && stack__push_owned_n(s, NULL, 1) == -1;
+    result &= !stack__push_owned(s, owned[0]) && !stack__borrow_top(s, &borrowed) && borrowed == owned[0];
+    result &= !stack__push_owned_n(s, owned + 1, 99) && !stack__borrow_top(s, &borrowed) && borrowed == owned[99];
+    result &= !stack__pop(s, &elem) && elem == owned[99];
+    free(elem);
+    stack__free(s);
+
+    s = stack__empty_inline(sizeof(u32));
+    result &= stack__push_owned(s, &elem) == -1 && stack__push_owned_n(s, owned, 1) == -1;
+    stack__free(s);
+    s = stack__empty_arena(operator_size);
+    result &= stack__push_owned(s, &elem) == -1;
+    stack__free(s);
+
+    return result;
+}
+
+
+
+/* every run of elements is copied or deleted by a single call of the batch operators */
+static bool test_stack__batch_operators(void)
+{
+    printf("%s... ", __func__);
+
+    bool result = TEST_SUCCESS;
+    u32 values[100];
+    elem_t elems[100], *array;
+    const void *borrowed;
+    for (u32 i = 0; i < 100; i++) {
+        values[i] = i;
+        elems[i] = &values[i];
+    }
+
+    result &= !stack__empty_copy_enabled_n(NULL, operator_delete, operator_copy_n, operator_delete_n);
+
+    batch_calls = (batch_counter_t){0};
+    Stack s = stack__empty_copy_enabled_n(operator_copy, operator_delete, operator_copy_n, operator_delete_n);
+    result &= !stack__push_n(s, elems, 100);
+    array = stack__to_array(s);
+    for (u32 i = 0; array && i < 100; i++) {
+        result &= array[i] != elems[i] && *(u32 *)array[i] == i;
+        free(array[i]);
+    }
+    free(array);
+
+    Stack copy = stack__copy(s);
+    result &= stack__length(copy) == 100;
+    stack__clear(copy);
+    stack__free(copy);
+
+    stack__filter(s, is_odd, NULL);
+    result &= stack__length(s) == 50;
+    for (size_t i = 0; i < 50; i++) {
+        result &= !stack__borrow_nth(s, i, &borrowed) && *(const u32 *)borrowed == 2 * i + 1;
+    }
+    result &= stack__from_array(s, values, 10, sizeof(u32)) == s && stack__length(s) == 60;
+    result &= !stack__borrow_top(s, &borrowed) && borrowed != &values[9] && *(const u32 *)borrowed == 9;
+    stack__free(s);
+
+    result &= batch_calls.n_copy_calls == 4 && batch_calls.n_copied == 310;
+    result &= batch_calls.n_delete_calls == 3 && batch_calls.n_deleted == 210;
+
+    /* either operator may be left out */
+    s = stack__empty_copy_enabled_n(operator_copy, operator_delete, NULL, operator_delete_n);
+    result &= !stack__push_n(s, elems, 100);
+    stack__free(s);
+    result &= batch_calls.n_copy_calls == 4 && batch_calls.n_delete_calls == 4;
+
+    return result;
+}
+
+
+
+/* containers written one after the other on the same file are read back identical, whatever their storage */
+static bool test_stack__serialize_and_deserialize(void)
+{
+    printf("%s... ", __func__);
+
+    bool result = TEST_SUCCESS;
+    enum { N_SERIAL = 20000 };
+    u32 value = 0;
+    elem_t elem;
+    FILE *file = tmpfile();
+    int fd = fileno(file);
+
+    Stack inl = stack__empty_inline(sizeof(u32));
+    Stack ptr = stack__empty_copy_enabled(operator_copy, operator_delete);
+    for (u32 i = 0; i < N_SERIAL; i++) {
+        stack__push(inl, &i);
+        stack__push(ptr, &i);
+    }
+    result &= stack__serialize(ptr, fd, NULL) == -1 && stack__serialize(NULL, fd, operator_write_u32) == -1;
+    result &= !stack__serialize(inl, fd, NULL) && !stack__serialize(ptr, fd, operator_write_u32);
+    stack__free(inl);
+    stack__free(ptr);
+
+    lseek(fd, 0, SEEK_SET);
+    inl = stack__deserialize(NULL, fd, NULL, NULL);
+    ptr = stack__deserialize(stack__empty_copy_enabled(operator_copy, operator_delete), fd, operator_read_u32, NULL);
+    result &= inl && ptr && stack__length(inl) == N_SERIAL && stack__length(ptr) == N_SERIAL;
+    for (u32 i = 0; result && i < N_SERIAL; i++) {
+        result &= !stack__pop(inl, (elem_t *)&value) && value == N_SERIAL - 1 - i;
+        result &= !stack__pop(ptr, &elem) && *(u32 *)elem == N_SERIAL - 1 - i;
+        free(elem);
+    }
+    result &= !stack__deserialize(inl, fd, NULL, NULL);
+
+    /* streams of another container, of other values or truncated leave the stack unaltered */
+    stack__push(inl, &value);
+    result &= !ftruncate(fd, 0) && !lseek(fd, 0, SEEK_SET) && !stack__serialize(inl, fd, NULL);
+    result &= pwrite(fd, &(unsigned char){STREAM_QUEUE}, 1, 8) == 1 && !stack__pop(inl, NULL) && !lseek(fd, 0, SEEK_SET);
+    result &= !stack__deserialize(inl, fd, NULL, NULL) && stack__length(inl) == 0;
+
+    stack__push(ptr, &value);
+    stack__push(ptr, &value);
+    result &= !ftruncate(fd, 0) && !lseek(fd, 0, SEEK_SET) && !stack__serialize(ptr, fd, operator_write_u32);
+    lseek(fd, 0, SEEK_SET);
+    result &= !stack__deserialize(inl, fd, operator_read_u32, NULL) && stack__length(inl) == 0;
+    lseek(fd, 0, SEEK_SET);
+    result &= !stack__deserialize(NULL, fd, NULL, NULL) && !lseek(fd, 0, SEEK_SET);
+    result &= !stack__deserialize(NULL, fd, operator_read_u32, NULL) && !lseek(fd, 0, SEEK_SET);
+
+    /* the elements of a new stack are left to the user */
+    Stack loaded = stack__deserialize(NULL, fd, operator_read_u32, operator_delete);
+    result &= loaded && stack__is_copy_enabled(loaded) == 0 && stack__length(loaded) == 2;
+    while (loaded && !stack__pop(loaded, &elem)) {
+        free(elem);
+    }
+    stack__free(loaded);
+
+    /* the elements built before the failure are deleted by the stack if it owns them, by 'delete_op' otherwise */
+    result &= !ftruncate(fd, lseek(fd, 0, SEEK_END) - 1) && !lseek(fd, 0, SEEK_SET);
+    result &= !stack__deserialize(ptr, fd, operator_read_u32, NULL) && stack__length(ptr) == 2 && !lseek(fd, 0, SEEK_SET);
+    result &= !stack__deserialize(NULL, fd, operator_read_u32, operator_delete);
+
+    stack__free(inl);
+    stack__free(ptr);
+    fclose(file);
+
+    return result;
+}
+
+
 int main(void)
 {
     int nb_success = 0;
@@ -577,6 +1385,24 @@ int main(void)
     print_test_result(test_stack__sort_on_empty_stack(false), &nb_success, &nb_tests);
     print_test_result(test_stack__sort_on_non_empty_stack(false), &nb_success, &nb_tests);
 
+    print_test_result(test_stack__inline_push_pop_and_peek(), &nb_success, &nb_tests);
+    print_test_result(test_stack__inline_search_foreach_filter_and_sort(), &nb_success, &nb_tests);
+    print_test_result(test_stack__arena_copies_and_clear(), &nb_success, &nb_tests);
+    print_test_result(test_stack__custom_allocator(), &nb_success, &nb_tests);
+    print_test_result(test_stack__capacity_policy(), &nb_success, &nb_tests);
+    print_test_result(test_stack__push_n_and_pop_n(), &nb_success, &nb_tests);
+    print_test_result(test_stack__sort_parallel(), &nb_success, &nb_tests);
+    print_test_result(test_stack__sort_by_key(), &nb_success, &nb_tests);
+    print_test_result(test_stack__ptr_search_on_every_position(), &nb_success, &nb_tests);
+    print_test_result(test_stack__hash_index(), &nb_success, &nb_tests);
+    print_test_result(test_stack__foreach_visits_repeated_pointers_once(), &nb_success, &nb_tests);
+    print_test_result(test_stack__parallel_traversals(), &nb_success, &nb_tests);
+    print_test_result(test_stack__borrow_and_span(), &nb_success, &nb_tests);
+    print_test_result(test_stack__steal_and_adopt(), &nb_success, &nb_tests);
+    print_test_result(test_stack__push_owned(), &nb_success, &nb_tests);
+    print_test_result(test_stack__batch_operators(), &nb_success, &nb_tests);
+    print_test_result(test_stack__serialize_and_deserialize(), &nb_success, &nb_tests);
+
     print_test_summary(nb_success, nb_tests);
 
     return TEST_SUCCESS;
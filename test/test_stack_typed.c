@@ -0,0 +1,131 @@
+#include "common_tests_utils.h"
+#include "../stack/stack_typed.h"
+#include "../common/defs.h"
+
+#define N_SORT 10000
+
+static void plus_one(int *e, void *user_data)
+{
+    *e += 1;
+    *(int *)user_data += *e;
+}
+
+////////////////////////////////////////////////////////////////////
+///     TEST SUITE
+////////////////////////////////////////////////////////////////////
+
+static bool test_stack_typed__push_pop_and_peek(void)
+{
+    printf("%s... ", __func__);
+
+    bool result = TEST_SUCCESS;
+    int value;
+    Stack_int s = stack_int__empty();
+
+    result &= s && stack_int__is_empty(s) == 1 && stack_int__pop(s, &value) == -1;
+    for (int i = 0; i < 20; i++) {
+        result &= !stack_int__push(s, i);
+    }
+    result &= stack_int__length(s) == 20 && !stack_int__is_empty(s);
+    result &= !stack_int__peek_top(s, &value) && value == 19;
+    result &= !stack_int__peek_nth(s, 3, &value) && value == 3;
+    result &= stack_int__peek_nth(s, 20, &value) == -1;
+    for (int i = 19; i >= 10; i--) {
+        result &= !stack_int__pop(s, &value) && value == i;
+    }
+    result &= !stack_int__pop(s, NULL) && stack_int__length(s) == 9;
+
+    stack_int__free(s);
+    return result;
+}
+
+static bool test_stack_typed__copy_search_and_foreach(void)
+{
+    printf("%s... ", __func__);
+
+    bool result = TEST_SUCCESS;
+    int elems[8] = {4, 8, 15, 16, 23, 42, 8, 0};
+    int sum = 0;
+    Stack_int s = stack_int__from_array(NULL, elems, 8);
+    Stack_int t = stack_int__copy(s);
+
+    result &= stack_int__search(s, 8) == 1 && stack_int__search(s, 7) == SIZE_MAX;
+    result &= stack_int__contains(t, 42) == 1 && stack_int__contains(t, 43) == 0;
+
+    stack_int__foreach(s, plus_one, &sum);
+    int *A = stack_int__to_array(s);
+    int *B = stack_int__to_array(t);
+    for (int i = 0; i < 8; i++) {
+        result &= A[i] == elems[i] + 1 && B[i] == elems[i];
+    }
+    result &= sum == 124;
+
+    stack_int__reverse(t);
+    result &= !stack_int__pop(t, &sum) && sum == 4;
+
+    free(A);
+    free(B);
+    stack_int__free(s);
+    stack_int__free(t);
+    return result;
+}
+
+static bool test_stack_typed__sort(void)
+{
+    printf("%s... ", __func__);
+
+    bool result = TEST_SUCCESS;
+    long sum = 0, sorted_sum = 0;
+    int prev, value;
+    Stack_int s = stack_int__empty();
+    Stack_double d = stack_double__empty();
+
+    srand(42);
+    for (int i = 0; i < N_SORT; i++) {
+        value = rand() % 1000;
+        sum += value;
+        stack_int__push(s, value);
+        stack_double__push(d, (double)value / 7.0);
+    }
+    stack_int__sort(s);
+    stack_double__sort(d);
+
+    prev = -1;
+    for (size_t i = 0; i < N_SORT; i++) {
+        double x, y;
+        stack_int__peek_nth(s, i, &value);
+        result &= prev <= value;
+        sorted_sum += value;
+        prev = value;
+        if (i) {
+            stack_double__peek_nth(d, i - 1, &x);
+            stack_double__peek_nth(d, i, &y);
+            result &= x <= y;
+        }
+    }
+    result &= sum == sorted_sum;
+
+    stack_int__clear(s);
+    result &= stack_int__is_empty(s) == 1;
+    stack_int__sort(s);
+
+    stack_int__free(s);
+    stack_double__free(d);
+    return result;
+}
+
+
+int main(void)
+{
+    int nb_success = 0;
+    int nb_tests = 0;
+    printf("----------- TEST TYPED STACK -----------\n");
+
+    print_test_result(test_stack_typed__push_pop_and_peek(), &nb_success, &nb_tests);
+    print_test_result(test_stack_typed__copy_search_and_foreach(), &nb_success, &nb_tests);
+    print_test_result(test_stack_typed__sort(), &nb_success, &nb_tests);
+
+    print_test_summary(nb_success, nb_tests);
+
+    return TEST_SUCCESS;
+}
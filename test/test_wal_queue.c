@@ -0,0 +1,372 @@
+#include <fcntl.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "common_tests_utils.h"
+#include "../queue/wal_queue.h"
+#include "../common/defs.h"
+
+#define WAL_DIR(D) \
+    char D[] = "/tmp/test_wal_queueXXXXXX"; \
+    if (!mkdtemp(D)) return TEST_FAILURE
+
+#define N_RECORDS 1000
+
+/**
+ * Policy committing every 'group_size' records without fdatasync, the tests only simulate crashes of the process
+ */
+#define WAL_TEST_POLICY(__group_size, __compact_bytes) \
+    ((wal_policy_t){(__group_size), 0, false, (__compact_bytes)})
+
+/**
+ * Removes the log and its directory
+ */
+static bool remove_dir(const char *dir)
+{
+    char path[64];
+    snprintf(path, sizeof(path), "%s/queue.wal", dir);
+    return !unlink(path) && !rmdir(dir);
+}
+
+static off_t log_size(const char *dir)
+{
+    char path[64];
+    snprintf(path, sizeof(path), "%s/queue.wal", dir);
+    int fd = open(path, O_RDONLY);
+    off_t size = lseek(fd, 0, SEEK_END);
+    close(fd);
+    return size;
+}
+
+/**
+ * Checks that the queue holds the values from 'first' to 'last' excluded, dequeuing them
+ */
+static bool dequeue_range(const WalQueue q, const u32 first, const u32 last)
+{
+    bool result = wal_queue__length(q) == last - first;
+    u32 value;
+    for (u32 i = first; result && i < last; i++) {
+        result &= !wal_queue__dequeue(q, (elem_t *)&value) && value == i;
+    }
+    return result && !wal_queue__length(q);
+}
+
+/**
+ * Element reader failing on the value 13
+ */
+static elem_t read_u32_but_13(const void *payload, size_t size)
+{
+    u32 value;
+    memcpy(&value, payload, sizeof(u32));
+    return value == 13 ? NULL : operator_read_u32(payload, size);
+}
+
+////////////////////////////////////////////////////////////////////
+///     TEST SUITE
+////////////////////////////////////////////////////////////////////
+
+static bool test_wal_queue__open(void)
+{
+    printf("%s... ", __func__);
+
+    bool result = TEST_SUCCESS;
+    wal_queue_stats_t stats;
+    WAL_DIR(dir);
+
+    result &= !wal_queue__open_inline(NULL, sizeof(u32), NULL) && !wal_queue__open_inline(dir, 0, NULL);
+    result &= !wal_queue__open_inline("/nonexistent", sizeof(u32), NULL);
+    result &= !wal_queue__open_copy_enabled(dir, operator_copy, operator_delete, NULL, operator_read_u32, NULL);
+
+    WalQueue q = wal_queue__open_inline(dir, sizeof(u32), NULL);
+    result &= q && wal_queue__length(q) == 0 && !wal_queue__stats(q, &stats) && !stats.n_recovered;
+    result &= wal_queue__dequeue(q, NULL) == -1 && wal_queue__enqueue(q, NULL) == -1;
+    wal_queue__free(q);
+
+    /* a log torn before the end of its header is rewritten as an empty one */
+    off_t size = log_size(dir);
+    char path[64];
+    snprintf(path, sizeof(path), "%s/queue.wal", dir);
+    result &= !truncate(path, 5);
+    q = wal_queue__open_inline(dir, sizeof(u32), NULL);
+    result &= q && wal_queue__length(q) == 0 && log_size(dir) == size;
+    result &= !wal_queue__enqueue(q, &(u32){7});
+    wal_queue__free(q);
+    q = wal_queue__open_inline(dir, sizeof(u32), NULL);
+    result &= q && dequeue_range(q, 7, 8);
+    wal_queue__free(q);
+
+    /* the log keeps the size of the values it was written with */
+    result &= !wal_queue__open_inline(dir, sizeof(uint64_t), NULL);
+    result &= !wal_queue__open_copy_enabled(dir, operator_copy, operator_delete, operator_write_u32, operator_read_u32, NULL);
+    result &= wal_queue__length(NULL) == SIZE_MAX && wal_queue__stats(NULL, &stats) == -1;
+
+    result &= remove_dir(dir);
+    return result;
+}
+
+static bool test_wal_queue__replay(void)
+{
+    printf("%s... ", __func__);
+
+    bool result = TEST_SUCCESS;
+    u32 values[N_RECORDS];
+    wal_queue_stats_t stats;
+    wal_policy_t policy = WAL_TEST_POLICY(64, 0);
+    WAL_DIR(dir);
+
+    for (u32 i = 0; i < N_RECORDS; i++) {
+        values[i] = i;
+    }
+    WalQueue q = wal_queue__open_inline(dir, sizeof(u32), &policy);
+    result &= !wal_queue__enqueue_n(q, values, N_RECORDS / 2);
+    for (u32 i = N_RECORDS / 2; i < N_RECORDS; i++) {
+        result &= !wal_queue__enqueue(q, &values[i]);
+    }
+    result &= wal_queue__dequeue_n(q, values, 100) == 100 && values[99] == 99;
+    result &= !wal_queue__dequeue(q, NULL) && !wal_queue__stats(q, &stats);
+    result &= stats.n_records == N_RECORDS + 2 && stats.n_commits == 1 + (N_RECORDS / 2) / 64 && !stats.n_syncs;
+    wal_queue__free(q);
+
+    /* the pending records were committed when the queue was freed */
+    q = wal_queue__open_inline(dir, sizeof(u32), &policy);
+    result &= q && !wal_queue__stats(q, &stats) && stats.n_recovered == N_RECORDS + 2;
+    result &= stats.log_bytes == (uint64_t)log_size(dir);
+    result &= !wal_queue__peek_front(q, (elem_t *)&values[0]) && values[0] == 101;
+    result &= dequeue_range(q, 101, N_RECORDS);
+    wal_queue__free(q);
+
+    q = wal_queue__open_inline(dir, sizeof(u32), &policy);
+    result &= q && wal_queue__length(q) == 0;
+    wal_queue__free(q);
+
+    result &= remove_dir(dir);
+    return result;
+}
+
+static bool test_wal_queue__crash(void)
+{
+    printf("%s... ", __func__);
+
+    bool result = TEST_SUCCESS;
+    wal_policy_t policy = WAL_DEFAULT_POLICY;
+    WAL_DIR(dir);
+
+    /* the process is killed with all its records pending, none of them was synced */
+    policy.group_size = 1000;
+    policy.group_ns = 0;
+    pid_t pid = fork();
+    if (!pid) {
+        wal_queue_stats_t stats;
+        WalQueue q = wal_queue__open_inline(dir, sizeof(u32), &policy);
+        for (u32 i = 0; i < 350; i++) {
+            wal_queue__enqueue(q, &i);
+        }
+        wal_queue__dequeue_n(q, NULL, 20);
+        if (wal_queue__stats(q, &stats) < 0 || stats.n_syncs || stats.n_commits) _exit(EXIT_FAILURE);
+        kill(getpid(), SIGKILL);
+    }
+    int status;
+    result &= pid > 0 && waitpid(pid, &status, 0) == pid && WIFSIGNALED(status) && WTERMSIG(status) == SIGKILL;
+
+    policy = WAL_TEST_POLICY(100, 0);
+    WalQueue q = wal_queue__open_inline(dir, sizeof(u32), &policy);
+    result &= q && dequeue_range(q, 20, 350);
+    for (u32 i = 0; i < 300; i++) {
+        result &= !wal_queue__enqueue(q, &i);
+    }
+    result &= !wal_queue__sync(q);
+
+    /* a record torn by the crash is dropped with the bytes after it, then overwritten */
+    off_t size = log_size(dir);
+    wal_queue__free(q);
+    char path[64];
+    snprintf(path, sizeof(path), "%s/queue.wal", dir);
+    result &= !truncate(path, size - 3);
+
+    q = wal_queue__open_inline(dir, sizeof(u32), &policy);
+    result &= q && wal_queue__length(q) == 299 && log_size(dir) < size - 3;
+    result &= !wal_queue__enqueue(q, &(u32){299}) && !wal_queue__sync(q);
+    wal_queue__free(q);
+
+    /* a corrupted record is dropped too */
+    int fd = open(path, O_WRONLY);
+    result &= pwrite(fd, "x", 1, log_size(dir) - 6) == 1;
+    close(fd);
+    q = wal_queue__open_inline(dir, sizeof(u32), &policy);
+    result &= q && dequeue_range(q, 0, 299);
+    wal_queue__free(q);
+
+    result &= remove_dir(dir);
+    return result;
+}
+
+static bool test_wal_queue__write_failure(void)
+{
+    printf("%s... ", __func__);
+
+    bool result = TEST_SUCCESS;
+    wal_policy_t policy = WAL_TEST_POLICY(1, 0);
+    WAL_DIR(dir);
+
+    /* the log cannot grow in the child while its file size limit is lowered, the operations fail unapplied */
+    pid_t pid = fork();
+    if (!pid) {
+        struct rlimit limit;
+        bool ok = !getrlimit(RLIMIT_FSIZE, &limit) && signal(SIGXFSZ, SIG_IGN) != SIG_ERR;
+        WalQueue q = wal_queue__open_inline(dir, sizeof(u32), &policy);
+        for (u32 i = 0; ok && i < 10; i++) {
+            ok &= !wal_queue__enqueue(q, &i);
+        }
+
+        struct rlimit lowered = {(rlim_t)log_size(dir), limit.rlim_max};
+        ok &= !setrlimit(RLIMIT_FSIZE, &lowered);
+        for (u32 i = 10; ok && i < 20; i++) {
+            ok &= wal_queue__enqueue(q, &i) == -1;
+        }
+        ok &= wal_queue__enqueue_n(q, (u32[]){10, 11}, 2) == -1 && wal_queue__dequeue(q, NULL) == -1;
+        ok &= wal_queue__dequeue_n(q, NULL, 5) == SIZE_MAX && wal_queue__length(q) == 10;
+        ok &= log_size(dir) == (off_t)lowered.rlim_cur;
+
+        ok &= !setrlimit(RLIMIT_FSIZE, &limit);
+        for (u32 i = 10; ok && i < 20; i++) {
+            ok &= !wal_queue__enqueue(q, &i);
+        }
+        ok &= !wal_queue__dequeue(q, NULL) && !wal_queue__sync(q);
+        wal_queue__free(q);
+        _exit(ok ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+    int status;
+    result &= pid > 0 && waitpid(pid, &status, 0) == pid && WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS;
+
+    /* only the operations which succeeded were logged */
+    WalQueue q = wal_queue__open_inline(dir, sizeof(u32), &policy);
+    result &= q && dequeue_range(q, 1, 20);
+    wal_queue__free(q);
+
+    result &= remove_dir(dir);
+    return result;
+}
+
+static bool test_wal_queue__replay_failure(void)
+{
+    printf("%s... ", __func__);
+
+    bool result = TEST_SUCCESS;
+    elem_t elem;
+    wal_policy_t policy = WAL_TEST_POLICY(1, 0);
+    WAL_DIR(dir);
+
+    WalQueue q = wal_queue__open_copy_enabled(dir, operator_copy, operator_delete, operator_write_u32, operator_read_u32, &policy);
+    for (u32 i = 0; i < 20; i++) {
+        result &= !wal_queue__enqueue(q, &i);
+    }
+    wal_queue__free(q);
+
+    /* a valid record which cannot be replayed fails the open and keeps the records after it */
+    off_t size = log_size(dir);
+    result &= !wal_queue__open_copy_enabled(dir, operator_copy, operator_delete, operator_write_u32, read_u32_but_13, &policy);
+    result &= log_size(dir) == size;
+
+    q = wal_queue__open_copy_enabled(dir, operator_copy, operator_delete, operator_write_u32, operator_read_u32, &policy);
+    result &= q && wal_queue__length(q) == 20;
+    for (u32 i = 0; result && i < 20; i++) {
+        result &= !wal_queue__dequeue(q, &elem) && *(u32 *)elem == i;
+        free(elem);
+    }
+    wal_queue__free(q);
+
+    result &= remove_dir(dir);
+    return result;
+}
+
+static bool test_wal_queue__compact(void)
+{
+    printf("%s... ", __func__);
+
+    bool result = TEST_SUCCESS;
+    wal_queue_stats_t stats;
+    wal_policy_t policy = WAL_TEST_POLICY(16, 4096);
+    WAL_DIR(dir);
+
+    /* the log is compacted while only a few elements are queued */
+    WalQueue q = wal_queue__open_inline(dir, sizeof(u32), &policy);
+    for (u32 i = 0; i < 20 * N_RECORDS; i++) {
+        result &= !wal_queue__enqueue(q, &i);
+        if (i >= 10) {
+            result &= !wal_queue__dequeue(q, NULL);
+        }
+    }
+    result &= !wal_queue__stats(q, &stats) && stats.n_compactions && stats.log_bytes < 8192;
+    result &= !wal_queue__compact(q) && !wal_queue__stats(q, &stats) && stats.log_bytes == (uint64_t)log_size(dir);
+    wal_queue__free(q);
+
+    q = wal_queue__open_inline(dir, sizeof(u32), &policy);
+    result &= q && !wal_queue__stats(q, &stats) && stats.n_recovered == 10;
+    result &= dequeue_range(q, 20 * N_RECORDS - 10, 20 * N_RECORDS);
+    wal_queue__free(q);
+
+    result &= remove_dir(dir);
+    return result;
+}
+
+static bool test_wal_queue__copy_enabled(void)
+{
+    printf("%s... ", __func__);
+
+    bool result = TEST_SUCCESS;
+    elem_t elem;
+    elem_t elems[3] = {&(u32){1}, &(u32){STREAM_BIG_VALUE}, &(u32){3}};
+    wal_policy_t policy = WAL_TEST_POLICY(1, 1 << 20);
+    WAL_DIR(dir);
+
+    WalQueue q = wal_queue__open_copy_enabled(dir, operator_copy, operator_delete, operator_write_u32, operator_read_u32, &policy);
+    result &= !wal_queue__enqueue(q, &(u32){0}) && !wal_queue__enqueue_n(q, elems, 3);
+    result &= wal_queue__enqueue_n(q, (elem_t[]){&(u32){4}, NULL}, 2) == -1 && wal_queue__length(q) == 4;
+    result &= !wal_queue__dequeue(q, &elem) && *(u32 *)elem == 0;
+    free(elem);
+    wal_queue__free(q);
+
+    /* the record of the big payload grows the buffer and survives the compaction */
+    q = wal_queue__open_copy_enabled(dir, operator_copy, operator_delete, operator_write_u32, operator_read_u32, &policy);
+    result &= q && wal_queue__length(q) == 3 && !wal_queue__compact(q);
+    wal_queue__free(q);
+
+    q = wal_queue__open_copy_enabled(dir, operator_copy, operator_delete, operator_write_u32, operator_read_u32, &policy);
+    for (u32 i = 0; result && i < 3; i++) {
+        result &= !wal_queue__dequeue(q, &elem) && *(u32 *)elem == *(u32 *)elems[i];
+        free(elem);
+    }
+    result &= !wal_queue__enqueue(q, &(u32){5});
+    wal_queue__free(q);
+
+    /* the elements left are deleted with the queue */
+    q = wal_queue__open_copy_enabled(dir, operator_copy, operator_delete, operator_write_u32, operator_read_u32, &policy);
+    result &= q && wal_queue__length(q) == 1;
+    wal_queue__free(q);
+
+    result &= remove_dir(dir);
+    return result;
+}
+
+
+int main(void)
+{
+    int nb_success = 0;
+    int nb_tests = 0;
+    printf("----------- TEST WAL QUEUE -----------\n");
+
+    print_test_result(test_wal_queue__open(), &nb_success, &nb_tests);
+    print_test_result(test_wal_queue__replay(), &nb_success, &nb_tests);
+    print_test_result(test_wal_queue__crash(), &nb_success, &nb_tests);
+    print_test_result(test_wal_queue__write_failure(), &nb_success, &nb_tests);
+    print_test_result(test_wal_queue__replay_failure(), &nb_success, &nb_tests);
+    print_test_result(test_wal_queue__compact(), &nb_success, &nb_tests);
+    print_test_result(test_wal_queue__copy_enabled(), &nb_success, &nb_tests);
+
+    print_test_summary(nb_success, nb_tests);
+
+    return TEST_SUCCESS;
+}
@@ -0,0 +1,194 @@
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+
+#include "common_tests_utils.h"
+#include "../stack/ws_deque.h"
+#include "../common/defs.h"
+
+#define WS_DEQUE_CREATE(A, B) \
+    WsDeque A = NULL, B = NULL; \
+    A = ws_deque__empty_copy_enabled(operator_copy, operator_delete); \
+    B = ws_deque__empty_copy_disabled()
+
+#define WS_DEQUE_FREE(A, B, C, D) \
+    FREE(ws_deque__free, A, B, C, D)
+
+#define N_THIEVES 4
+#define N_TASKS 200000
+
+typedef struct {
+    WsDeque d;
+    atomic_bool *done;
+    _Atomic unsigned char *taken;
+    size_t count;
+} worker_t;
+
+////////////////////////////////////////////////////////////////////
+///     TEST SUITE
+////////////////////////////////////////////////////////////////////
+
+static bool test_ws_deque__empty(void)
+{
+    printf("%s... ", __func__);
+
+    bool result;
+    WS_DEQUE_CREATE(d, e);
+
+    result = (d && e
+           && ws_deque__is_copy_enabled(d) == 1
+           && ws_deque__is_copy_enabled(e) == 0
+           && ws_deque__is_empty(d) == 1
+           && ws_deque__is_empty(e) == 1
+           && ws_deque__length(d) == 0
+           && ws_deque__length(e) == 0) ? TEST_SUCCESS : TEST_FAILURE;
+
+    WS_DEQUE_FREE(d, e, NULL, NULL);
+    return result;
+}
+
+static bool test_ws_deque__pop_and_steal_on_empty_deque(void)
+{
+    printf("%s... ", __func__);
+
+    bool result;
+    elem_t elem = NULL;
+    WS_DEQUE_CREATE(d, e);
+
+    result = (ws_deque__pop(d, &elem) == -1 && ws_deque__pop(e, &elem) == -1
+           && ws_deque__steal(d, &elem) == -1 && ws_deque__steal(e, &elem) == -1) ? TEST_SUCCESS : TEST_FAILURE;
+
+    WS_DEQUE_FREE(d, e, NULL, NULL);
+    return result;
+}
+
+static bool test_ws_deque__pop_is_lifo_and_steal_is_fifo(void)
+{
+    printf("%s... ", __func__);
+
+    bool result = TEST_SUCCESS;
+    u32 elems[6] = {0, 1, 2, 3, 4, 5};
+    elem_t elem_d = NULL;
+    elem_t elem_e = NULL;
+    WS_DEQUE_CREATE(d, e);
+
+    for (u32 i = 0; i < 6; i++) {
+        result &= !ws_deque__push(d, &elems[i]) && !ws_deque__push(e, &elems[i]);
+    }
+    for (u32 i = 0; i < 3; i++) {
+        result &= !ws_deque__pop(d, &elem_d) && !ws_deque__pop(e, &elem_e);
+        result &= *(u32 *)elem_d == 5 - i && elem_e == &elems[5 - i];
+        free(elem_d);
+        result &= !ws_deque__steal(d, &elem_d) && !ws_deque__steal(e, &elem_e);
+        result &= *(u32 *)elem_d == i && elem_e == &elems[i];
+        free(elem_d);
+    }
+    result &= ws_deque__is_empty(d) && ws_deque__is_empty(e);
+
+    WS_DEQUE_FREE(d, e, NULL, NULL);
+    return result;
+}
+
+static bool test_ws_deque__push_grows_buffer(void)
+{
+    printf("%s... ", __func__);
+
+    bool result = TEST_SUCCESS;
+    u32 elems[1000];
+    elem_t elem_d = NULL;
+    elem_t elem_e = NULL;
+    WS_DEQUE_CREATE(d, e);
+
+    for (u32 i = 0; i < 1000; i++) {
+        elems[i] = i;
+        result &= !ws_deque__push(d, &elems[i]) && !ws_deque__push(e, &elems[i]);
+        if (i % 3 == 2) {
+            result &= !ws_deque__steal(d, &elem_d) && !ws_deque__steal(e, &elem_e);
+            result &= *(u32 *)elem_d == i / 3 && elem_e == &elems[i / 3];
+            free(elem_d);
+        }
+    }
+    result &= ws_deque__length(d) == 1000 - 333 && ws_deque__length(e) == 1000 - 333;
+    result &= !ws_deque__pop(d, &elem_d) && !ws_deque__pop(e, &elem_e);
+    result &= *(u32 *)elem_d == 999 && elem_e == &elems[999];
+    free(elem_d);
+
+    WS_DEQUE_FREE(d, e, NULL, NULL);
+    return result;
+}
+
+static void *thief(void *arg)
+{
+    worker_t *worker = arg;
+    elem_t top;
+    while (!atomic_load(worker->done) || !ws_deque__is_empty(worker->d)) {
+        if (!ws_deque__steal(worker->d, &top)) {
+            atomic_fetch_add(&worker->taken[(size_t)top], 1);
+            worker->count++;
+        } else {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static bool test_ws_deque__concurrent_owner_and_thieves(void)
+{
+    printf("%s... ", __func__);
+
+    bool result = TEST_SUCCESS;
+    pthread_t threads[N_THIEVES];
+    worker_t workers[N_THIEVES];
+    atomic_bool done = false;
+    _Atomic unsigned char *taken = calloc(N_TASKS, sizeof(_Atomic unsigned char));
+    size_t count = 0;
+    elem_t bottom;
+    WsDeque d = ws_deque__empty_copy_disabled();
+
+    for (size_t i = 0; i < N_THIEVES; i++) {
+        workers[i].d = d;
+        workers[i].done = &done;
+        workers[i].taken = taken;
+        workers[i].count = 0;
+        pthread_create(&threads[i], NULL, thief, &workers[i]);
+    }
+    for (size_t i = 0; i < N_TASKS; i++) {
+        result &= !ws_deque__push(d, (elem_t)i);
+        if (i % 4 == 3 && !ws_deque__pop(d, &bottom)) {
+            atomic_fetch_add(&taken[(size_t)bottom], 1);
+            count++;
+        }
+    }
+    atomic_store(&done, true);
+    for (size_t i = 0; i < N_THIEVES; i++) {
+        pthread_join(threads[i], NULL);
+        count += workers[i].count;
+    }
+
+    result &= count == N_TASKS && ws_deque__is_empty(d);
+    for (size_t i = 0; i < N_TASKS; i++) {
+        result &= atomic_load(&taken[i]) == 1;
+    }
+
+    free(taken);
+    WS_DEQUE_FREE(d, NULL, NULL, NULL);
+    return result;
+}
+
+
+int main(void)
+{
+    int nb_success = 0;
+    int nb_tests = 0;
+    printf("----------- TEST WORK-STEALING DEQUE -----------\n");
+
+    print_test_result(test_ws_deque__empty(), &nb_success, &nb_tests);
+    print_test_result(test_ws_deque__pop_and_steal_on_empty_deque(), &nb_success, &nb_tests);
+    print_test_result(test_ws_deque__pop_is_lifo_and_steal_is_fifo(), &nb_success, &nb_tests);
+    print_test_result(test_ws_deque__push_grows_buffer(), &nb_success, &nb_tests);
+    print_test_result(test_ws_deque__concurrent_owner_and_thieves(), &nb_success, &nb_tests);
+
+    print_test_summary(nb_success, nb_tests);
+
+    return TEST_SUCCESS;
+}